@@ -0,0 +1,45 @@
+"""
+Sample Archive for ESPHome
+- Keeps every sample snapshot on a raw flash data partition, in a ring of 4 KiB pages.
+- Column-oriented blocks: delta-of-delta timestamps and XOR values (Gorilla), about 2.7 bytes per value.
+- GET /archive?from=&to=&sensor= streams a time range as chunked CSV, one block decoded at a time.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import web_server_base
+from esphome.components.sample_snapshot import SampleSnapshot
+from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
+from esphome.const import CONF_ID
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["sample_snapshot", "network", "esp32"]
+AUTO_LOAD = ["web_server_base"]
+
+CONF_SNAPSHOT_ID = "snapshot_id"
+CONF_PARTITION = "partition"
+CONF_BLOCK_SAMPLES = "block_samples"
+
+archive_ns = cg.esphome_ns.namespace("archive")
+Archive = archive_ns.class_("Archive", cg.Component)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(Archive),
+    cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+    cv.GenerateID(CONF_SNAPSHOT_ID): cv.use_id(SampleSnapshot),
+    # label of a data partition in the partition table
+    cv.Optional(CONF_PARTITION, default="archive"): cv.string_strict,
+    # samples per block; samples are only written to flash once a block is full (or on shutdown)
+    cv.Optional(CONF_BLOCK_SAMPLES, default=12): cv.int_range(min=1, max=64),
+}).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    base = await cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
+    var = cg.new_Pvariable(config[CONF_ID], base)
+    await cg.register_component(var, config)
+
+    snapshot = await cg.get_variable(config[CONF_SNAPSHOT_ID])
+    cg.add(var.set_snapshot(snapshot))
+    cg.add(var.set_partition_label(config[CONF_PARTITION]))
+    cg.add(var.set_block_samples(config[CONF_BLOCK_SAMPLES]))
@@ -0,0 +1,362 @@
+#include "archive.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <esp_http_server.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace esphome {
+namespace archive {
+
+static const char *const TAG = "archive";
+
+// --- Setup ---
+
+void Archive::setup() {
+  this->partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                              this->partition_label_.c_str());
+  if (this->partition_ == nullptr) {
+    ESP_LOGE(TAG, "No data partition '%s', see config/archive.yaml", this->partition_label_.c_str());
+    this->mark_failed();
+    return;
+  }
+  this->page_count_ = this->partition_->size / PAGE_SIZE;
+  if (this->page_count_ < 2) {
+    ESP_LOGE(TAG, "Partition '%s' is too small", this->partition_label_.c_str());
+    this->mark_failed();
+    return;
+  }
+
+  // Series are the snapshot sources in configuration order; a different list starts a new layout
+  const auto &readings = this->snapshot_->get_snapshot().readings;
+  // get_object_id() returns a copy, keep the strings alive while hashing
+  std::vector<std::string> object_ids;
+  for (const auto &reading : readings)
+    object_ids.push_back(reading.sensor->get_object_id());
+  std::vector<const char *> names;
+  for (const auto &object_id : object_ids)
+    names.push_back(object_id.c_str());
+  this->series_ = readings.size();
+  this->layout_ = layout_hash(names.data(), names.size());
+
+  // Largest block that always fits a page
+  while (this->block_samples_ > 1 && max_block_size(this->block_samples_, this->series_) > PAGE_DATA_SIZE)
+    this->block_samples_--;
+  this->timestamps_.resize(this->block_samples_);
+  this->values_.resize(this->block_samples_ * this->series_);
+  this->block_.resize(PAGE_DATA_SIZE);
+
+  this->scan_();
+
+  this->snapshot_->add_on_snapshot_callback([this](const sample_snapshot::Snapshot &snapshot) { this->add(snapshot); });
+  this->base_->init();
+  this->base_->add_handler(this);
+}
+
+// Finds the newest page and the free space in it
+void Archive::scan_() {
+  uint32_t valid = 0;
+  bool found = false;
+  for (uint32_t page = 0; page < this->page_count_; page++) {
+    PageHeader header;
+    if (esp_partition_read(this->partition_, this->page_address_(page), &header, sizeof(header)) != ESP_OK)
+      continue;
+    if (header.magic != PAGE_MAGIC)
+      continue;
+    valid++;
+    if (!found || static_cast<int32_t>(header.sequence - this->head_sequence_) > 0) {
+      this->head_page_ = page;
+      this->head_sequence_ = header.sequence;
+      found = true;
+    }
+  }
+
+  if (!found) {
+    ESP_LOGI(TAG, "Empty archive, starting at page 0");
+    this->used_pages_ = 0;
+    this->start_page_(0, 1);
+    return;
+  }
+  this->used_pages_ = valid;
+
+  // Walk the blocks of the head page; a torn block (power lost mid-write) closes the page
+  uint32_t offset = sizeof(PageHeader);
+  uint8_t *buffer = this->block_.data();
+  esp_partition_read(this->partition_, this->page_address_(this->head_page_) + offset, buffer, PAGE_DATA_SIZE);
+  while (offset + sizeof(BlockHeader) <= PAGE_SIZE) {
+    const uint8_t *block = buffer + offset - sizeof(PageHeader);
+    uint16_t magic;
+    std::memcpy(&magic, block, sizeof(magic));
+    if (magic == 0xFFFF)
+      break;
+    if (!check_block(block, PAGE_SIZE - offset)) {
+      ESP_LOGW(TAG, "Damaged block in page %u at %u, continuing on a new page", this->head_page_, offset);
+      offset = PAGE_SIZE;
+      break;
+    }
+    offset += reinterpret_cast<const BlockHeader *>(block)->length;
+  }
+  this->head_offset_ = offset;
+  ESP_LOGD(TAG, "Head page %u (sequence %u), %u bytes free, %u pages in use", this->head_page_, this->head_sequence_,
+           PAGE_SIZE - offset, this->used_pages_);
+}
+
+bool Archive::start_page_(uint32_t page, uint32_t sequence) {
+  esp_err_t err = esp_partition_erase_range(this->partition_, this->page_address_(page), PAGE_SIZE);
+  if (err == ESP_OK) {
+    PageHeader header{PAGE_MAGIC, sequence};
+    err = esp_partition_write(this->partition_, this->page_address_(page), &header, sizeof(header));
+  }
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Starting page %u failed: %s", page, esp_err_to_name(err));
+    return false;
+  }
+  this->head_page_ = page;
+  this->head_sequence_ = sequence;
+  this->head_offset_ = sizeof(PageHeader);
+  if (this->used_pages_ < this->page_count_)
+    this->used_pages_++;
+  return true;
+}
+
+// --- Writing ---
+
+void Archive::add(const sample_snapshot::Snapshot &snapshot) {
+  if (this->is_failed())
+    return;
+  if (snapshot.timestamp == 0) {
+    ESP_LOGD(TAG, "No valid time, sample not archived");
+    return;
+  }
+  // Blocks are in time order; a clock step back starts a new one
+  if (this->pending_ > 0 && static_cast<uint32_t>(snapshot.timestamp) <= this->timestamps_[this->pending_ - 1])
+    this->flush();
+
+  {
+    std::lock_guard<std::mutex> guard(this->lock_);
+    this->timestamps_[this->pending_] = snapshot.timestamp;
+    for (uint8_t s = 0; s < this->series_; s++)
+      this->values_[this->pending_ * this->series_ + s] = snapshot.readings[s].value;
+    this->pending_++;
+  }
+  if (this->pending_ == this->block_samples_)
+    this->flush();
+}
+
+void Archive::flush() {
+  if (this->is_failed() || this->pending_ == 0)
+    return;
+  std::lock_guard<std::mutex> guard(this->lock_);
+
+  size_t length = encode_block(this->timestamps_.data(), this->values_.data(), this->pending_, this->series_,
+                               this->layout_, this->block_.data(), this->block_.size());
+  if (length == 0) {
+    ESP_LOGE(TAG, "Encoding %u samples failed", this->pending_);
+    this->pending_ = 0;
+    return;
+  }
+  if (this->head_offset_ + length > PAGE_SIZE) {
+    // Erases the oldest page once the ring is full
+    if (!this->start_page_((this->head_page_ + 1) % this->page_count_, this->head_sequence_ + 1)) {
+      this->pending_ = 0;
+      return;
+    }
+  }
+  esp_err_t err = esp_partition_write(this->partition_, this->page_address_(this->head_page_) + this->head_offset_,
+                                      this->block_.data(), length);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Writing block failed: %s", esp_err_to_name(err));
+    // The page may hold a partial block now, continue on the next one
+    this->head_offset_ = PAGE_SIZE;
+    this->pending_ = 0;
+    return;
+  }
+  ESP_LOGD(TAG, "Archived %u samples in %u bytes (page %u)", this->pending_, static_cast<unsigned>(length),
+           this->head_page_);
+  this->head_offset_ += length;
+  this->pending_ = 0;
+}
+
+// --- Query ---
+
+bool Archive::canHandle(AsyncWebServerRequest *request) const {
+  return request->method() == HTTP_GET && request->url() == "/archive";
+}
+
+bool Archive::first_timestamp_(uint32_t page, uint32_t *timestamp) {
+  BlockHeader header;
+  std::lock_guard<std::mutex> guard(this->lock_);
+  if (esp_partition_read(this->partition_, this->page_address_(page) + sizeof(PageHeader), &header,
+                         sizeof(header)) != ESP_OK ||
+      header.magic != BLOCK_MAGIC)
+    return false;
+  *timestamp = header.first_timestamp;
+  return true;
+}
+
+// CSV of the samples in one decoded block
+static void append_rows(std::string &out, const uint32_t *timestamps, const float *values, uint8_t count,
+                        size_t columns, uint32_t from, uint32_t to) {
+  char number[24];
+  for (uint8_t i = 0; i < count; i++) {
+    if (timestamps[i] < from || timestamps[i] > to)
+      continue;
+    out += to_string(timestamps[i]);
+    for (size_t c = 0; c < columns; c++) {
+      out += ',';
+      float value = values[c * count + i];
+      if (!std::isnan(value)) {
+        snprintf(number, sizeof(number), "%.6g", value);
+        out += number;
+      }
+    }
+    out += '\n';
+  }
+}
+
+void Archive::handleRequest(AsyncWebServerRequest *request) {
+  if (this->is_failed()) {
+    request->send(503, "text/plain", "Archive unavailable");
+    return;
+  }
+  uint32_t from = request->hasParam("from") ? strtoul(request->arg("from").c_str(), nullptr, 10) : 0;
+  uint32_t to = request->hasParam("to") ? strtoul(request->arg("to").c_str(), nullptr, 10) : UINT32_MAX;
+
+  // Selected series, all by default
+  const auto &readings = this->snapshot_->get_snapshot().readings;
+  std::vector<uint8_t> selected;
+  if (request->hasParam("sensor")) {
+    std::string list = request->arg("sensor");
+    size_t start = 0;
+    while (start <= list.size()) {
+      size_t end = list.find(',', start);
+      if (end == std::string::npos)
+        end = list.size();
+      std::string name = list.substr(start, end - start);
+      for (uint8_t s = 0; s < this->series_; s++) {
+        if (readings[s].sensor->get_object_id() == name)
+          selected.push_back(s);
+      }
+      start = end + 1;
+    }
+    if (selected.empty()) {
+      request->send(404, "text/plain", "Unknown sensor");
+      return;
+    }
+  } else {
+    for (uint8_t s = 0; s < this->series_; s++)
+      selected.push_back(s);
+  }
+
+  // One page, one decoded block
+  std::unique_ptr<uint8_t[]> page(new uint8_t[PAGE_SIZE]);
+  std::vector<uint32_t> timestamps(MAX_BLOCK_SAMPLES);
+  std::vector<float> values(MAX_BLOCK_SAMPLES * selected.size());
+
+  httpd_req_t *req = *request;
+  httpd_resp_set_type(req, "text/csv");
+  std::string out = "timestamp";
+  for (uint8_t s : selected) {
+    out += ',';
+    out += readings[s].sensor->get_object_id();
+  }
+  out += '\n';
+
+  uint32_t head_page, used_pages;
+  {
+    std::lock_guard<std::mutex> guard(this->lock_);
+    head_page = this->head_page_;
+    used_pages = this->used_pages_;
+  }
+
+  // Oldest page whose first block starts at or before from
+  uint32_t low = 0, high = used_pages;
+  while (high - low > 1) {
+    uint32_t middle = (low + high) / 2;
+    uint32_t first;
+    // An empty or damaged page gives no bisection information, scan from low
+    if (!this->first_timestamp_(this->ring_page_(middle, head_page, used_pages), &first))
+      break;
+    if (first <= from) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  bool done = false;
+  size_t rows_bytes = 0;
+  for (uint32_t index = low; index < used_pages && !done; index++) {
+    uint32_t physical = this->ring_page_(index, head_page, used_pages);
+    {
+      std::lock_guard<std::mutex> guard(this->lock_);
+      esp_partition_read(this->partition_, this->page_address_(physical), page.get(), PAGE_SIZE);
+    }
+    // A page erased by the writer in the meantime fails the block checks and is skipped
+    uint32_t offset = sizeof(PageHeader);
+    while (offset + sizeof(BlockHeader) <= PAGE_SIZE) {
+      const uint8_t *block = page.get() + offset;
+      if (!check_block(block, PAGE_SIZE - offset))
+        break;
+      const auto *header = reinterpret_cast<const BlockHeader *>(block);
+      offset += header->length;
+      if (header->layout != this->layout_ || header->last_timestamp < from)
+        continue;
+      if (header->first_timestamp > to) {
+        done = true;
+        break;
+      }
+      decode_timestamps(block, timestamps.data());
+      for (size_t c = 0; c < selected.size(); c++)
+        decode_series(block, selected[c], values.data() + c * header->count);
+      append_rows(out, timestamps.data(), values.data(), header->count, selected.size(), from, to);
+    }
+    if (out.size() > 1024 || done) {
+      if (httpd_resp_send_chunk(req, out.data(), out.size()) != ESP_OK) {
+        ESP_LOGW(TAG, "Query aborted by client");
+        return;
+      }
+      rows_bytes += out.size();
+      out.clear();
+      yield();
+    }
+  }
+
+  // Samples not written to flash yet
+  if (!done) {
+    std::lock_guard<std::mutex> guard(this->lock_);
+    uint8_t count = this->pending_;
+    for (uint8_t i = 0; i < count; i++)
+      timestamps[i] = this->timestamps_[i];
+    for (size_t c = 0; c < selected.size(); c++) {
+      for (uint8_t i = 0; i < count; i++)
+        values[c * count + i] = this->values_[i * this->series_ + selected[c]];
+    }
+    append_rows(out, timestamps.data(), values.data(), count, selected.size(), from, to);
+  }
+  if (!out.empty())
+    httpd_resp_send_chunk(req, out.data(), out.size());
+  httpd_resp_send_chunk(req, nullptr, 0);
+  ESP_LOGD(TAG, "Query %u-%u: %u bytes", from, to, static_cast<unsigned>(rows_bytes + out.size()));
+}
+
+void Archive::dump_config() {
+  ESP_LOGCONFIG(TAG, "Archive:");
+  if (this->is_failed()) {
+    ESP_LOGE(TAG, "  Partition '%s' not available", this->partition_label_.c_str());
+    return;
+  }
+  ESP_LOGCONFIG(TAG, "  Partition: %s, %u pages (%u in use)", this->partition_label_.c_str(), this->page_count_,
+                this->used_pages_);
+  ESP_LOGCONFIG(TAG, "  Series: %u, Block: %u samples, Layout: 0x%08X", this->series_, this->block_samples_,
+                this->layout_);
+  ESP_LOGCONFIG(TAG, "  Query: GET /archive?from=&to=&sensor=");
+}
+
+}  // namespace archive
+}  // namespace esphome
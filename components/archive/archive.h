@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <esp_partition.h>
+
+#include "esphome/core/component.h"
+#include "esphome/components/sample_snapshot/sample_snapshot.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+#include "archive_codec.h"
+
+namespace esphome {
+namespace archive {
+
+/**
+ * @brief Archive Component
+ *
+ * Keeps every sample snapshot in a ring of flash pages on a raw data partition. Samples are
+ * collected into column-oriented, Gorilla-coded blocks of block_samples snapshots (archive_codec.h),
+ * appended to the current 4 KiB page; the oldest page is erased when the ring wraps.
+ *
+ * GET /archive?from=<epoch>&to=<epoch>&sensor=<object_id>[,<object_id>...] streams the matching
+ * samples as chunked CSV. Pages are read and decoded one block at a time, so a query needs one page
+ * of RAM whatever its range. Samples not yet written to flash are included at the end.
+ */
+class Archive : public Component, public AsyncWebHandler {
+ public:
+  explicit Archive(web_server_base::WebServerBase *base) : base_(base) {}
+
+  // --- Component lifecycle ---
+  void setup() override;
+  void dump_config() override;
+  void on_shutdown() override { flush(); }
+  // after the snapshot sources are allocated and the network is up
+  float get_setup_priority() const override { return setup_priority::WIFI - 1.0f; }
+
+  // --- Configuration setters (called by Python codegen) ---
+  void set_snapshot(sample_snapshot::SampleSnapshot *snapshot) { snapshot_ = snapshot; }
+  void set_partition_label(const std::string &label) { partition_label_ = label; }
+  void set_block_samples(uint8_t block_samples) { block_samples_ = block_samples; }
+
+  // --- Public API ---
+  void add(const sample_snapshot::Snapshot &snapshot);
+  // Writes the pending samples as a (short) block
+  void flush();
+
+  // --- AsyncWebHandler ---
+  bool canHandle(AsyncWebServerRequest *request) const override;
+  void handleRequest(AsyncWebServerRequest *request) override;
+
+ protected:
+  static constexpr uint32_t PAGE_SIZE = 4096;  // flash sector
+  static constexpr uint32_t PAGE_MAGIC = 0x48435241;  // "ARCH"
+
+  struct PageHeader {
+    uint32_t magic;
+    uint32_t sequence;  // increases by one per page written, the ring order
+  };
+  static constexpr uint32_t PAGE_DATA_SIZE = PAGE_SIZE - sizeof(PageHeader);
+
+  // --- Configuration ---
+  web_server_base::WebServerBase *base_;
+  sample_snapshot::SampleSnapshot *snapshot_{nullptr};
+  std::string partition_label_{"archive"};
+  uint8_t block_samples_{12};
+
+  // --- Flash ring (guarded by lock_, the web server runs in its own task) ---
+  std::mutex lock_;
+  const esp_partition_t *partition_{nullptr};
+  uint32_t page_count_{0};
+  uint32_t head_page_{0};      // page being appended to
+  uint32_t head_sequence_{0};
+  uint32_t head_offset_{0};    // next free byte in the head page
+  uint32_t used_pages_{0};     // pages holding data, the oldest is head_page_ - used_pages_ + 1
+
+  // --- Layout and pending block ---
+  uint32_t layout_{0};
+  uint8_t series_{0};
+  std::vector<uint32_t> timestamps_;
+  std::vector<float> values_;  // [sample][series]
+  uint8_t pending_{0};
+  std::vector<uint8_t> block_;  // encode buffer, one page of data
+
+  // --- Helper methods ---
+  void scan_();
+  bool start_page_(uint32_t page, uint32_t sequence);
+  uint32_t page_address_(uint32_t page) const { return page * PAGE_SIZE; }
+  // Physical page of the index-th oldest page
+  uint32_t ring_page_(uint32_t index, uint32_t head_page, uint32_t used_pages) const {
+    return (head_page + this->page_count_ - used_pages + 1 + index) % this->page_count_;
+  }
+  bool first_timestamp_(uint32_t page, uint32_t *timestamp);
+};
+
+}  // namespace archive
+}  // namespace esphome
@@ -0,0 +1,280 @@
+#include "archive_codec.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace archive {
+
+static inline uint32_t float_bits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static inline float bits_float(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// --- Bit streams ---
+
+bool BitWriter::write(uint32_t value, uint8_t bits) {
+  if (this->bit_pos_ + bits > this->capacity_bits_)
+    return false;
+  for (int i = bits - 1; i >= 0; i--) {
+    if ((value >> i) & 1)
+      this->buffer_[this->bit_pos_ / 8] |= static_cast<uint8_t>(0x80 >> (this->bit_pos_ % 8));
+    this->bit_pos_++;
+  }
+  return true;
+}
+
+uint32_t BitReader::read(uint8_t bits) {
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < bits; i++) {
+    uint32_t bit = 0;
+    if (this->bit_pos_ < this->length_bits_)
+      bit = (this->buffer_[this->bit_pos_ / 8] >> (7 - this->bit_pos_ % 8)) & 1;
+    value = (value << 1) | bit;
+    this->bit_pos_++;
+  }
+  return value;
+}
+
+// --- Timestamps: delta of delta ---
+//   0                 dod == 0 (regular sampling)
+//   10   + 7 bits     dod in [-63, 64]
+//   110  + 9 bits     dod in [-255, 256]
+//   1110 + 12 bits    dod in [-2047, 2048]
+//   1111 + 32 bits    anything else
+// The first timestamp is stored raw.
+
+bool TimestampEncoder::add(BitWriter &writer, uint32_t timestamp) {
+  bool ok;
+  if (this->count_ == 0) {
+    ok = writer.write(timestamp, 32);
+  } else {
+    int64_t delta = static_cast<int64_t>(timestamp) - this->previous_;
+    int64_t dod = delta - this->previous_delta_;
+    if (dod == 0) {
+      ok = writer.write(0b0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+      ok = writer.write(0b10, 2) && writer.write(static_cast<uint32_t>(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+      ok = writer.write(0b110, 3) && writer.write(static_cast<uint32_t>(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+      ok = writer.write(0b1110, 4) && writer.write(static_cast<uint32_t>(dod + 2047), 12);
+    } else {
+      ok = writer.write(0b1111, 4) && writer.write(static_cast<uint32_t>(static_cast<int32_t>(dod)), 32);
+    }
+    this->previous_delta_ = delta;
+  }
+  this->previous_ = timestamp;
+  this->count_++;
+  return ok;
+}
+
+uint32_t TimestampDecoder::next(BitReader &reader) {
+  if (this->count_++ == 0) {
+    this->previous_ = reader.read(32);
+    return this->previous_;
+  }
+  int64_t dod;
+  if (reader.read(1) == 0) {
+    dod = 0;
+  } else if (reader.read(1) == 0) {
+    dod = static_cast<int64_t>(reader.read(7)) - 63;
+  } else if (reader.read(1) == 0) {
+    dod = static_cast<int64_t>(reader.read(9)) - 255;
+  } else if (reader.read(1) == 0) {
+    dod = static_cast<int64_t>(reader.read(12)) - 2047;
+  } else {
+    dod = static_cast<int32_t>(reader.read(32));
+  }
+  this->previous_delta_ += dod;
+  this->previous_ = static_cast<uint32_t>(this->previous_ + this->previous_delta_);
+  return this->previous_;
+}
+
+// --- Values: XOR with the previous value ---
+//   0                                     same value
+//   10 + meaningful bits                  XOR fits the previous leading/trailing zero window
+//   11 + 5 bits leading + 5 bits (length - 1) + length bits
+// The first value is stored raw.
+
+bool ValueEncoder::add(BitWriter &writer, float value) {
+  uint32_t bits = float_bits(value);
+  bool ok;
+  if (this->count_ == 0) {
+    ok = writer.write(bits, 32);
+  } else {
+    uint32_t x = bits ^ this->previous_;
+    if (x == 0) {
+      ok = writer.write(0b0, 1);
+    } else {
+      uint8_t leading = __builtin_clz(x);
+      uint8_t trailing = __builtin_ctz(x);
+      if (leading > 31)
+        leading = 31;
+      if (this->leading_ != 0xFF && leading >= this->leading_ && trailing >= this->trailing_) {
+        uint8_t length = 32 - this->leading_ - this->trailing_;
+        ok = writer.write(0b10, 2) && writer.write(x >> this->trailing_, length);
+      } else {
+        uint8_t length = 32 - leading - trailing;
+        ok = writer.write(0b11, 2) && writer.write(leading, 5) && writer.write(length - 1, 5) &&
+             writer.write(x >> trailing, length);
+        this->leading_ = leading;
+        this->trailing_ = trailing;
+      }
+    }
+  }
+  this->previous_ = bits;
+  this->count_++;
+  return ok;
+}
+
+float ValueDecoder::next(BitReader &reader) {
+  if (this->count_++ == 0) {
+    this->previous_ = reader.read(32);
+    return bits_float(this->previous_);
+  }
+  if (reader.read(1) == 0)
+    return bits_float(this->previous_);
+  if (reader.read(1) == 1) {
+    this->leading_ = reader.read(5);
+    this->trailing_ = 32 - this->leading_ - (reader.read(5) + 1);
+  }
+  uint8_t length = 32 - this->leading_ - this->trailing_;
+  this->previous_ ^= reader.read(length) << this->trailing_;
+  return bits_float(this->previous_);
+}
+
+// --- Blocks ---
+
+uint16_t crc16(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= static_cast<uint16_t>(data[i]) << 8;
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+uint32_t layout_hash(const char *const *names, size_t count) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < count; i++) {
+    for (const char *c = names[i];; c++) {
+      hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+      if (*c == '\0')
+        break;
+    }
+  }
+  return hash;
+}
+
+static inline size_t columns_offset(uint8_t series) { return sizeof(BlockHeader) + (series + 1) * sizeof(uint16_t); }
+
+size_t max_block_size(uint8_t count, uint8_t series) {
+  // 32 bits first entry, then at most 36 bits per timestamp and 44 per value
+  size_t timestamp_bytes = (32 + (count - 1) * 36 + 7) / 8;
+  size_t series_bytes = (32 + (count - 1) * 44 + 7) / 8;
+  return columns_offset(series) + timestamp_bytes + series * series_bytes;
+}
+
+size_t encode_block(const uint32_t *timestamps, const float *values, uint8_t count, uint8_t series, uint32_t layout,
+                    uint8_t *out, size_t capacity) {
+  const size_t offset = columns_offset(series);
+  if (count == 0 || count > MAX_BLOCK_SAMPLES || capacity < offset)
+    return 0;
+  std::memset(out, 0, capacity);
+  uint16_t *lengths = reinterpret_cast<uint16_t *>(out + sizeof(BlockHeader));
+  size_t position = offset;
+
+  {
+    BitWriter writer(out + position, capacity - position);
+    TimestampEncoder encoder;
+    for (uint8_t i = 0; i < count; i++) {
+      if (!encoder.add(writer, timestamps[i]))
+        return 0;
+    }
+    lengths[0] = writer.bytes();
+    position += writer.bytes();
+  }
+  for (uint8_t s = 0; s < series; s++) {
+    BitWriter writer(out + position, capacity - position);
+    ValueEncoder encoder;
+    for (uint8_t i = 0; i < count; i++) {
+      if (!encoder.add(writer, values[i * series + s]))
+        return 0;
+    }
+    lengths[s + 1] = writer.bytes();
+    position += writer.bytes();
+  }
+  if (position > UINT16_MAX)
+    return 0;
+
+  BlockHeader header;
+  header.magic = BLOCK_MAGIC;
+  header.length = position;
+  header.layout = layout;
+  header.first_timestamp = timestamps[0];
+  header.last_timestamp = timestamps[count - 1];
+  header.count = count;
+  header.series = series;
+  header.crc = crc16(out + sizeof(BlockHeader), position - sizeof(BlockHeader));
+  std::memcpy(out, &header, sizeof(header));
+  return position;
+}
+
+bool check_block(const uint8_t *block, size_t available) {
+  if (available < sizeof(BlockHeader))
+    return false;
+  BlockHeader header;
+  std::memcpy(&header, block, sizeof(header));
+  if (header.magic != BLOCK_MAGIC || header.length > available || header.count == 0 ||
+      header.count > MAX_BLOCK_SAMPLES || header.length < columns_offset(header.series))
+    return false;
+  return crc16(block + sizeof(BlockHeader), header.length - sizeof(BlockHeader)) == header.crc;
+}
+
+// Start and length of column (0 = timestamps)
+static const uint8_t *column(const uint8_t *block, uint8_t index, size_t *length) {
+  BlockHeader header;
+  std::memcpy(&header, block, sizeof(header));
+  const uint8_t *lengths = block + sizeof(BlockHeader);
+  *length = 0;
+  size_t position = columns_offset(header.series);
+  for (uint8_t i = 0; i <= index; i++) {
+    uint16_t column_length;
+    std::memcpy(&column_length, lengths + i * sizeof(uint16_t), sizeof(column_length));
+    if (i == index) {
+      *length = column_length;
+      break;
+    }
+    position += column_length;
+  }
+  return block + position;
+}
+
+void decode_timestamps(const uint8_t *block, uint32_t *timestamps) {
+  size_t length;
+  const uint8_t *data = column(block, 0, &length);
+  BitReader reader(data, length);
+  TimestampDecoder decoder;
+  for (uint8_t i = 0; i < reinterpret_cast<const BlockHeader *>(block)->count; i++)
+    timestamps[i] = decoder.next(reader);
+}
+
+void decode_series(const uint8_t *block, uint8_t index, float *values) {
+  size_t length;
+  const uint8_t *data = column(block, index + 1, &length);
+  BitReader reader(data, length);
+  ValueDecoder decoder;
+  for (uint8_t i = 0; i < reinterpret_cast<const BlockHeader *>(block)->count; i++)
+    values[i] = decoder.next(reader);
+}
+
+}  // namespace archive
+}  // namespace esphome
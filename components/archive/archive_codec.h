@@ -0,0 +1,123 @@
+#pragma once
+
+// Gorilla-style block codec for the archive, without ESPHome or ESP-IDF dependencies so it can be
+// built and measured on a host.
+//
+// A block holds up to MAX_BLOCK_SAMPLES samples of one snapshot layout, column by column:
+//   [BlockHeader] [column length, u16 x (series + 1)] [timestamps] [series 0] ... [series n-1]
+// Timestamps are delta-of-delta coded, values XOR coded against the previous value of the same
+// series (Pelkonen et al., "Gorilla", VLDB 2015). Columns are byte aligned, so a query for one
+// sensor skips the others without decoding them.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace archive {
+
+static constexpr uint16_t BLOCK_MAGIC = 0xA7C5;
+static constexpr uint8_t MAX_BLOCK_SAMPLES = 64;
+
+struct __attribute__((packed)) BlockHeader {
+  uint16_t magic;
+  uint16_t length;           // bytes, including this header
+  uint32_t layout;           // hash of the series names, see layout_hash()
+  uint32_t first_timestamp;  // epoch seconds
+  uint32_t last_timestamp;
+  uint8_t count;             // samples
+  uint8_t series;            // value columns
+  uint16_t crc;              // CRC-16/CCITT of the bytes after the header
+};
+
+// --- Bit streams (MSB first) ---
+
+class BitWriter {
+ public:
+  // buffer must be zeroed
+  BitWriter(uint8_t *buffer, size_t capacity) : buffer_(buffer), capacity_bits_(capacity * 8) {}
+  // false once the buffer is full
+  bool write(uint32_t value, uint8_t bits);
+  size_t bytes() const { return (bit_pos_ + 7) / 8; }
+
+ protected:
+  uint8_t *buffer_;
+  size_t capacity_bits_;
+  size_t bit_pos_{0};
+};
+
+class BitReader {
+ public:
+  BitReader(const uint8_t *buffer, size_t length) : buffer_(buffer), length_bits_(length * 8) {}
+  // Reads zeros past the end
+  uint32_t read(uint8_t bits);
+  bool overrun() const { return bit_pos_ > length_bits_; }
+
+ protected:
+  const uint8_t *buffer_;
+  size_t length_bits_;
+  size_t bit_pos_{0};
+};
+
+// --- Column codecs ---
+
+class TimestampEncoder {
+ public:
+  bool add(BitWriter &writer, uint32_t timestamp);
+
+ protected:
+  uint32_t count_{0};
+  uint32_t previous_{0};
+  int64_t previous_delta_{0};
+};
+
+class TimestampDecoder {
+ public:
+  uint32_t next(BitReader &reader);
+
+ protected:
+  uint32_t count_{0};
+  uint32_t previous_{0};
+  int64_t previous_delta_{0};
+};
+
+class ValueEncoder {
+ public:
+  bool add(BitWriter &writer, float value);
+
+ protected:
+  uint32_t count_{0};
+  uint32_t previous_{0};
+  uint8_t leading_{0xFF};  // meaningful bit window of the previous XOR, 0xFF = none yet
+  uint8_t trailing_{0};
+};
+
+class ValueDecoder {
+ public:
+  float next(BitReader &reader);
+
+ protected:
+  uint32_t count_{0};
+  uint32_t previous_{0};
+  uint8_t leading_{0};
+  uint8_t trailing_{0};
+};
+
+// --- Blocks ---
+
+uint16_t crc16(const uint8_t *data, size_t length);
+// FNV-1a over the NUL-separated series names
+uint32_t layout_hash(const char *const *names, size_t count);
+// Worst case encoded size of a block
+size_t max_block_size(uint8_t count, uint8_t series);
+
+// values are row major ([sample][series]); returns the block length, 0 if it does not fit
+size_t encode_block(const uint32_t *timestamps, const float *values, uint8_t count, uint8_t series, uint32_t layout,
+                    uint8_t *out, size_t capacity);
+// Header, length and CRC of a block read from flash; available is the number of bytes in block
+bool check_block(const uint8_t *block, size_t available);
+// Decode one column of a checked block into count entries
+void decode_timestamps(const uint8_t *block, uint32_t *timestamps);
+void decode_series(const uint8_t *block, uint8_t index, float *values);
+
+}  // namespace archive
+}  // namespace esphome
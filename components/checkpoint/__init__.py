@@ -0,0 +1,37 @@
+"""
+Pipeline Checkpoint for ESPHome
+- Keeps compact pipeline state (median windows, sound level accumulators, InfluxDB backlog)
+  in RTC memory across software resets, OTA, brownouts and deep sleep.
+- Saved every update_interval and on shutdown; CRC checked and only restored when younger
+  than max_age. Each record carries its client's version, so an OTA keeps unchanged records.
+- Components and streaming filters opt in with `checkpoint_id`.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.const import CONF_ID, CONF_SIZE
+
+CODEOWNERS = ["@IEQLab"]
+
+CONF_CHECKPOINT_ID = "checkpoint_id"
+CONF_MAX_AGE = "max_age"
+
+checkpoint_ns = cg.esphome_ns.namespace("checkpoint")
+Checkpoint = checkpoint_ns.class_("Checkpoint", cg.PollingComponent)
+
+# RTC slow memory is 8 KiB on the ESP32, shared with anything else kept there
+MAX_SIZE = 6144
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(Checkpoint),
+    cv.Optional(CONF_SIZE, default=4096): cv.int_range(min=256, max=MAX_SIZE),
+    # older checkpoints are discarded (e.g. after a long deep sleep or a power cycle)
+    cv.Optional(CONF_MAX_AGE, default="10min"): cv.positive_time_period_milliseconds,
+}).extend(cv.polling_component_schema("60s"))
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID], config[CONF_MAX_AGE])
+    await cg.register_component(var, config)
+    cg.add_define("USE_CHECKPOINT")
+    cg.add_define("CHECKPOINT_SIZE", config[CONF_SIZE])
@@ -0,0 +1,238 @@
+#include "checkpoint.h"
+#include <sys/time.h>
+#include <cinttypes>
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include "esp_attr.h"
+#include "esp_rom_crc.h"
+
+#ifndef CHECKPOINT_SIZE
+#define CHECKPOINT_SIZE 4096
+#endif
+
+namespace esphome {
+namespace checkpoint {
+
+static const char *const TAG = "checkpoint";
+
+static constexpr uint32_t CHECKPOINT_MAGIC = 0x54504B43;  // "CKPT"
+static constexpr uint16_t CHECKPOINT_VERSION = 2;         // bump when the header or record framing changes
+static constexpr size_t RECORD_OVERHEAD = 2 * sizeof(uint32_t) + sizeof(uint16_t);
+
+// At the start of the RTC buffer, followed by records: [key u32][client version u32][length u16][data].
+// No padding, so the CRC only covers defined bytes.
+struct Header {
+  int64_t saved_at_us;   // system time, kept by the RTC across resets and deep sleep
+  uint32_t magic;
+  uint16_t version;
+  uint16_t length;       // bytes of records after the header
+  uint32_t records;
+  uint32_t crc;          // of the header fields before it and of the records
+};
+static_assert(sizeof(Header) == 24, "checkpoint header must not be padded");
+
+// Not cleared at boot; random after power-on
+static RTC_NOINIT_ATTR uint8_t rtc_checkpoint[CHECKPOINT_SIZE] __attribute__((aligned(8)));
+
+// --- Half precision ---
+
+uint16_t float_to_half(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint16_t sign = (bits >> 16) & 0x8000;
+  int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+  uint32_t mantissa = bits & 0x7FFFFF;
+
+  if (((bits >> 23) & 0xFF) == 0xFF)  // Inf, NaN
+    return sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0);
+  if (exponent >= 0x1F)  // too large, saturate to Inf
+    return sign | 0x7C00;
+  if (exponent <= 0) {
+    if (exponent < -10)  // too small, flush to zero
+      return sign;
+    // subnormal: shift the mantissa with its implicit leading one, round to nearest
+    mantissa |= 0x800000;
+    uint32_t shift = 14 - exponent;
+    return sign | static_cast<uint16_t>((mantissa + (1u << (shift - 1))) >> shift);
+  }
+  // round to nearest; a carry into the exponent is still the correct result
+  return static_cast<uint16_t>(sign | ((exponent << 10) + ((mantissa + 0x1000) >> 13)));
+}
+
+float half_to_float(uint16_t half) {
+  uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1F;
+  uint32_t mantissa = half & 0x3FF;
+  uint32_t bits;
+  if (exponent == 0x1F) {
+    bits = sign | 0x7F800000 | (mantissa << 13);
+  } else if (exponent != 0) {
+    bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    bits = sign;
+  } else {
+    // subnormal: normalise
+    exponent = 127 - 15 + 1;
+    while ((mantissa & 0x400) == 0) {
+      mantissa <<= 1;
+      exponent--;
+    }
+    bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+  }
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// --- Checkpoint ---
+
+static int64_t system_time_us() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+static uint32_t header_crc(const Header &header) {
+  // the header up to the crc field, then the records
+  uint32_t crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t *>(&header), offsetof(Header, crc));
+  return esp_rom_crc32_le(crc, rtc_checkpoint + sizeof(Header), header.length);
+}
+
+bool Checkpoint::check_retained_() {
+  if (this->retained_ != Retained::UNCHECKED)
+    return this->retained_ == Retained::VALID;
+  this->retained_ = Retained::INVALID;
+
+  Header header;
+  memcpy(&header, rtc_checkpoint, sizeof(header));
+  if (header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION) {
+    ESP_LOGD(TAG, "No checkpoint retained");
+    return false;
+  }
+  if (header.length > CHECKPOINT_SIZE - sizeof(Header) || header.crc != header_crc(header)) {
+    ESP_LOGW(TAG, "Retained checkpoint is corrupt");
+    return false;
+  }
+  int64_t age_us = system_time_us() - header.saved_at_us;
+  if (age_us < 0 || age_us > static_cast<int64_t>(this->max_age_ms_) * 1000) {
+    ESP_LOGI(TAG, "Retained checkpoint is too old (%lld s), discarded", static_cast<long long>(age_us / 1000000));
+    return false;
+  }
+  this->retained_age_ms_ = age_us / 1000;
+  this->retained_ = Retained::VALID;
+  ESP_LOGI(TAG, "Restoring checkpoint of %u records (%u bytes) from %u ms ago", header.records, header.length,
+           this->retained_age_ms_);
+  return true;
+}
+
+const uint8_t *Checkpoint::find_record_(uint32_t key, uint32_t *version, uint16_t *length) const {
+  uint16_t total;
+  memcpy(&total, rtc_checkpoint + offsetof(Header, length), sizeof(total));
+  const uint8_t *record = rtc_checkpoint + sizeof(Header);
+  const uint8_t *end = record + total;
+  while (end - record >= static_cast<ptrdiff_t>(RECORD_OVERHEAD)) {
+    uint32_t record_key;
+    uint16_t record_length;
+    memcpy(&record_key, record, sizeof(record_key));
+    memcpy(&record_length, record + 2 * sizeof(uint32_t), sizeof(record_length));
+    const uint8_t *data = record + RECORD_OVERHEAD;
+    if (record_length > end - data)
+      return nullptr;
+    if (record_key == key) {
+      memcpy(version, record + sizeof(record_key), sizeof(*version));
+      *length = record_length;
+      return data;
+    }
+    record = data + record_length;
+  }
+  return nullptr;
+}
+
+bool Checkpoint::add_client(const char *name, uint32_t version, SaveCallback &&save, RestoreCallback &&restore) {
+  uint32_t key = fnv1_hash(name);
+  this->clients_.push_back({name, key, version, std::move(save), false});
+
+  if (!this->check_retained_())
+    return false;
+  uint32_t record_version;
+  uint16_t length;
+  const uint8_t *data = this->find_record_(key, &record_version, &length);
+  if (data == nullptr)
+    return false;
+  if (record_version != version) {
+    // e.g. an OTA that changed what the client saves, or its configuration
+    ESP_LOGI(TAG, "'%s' record is version %" PRIu32 ", expected %" PRIu32 ", discarded", name, record_version,
+             version);
+    return false;
+  }
+  Reader reader(data, length);
+  if (!restore(reader, this->retained_age_ms_) || !reader.ok()) {
+    ESP_LOGW(TAG, "'%s' rejected its checkpoint", name);
+    return false;
+  }
+  this->restored_++;
+  ESP_LOGD(TAG, "'%s' restored (%u bytes)", name, length);
+  return true;
+}
+
+void Checkpoint::save() {
+  // Invalidate first: a reset in the middle of a save leaves no half written checkpoint
+  this->retained_ = Retained::INVALID;
+  Header header{};
+  memcpy(rtc_checkpoint, &header, sizeof(header));
+
+  Writer writer(rtc_checkpoint + sizeof(Header), CHECKPOINT_SIZE - sizeof(Header));
+  uint32_t records = 0;
+  for (auto &client : this->clients_) {
+    size_t start = writer.size();
+    writer.write_u32(client.key);
+    writer.write_u32(client.version);
+    writer.write_u16(0);
+    client.save(writer);
+    size_t length = writer.size() - start - RECORD_OVERHEAD;
+    if (writer.overflow() || length > UINT16_MAX) {
+      writer.truncate(start);
+      if (!client.warned)
+        ESP_LOGW(TAG, "'%s' does not fit in the remaining %zu bytes", client.name, writer.remaining());
+      client.warned = true;
+      continue;
+    }
+    uint16_t record_length = length;
+    memcpy(writer.data() + start + 2 * sizeof(uint32_t), &record_length, sizeof(record_length));
+    records++;
+  }
+
+  header.saved_at_us = system_time_us();
+  header.magic = CHECKPOINT_MAGIC;
+  header.version = CHECKPOINT_VERSION;
+  header.length = writer.size();
+  header.records = records;
+  header.crc = header_crc(header);
+  memcpy(rtc_checkpoint, &header, sizeof(header));
+  this->last_size_ = header.length;
+  ESP_LOGV(TAG, "Saved %u bytes", header.length);
+}
+
+void Checkpoint::setup() {
+  // Everything retained has been offered to the clients by now
+  this->check_retained_();
+}
+
+void Checkpoint::update() { this->save(); }
+
+void Checkpoint::on_shutdown() { this->save(); }
+
+void Checkpoint::dump_config() {
+  ESP_LOGCONFIG(TAG, "Checkpoint:");
+  ESP_LOGCONFIG(TAG, "  Size: %u bytes of RTC memory, %u used", static_cast<unsigned>(CHECKPOINT_SIZE),
+                this->last_size_ + static_cast<unsigned>(sizeof(Header)));
+  ESP_LOGCONFIG(TAG, "  Max age: %u s", this->max_age_ms_ / 1000);
+  ESP_LOGCONFIG(TAG, "  Clients: %zu, restored at boot: %u", this->clients_.size(), this->restored_);
+  for (const auto &client : this->clients_)
+    ESP_LOGCONFIG(TAG, "    %s (version %" PRIu32 ")", client.name, client.version);
+  LOG_UPDATE_INTERVAL(this);
+}
+
+}  // namespace checkpoint
+}  // namespace esphome
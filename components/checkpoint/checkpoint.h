@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace checkpoint {
+
+// --- Half precision ---
+// Windows of sensor values are stored as IEEE 754 binary16: ~3 significant digits, NaN kept
+uint16_t float_to_half(float value);
+float half_to_float(uint16_t half);
+
+// --- Record serialization ---
+
+// Appends to a fixed buffer; a write that does not fit sets overflow() and is dropped
+class Writer {
+ public:
+  Writer(uint8_t *data, size_t capacity) : data_(data), capacity_(capacity) {}
+
+  void write(const void *data, size_t len) {
+    if (this->overflow_ || len > this->capacity_ - this->size_) {
+      this->overflow_ = true;
+      return;
+    }
+    memcpy(this->data_ + this->size_, data, len);
+    this->size_ += len;
+  }
+  template<typename T> void write_value(T value) { this->write(&value, sizeof(T)); }
+  void write_u8(uint8_t value) { this->write_value(value); }
+  void write_u16(uint16_t value) { this->write_value(value); }
+  void write_u32(uint32_t value) { this->write_value(value); }
+  void write_float(float value) { this->write_value(value); }
+  void write_double(double value) { this->write_value(value); }
+  void write_half(float value) { this->write_value(float_to_half(value)); }
+  void write_string(const std::string &value) {
+    this->write_u16(value.size());
+    this->write(value.data(), value.size());
+  }
+
+  size_t size() const { return size_; }
+  size_t remaining() const { return overflow_ ? 0 : capacity_ - size_; }
+  bool overflow() const { return overflow_; }
+  // Drops everything written after size, e.g. a record that did not fit
+  void truncate(size_t size) {
+    this->size_ = size;
+    this->overflow_ = false;
+  }
+  uint8_t *data() { return data_; }
+
+ protected:
+  uint8_t *data_;
+  size_t capacity_;
+  size_t size_{0};
+  bool overflow_{false};
+};
+
+// Reads from a record; reading past its end returns zeros and clears ok()
+class Reader {
+ public:
+  Reader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+  bool read(void *data, size_t len) {
+    if (!this->ok_ || len > this->size_ - this->position_) {
+      this->ok_ = false;
+      memset(data, 0, len);
+      return false;
+    }
+    memcpy(data, this->data_ + this->position_, len);
+    this->position_ += len;
+    return true;
+  }
+  template<typename T> T read_value() {
+    T value;
+    this->read(&value, sizeof(T));
+    return value;
+  }
+  uint8_t read_u8() { return this->read_value<uint8_t>(); }
+  uint16_t read_u16() { return this->read_value<uint16_t>(); }
+  uint32_t read_u32() { return this->read_value<uint32_t>(); }
+  float read_float() { return this->read_value<float>(); }
+  double read_double() { return this->read_value<double>(); }
+  float read_half() { return half_to_float(this->read_value<uint16_t>()); }
+  std::string read_string() {
+    uint16_t len = this->read_u16();
+    if (!this->ok_ || len > this->size_ - this->position_) {
+      this->ok_ = false;
+      return {};
+    }
+    std::string value(reinterpret_cast<const char *>(this->data_ + this->position_), len);
+    this->position_ += len;
+    return value;
+  }
+
+  size_t remaining() const { return size_ - position_; }
+  bool ok() const { return ok_; }
+
+ protected:
+  const uint8_t *data_;
+  size_t size_;
+  size_t position_{0};
+  bool ok_{true};
+};
+
+/**
+ * @brief Checkpoint Component
+ *
+ * Keeps the compact state of the measurement pipeline (median windows, sound level accumulators,
+ * the InfluxDB backlog) in RTC slow memory, so it survives a software reset, OTA, brownout, crash
+ * or deep sleep, and the pipeline resumes within seconds instead of warming up again:
+ *   - clients register under a unique name with a version, a save and a restore callback
+ *   - every update_interval and on shutdown, all clients write one record each into the
+ *     RTC_NOINIT buffer; a record that does not fit in the remaining space is left out
+ *   - the buffer carries a magic, a layout version and a CRC, and the time it was written; it is
+ *     restored when the CRC matches and it is not older than max_age. After power loss the
+ *     content is random and fails the checks
+ *   - each record carries the version of its client, and is only restored by a client of the
+ *     same version, so a firmware update keeps the records whose format it did not change
+ *   - restore runs once, when a client registers, with the age of the checkpoint, so clients
+ *     register from their setup() (or constructor) before the first save overwrites the buffer
+ */
+class Checkpoint : public PollingComponent {
+ public:
+  using SaveCallback = std::function<void(Writer &)>;
+  // returns whether the record was used
+  using RestoreCallback = std::function<bool(Reader &, uint32_t age_ms)>;
+
+  // max_age is needed before the first client registers, which can be from codegen
+  explicit Checkpoint(uint32_t max_age) : max_age_ms_(max_age) {}
+
+  // --- Public API ---
+  // Registers a client; restore is called right away if the retained checkpoint has a valid record
+  // for name of the same version. version identifies what save writes: bump it when the format
+  // changes, and fold in any configuration the record depends on. Returns whether restore was
+  // called and used the record.
+  bool add_client(const char *name, uint32_t version, SaveCallback &&save, RestoreCallback &&restore);
+  // Writes all clients to RTC memory, e.g. before a planned deep sleep
+  void save();
+
+  // --- Component lifecycle ---
+  void setup() override;
+  void update() override;
+  void on_shutdown() override;
+  void dump_config() override;
+  // after the clients that register from setup(), so the first save cannot overwrite their records
+  float get_setup_priority() const override { return setup_priority::LATE; }
+
+ protected:
+  struct Client {
+    const char *name;
+    uint32_t key;
+    uint32_t version;
+    SaveCallback save;
+    bool warned;  // record did not fit, logged once
+  };
+
+  enum class Retained : uint8_t { UNCHECKED, VALID, INVALID };
+
+  // --- Configuration ---
+  uint32_t max_age_ms_;
+  std::vector<Client> clients_;
+
+  // --- Runtime state ---
+  Retained retained_{Retained::UNCHECKED};
+  uint32_t retained_age_ms_{0};
+  uint16_t restored_{0};
+  uint16_t last_size_{0};
+
+  // --- Helper methods ---
+  bool check_retained_();
+  const uint8_t *find_record_(uint32_t key, uint32_t *version, uint16_t *length) const;
+};
+
+}  // namespace checkpoint
+}  // namespace esphome
@@ -0,0 +1,107 @@
+"""
+Thermal Comfort for ESPHome
+- ISO 7730 PMV and PPD and ISO 7726 operative temperature, computed for every sample snapshot.
+- Single precision, bounded clothing temperature iteration warm-started from the previous sample.
+- Optional table for the saturation vapour pressure instead of exp().
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.components.sample_snapshot import SampleSnapshot
+from esphome.const import (
+    CONF_HUMIDITY,
+    CONF_ID,
+    CONF_TEMPERATURE,
+    DEVICE_CLASS_TEMPERATURE,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_CELSIUS,
+    UNIT_PERCENT,
+)
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["sample_snapshot"]
+AUTO_LOAD = ["sensor"]
+
+CONF_SNAPSHOT_ID = "snapshot_id"
+CONF_RADIANT_TEMPERATURE = "radiant_temperature"
+CONF_AIR_SPEED = "air_speed"
+CONF_METABOLIC_RATE = "metabolic_rate"
+CONF_CLOTHING = "clothing"
+CONF_MAX_ITERATIONS = "max_iterations"
+CONF_USE_TABLE = "use_table"
+CONF_PMV = "pmv"
+CONF_PPD = "ppd"
+CONF_OPERATIVE_TEMPERATURE = "operative_temperature"
+
+ICON_THERMOMETER = "mdi:thermometer"
+ICON_EMOTICON = "mdi:emoticon-outline"
+ICON_PERCENT = "mdi:account-group"
+
+comfort_ns = cg.esphome_ns.namespace("comfort")
+Comfort = comfort_ns.class_("Comfort", cg.Component)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(Comfort),
+    cv.GenerateID(CONF_SNAPSHOT_ID): cv.use_id(SampleSnapshot),
+    # Inputs, read from the snapshot (or their current state if they are not snapshot sources)
+    cv.Required(CONF_TEMPERATURE): cv.use_id(sensor.Sensor),
+    cv.Required(CONF_RADIANT_TEMPERATURE): cv.use_id(sensor.Sensor),
+    cv.Required(CONF_AIR_SPEED): cv.use_id(sensor.Sensor),
+    cv.Required(CONF_HUMIDITY): cv.use_id(sensor.Sensor),
+    # Personal factors, ISO 7730 validity range
+    cv.Optional(CONF_METABOLIC_RATE, default=1.1): cv.float_range(min=0.8, max=4.0),
+    cv.Optional(CONF_CLOTHING, default=0.6): cv.float_range(min=0.0, max=2.0),
+    # Solver
+    cv.Optional(CONF_MAX_ITERATIONS, default=50): cv.int_range(min=1, max=255),
+    cv.Optional(CONF_USE_TABLE, default=False): cv.boolean,
+    # Outputs
+    cv.Optional(CONF_PMV): sensor.sensor_schema(
+        icon=ICON_EMOTICON,
+        accuracy_decimals=2,
+        state_class=STATE_CLASS_MEASUREMENT,
+    ),
+    cv.Optional(CONF_PPD): sensor.sensor_schema(
+        unit_of_measurement=UNIT_PERCENT,
+        icon=ICON_PERCENT,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+    ),
+    cv.Optional(CONF_OPERATIVE_TEMPERATURE): sensor.sensor_schema(
+        unit_of_measurement=UNIT_CELSIUS,
+        icon=ICON_THERMOMETER,
+        accuracy_decimals=1,
+        device_class=DEVICE_CLASS_TEMPERATURE,
+        state_class=STATE_CLASS_MEASUREMENT,
+    ),
+}).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    snapshot = await cg.get_variable(config[CONF_SNAPSHOT_ID])
+    cg.add(var.set_snapshot(snapshot))
+
+    # Inputs
+    cg.add(var.set_temperature_source(await cg.get_variable(config[CONF_TEMPERATURE])))
+    cg.add(var.set_radiant_temperature_source(await cg.get_variable(config[CONF_RADIANT_TEMPERATURE])))
+    cg.add(var.set_air_speed_source(await cg.get_variable(config[CONF_AIR_SPEED])))
+    cg.add(var.set_humidity_source(await cg.get_variable(config[CONF_HUMIDITY])))
+
+    cg.add(var.set_metabolic_rate(config[CONF_METABOLIC_RATE]))
+    cg.add(var.set_clothing(config[CONF_CLOTHING]))
+    cg.add(var.set_max_iterations(config[CONF_MAX_ITERATIONS]))
+    cg.add(var.set_use_table(config[CONF_USE_TABLE]))
+
+    # Optional sensors
+    if pmv_config := config.get(CONF_PMV):
+        sens = await sensor.new_sensor(pmv_config)
+        cg.add(var.set_pmv_sensor(sens))
+    if ppd_config := config.get(CONF_PPD):
+        sens = await sensor.new_sensor(ppd_config)
+        cg.add(var.set_ppd_sensor(sens))
+    if operative_config := config.get(CONF_OPERATIVE_TEMPERATURE):
+        sens = await sensor.new_sensor(operative_config)
+        cg.add(var.set_operative_temperature_sensor(sens))
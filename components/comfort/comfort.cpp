@@ -0,0 +1,69 @@
+#include "comfort.h"
+#include "esphome/core/log.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace comfort {
+
+static const char *const TAG = "comfort";
+
+void Comfort::setup() {
+  this->solver_.set_use_table(this->use_table_);
+  this->snapshot_->add_on_snapshot_callback([this](const sample_snapshot::Snapshot &snapshot) {
+    this->compute(snapshot);
+  });
+}
+
+float Comfort::input_(const sample_snapshot::Snapshot &snapshot, sensor::Sensor *source) {
+  const auto *reading = snapshot.find(source);
+  return reading != nullptr ? reading->value : source->state;
+}
+
+void Comfort::compute(const sample_snapshot::Snapshot &snapshot) {
+  float ta = input_(snapshot, this->temperature_source_);
+  float tr = input_(snapshot, this->radiant_temperature_source_);
+  float air_speed = input_(snapshot, this->air_speed_source_);
+  float rh = input_(snapshot, this->humidity_source_);
+
+  if (std::isnan(ta) || std::isnan(tr) || std::isnan(air_speed) || std::isnan(rh)) {
+    ESP_LOGD(TAG, "Missing input, comfort indices not computed");
+    // Inputs after a gap may be far from the last solution
+    this->solver_.reset();
+    if (this->pmv_sensor_ != nullptr)
+      this->pmv_sensor_->publish_state(NAN);
+    if (this->ppd_sensor_ != nullptr)
+      this->ppd_sensor_->publish_state(NAN);
+    if (this->operative_temperature_sensor_ != nullptr)
+      this->operative_temperature_sensor_->publish_state(NAN);
+    return;
+  }
+
+  PMVResult result = this->solver_.solve(ta, tr, air_speed, rh, this->met_, this->clo_);
+  if (!result.converged) {
+    this->not_converged_++;
+    ESP_LOGW(TAG, "Clothing temperature did not converge in %u iterations (%u times)", result.iterations,
+             this->not_converged_);
+  } else {
+    ESP_LOGV(TAG, "PMV %.2f after %u iterations", result.pmv, result.iterations);
+  }
+
+  if (this->pmv_sensor_ != nullptr)
+    this->pmv_sensor_->publish_state(result.pmv);
+  if (this->ppd_sensor_ != nullptr)
+    this->ppd_sensor_->publish_state(result.ppd);
+  if (this->operative_temperature_sensor_ != nullptr)
+    this->operative_temperature_sensor_->publish_state(PMVSolver::operative_temperature(ta, tr, air_speed));
+}
+
+void Comfort::dump_config() {
+  ESP_LOGCONFIG(TAG, "Comfort:");
+  ESP_LOGCONFIG(TAG, "  Metabolic rate: %.2f met, Clothing: %.2f clo", this->met_, this->clo_);
+  ESP_LOGCONFIG(TAG, "  Saturation pressure table: %s", YESNO(this->use_table_));
+  LOG_SENSOR("  ", "PMV", this->pmv_sensor_);
+  LOG_SENSOR("  ", "PPD", this->ppd_sensor_);
+  LOG_SENSOR("  ", "Operative Temperature", this->operative_temperature_sensor_);
+}
+
+}  // namespace comfort
+}  // namespace esphome
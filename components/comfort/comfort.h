@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/sample_snapshot/sample_snapshot.h"
+#include "pmv.h"
+
+namespace esphome {
+namespace comfort {
+
+/**
+ * @brief Comfort Component
+ *
+ * Computes ISO 7730 PMV and PPD and ISO 7726 operative temperature from the air temperature,
+ * mean radiant temperature, air speed and humidity of every sample snapshot, so the indices
+ * describe the same instant as the measurements uploaded with them. Metabolic rate and clothing
+ * insulation are configured, and can be changed at runtime.
+ */
+class Comfort : public Component {
+ public:
+  // --- Component lifecycle ---
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  // --- Configuration setters (called by Python codegen) ---
+  void set_snapshot(sample_snapshot::SampleSnapshot *snapshot) { snapshot_ = snapshot; }
+  void set_temperature_source(sensor::Sensor *sensor) { temperature_source_ = sensor; }
+  void set_radiant_temperature_source(sensor::Sensor *sensor) { radiant_temperature_source_ = sensor; }
+  void set_air_speed_source(sensor::Sensor *sensor) { air_speed_source_ = sensor; }
+  void set_humidity_source(sensor::Sensor *sensor) { humidity_source_ = sensor; }
+  void set_metabolic_rate(float met) { met_ = met; }
+  void set_clothing(float clo) { clo_ = clo; }
+  void set_max_iterations(uint8_t max_iterations) { solver_.set_max_iterations(max_iterations); }
+  void set_use_table(bool use_table) { use_table_ = use_table; }
+  void set_pmv_sensor(sensor::Sensor *sensor) { pmv_sensor_ = sensor; }
+  void set_ppd_sensor(sensor::Sensor *sensor) { ppd_sensor_ = sensor; }
+  void set_operative_temperature_sensor(sensor::Sensor *sensor) { operative_temperature_sensor_ = sensor; }
+
+  // --- Public API ---
+  void compute(const sample_snapshot::Snapshot &snapshot);
+  float get_metabolic_rate() const { return met_; }
+  float get_clothing() const { return clo_; }
+
+ protected:
+  // --- Configuration ---
+  sample_snapshot::SampleSnapshot *snapshot_{nullptr};
+  sensor::Sensor *temperature_source_{nullptr};
+  sensor::Sensor *radiant_temperature_source_{nullptr};
+  sensor::Sensor *air_speed_source_{nullptr};
+  sensor::Sensor *humidity_source_{nullptr};
+  float met_{1.1f};
+  float clo_{0.6f};
+  bool use_table_{false};
+
+  // --- Outputs ---
+  sensor::Sensor *pmv_sensor_{nullptr};
+  sensor::Sensor *ppd_sensor_{nullptr};
+  sensor::Sensor *operative_temperature_sensor_{nullptr};
+
+  // --- Runtime state ---
+  PMVSolver solver_;
+  uint32_t not_converged_{0};
+
+  // Value of source in snapshot, or its current state if it is not a snapshot source
+  static float input_(const sample_snapshot::Snapshot &snapshot, sensor::Sensor *source);
+};
+
+}  // namespace comfort
+}  // namespace esphome
@@ -0,0 +1,115 @@
+#include "pmv.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace comfort {
+
+static float saturation_pressure_exp(float ta) { return std::exp(16.6536f - 4030.183f / (ta + 235.0f)); }
+
+// x^0.25 without pow()
+static inline float fourth_root(float x) { return std::sqrt(std::sqrt(x)); }
+
+static inline float fourth_power(float x) {
+  float x2 = x * x;
+  return x2 * x2;
+}
+
+void PMVSolver::set_use_table(bool use_table) {
+  this->saturation_table_.clear();
+  if (!use_table)
+    return;
+  for (int i = 0; i <= 160; i++)
+    this->saturation_table_.push_back(saturation_pressure_exp(TABLE_MIN + i * TABLE_STEP));
+}
+
+float PMVSolver::saturation_pressure_(float ta) const {
+  if (!this->saturation_table_.empty()) {
+    float position = (ta - TABLE_MIN) / TABLE_STEP;
+    if (position >= 0.0f && position < this->saturation_table_.size() - 1) {
+      size_t index = static_cast<size_t>(position);
+      float fraction = position - index;
+      return this->saturation_table_[index] +
+             fraction * (this->saturation_table_[index + 1] - this->saturation_table_[index]);
+    }
+  }
+  return saturation_pressure_exp(ta);
+}
+
+// ISO 7730:2005 Annex D, with the iteration rewritten to start from the previous solution
+PMVResult PMVSolver::solve(float ta, float tr, float air_speed, float rh, float met, float clo, float work) {
+  PMVResult result{NAN, NAN, NAN, 0, false};
+  if (std::isnan(ta) || std::isnan(tr) || std::isnan(air_speed) || std::isnan(rh) || std::isnan(met) ||
+      std::isnan(clo))
+    return result;
+
+  const float pa = rh * 10.0f * this->saturation_pressure_(ta);  // water vapour pressure, Pa
+  const float icl = 0.155f * clo;                                 // clothing insulation, m²K/W
+  const float m = met * 58.15f;                                   // metabolic rate, W/m²
+  const float w = work * 58.15f;
+  const float mw = m - w;
+  const float fcl = icl <= 0.078f ? 1.0f + 1.29f * icl : 1.05f + 0.645f * icl;
+  const float hcf = 12.1f * std::sqrt(std::fmax(air_speed, 0.0f));  // forced convection
+  const float taa = ta + 273.0f;
+  const float tra = tr + 273.0f;
+
+  const float p1 = icl * fcl;
+  const float p2 = p1 * 3.96f;
+  const float p3 = p1 * 100.0f;
+  const float p4 = p1 * taa;
+  const float p5 = 308.7f - 0.028f * mw + p2 * fourth_power(tra / 100.0f);
+
+  // Clothing surface temperature (K / 100)
+  float xf = this->previous_xn_;
+  if (xf <= 0.0f) {
+    const float tcla = taa + (35.5f - ta) / (3.5f * icl + 0.1f);
+    xf = tcla / 100.0f;
+  }
+  float xn = xf;
+  float hc = hcf;
+  for (uint8_t n = 0; n < this->max_iterations_; n++) {
+    const float hcn = 2.38f * fourth_root(std::fabs(100.0f * xf - taa));  // natural convection
+    hc = std::fmax(hcf, hcn);
+    xn = (p5 + p4 * hc - p2 * fourth_power(xf)) / (100.0f + p3 * hc);
+    result.iterations = n + 1;
+    if (std::fabs(xn - xf) <= EPSILON) {
+      result.converged = true;
+      break;
+    }
+    xf = (xf + xn) / 2.0f;
+  }
+  this->previous_xn_ = result.converged ? xn : -1.0f;
+  const float tcl = 100.0f * xn - 273.0f;
+
+  // Heat losses
+  const float hl1 = 3.05e-3f * (5733.0f - 6.99f * mw - pa);             // skin diffusion
+  const float hl2 = mw > 58.15f ? 0.42f * (mw - 58.15f) : 0.0f;         // sweating
+  const float hl3 = 1.7e-5f * m * (5867.0f - pa);                       // latent respiration
+  const float hl4 = 0.0014f * m * (34.0f - ta);                         // dry respiration
+  const float hl5 = 3.96f * fcl * (fourth_power(xn) - fourth_power(tra / 100.0f));  // radiation
+  const float hl6 = fcl * hc * (tcl - ta);                              // convection
+
+  const float ts = 0.303f * std::exp(-0.036f * m) + 0.028f;
+  const float pmv = ts * (mw - hl1 - hl2 - hl3 - hl4 - hl5 - hl6);
+  const float pmv2 = pmv * pmv;
+
+  result.pmv = pmv;
+  result.ppd = 100.0f - 95.0f * std::exp(-0.03353f * pmv2 * pmv2 - 0.2179f * pmv2);
+  result.clothing_temperature = tcl;
+  return result;
+}
+
+float PMVSolver::operative_temperature(float ta, float tr, float air_speed) {
+  float a;
+  if (air_speed < 0.2f) {
+    a = 0.5f;
+  } else if (air_speed < 0.6f) {
+    a = 0.6f;
+  } else {
+    a = 0.7f;
+  }
+  return a * ta + (1.0f - a) * tr;
+}
+
+}  // namespace comfort
+}  // namespace esphome
@@ -0,0 +1,55 @@
+#pragma once
+
+// ISO 7730 PMV/PPD without ESPHome dependencies, so the model can be checked on a host against
+// the reference cases of ISO 7730 Annex D as well as run on the device.
+
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace comfort {
+
+struct PMVResult {
+  float pmv;
+  float ppd;                   // %
+  float clothing_temperature;  // °C
+  uint8_t iterations;
+  bool converged;
+};
+
+/**
+ * @brief PMVSolver
+ *   - Single precision ISO 7730 PMV/PPD (the ESP32 FPU has no double support).
+ *   - The clothing surface temperature iteration is bounded by max_iterations and starts from
+ *     the previous solution, which for consecutive samples is usually within a few steps.
+ *   - Optionally interpolates the saturation vapour pressure from a table instead of exp().
+ */
+class PMVSolver {
+ public:
+  void set_max_iterations(uint8_t max_iterations) { max_iterations_ = max_iterations; }
+  // Builds the saturation pressure table (-20..60 °C in 0.5 °C steps, 161 floats)
+  void set_use_table(bool use_table);
+
+  // ta/tr °C, air_speed m/s (relative to the body), rh %, met, clo, external work in met
+  PMVResult solve(float ta, float tr, float air_speed, float rh, float met, float clo, float work = 0.0f);
+  // Forgets the warm start, e.g. after a gap in the inputs
+  void reset() { previous_xn_ = -1.0f; }
+
+  // ISO 7726 operative temperature, weighting air and radiant temperature by air speed
+  static float operative_temperature(float ta, float tr, float air_speed);
+
+ protected:
+  static constexpr float TABLE_MIN = -20.0f;
+  static constexpr float TABLE_STEP = 0.5f;
+  static constexpr float EPSILON = 0.00015f;
+
+  uint8_t max_iterations_{50};
+  float previous_xn_{-1.0f};
+  std::vector<float> saturation_table_;
+
+  // kPa
+  float saturation_pressure_(float ta) const;
+};
+
+}  // namespace comfort
+}  // namespace esphome
@@ -0,0 +1,97 @@
+"""
+Delta OTA for ESPHome
+- Applies a compressed binary patch (tools/delta_ota.py) to the running image while it downloads.
+- Neither image is held in RAM; the running image and the result are checked against MD5s in the patch.
+- Publishes the bytes downloaded by the last update and their share of the full image.
+- on_error fires when no patch applies, e.g. to fall back to a full image update.
+"""
+
+from esphome import automation
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    CONF_ID,
+    CONF_TRIGGER_ID,
+    CONF_URL,
+    CONF_VERIFY_SSL,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_BYTES,
+    UNIT_PERCENT,
+)
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["network", "esp32"]
+AUTO_LOAD = ["md5", "sensor"]
+
+CONF_DOWNLOAD_SIZE = "download_size"
+CONF_DOWNLOAD_RATIO = "download_ratio"
+CONF_ON_ERROR = "on_error"
+
+ICON_DOWNLOAD = "mdi:download-network"
+
+delta_ota_ns = cg.esphome_ns.namespace("delta_ota")
+DeltaOTA = delta_ota_ns.class_("DeltaOTA", cg.Component)
+ErrorTrigger = delta_ota_ns.class_("ErrorTrigger", automation.Trigger.template())
+FlashAction = delta_ota_ns.class_("FlashAction", automation.Action)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(DeltaOTA),
+    cv.Optional(CONF_VERIFY_SSL, default=True): cv.boolean,
+    # last update, published after the reboot into the new firmware
+    cv.Optional(CONF_DOWNLOAD_SIZE): sensor.sensor_schema(
+        unit_of_measurement=UNIT_BYTES,
+        icon=ICON_DOWNLOAD,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_DOWNLOAD_RATIO): sensor.sensor_schema(
+        unit_of_measurement=UNIT_PERCENT,
+        icon=ICON_DOWNLOAD,
+        accuracy_decimals=1,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_ON_ERROR): automation.validate_automation(
+        {
+            cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(ErrorTrigger),
+        }
+    ),
+}).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    cg.add(var.set_verify_ssl(config[CONF_VERIFY_SSL]))
+    if download_size_config := config.get(CONF_DOWNLOAD_SIZE):
+        sens = await sensor.new_sensor(download_size_config)
+        cg.add(var.set_download_size_sensor(sens))
+    if download_ratio_config := config.get(CONF_DOWNLOAD_RATIO):
+        sens = await sensor.new_sensor(download_ratio_config)
+        cg.add(var.set_download_ratio_sensor(sens))
+
+    for conf in config.get(CONF_ON_ERROR, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [], conf)
+
+
+@automation.register_action(
+    "delta_ota.flash",
+    FlashAction,
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.use_id(DeltaOTA),
+            cv.Required(CONF_URL): cv.templatable(cv.url),
+        }
+    ),
+)
+async def delta_ota_flash_to_code(config, action_id, template_arg, args):
+    paren = await cg.get_variable(config[CONF_ID])
+    var = cg.new_Pvariable(action_id, template_arg, paren)
+    template_ = await cg.templatable(config[CONF_URL], args, cg.std_string)
+    cg.add(var.set_url(template_))
+    return var
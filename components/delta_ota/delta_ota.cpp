@@ -0,0 +1,295 @@
+#include "delta_ota.h"
+#include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/md5/md5.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "esp_crt_bundle.h"
+#include "esp_http_client.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp32/rom/miniz.h"
+
+namespace esphome {
+namespace delta_ota {
+
+static const char *const TAG = "delta_ota";
+
+static constexpr size_t HTTP_BUFFER_SIZE = 1024;
+static constexpr uint8_t MAX_REDIRECTS = 3;
+
+// Reads the old image from the running partition, writes the new one to the OTA partition
+class PartitionTarget : public PatchTarget {
+ public:
+  PartitionTarget(const esp_partition_t *running, esp_ota_handle_t handle) : running_(running), handle_(handle) {
+    this->md5_.init();
+  }
+
+  bool read_old(uint32_t offset, uint8_t *data, size_t len) override {
+    return esp_partition_read(this->running_, offset, data, len) == ESP_OK;
+  }
+  bool write_new(const uint8_t *data, size_t len) override {
+    this->md5_.add(data, len);
+    return esp_ota_write(this->handle_, data, len) == ESP_OK;
+  }
+  bool check_md5(const uint8_t *expected) {
+    this->md5_.calculate();
+    return this->md5_.equals_bytes(expected);
+  }
+
+ protected:
+  const esp_partition_t *running_;
+  esp_ota_handle_t handle_;
+  md5::MD5Digest md5_;
+};
+
+static const char *error_to_string(PatchError error) {
+  switch (error) {
+    case PatchError::CORRUPT:
+      return "corrupt patch";
+    case PatchError::READ_OLD:
+      return "reading the running image failed";
+    case PatchError::WRITE_NEW:
+      return "writing the new image failed";
+    default:
+      return "none";
+  }
+}
+
+// Reads exactly len bytes unless the response ends first
+static bool read_fully(esp_http_client_handle_t client, uint8_t *data, size_t len) {
+  while (len > 0) {
+    int r = esp_http_client_read(client, reinterpret_cast<char *>(data), len);
+    if (r <= 0)
+      return false;
+    data += r;
+    len -= r;
+  }
+  return true;
+}
+
+static bool check_running_md5(const esp_partition_t *running, uint32_t size, const uint8_t *expected,
+                              uint8_t *buffer, size_t buffer_size) {
+  md5::MD5Digest md5;
+  md5.init();
+  for (uint32_t offset = 0; offset < size; offset += buffer_size) {
+    size_t n = std::min<size_t>(buffer_size, size - offset);
+    if (esp_partition_read(running, offset, buffer, n) != ESP_OK)
+      return false;
+    md5.add(buffer, n);
+    App.feed_wdt();
+  }
+  md5.calculate();
+  return md5.equals_bytes(expected);
+}
+
+void DeltaOTA::setup() {
+  // fixed key, so the firmware after the update finds what the one before it wrote
+  this->pref_ = global_preferences->make_preference<UpdateStats>(fnv1_hash("delta_ota"));
+  UpdateStats stats{};
+  if (!this->pref_.load(&stats) || stats.image_size == 0)
+    return;
+  ESP_LOGI(TAG, "Last update downloaded %u bytes for a %u byte image", stats.patch_size, stats.image_size);
+  if (this->download_size_sensor_ != nullptr)
+    this->download_size_sensor_->publish_state(stats.patch_size);
+  if (this->download_ratio_sensor_ != nullptr)
+    this->download_ratio_sensor_->publish_state(100.0f * stats.patch_size / stats.image_size);
+}
+
+bool DeltaOTA::flash(const std::string &url) {
+  ESP_LOGI(TAG, "Applying patch %s", url.c_str());
+  UpdateStats stats{};
+  uint32_t start = millis();
+  if (!this->apply_(url, stats)) {
+    this->on_error_callback_.call();
+    return false;
+  }
+  ESP_LOGI(TAG, "Update applied in %u ms: %u bytes downloaded for a %u byte image (%.1f%%), rebooting",
+           millis() - start, stats.patch_size, stats.image_size, 100.0f * stats.patch_size / stats.image_size);
+  this->pref_.save(&stats);
+  App.safe_reboot();
+  return true;
+}
+
+bool DeltaOTA::apply_(const std::string &url, UpdateStats &stats) {
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  const esp_partition_t *next = esp_ota_get_next_update_partition(nullptr);
+  if (running == nullptr || next == nullptr) {
+    ESP_LOGE(TAG, "No OTA partition to update");
+    return false;
+  }
+
+  // --- Request ---
+  esp_http_client_config_t cfg = {};
+  cfg.url = url.c_str();
+  cfg.method = HTTP_METHOD_GET;
+  cfg.keep_alive_enable = false;
+  cfg.timeout_ms = 12000;
+  cfg.buffer_size = HTTP_BUFFER_SIZE;
+  if (this->verify_ssl_)
+    cfg.crt_bundle_attach = esp_crt_bundle_attach;
+  esp_http_client_handle_t client = esp_http_client_init(&cfg);
+  if (client == nullptr) {
+    ESP_LOGE(TAG, "esp_http_client_init failed");
+    return false;
+  }
+  auto cleanup = [client]() {
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+  };
+
+  int status = 0;
+  int64_t content_length = 0;
+  for (uint8_t redirects = 0; redirects <= MAX_REDIRECTS; redirects++) {
+    esp_err_t err = esp_http_client_open(client, 0);
+    if (err != ESP_OK) {
+      ESP_LOGE(TAG, "HTTP open failed: %s", esp_err_to_name(err));
+      esp_http_client_cleanup(client);
+      return false;
+    }
+    content_length = esp_http_client_fetch_headers(client);
+    status = esp_http_client_get_status_code(client);
+    if (status < 300 || status >= 400)
+      break;
+    esp_http_client_set_redirection(client);
+    esp_http_client_close(client);
+  }
+  if (status != 200) {
+    // no patch between these versions is expected, e.g. after a skipped release
+    ESP_LOGW(TAG, "HTTP status %d, no patch", status);
+    cleanup();
+    return false;
+  }
+
+  // --- Header ---
+  PatchHeader header;
+  if (!read_fully(client, reinterpret_cast<uint8_t *>(&header), sizeof(header)) || header.magic != PATCH_MAGIC) {
+    ESP_LOGE(TAG, "Not a delta patch");
+    cleanup();
+    return false;
+  }
+  if (header.old_size > running->size || header.new_size > next->size) {
+    ESP_LOGE(TAG, "Patch does not fit the partitions (%u -> %u bytes)", header.old_size, header.new_size);
+    cleanup();
+    return false;
+  }
+
+  // tinfl needs its whole window as a ring buffer, sized TINFL_LZ_DICT_SIZE
+  RAMAllocator<uint8_t> allocator;
+  uint8_t *window = allocator.allocate(TINFL_LZ_DICT_SIZE);
+  auto inflator = std::make_unique<tinfl_decompressor>();
+  if (window == nullptr) {
+    ESP_LOGE(TAG, "Failed to allocate %u bytes for inflate", TINFL_LZ_DICT_SIZE);
+    cleanup();
+    return false;
+  }
+  auto release = [&]() {
+    allocator.deallocate(window, TINFL_LZ_DICT_SIZE);
+    cleanup();
+  };
+
+  // the window doubles as the read buffer for the MD5 of the running image
+  if (!check_running_md5(running, header.old_size, header.old_md5, window, TINFL_LZ_DICT_SIZE)) {
+    ESP_LOGW(TAG, "Patch is for another image than the running one");
+    release();
+    return false;
+  }
+
+  // --- Apply ---
+  esp_ota_handle_t handle;
+  esp_err_t err = esp_ota_begin(next, header.new_size, &handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "esp_ota_begin failed: %s", esp_err_to_name(err));
+    release();
+    return false;
+  }
+  PartitionTarget target(running, handle);
+  PatchDecoder decoder(&target, header.old_size, header.new_size);
+
+  tinfl_init(inflator.get());
+  uint8_t input[HTTP_BUFFER_SIZE];
+  size_t input_pos = 0, input_len = 0;
+  size_t window_pos = 0;
+  uint32_t received = sizeof(header);
+  uint8_t progress = 0;
+  bool need_input = true;
+  bool ok = false;
+  while (true) {
+    // tinfl may still hold output once all input is consumed
+    if (input_pos == input_len && need_input) {
+      int r = esp_http_client_read(client, reinterpret_cast<char *>(input), sizeof(input));
+      if (r <= 0) {
+        ESP_LOGE(TAG, "Download ended after %u bytes", received);
+        break;
+      }
+      input_pos = 0;
+      input_len = r;
+      received += r;
+      App.feed_wdt();
+    }
+    size_t in_bytes = input_len - input_pos;
+    size_t out_bytes = TINFL_LZ_DICT_SIZE - window_pos;
+    tinfl_status result = tinfl_decompress(inflator.get(), input + input_pos, &in_bytes, window,
+                                           window + window_pos, &out_bytes,
+                                           TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+    input_pos += in_bytes;
+    if (out_bytes > 0 && !decoder.feed(window + window_pos, out_bytes)) {
+      ESP_LOGE(TAG, "Patch failed at byte %u of the new image: %s", decoder.get_new_position(),
+               error_to_string(decoder.get_error()));
+      break;
+    }
+    window_pos = (window_pos + out_bytes) & (TINFL_LZ_DICT_SIZE - 1);
+    if (result == TINFL_STATUS_DONE) {
+      ok = decoder.is_done();
+      if (!ok)
+        ESP_LOGE(TAG, "Patch ended at byte %u of %u", decoder.get_new_position(), header.new_size);
+      break;
+    }
+    if (result < TINFL_STATUS_DONE) {
+      ESP_LOGE(TAG, "Inflate failed (%d)", result);
+      break;
+    }
+    need_input = result == TINFL_STATUS_NEEDS_MORE_INPUT;
+    uint8_t percent = uint64_t(decoder.get_new_position()) * 100 / header.new_size;
+    if (percent >= progress + 10) {
+      progress = percent - percent % 10;
+      ESP_LOGD(TAG, "%u%% written, %u bytes received", progress, received);
+    }
+  }
+  release();
+
+  if (ok && !target.check_md5(header.new_md5)) {
+    ESP_LOGE(TAG, "New image does not match its MD5");
+    ok = false;
+  }
+  if (!ok) {
+    esp_ota_abort(handle);
+    return false;
+  }
+  err = esp_ota_end(handle);
+  if (err == ESP_OK)
+    err = esp_ota_set_boot_partition(next);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Activating the new image failed: %s", esp_err_to_name(err));
+    return false;
+  }
+  stats.patch_size = content_length > 0 ? content_length : received;
+  stats.image_size = header.new_size;
+  return true;
+}
+
+void DeltaOTA::dump_config() {
+  ESP_LOGCONFIG(TAG, "Delta OTA:");
+  ESP_LOGCONFIG(TAG, "  Verify SSL: %s", YESNO(this->verify_ssl_));
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  if (running != nullptr)
+    ESP_LOGCONFIG(TAG, "  Running partition: %s", running->label);
+  LOG_SENSOR("  ", "Download Size", this->download_size_sensor_);
+  LOG_SENSOR("  ", "Download Ratio", this->download_ratio_sensor_);
+}
+
+}  // namespace delta_ota
+}  // namespace esphome
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "esphome/core/automation.h"
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/sensor/sensor.h"
+
+#include "delta_patch.h"
+
+namespace esphome {
+namespace delta_ota {
+
+/**
+ * @brief Delta OTA Component
+ *
+ * Updates the firmware from a patch against the running image instead of downloading the full
+ * image (see tools/delta_ota.py, which builds the patches between releases):
+ *   - the patch header names the image it applies to; its MD5 is checked against the running
+ *     partition before anything is written, so a device on another version falls back cleanly
+ *   - the patch is streamed: inflated through the 32 KiB window of the ROM inflater and decoded
+ *     entry by entry, reading old bytes from the running partition and writing the new image to
+ *     the next OTA partition. About 45 KiB of heap are needed, not either image
+ *   - the new image is checked against the MD5 in the header and by esp_ota_end() before it is
+ *     made the boot partition, then the device reboots
+ *   - the bytes downloaded and the size of the full image are kept across the reboot and
+ *     published by the new firmware
+ *   - on any failure before the boot partition is switched on_error fires, e.g. to fall back to
+ *     a full image update
+ */
+class DeltaOTA : public Component {
+ public:
+  // --- Component lifecycle ---
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::AFTER_WIFI; }
+
+  // --- Public API ---
+  // Blocks until the patch at url is applied and reboots; returns false (and fires on_error) if it
+  // could not be applied, the running firmware is left untouched then
+  bool flash(const std::string &url);
+  void add_on_error_callback(std::function<void()> &&callback) { on_error_callback_.add(std::move(callback)); }
+
+  // --- Configuration setters (called by Python codegen) ---
+  void set_verify_ssl(bool verify_ssl) { verify_ssl_ = verify_ssl; }
+  void set_download_size_sensor(sensor::Sensor *sensor) { download_size_sensor_ = sensor; }
+  void set_download_ratio_sensor(sensor::Sensor *sensor) { download_ratio_sensor_ = sensor; }
+
+ protected:
+  // last delta update, written before the reboot into the new firmware
+  struct UpdateStats {
+    uint32_t patch_size;
+    uint32_t image_size;
+  };
+
+  // --- Configuration ---
+  bool verify_ssl_{true};
+  sensor::Sensor *download_size_sensor_{nullptr};
+  sensor::Sensor *download_ratio_sensor_{nullptr};
+
+  // --- Runtime state ---
+  ESPPreferenceObject pref_;
+  CallbackManager<void()> on_error_callback_;
+
+  // --- Helper methods ---
+  bool apply_(const std::string &url, UpdateStats &stats);
+};
+
+class ErrorTrigger : public Trigger<> {
+ public:
+  explicit ErrorTrigger(DeltaOTA *parent) {
+    parent->add_on_error_callback([this]() { this->trigger(); });
+  }
+};
+
+template<typename... Ts> class FlashAction : public Action<Ts...> {
+ public:
+  explicit FlashAction(DeltaOTA *parent) : parent_(parent) {}
+  TEMPLATABLE_VALUE(std::string, url)
+
+  void play(Ts... x) override { this->parent_->flash(this->url_.value(x...)); }
+
+ protected:
+  DeltaOTA *parent_;
+};
+
+}  // namespace delta_ota
+}  // namespace esphome
@@ -0,0 +1,95 @@
+#include "delta_patch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace delta_ota {
+
+bool PatchDecoder::fail_(PatchError error) {
+  this->state_ = State::ERROR;
+  this->error_ = error;
+  return false;
+}
+
+bool PatchDecoder::start_entry_() {
+  uint32_t diff_length, extra_length;
+  memcpy(&diff_length, this->control_, 4);
+  memcpy(&extra_length, this->control_ + 4, 4);
+  memcpy(&this->seek_, this->control_ + 8, 4);
+  this->control_length_ = 0;
+
+  // 64 bit sums, a corrupt length must not wrap around the checks
+  uint64_t new_end = uint64_t(this->new_pos_) + diff_length + extra_length;
+  if (new_end > this->new_size_ || uint64_t(this->old_pos_) + diff_length > this->old_size_)
+    return this->fail_(PatchError::CORRUPT);
+  this->diff_left_ = diff_length;
+  this->extra_left_ = extra_length;
+  this->state_ = State::DIFF;
+  return true;
+}
+
+bool PatchDecoder::end_entry_() {
+  int64_t old_pos = int64_t(this->old_pos_) + this->seek_;
+  if (old_pos < 0 || old_pos > this->old_size_)
+    return this->fail_(PatchError::CORRUPT);
+  this->old_pos_ = old_pos;
+  this->state_ = this->new_pos_ == this->new_size_ ? State::DONE : State::CONTROL;
+  return true;
+}
+
+bool PatchDecoder::feed(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    switch (this->state_) {
+      case State::CONTROL: {
+        size_t n = std::min(len, sizeof(this->control_) - this->control_length_);
+        memcpy(this->control_ + this->control_length_, data, n);
+        this->control_length_ += n;
+        data += n;
+        len -= n;
+        if (this->control_length_ == sizeof(this->control_) && !this->start_entry_())
+          return false;
+        break;
+      }
+      case State::DIFF: {
+        size_t n = std::min<size_t>({len, this->diff_left_, sizeof(this->old_buffer_)});
+        if (!this->target_->read_old(this->old_pos_, this->old_buffer_, n))
+          return this->fail_(PatchError::READ_OLD);
+        for (size_t i = 0; i < n; i++)
+          this->old_buffer_[i] += data[i];
+        if (!this->target_->write_new(this->old_buffer_, n))
+          return this->fail_(PatchError::WRITE_NEW);
+        this->old_pos_ += n;
+        this->new_pos_ += n;
+        this->diff_left_ -= n;
+        data += n;
+        len -= n;
+        break;
+      }
+      case State::EXTRA: {
+        size_t n = std::min<size_t>(len, this->extra_left_);
+        if (!this->target_->write_new(data, n))
+          return this->fail_(PatchError::WRITE_NEW);
+        this->new_pos_ += n;
+        this->extra_left_ -= n;
+        data += n;
+        len -= n;
+        break;
+      }
+      case State::DONE:
+        // trailing data after the last entry
+        return this->fail_(PatchError::CORRUPT);
+      case State::ERROR:
+        return false;
+    }
+    // empty sections complete without input
+    if (this->state_ == State::DIFF && this->diff_left_ == 0)
+      this->state_ = State::EXTRA;
+    if (this->state_ == State::EXTRA && this->extra_left_ == 0 && !this->end_entry_())
+      return false;
+  }
+  return true;
+}
+
+}  // namespace delta_ota
+}  // namespace esphome
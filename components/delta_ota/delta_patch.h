@@ -0,0 +1,76 @@
+#pragma once
+
+// Streaming decoder for the delta patches built by tools/delta_ota.py, without ESPHome or ESP-IDF
+// dependencies so it can be built and checked against the tool on a host.
+//
+// A patch is [PatchHeader] followed by a zlib stream. Inflated, the stream is a list of bsdiff
+// style entries, applied in order until new_size bytes have been produced:
+//   [diff length u32] [extra length u32] [old seek i32]
+//   [diff bytes]   new = old + diff (mod 256); the old and new positions advance
+//   [extra bytes]  copied to new
+// then the old position moves by seek. Entries can be split anywhere between feed() calls, so
+// neither image nor the patch has to be held in RAM: old bytes are read as they are needed and
+// new bytes are written as soon as they are known.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace delta_ota {
+
+static constexpr uint32_t PATCH_MAGIC = 0x31504453;  // "SDP1"
+
+struct __attribute__((packed)) PatchHeader {
+  uint32_t magic;
+  uint32_t old_size;    // bytes of the running image the patch applies to
+  uint32_t new_size;
+  uint8_t old_md5[16];  // of the first old_size bytes of the running partition
+  uint8_t new_md5[16];
+};
+
+enum class PatchError : uint8_t { NONE, CORRUPT, READ_OLD, WRITE_NEW };
+
+// Where the old image comes from and the new one goes to
+class PatchTarget {
+ public:
+  virtual bool read_old(uint32_t offset, uint8_t *data, size_t len) = 0;
+  virtual bool write_new(const uint8_t *data, size_t len) = 0;
+};
+
+class PatchDecoder {
+ public:
+  PatchDecoder(PatchTarget *target, uint32_t old_size, uint32_t new_size)
+      : target_(target), old_size_(old_size), new_size_(new_size) {}
+
+  // Applies the next inflated bytes; false once an error occurred
+  bool feed(const uint8_t *data, size_t len);
+
+  bool is_done() const { return state_ == State::DONE; }
+  PatchError get_error() const { return error_; }
+  uint32_t get_new_position() const { return new_pos_; }
+
+ protected:
+  enum class State : uint8_t { CONTROL, DIFF, EXTRA, DONE, ERROR };
+
+  bool fail_(PatchError error);
+  bool start_entry_();
+  bool end_entry_();
+
+  PatchTarget *target_;
+  uint32_t old_size_;
+  uint32_t new_size_;
+
+  State state_{State::CONTROL};
+  PatchError error_{PatchError::NONE};
+  uint8_t control_[12];
+  uint8_t control_length_{0};
+  uint32_t diff_left_{0};
+  uint32_t extra_left_{0};
+  int32_t seek_{0};
+  uint32_t old_pos_{0};
+  uint32_t new_pos_{0};
+  uint8_t old_buffer_[512];
+};
+
+}  // namespace delta_ota
+}  // namespace esphome
@@ -0,0 +1,102 @@
+"""
+I2C Bus Arbiter for ESPHome
+- Polls the I²C devices sharing a bus earliest deadline first instead of on independent timers.
+- Batches devices due close together and reserves the bus for devices with a response delay.
+- Reports bus utilisation, contention and sampling jitter.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    CONF_DEVICES,
+    CONF_ID,
+    CONF_OFFSET,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_TIMER,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_MILLISECOND,
+    UNIT_PERCENT,
+)
+
+CODEOWNERS = ["@IEQLab"]
+AUTO_LOAD = ["sensor", "instrumentation"]
+
+# Component namespace and class registration
+i2c_arbiter_ns = cg.esphome_ns.namespace("i2c_arbiter")
+I2CArbiter = i2c_arbiter_ns.class_("I2CArbiter", cg.PollingComponent)
+
+# YAML config options
+CONF_I2C_ARBITER_ID = "i2c_arbiter_id"
+CONF_BATCH_WINDOW = "batch_window"
+CONF_HOLD = "hold"
+CONF_UTILIZATION = "utilization"
+CONF_CONTENTION = "contention"
+CONF_JITTER = "jitter"
+
+ICON_CPU = "mdi:cpu-32-bit"
+ICON_SWAP = "mdi:swap-horizontal"
+
+DEVICE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_ID): cv.use_id(cg.PollingComponent),
+        # bus reservation after update(), for devices that wait before reading the response
+        cv.Optional(CONF_HOLD, default="0ms"): cv.positive_time_period_milliseconds,
+        # first update after boot, to stagger devices with the same interval
+        cv.Optional(CONF_OFFSET, default="0ms"): cv.positive_time_period_milliseconds,
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(I2CArbiter),
+        cv.Optional(CONF_BATCH_WINDOW, default="50ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_DEVICES, default=[]): cv.ensure_list(DEVICE_SCHEMA),
+        # Diagnostics, published every update_interval
+        cv.Optional(CONF_UTILIZATION): sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            icon=ICON_CPU,
+            accuracy_decimals=2,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_CONTENTION): sensor.sensor_schema(
+            icon=ICON_SWAP,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_JITTER): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            icon=ICON_TIMER,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+).extend(cv.polling_component_schema("60s"))
+
+
+async def to_code(config):
+    """Generate C++ code for the I2C bus arbiter."""
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add_define("USE_I2C_ARBITER")
+
+    cg.add(var.set_batch_window(config[CONF_BATCH_WINDOW]))
+    for device_config in config[CONF_DEVICES]:
+        device = await cg.get_variable(device_config[CONF_ID])
+        cg.add(var.add_device(device, device_config[CONF_HOLD], device_config[CONF_OFFSET]))
+
+    # Optional sensors
+    if utilization_config := config.get(CONF_UTILIZATION):
+        sens = await sensor.new_sensor(utilization_config)
+        cg.add(var.set_utilization_sensor(sens))
+    if contention_config := config.get(CONF_CONTENTION):
+        sens = await sensor.new_sensor(contention_config)
+        cg.add(var.set_contention_sensor(sens))
+    if jitter_config := config.get(CONF_JITTER):
+        sens = await sensor.new_sensor(jitter_config)
+        cg.add(var.set_jitter_sensor(sens))
@@ -0,0 +1,157 @@
+#include "i2c_arbiter.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/instrumentation/trace_span.h"
+
+namespace esphome {
+namespace i2c_arbiter {
+
+static const char *const TAG = "i2c_arbiter";
+
+I2CArbiter *global_i2c_arbiter = nullptr;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Signed difference handles millis() rollover
+static inline bool is_due(uint32_t deadline, uint32_t now) { return static_cast<int32_t>(now - deadline) >= 0; }
+
+I2CArbiter::I2CArbiter() { global_i2c_arbiter = this; }
+
+void I2CArbiter::add_device(PollingComponent *device, uint32_t hold_ms, uint32_t offset_ms) {
+  this->devices_.push_back({device, 0, hold_ms, offset_ms, 0, false});
+}
+
+void I2CArbiter::setup() {
+  uint32_t now = millis();
+  for (auto &device : this->devices_) {
+    // Take over the polling: the device keeps its interval but its own poller never starts
+    device.interval_ms = device.component->get_update_interval();
+    device.component->set_update_interval(SCHEDULER_DONT_RUN);
+    device.deadline = now + device.offset_ms;
+  }
+  this->window_start_ = now;
+}
+
+void I2CArbiter::loop() {
+  uint32_t now = millis();
+
+  if (this->holder_ != nullptr) {
+    if (!is_due(this->reserved_until_, now)) {
+      // Count each device delayed by the reservation once
+      for (auto &device : this->devices_) {
+        if (!device.waiting && device.component != this->holder_ && is_due(device.deadline, now)) {
+          device.waiting = true;
+          this->contention_++;
+        }
+      }
+      return;
+    }
+    this->end_reservation_(now);
+  }
+
+  // Earliest deadline first; once a device has run, pull in the ones due within the batch window.
+  // Each device runs at most once per pass, even with an update_interval below the batch window.
+  Device *device = this->next_due_(now);
+  for (size_t batch = 0; device != nullptr && batch < this->devices_.size(); batch++) {
+    this->dispatch_(*device, now);
+    if (this->holder_ != nullptr)
+      break;
+    now = millis();
+    device = this->next_due_(now + this->batch_window_ms_);
+  }
+}
+
+I2CArbiter::Device *I2CArbiter::next_due_(uint32_t horizon) {
+  Device *next = nullptr;
+  for (auto &device : this->devices_) {
+    if (device.interval_ms == SCHEDULER_DONT_RUN || device.component->is_failed())
+      continue;
+    if (!is_due(device.deadline, horizon))
+      continue;
+    if (next == nullptr || static_cast<int32_t>(device.deadline - next->deadline) < 0)
+      next = &device;
+  }
+  return next;
+}
+
+void I2CArbiter::dispatch_(Device &device, uint32_t now) {
+  // Early (batched) and late dispatches both count as jitter
+  int32_t lateness = static_cast<int32_t>(now - device.deadline);
+  uint32_t jitter = lateness < 0 ? -lateness : lateness;
+  if (jitter > this->max_jitter_ms_)
+    this->max_jitter_ms_ = jitter;
+
+  // Advance on the original grid; after a long stall restart from now instead of catching up
+  device.deadline += device.interval_ms;
+  if (is_due(device.deadline, now))
+    device.deadline = now + device.interval_ms;
+  device.waiting = false;
+
+  uint32_t start = micros();
+  {
+    TRACE_SPAN_NAMED("sensor.update", device.component->get_component_source());
+    device.component->update();
+  }
+  this->busy_us_ += micros() - start;
+
+  if (device.hold_ms > 0) {
+    this->holder_ = device.component;
+    this->reserved_since_ = millis();
+    this->reserved_until_ = this->reserved_since_ + device.hold_ms;
+  }
+}
+
+void I2CArbiter::release(PollingComponent *device) {
+  if (this->holder_ == device)
+    this->end_reservation_(millis());
+}
+
+bool I2CArbiter::is_arbitrated(const PollingComponent *device) const {
+  for (const auto &registered : this->devices_) {
+    if (registered.component == device)
+      return true;
+  }
+  return false;
+}
+
+void I2CArbiter::end_reservation_(uint32_t now) {
+  uint32_t end = is_due(this->reserved_until_, now) ? this->reserved_until_ : now;
+  this->busy_us_ += (end - this->reserved_since_) * 1000;
+  this->holder_ = nullptr;
+}
+
+void I2CArbiter::update() {
+  uint32_t now = millis();
+  uint32_t elapsed_ms = now - this->window_start_;
+
+  if (this->utilization_sensor_ != nullptr && elapsed_ms > 0)
+    this->utilization_sensor_->publish_state(this->busy_us_ / (elapsed_ms * 10.0f));
+  if (this->contention_sensor_ != nullptr)
+    this->contention_sensor_->publish_state(this->contention_);
+  if (this->jitter_sensor_ != nullptr)
+    this->jitter_sensor_->publish_state(this->max_jitter_ms_);
+
+  this->window_start_ = now;
+  this->busy_us_ = 0;
+  this->contention_ = 0;
+  this->max_jitter_ms_ = 0;
+}
+
+void I2CArbiter::dump_config() {
+  ESP_LOGCONFIG(TAG, "I2C Arbiter:");
+  ESP_LOGCONFIG(TAG, "  Batch window: %ums, Devices: %u", this->batch_window_ms_,
+                static_cast<unsigned>(this->devices_.size()));
+  for (const auto &device : this->devices_) {
+    if (device.interval_ms == SCHEDULER_DONT_RUN) {
+      ESP_LOGW(TAG, "  %s: update_interval is never, not scheduled", device.component->get_component_source());
+      continue;
+    }
+    ESP_LOGCONFIG(TAG, "  %s: every %ums, hold %ums, offset %ums", device.component->get_component_source(),
+                  device.interval_ms, device.hold_ms, device.offset_ms);
+  }
+  LOG_UPDATE_INTERVAL(this);
+  LOG_SENSOR("  ", "Utilization", this->utilization_sensor_);
+  LOG_SENSOR("  ", "Contention", this->contention_sensor_);
+  LOG_SENSOR("  ", "Jitter", this->jitter_sensor_);
+}
+
+}  // namespace i2c_arbiter
+}  // namespace esphome
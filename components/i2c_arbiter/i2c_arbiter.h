@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+
+namespace esphome {
+namespace i2c_arbiter {
+
+/**
+ * @brief I2CArbiter
+ *   - Takes over the polling of I²C devices sharing one bus: each registered device keeps its
+ *     configured update_interval, but its update() is called by the arbiter instead of the
+ *     scheduler, earliest deadline first.
+ *   - Devices due within batch_window of each other are run back to back in one loop pass.
+ *   - A device can reserve the bus for a hold time after its update() (e.g. the K30 needs
+ *     25 ms between command and response); nothing else is started until the hold expires
+ *     or the device calls release().
+ *   - Reports bus utilisation, contention (dispatches delayed by a reservation) and the
+ *     worst sampling jitter per update_interval.
+ */
+class I2CArbiter : public PollingComponent {
+ public:
+  I2CArbiter();
+
+  // --- Configurable setters called by Python codegen ---
+  void add_device(PollingComponent *device, uint32_t hold_ms, uint32_t offset_ms);
+  void set_batch_window(uint32_t batch_window) { batch_window_ms_ = batch_window; }
+  void set_utilization_sensor(sensor::Sensor *sensor) { utilization_sensor_ = sensor; }
+  void set_contention_sensor(sensor::Sensor *sensor) { contention_sensor_ = sensor; }
+  void set_jitter_sensor(sensor::Sensor *sensor) { jitter_sensor_ = sensor; }
+
+  // --- Public API ---
+  // Ends the reservation of device early, e.g. once its response has been read
+  void release(PollingComponent *device);
+  // Whether update() of device is called by the arbiter
+  bool is_arbitrated(const PollingComponent *device) const;
+
+  // --- Component interface ---
+  void setup() override;
+  void loop() override;
+  void update() override;
+  void dump_config() override;
+  // before the devices, so their pollers are never started
+  float get_setup_priority() const override { return setup_priority::IO; }
+
+ protected:
+  struct Device {
+    PollingComponent *component;
+    uint32_t interval_ms;
+    uint32_t hold_ms;
+    uint32_t offset_ms;
+    uint32_t deadline;    // millis() of the next update()
+    bool waiting;         // due, but delayed by a reservation
+  };
+
+  // --- User options with sensible defaults ---
+  uint32_t batch_window_ms_{50};
+  std::vector<Device> devices_;
+
+  // --- Optional sensors ---
+  sensor::Sensor *utilization_sensor_{nullptr};
+  sensor::Sensor *contention_sensor_{nullptr};
+  sensor::Sensor *jitter_sensor_{nullptr};
+
+  // --- Bus reservation ---
+  PollingComponent *holder_{nullptr};
+  uint32_t reserved_until_{0};
+  uint32_t reserved_since_{0};
+
+  // --- Statistics since the last update() ---
+  uint32_t window_start_{0};
+  uint32_t busy_us_{0};
+  uint32_t contention_{0};
+  uint32_t max_jitter_ms_{0};
+
+  // --- Helper methods ---
+  Device *next_due_(uint32_t horizon);
+  void dispatch_(Device &device, uint32_t now);
+  void end_reservation_(uint32_t now);
+};
+
+extern I2CArbiter *global_i2c_arbiter;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace i2c_arbiter
+}  // namespace esphome
@@ -1,10 +1,19 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import http_request, time
-from esphome.const import CONF_ID, CONF_UPDATE_INTERVAL
+from esphome.components import http_request, sensor, time
+from esphome.components.checkpoint import CONF_CHECKPOINT_ID, Checkpoint
+from esphome.const import (
+    CONF_ABOVE,
+    CONF_BELOW,
+    CONF_ID,
+    CONF_LAMBDA,
+    CONF_SENSOR,
+    CONF_UPDATE_INTERVAL,
+)
 
 CODEOWNERS = ["@IEQLab"]
 DEPENDENCIES = ["http_request", "time"]
+AUTO_LOAD = ["instrumentation"]
 
 CONF_HOST = "host"
 CONF_TOKEN = "token"
@@ -20,19 +29,61 @@ CONF_FIELD_NAME = "field_names"
 CONF_USE_SSL = "use_ssl"
 CONF_SENSORS_NAMES = "sensor_names"
 CONF_SEND_MAC = "send_mac"
+CONF_MAX_BACKLOG = "max_backlog"
+CONF_TRIGGERS = "triggers"
+CONF_TARGET = "target"
+CONF_RATE = "rate"
+CONF_ZSCORE = "zscore"
+CONF_HYSTERESIS = "hysteresis"
+CONF_ALPHA = "alpha"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_EVENT = "event"
 
 influxdb_ns = cg.esphome_ns.namespace("influxdb")
 InfluxDB = influxdb_ns.class_("InfluxDB", cg.Component)
+TriggerRule = influxdb_ns.class_("TriggerRule")
+TriggerType = influxdb_ns.enum("TriggerType")
+TRIGGER_TYPES = {
+    CONF_ABOVE: TriggerType.TRIGGER_ABOVE,
+    CONF_BELOW: TriggerType.TRIGGER_BELOW,
+    CONF_RATE: TriggerType.TRIGGER_RATE,
+    CONF_ZSCORE: TriggerType.TRIGGER_ZSCORE,
+}
 
 def validate_update_interval(value):
     """Validate update interval using ESPHome's built-in validation that supports 'never'."""
     # Use ESPHome's native update_interval validation which handles "never"
     return cv.update_interval(value)
 
+TRIGGER_SCHEMA = cv.All(
+    cv.Schema({
+        cv.GenerateID(): cv.declare_id(TriggerRule),
+        # values of this sensor are checked
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        # the event line uses this sensor's measurement, tags and field (default: sensor)
+        cv.Optional(CONF_TARGET): cv.use_id(sensor.Sensor),
+        # applied to each value first, e.g. the target's calibration
+        cv.Optional(CONF_LAMBDA): cv.returning_lambda,
+        # exactly one condition
+        cv.Optional(CONF_ABOVE): cv.float_,
+        cv.Optional(CONF_BELOW): cv.float_,
+        cv.Optional(CONF_RATE): cv.positive_float,  # per minute
+        cv.Optional(CONF_ZSCORE): cv.positive_float,
+        cv.Optional(CONF_HYSTERESIS, default=0.0): cv.positive_float,
+        cv.Optional(CONF_ALPHA, default=0.05): cv.float_range(min=0.001, max=1.0, min_included=False),
+        cv.Optional(CONF_MIN_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        # value of the event tag (default: the condition, e.g. "above")
+        cv.Optional(CONF_EVENT): cv.string_strict,
+    }),
+    cv.has_exactly_one_key(CONF_ABOVE, CONF_BELOW, CONF_RATE, CONF_ZSCORE),
+)
+
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(InfluxDB),
     cv.Required(CONF_HTTP_REQUEST_ID): cv.use_id(http_request.HttpRequestComponent),
     cv.Optional(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+    # keep the backlog across resets
+    cv.Optional(CONF_CHECKPOINT_ID): cv.use_id(Checkpoint),
     cv.Required(CONF_HOST): cv.string_strict,
     cv.Required(CONF_TOKEN): cv.string_strict,
     cv.Required(CONF_BUCKET): cv.string_strict,
@@ -42,6 +93,8 @@ CONFIG_SCHEMA = cv.Schema({
     cv.Optional(CONF_UPDATE_INTERVAL, default="60s"): validate_update_interval,
     cv.Optional(CONF_SEND_MAC, default=True): cv.boolean,
     cv.Optional(CONF_USE_SSL, default=True): cv.boolean,
+    # failed requests kept in RAM and replayed after the next successful publish
+    cv.Optional(CONF_MAX_BACKLOG, default=0): cv.int_range(min=0, max=48),
     cv.Optional(CONF_TIMESTAMP_UNIT, default="s"): cv.one_of("s", "ms", "us", "ns", lower=True),
     cv.Optional(CONF_FIELD_NAME, default={}): cv.Schema({
         cv.string: cv.string
@@ -54,6 +107,7 @@ CONFIG_SCHEMA = cv.Schema({
     cv.Optional(CONF_GLOBAL_TAGS, default={}): cv.Schema({
         cv.string: cv.string
     }),
+    cv.Optional(CONF_TRIGGERS, default=[]): cv.ensure_list(TRIGGER_SCHEMA),
 }).extend(cv.COMPONENT_SCHEMA)
 
 async def to_code(config):
@@ -68,6 +122,10 @@ async def to_code(config):
     if CONF_TIME_ID in config:
         time_ = await cg.get_variable(config[CONF_TIME_ID])
         cg.add(var.set_time_source(time_))
+
+    if CONF_CHECKPOINT_ID in config:
+        checkpoint = await cg.get_variable(config[CONF_CHECKPOINT_ID])
+        cg.add(var.set_checkpoint(checkpoint))
     
     # Basic configuration
     cg.add(var.set_host(config[CONF_HOST]))
@@ -78,6 +136,7 @@ async def to_code(config):
     cg.add(var.set_use_ssl(config[CONF_USE_SSL]))
     cg.add(var.set_timestamp_unit(config[CONF_TIMESTAMP_UNIT]))
     cg.add(var.set_send_mac(config[CONF_SEND_MAC]))
+    cg.add(var.set_max_backlog(config[CONF_MAX_BACKLOG]))
     
     # Handle update interval using ESPHome's standard approach
     # ESPHome's cv.update_interval converts "never" to UINT32_MAX (4294967295)
@@ -104,3 +163,19 @@ async def to_code(config):
     if CONF_FIELD_NAME in config:
         for sensor_id, field_name in config[CONF_FIELD_NAME].items():
             cg.add(var.set_field_name(sensor_id, field_name))
+
+    # Event triggers
+    for trigger in config[CONF_TRIGGERS]:
+        type_ = next(key for key in TRIGGER_TYPES if key in trigger)
+        rule = cg.new_Pvariable(trigger[CONF_ID], TRIGGER_TYPES[type_], trigger[type_])
+        cg.add(rule.set_hysteresis(trigger[CONF_HYSTERESIS]))
+        cg.add(rule.set_alpha(trigger[CONF_ALPHA]))
+        cg.add(rule.set_min_interval(trigger[CONF_MIN_INTERVAL]))
+        source = await cg.get_variable(trigger[CONF_SENSOR])
+        target = await cg.get_variable(trigger.get(CONF_TARGET, trigger[CONF_SENSOR]))
+        event = trigger.get(CONF_EVENT, type_)
+        if CONF_LAMBDA in trigger:
+            transform = await cg.process_lambda(trigger[CONF_LAMBDA], [(float, "x")], return_type=float)
+            cg.add(var.add_trigger(rule, source, target, event, transform))
+        else:
+            cg.add(var.add_trigger(rule, source, target, event))
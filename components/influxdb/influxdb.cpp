@@ -2,6 +2,8 @@
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
 #include "esphome/core/helpers.h"
+#include "esphome/components/instrumentation/profile_scope.h"
+#include "esphome/components/instrumentation/trace_span.h"
 
 #include <cmath>
 #include <string>
@@ -34,6 +36,11 @@ void InfluxDB::setup() {
   this->build_url_();
   this->setup_headers_();
   this->collect_sensors_();
+  this->setup_triggers_();
+#ifdef USE_CHECKPOINT
+  if (this->checkpoint_ != nullptr)
+    this->setup_checkpoint_();
+#endif
   
   if (this->send_mac_) {
     this->mac_address_ = get_mac_address();
@@ -102,15 +109,30 @@ bool InfluxDB::post_raw_idf_(const std::string &url,
     esp_http_client_set_header(client, "Content-Type", "text/plain; charset=utf-8");
   }
   
-  // Open stream and write body
-  esp_err_t err = esp_http_client_open(client, body.size());
+  // Open stream and write body; the TLS handshake happens in open
+  esp_err_t err;
+  {
+    TRACE_SPAN("influxdb.connect");
+    err = esp_http_client_open(client, body.size());
+  }
   if (err != ESP_OK) {
     ESP_LOGE(TAG, "HTTP open failed: %s", esp_err_to_name(err));
     esp_http_client_cleanup(client);
     return false;
   }
   
-  int written = esp_http_client_write(client, body.data(), body.size());
+  int written;
+  int status = 0;
+  {
+    // Request out to response status back
+    TRACE_SPAN("influxdb.post");
+    written = esp_http_client_write(client, body.data(), body.size());
+    if (written >= 0 && static_cast<size_t>(written) == body.size()) {
+      // Fetch headers / status, then drain any response body
+      (void) esp_http_client_fetch_headers(client);
+      status = esp_http_client_get_status_code(client);
+    }
+  }
   if (written < 0 || static_cast<size_t>(written) != body.size()) {
     ESP_LOGE(TAG, "HTTP write failed: %d", written);
     esp_http_client_close(client);
@@ -118,9 +140,6 @@ bool InfluxDB::post_raw_idf_(const std::string &url,
     return false;
   }
   
-  // Fetch headers / status, then drain any response body
-  (void) esp_http_client_fetch_headers(client);
-  int status = esp_http_client_get_status_code(client);
   ESP_LOGD(TAG, "HTTP status: %d", status);
   
   // Drain response body as per ESP-IDF documentation
@@ -140,6 +159,9 @@ void InfluxDB::loop() {
   if (this->should_publish_()) {
     this->publish_now();
   }
+  if (!this->pending_events_.empty() && !this->publish_in_progress_ && !this->is_failed()) {
+    this->publish_events_();
+  }
 }
 
 void InfluxDB::build_url_() {
@@ -250,22 +272,106 @@ size_t InfluxDB::estimate_payload_size_() const {
 }
 
 void InfluxDB::publish_now() {
+  std::vector<float> values;
+  values.reserve(this->sensors_.size());
+  for (auto *sensor : this->sensors_) {
+    values.push_back(sensor->state);
+  }
+  this->publish_(values, this->build_timestamp_());
+}
+
+#ifdef USE_SAMPLE_SNAPSHOT
+void InfluxDB::publish_snapshot(const sample_snapshot::Snapshot &snapshot) {
+  std::vector<float> values;
+  values.reserve(this->sensors_.size());
+  for (auto *sensor : this->sensors_) {
+    const auto *reading = snapshot.find(sensor);
+    values.push_back(reading != nullptr ? reading->value : sensor->state);
+  }
+  
+  // All lines carry the instant of the snapshot
+  if (snapshot.timestamp != 0) {
+    this->publish_(values, std::string(" ") + to_string(snapshot.timestamp));
+  } else {
+    this->publish_(values, this->build_timestamp_());
+  }
+}
+#endif
+
+// values holds one value per entry of sensors_
+void InfluxDB::publish_(const std::vector<float> &values, const std::string &timestamp) {
+  PROFILE_SCOPE("influxdb.publish");
   if (this->is_failed() || this->publish_in_progress_) {
     ESP_LOGW(TAG, "Cannot publish: component failed or publish in progress");
     return;
   }
   
+  std::string body;
+  size_t data_points = this->build_body_(values, timestamp, body);
+  
+  if (data_points == 0) {
+    ESP_LOGD(TAG, "No valid sensor data to publish");
+    return;
+  }
+  
+  // Providers start a new interval with each publish
+  for (const auto &pair : this->field_providers_) {
+    pair.second->on_published();
+  }
+  
+  // Shrink buffer to actual size
+  body.shrink_to_fit();
+  
+  ESP_LOGI(TAG, "Publishing %zu data points to InfluxDB", data_points);
+  ESP_LOGVV(TAG, "Request body length: %u bytes", (unsigned) body.size());
+  
+  this->publish_in_progress_ = true;
+  this->last_publish_ = millis();
+  this->on_publish_begin_callback_.call();
+  
+  // One-shot IDF client (verify SSL if URL is https)
+  const bool verify_ssl = this->url_.rfind("https://", 0) == 0;
+  
+  bool ok = this->post_with_retries_(body, verify_ssl);
+  
+  if (!ok) {
+    ESP_LOGW(TAG, "InfluxDB POST failed after %d attempts", MAX_RETRIES + 1);
+    // Without a timestamp the server would date a replay at its arrival, so only keep timestamped bodies
+    if (!timestamp.empty()) {
+      this->keep_for_replay_(std::move(body));
+    }
+  } else {
+    ESP_LOGD(TAG, "Successfully published to InfluxDB");
+#ifdef USE_TRACE
+    // the sample being traced is acknowledged
+    if (trace::global_trace != nullptr)
+      trace::global_trace->end_sample();
+#endif
+    // Replay in the same connection window while the server is known to be reachable
+    this->replay_backlog_(verify_ssl);
+  }
+  
+  // Free the request body's capacity immediately
+  std::string().swap(body);
+  
+  this->publish_in_progress_ = false;
+  this->on_publish_end_callback_.call(PUBLISH_SAMPLE, ok);
+}
+
+size_t InfluxDB::build_body_(const std::vector<float> &values, const std::string &timestamp, std::string &body) {
+  TRACE_SPAN("influxdb.serialize");
   // Optimized payload building with better size estimation
   const size_t estimated_size = this->estimate_payload_size_();
-  std::string body;
   body.reserve(estimated_size);
   size_t data_points = 0;
   
   // Build payload efficiently - no preflight checks
-  for (auto *sensor : this->sensors_) {
-    if (!std::isnan(sensor->state)) {
-      const std::string &sensor_id = sensor->get_object_id();
-      body += this->build_line_protocol_line_(sensor_id, to_string(sensor->state));
+  for (size_t i = 0; i < this->sensors_.size(); i++) {
+    if (!std::isnan(values[i])) {
+      const std::string &sensor_id = this->sensors_[i]->get_object_id();
+      std::string value = to_string(values[i]);
+      this->append_provider_fields_(this->sensors_[i], value);
+      this->append_line_protocol_line_(body, sensor_id, value, timestamp);
       data_points++;
     }
   }
@@ -273,117 +379,209 @@ void InfluxDB::publish_now() {
   for (auto *text_sensor : this->text_sensors_) {
     if (!text_sensor->state.empty()) {
       const std::string &sensor_id = text_sensor->get_object_id();
-      body += this->build_line_protocol_line_(sensor_id, text_sensor->state, true);
+      this->append_line_protocol_line_(body, sensor_id, text_sensor->state, timestamp, true);
       data_points++;
     }
   }
   
 #ifdef USE_BINARY_SENSOR
   for (const auto &pair : this->binary_sensor_states_) {
-    body += this->build_line_protocol_line_(pair.first, std::to_string(pair.second ? 1 : 0));
+    this->append_line_protocol_line_(body, pair.first, std::to_string(pair.second ? 1 : 0), timestamp);
     data_points++;
   }
 #endif
   
-  if (data_points == 0) {
-    ESP_LOGD(TAG, "No valid sensor data to publish");
-    return;
-  }
-  
-  // Shrink buffer to actual size
-  body.shrink_to_fit();
-  
-  ESP_LOGI(TAG, "Publishing %zu data points to InfluxDB", data_points);
-  ESP_LOGVV(TAG, "Request body length: %u bytes", (unsigned) body.size());
-  
-  this->publish_in_progress_ = true;
-  this->last_publish_ = millis();
-  
-  // One-shot IDF client (verify SSL if URL is https)
-  const bool verify_ssl = this->url_.rfind("https://", 0) == 0;
-  
-  // Retry logic with exponential backoff
-  int attempts = 0, max_retries = 2;
+  return data_points;
+}
+
+// Retry logic with exponential backoff
+bool InfluxDB::post_with_retries_(const std::string &body, bool verify_ssl) {
+  int attempts = 0;
   bool ok = false;
   do {
     ok = this->post_raw_idf_(this->url_, body, this->headers_, verify_ssl);
-    if (!ok && attempts < max_retries) {
+    if (!ok && attempts < MAX_RETRIES) {
       uint32_t backoff = BASE_BACKOFF_MS + (esp_random() % BACKOFF_RANGE_MS);
       ESP_LOGW(TAG, "POST failed, retrying in %u ms (attempt %d/%d)",
-               backoff, attempts + 1, max_retries);
+               backoff, attempts + 1, MAX_RETRIES);
       delay(backoff);
     }
-  } while (!ok && ++attempts <= max_retries);
-  
-  // Free the request body's capacity immediately
-  std::string().swap(body);
-  
+  } while (!ok && ++attempts <= MAX_RETRIES);
+  return ok;
+}
+
+void InfluxDB::keep_for_replay_(std::string &&body) {
+  if (this->max_backlog_ == 0) {
+    return;
+  }
+  if (this->backlog_.size() >= this->max_backlog_) {
+    ESP_LOGW(TAG, "Backlog full, dropping oldest request");
+    this->backlog_.pop_front();
+  }
+  body.shrink_to_fit();
+  this->backlog_.push_back(std::move(body));
+  ESP_LOGD(TAG, "Request kept for replay (%zu in backlog)", this->backlog_.size());
+}
+
+// Oldest first, one attempt each; stops at the first failure so the order is kept
+void InfluxDB::replay_backlog_(bool verify_ssl) {
+  size_t replayed = 0;
+  while (!this->backlog_.empty()) {
+    if (!this->post_raw_idf_(this->url_, this->backlog_.front(), this->headers_, verify_ssl)) {
+      ESP_LOGW(TAG, "Backlog replay failed, %zu requests left", this->backlog_.size());
+      break;
+    }
+    this->backlog_.pop_front();
+    replayed++;
+  }
+  if (replayed > 0) {
+    ESP_LOGI(TAG, "Replayed %zu requests from backlog", replayed);
+  }
+}
+
+// --- Event fast path ---
+
+#ifdef USE_CHECKPOINT
+// Keeps the newest backlog bodies that fit in the checkpoint; they are replayed after the next
+// successful publish like any other backlog entry. The bodies are complete line protocol, so a
+// firmware with another configuration can still send them.
+void InfluxDB::setup_checkpoint_() {
+  this->checkpoint_->add_client(
+      "influxdb", CHECKPOINT_RECORD_VERSION,
+      [this](checkpoint::Writer &writer) {
+        size_t space = writer.remaining() > 0 ? writer.remaining() - sizeof(uint8_t) : 0;  // after the count
+        size_t first = this->backlog_.size();
+        while (first > 0 && this->backlog_[first - 1].size() + sizeof(uint16_t) <= space) {
+          first--;
+          space -= this->backlog_[first].size() + sizeof(uint16_t);
+        }
+        writer.write_u8(this->backlog_.size() - first);
+        for (size_t i = first; i < this->backlog_.size(); i++)
+          writer.write_string(this->backlog_[i]);
+      },
+      [this](checkpoint::Reader &reader, uint32_t age_ms) {
+        uint8_t count = reader.read_u8();
+        for (uint8_t i = 0; i < count && reader.ok(); i++)
+          this->keep_for_replay_(reader.read_string());
+        ESP_LOGI(TAG, "Restored %zu backlog requests", this->backlog_.size());
+        return reader.ok();
+      });
+}
+#endif
+
+void InfluxDB::setup_triggers_() {
+  for (size_t i = 0; i < this->triggers_.size(); i++) {
+    // By index, the callbacks outlive any reallocation of triggers_
+    this->triggers_[i].source->add_on_state_callback([this, i](float value) { this->check_trigger_(i, value); });
+  }
+}
+
+void InfluxDB::check_trigger_(size_t index, float value) {
+  EventTrigger &trigger = this->triggers_[index];
+  if (trigger.transform) {
+    value = trigger.transform(value);
+  }
+  if (!trigger.rule->check(value, millis())) {
+    return;
+  }
+
+  const std::string &sensor_id = trigger.target->get_object_id();
+  ESP_LOGI(TAG, "Event '%s' on %s: %.2f", trigger.event.c_str(), sensor_id.c_str(), value);
+  if (this->pending_events_.size() >= MAX_PENDING_EVENTS) {
+    ESP_LOGW(TAG, "Too many pending events, dropping '%s'", trigger.event.c_str());
+    return;
+  }
+
+  // Timestamped when the rule fired, not when the line is sent
+  std::string line;
+  line.reserve(128);
+  this->append_line_protocol_line_(line, sensor_id, to_string(value), this->build_timestamp_(), false, trigger.event);
+  this->pending_events_.push_back(std::move(line));
+}
+
+// One attempt: an event is only worth sending fast; a failed one goes to the backlog
+void InfluxDB::publish_events_() {
+  std::string body;
+  for (const auto &line : this->pending_events_) {
+    body += line;
+  }
+  const size_t events = this->pending_events_.size();
+  this->pending_events_.clear();
+
+  ESP_LOGD(TAG, "Publishing %zu events", events);
+  this->publish_in_progress_ = true;
+  this->on_publish_begin_callback_.call();
+  const bool verify_ssl = this->url_.rfind("https://", 0) == 0;
+  bool ok = this->post_raw_idf_(this->url_, body, this->headers_, verify_ssl);
   if (!ok) {
-    ESP_LOGW(TAG, "InfluxDB POST failed after %d attempts", max_retries + 1);
-  } else {
-    ESP_LOGD(TAG, "Successfully published to InfluxDB");
+    ESP_LOGW(TAG, "Event POST failed");
+    // Event lines only lack a timestamp if there was no valid time; those cannot be replayed
+    if (this->time_source_ != nullptr && this->time_source_->now().is_valid()) {
+      this->keep_for_replay_(std::move(body));
+    }
   }
-  
   this->publish_in_progress_ = false;
+  this->on_publish_end_callback_.call(PUBLISH_EVENTS, ok);
 }
 
-std::string InfluxDB::build_line_protocol_line_(const std::string &sensor_id,
-                                                const std::string &value,
-                                                bool is_string_value) {
-  std::string line;
-  line.reserve(128);  // Pre-allocate reasonable size
-  
-  line += this->build_measurement_name_(sensor_id);
-  line += this->build_tags_(sensor_id);
-  line += " ";
-  line += this->build_fields_(sensor_id, value, is_string_value);
-  line += this->build_timestamp_();
-  line += "\n";
-  
-  return line;
+void InfluxDB::append_line_protocol_line_(std::string &out,
+                                          const std::string &sensor_id,
+                                          const std::string &value,
+                                          const std::string &timestamp,
+                                          bool is_string_value,
+                                          const std::string &event) const {
+  // Straight from the configuration maps, in the order of get_tags(), without copying them per line
+  auto measurement = this->sensor_measurements_.find(sensor_id);
+  line_protocol::append_escaped_key(out, measurement != this->sensor_measurements_.end() ? measurement->second
+                                                                                         : sensor_id);
+  for (const auto &tag : this->global_tags_) {
+    line_protocol::append_tag(out, tag.first, tag.second);
+  }
+  auto static_it = this->static_tags_.find(sensor_id);
+  if (static_it != this->static_tags_.end()) {
+    for (const auto &tag : static_it->second) {
+      line_protocol::append_tag(out, tag.first, tag.second);
+    }
+  }
+  if (this->send_mac_ && !this->mac_address_.empty()) {
+    line_protocol::append_tag(out, "device", this->mac_address_);
+  }
+  if (!event.empty()) {
+    line_protocol::append_tag(out, "event", event);
+  }
+
+  static const std::string DEFAULT_FIELD = "value";
+  auto field = this->field_names_.find(sensor_id);
+  out += ' ';
+  line_protocol::append_field(out, field != this->field_names_.end() ? field->second : DEFAULT_FIELD, value,
+                              is_string_value);
+  out += timestamp;
+  out += '\n';
 }
 
-std::string InfluxDB::build_measurement_name_(const std::string &sensor_id) const {
+// By value: the sensor id itself is the name of an unmapped sensor, and may be a temporary
+std::string InfluxDB::get_measurement_name(const std::string &sensor_id) const {
   auto it = this->sensor_measurements_.find(sensor_id);
-  const std::string &measurement = (it != this->sensor_measurements_.end()) ? it->second : sensor_id;
-  return this->escape_influx_key_(measurement);
+  return (it != this->sensor_measurements_.end()) ? it->second : sensor_id;
 }
 
-std::string InfluxDB::build_tags_(const std::string &sensor_id) const {
-  std::string tags;
-  tags.reserve(128);  // Pre-allocate for typical tag size
-  
-  // Global tags
-  for (const auto &pair : this->global_tags_) {
-    tags += "," + this->escape_influx_key_(pair.first) + "=" + this->escape_influx_key_(pair.second);
-  }
+std::vector<std::pair<std::string, std::string>> InfluxDB::get_tags(const std::string &sensor_id) const {
+  std::vector<std::pair<std::string, std::string>> tags(this->global_tags_.begin(), this->global_tags_.end());
   
   // Static tags for this sensor
   auto static_it = this->static_tags_.find(sensor_id);
   if (static_it != this->static_tags_.end()) {
-    for (const auto &pair : static_it->second) {
-      tags += "," + this->escape_influx_key_(pair.first) + "=" + this->escape_influx_key_(pair.second);
-    }
+    tags.insert(tags.end(), static_it->second.begin(), static_it->second.end());
   }
   
   // MAC address tag (optional)
   if (this->send_mac_ && !this->mac_address_.empty()) {
-    tags += ",device=" + this->escape_influx_key_(this->mac_address_);
+    tags.emplace_back("device", this->mac_address_);
   }
   
   return tags;
 }
 
-std::string InfluxDB::build_fields_(const std::string &sensor_id,
-                                    const std::string &value,
-                                    bool is_string_value) const {
-  const std::string &field_name = this->get_field_name_(sensor_id);
-  std::string field_value = is_string_value
-  ? "\"" + this->escape_influx_string_value_(value) + "\""
-  : value;
-  return field_name + "=" + std::move(field_value);
-}
-
 std::string InfluxDB::build_timestamp_() const {
   if (this->time_source_ != nullptr) {
     auto now = this->time_source_->now();
@@ -394,29 +592,13 @@ std::string InfluxDB::build_timestamp_() const {
   return "";  // InfluxDB will use server timestamp if not provided
 }
 
-std::string InfluxDB::escape_influx_key_(const std::string &input) const {
-  std::string output;
-  output.reserve(static_cast<size_t>(input.length() * 1.2f));
-  for (char c : input) {
-    if (c == ' ' || c == ',' || c == '=') output += '\\';
-    output += c;
-  }
-  return output;
-}
-
-std::string InfluxDB::escape_influx_string_value_(const std::string &input) const {
-  std::string output;
-  output.reserve(static_cast<size_t>(input.length() * 1.2f));
-  for (char c : input) {
-    if (c == '"' || c == '\\') output += '\\';
-    output += c;
+// Extra fields follow the value field on the same line
+void InfluxDB::append_provider_fields_(sensor::Sensor *sensor, std::string &value) const {
+  for (const auto &pair : this->field_providers_) {
+    if (pair.first == sensor) {
+      pair.second->append_fields(value);
+    }
   }
-  return output;
-}
-
-std::string InfluxDB::get_field_name_(const std::string &sensor_id) const {
-  auto it = this->field_names_.find(sensor_id);
-  return (it != this->field_names_.end()) ? it->second : "value";
 }
 
 bool InfluxDB::has_sensor_mapping_(const std::string &sensor_id) const {
@@ -446,6 +628,15 @@ void InfluxDB::set_field_name(const std::string &sensor_id,
   this->field_names_[sensor_id] = field_name;
 }
 
+void InfluxDB::add_field_provider(sensor::Sensor *sensor, FieldProvider *provider) {
+  this->field_providers_.emplace_back(sensor, provider);
+}
+
+void InfluxDB::add_trigger(TriggerRule *rule, sensor::Sensor *source, sensor::Sensor *target,
+                           const std::string &event, std::function<float(float)> &&transform) {
+  this->triggers_.push_back({rule, source, target, event, std::move(transform)});
+}
+
 void InfluxDB::dump_config() {
   ESP_LOGCONFIG(TAG, "InfluxDB:");
   ESP_LOGCONFIG(TAG, "  URL: %s", this->url_.c_str());
@@ -459,6 +650,12 @@ void InfluxDB::dump_config() {
   }
   ESP_LOGCONFIG(TAG, "  SSL: %s", this->use_ssl_ ? "YES" : "NO");
   ESP_LOGCONFIG(TAG, "  Send MAC: %s", this->send_mac_ ? "YES" : "NO");
+  ESP_LOGCONFIG(TAG, "  Max backlog: %zu requests", this->max_backlog_);
+  for (const auto &trigger : this->triggers_) {
+    ESP_LOGCONFIG(TAG, "  Event '%s': %s on %s, line for %s", trigger.event.c_str(),
+                  TriggerRule::type_name(trigger.rule->get_type()), trigger.source->get_object_id().c_str(),
+                  trigger.target->get_object_id().c_str());
+  }
   ESP_LOGCONFIG(TAG, "  Configured sensors: %zu", this->sensor_measurements_.size());
   
   if (this->time_source_ == nullptr) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <deque>
+#include <functional>
 #include <map>
 #include <string>
 #include <list>
@@ -7,6 +9,7 @@
 #include <unordered_map>
 
 #include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/text_sensor/text_sensor.h"
 #include "esphome/components/http_request/http_request.h"
@@ -16,9 +19,37 @@
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #endif
 
+#ifdef USE_SAMPLE_SNAPSHOT
+#include "esphome/components/sample_snapshot/sample_snapshot.h"
+#endif
+
+#ifdef USE_CHECKPOINT
+#include "esphome/components/checkpoint/checkpoint.h"
+#endif
+
+#include "line_protocol.h"
+#include "trigger_rule.h"
+
 namespace esphome {
 namespace influxdb {
 
+/**
+ * @brief Adds fields after the value field of a sensor's line, e.g. interval statistics
+ */
+class FieldProvider {
+ public:
+  // Appends ",key=value" pairs to fields
+  virtual void append_fields(std::string &fields) = 0;
+  // Called once the fields have been serialized into a publish
+  virtual void on_published() {}
+};
+
+// What a publish sent: the regular sample (publish_now/publish_snapshot) or triggered event lines
+enum PublishKind : uint8_t {
+  PUBLISH_SAMPLE,
+  PUBLISH_EVENTS,
+};
+
 /**
  * @brief InfluxDB Component
  * 
@@ -35,6 +66,26 @@ class InfluxDB : public Component {
 
   // --- Public API ---
   void publish_now();
+#ifdef USE_SAMPLE_SNAPSHOT
+  // Publishes the snapshot values and timestamp; mapped sensors outside the snapshot use their state
+  void publish_snapshot(const sample_snapshot::Snapshot &snapshot);
+#endif
+  size_t get_backlog_size() const { return backlog_.size(); }
+  // Series naming shared with local exporters: mapped sensors, measurement names (unescaped)
+  // and tags in line order (global, per sensor, device)
+  const std::vector<sensor::Sensor *> &get_sensors() const { return sensors_; }
+  std::string get_measurement_name(const std::string &sensor_id) const;
+  std::vector<std::pair<std::string, std::string>> get_tags(const std::string &sensor_id) const;
+
+  // --- Publish hooks ---
+  // begin: before the first connection of a publish; end: after its last request (including
+  // backlog replay), with what was published and whether the new data was accepted
+  void add_on_publish_begin_callback(std::function<void()> &&callback) {
+    on_publish_begin_callback_.add(std::move(callback));
+  }
+  void add_on_publish_end_callback(std::function<void(PublishKind, bool)> &&callback) {
+    on_publish_end_callback_.add(std::move(callback));
+  }
 
   // --- Configuration setters (called by Python codegen) ---
   void set_host(const std::string &host) { host_ = host; }
@@ -48,16 +99,26 @@ class InfluxDB : public Component {
   void set_update_interval(uint32_t interval_ms) { 
     update_interval_ = interval_ms;
   }
+  void set_max_backlog(size_t max_backlog) { max_backlog_ = max_backlog; }
   
   // --- Component dependencies ---
   void set_http_request(http_request::HttpRequestComponent *request) { http_request_ = request; }
   void set_time_source(time::RealTimeClock *time_source) { time_source_ = time_source; }
+#ifdef USE_CHECKPOINT
+  // the backlog is kept across resets
+  void set_checkpoint(checkpoint::Checkpoint *checkpoint) { checkpoint_ = checkpoint; }
+#endif
 
   // --- Sensor configuration ---
   void add_sensor_mapping(const std::string &sensor_id, const std::string &measurement_name);
   void add_static_tag(const std::string &sensor_id, const std::string &tag_key, const std::string &tag_value);
   void add_global_tag(const std::string &tag_key, const std::string &tag_value);
   void set_field_name(const std::string &sensor_id, const std::string &field_name);
+  void add_field_provider(sensor::Sensor *sensor, FieldProvider *provider);
+  // Values of source (after transform, if set) are checked against rule; when it fires, a single
+  // line for target's measurement is sent with an event tag, outside the regular publishes
+  void add_trigger(TriggerRule *rule, sensor::Sensor *source, sensor::Sensor *target, const std::string &event,
+                   std::function<float(float)> &&transform = nullptr);
 
  protected:
   // --- Configuration ---
@@ -70,6 +131,7 @@ class InfluxDB : public Component {
   bool use_ssl_{false};  // Use HTTPS if true
   bool send_mac_{false};  // Include MAC address tag
   uint32_t update_interval_{60000};  // 60 seconds default
+  size_t max_backlog_{0};  // failed request bodies kept for replay
 
   // --- ESP-IDF HTTP client implementation ---
   bool post_raw_idf_(const std::string &url,
@@ -83,10 +145,16 @@ class InfluxDB : public Component {
   std::list<http_request::Header> headers_;
   uint32_t last_publish_{0};
   bool publish_in_progress_{false};
+  std::deque<std::string> backlog_;  // oldest first, only bodies with explicit timestamps
+  CallbackManager<void()> on_publish_begin_callback_;
+  CallbackManager<void(PublishKind, bool)> on_publish_end_callback_;
   
   // --- Component dependencies ---
   http_request::HttpRequestComponent *http_request_{nullptr};
   time::RealTimeClock *time_source_{nullptr};
+#ifdef USE_CHECKPOINT
+  checkpoint::Checkpoint *checkpoint_{nullptr};
+#endif
 
   // --- Sensor management (removed unused sensor_names_) ---
   std::unordered_map<std::string, std::string> sensor_measurements_;  // sensor_id -> measurement_name
@@ -97,27 +165,48 @@ class InfluxDB : public Component {
   // --- Sensor collections ---
   std::vector<sensor::Sensor *> sensors_;
   std::vector<text_sensor::TextSensor *> text_sensors_;
+  std::vector<std::pair<sensor::Sensor *, FieldProvider *>> field_providers_;
 #ifdef USE_BINARY_SENSOR
   std::unordered_map<std::string, bool> binary_sensor_states_;
 #endif
 
+  // --- Event fast path ---
+  struct EventTrigger {
+    TriggerRule *rule;
+    sensor::Sensor *source;
+    sensor::Sensor *target;
+    std::string event;
+    std::function<float(float)> transform;
+  };
+  std::vector<EventTrigger> triggers_;
+  std::vector<std::string> pending_events_;  // lines queued by sensor callbacks, sent from loop()
+
   // --- Helper methods ---
   bool validate_required_config_();
   void collect_sensors_();
   void build_url_();
   void setup_headers_();
   size_t estimate_payload_size_() const;
+  void publish_(const std::vector<float> &values, const std::string &timestamp);
+  // Line protocol for all sensors into body; returns the number of data points
+  size_t build_body_(const std::vector<float> &values, const std::string &timestamp, std::string &body);
+  bool post_with_retries_(const std::string &body, bool verify_ssl);
+  void keep_for_replay_(std::string &&body);
+  void replay_backlog_(bool verify_ssl);
+  void setup_triggers_();
+  void check_trigger_(size_t index, float value);
+  void publish_events_();
+#ifdef USE_CHECKPOINT
+  void setup_checkpoint_();
+#endif
   
-  std::string build_line_protocol_line_(const std::string &sensor_id, const std::string &value, bool is_string_value = false);
-  std::string build_measurement_name_(const std::string &sensor_id) const;
-  std::string build_tags_(const std::string &sensor_id) const;
-  std::string build_fields_(const std::string &sensor_id, const std::string &value, bool is_string_value = false) const;
+  // Appends the line for sensor_id, with an event tag if event is not empty
+  void append_line_protocol_line_(std::string &out, const std::string &sensor_id, const std::string &value,
+                                  const std::string &timestamp, bool is_string_value = false,
+                                  const std::string &event = "") const;
   std::string build_timestamp_() const;
+  void append_provider_fields_(sensor::Sensor *sensor, std::string &value) const;
   
-  std::string escape_influx_key_(const std::string &input) const;
-  std::string escape_influx_string_value_(const std::string &input) const;
-  
-  std::string get_field_name_(const std::string &sensor_id) const;
   bool has_sensor_mapping_(const std::string &sensor_id) const;
   bool should_publish_() const;
   
@@ -126,6 +215,9 @@ class InfluxDB : public Component {
   static constexpr size_t MIN_BUFFER_SIZE = 256;
   static constexpr uint32_t BASE_BACKOFF_MS = 500;
   static constexpr uint32_t BACKOFF_RANGE_MS = 1500;
+  static constexpr int MAX_RETRIES = 2;
+  static constexpr uint32_t CHECKPOINT_RECORD_VERSION = 1;  // bump when the backlog record changes
+  static constexpr size_t MAX_PENDING_EVENTS = 8;
 };
 
 }  // namespace influxdb
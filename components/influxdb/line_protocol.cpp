@@ -0,0 +1,55 @@
+#include "line_protocol.h"
+
+namespace esphome {
+namespace influxdb {
+namespace line_protocol {
+
+void append_escaped_key(std::string &out, const std::string &input) {
+  for (char c : input) {
+    if (c == ' ' || c == ',' || c == '=')
+      out += '\\';
+    out += c;
+  }
+}
+
+void append_escaped_string(std::string &out, const std::string &input) {
+  for (char c : input) {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    out += c;
+  }
+}
+
+void append_field(std::string &out, const std::string &key, const std::string &value, bool is_string) {
+  append_escaped_key(out, key);
+  out += '=';
+  if (is_string) {
+    out += '"';
+    append_escaped_string(out, value);
+    out += '"';
+  } else {
+    out += value;
+  }
+}
+
+void append_tag(std::string &out, const std::string &key, const std::string &value) {
+  out += ',';
+  append_escaped_key(out, key);
+  out += '=';
+  append_escaped_key(out, value);
+}
+
+void append_line(std::string &out, const std::string &measurement, const Tags &tags, const std::string &fields,
+                 const std::string &timestamp) {
+  append_escaped_key(out, measurement);
+  for (const auto &tag : tags)
+    append_tag(out, tag.first, tag.second);
+  out += ' ';
+  out += fields;
+  out += timestamp;
+  out += '\n';
+}
+
+}  // namespace line_protocol
+}  // namespace influxdb
+}  // namespace esphome
@@ -0,0 +1,36 @@
+#pragma once
+
+// InfluxDB line protocol serialization, without ESPHome or ESP-IDF dependencies so it can be linked
+// into host tools (e.g. an ingest load generator) with exactly the bytes the device sends.
+//
+//   measurement[,tag=value...] field=value[,field=value...][ timestamp]\n
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace influxdb {
+namespace line_protocol {
+
+using Tags = std::vector<std::pair<std::string, std::string>>;
+
+// Measurement names, tag keys and values, field keys: backslash before space, comma and equals sign
+void append_escaped_key(std::string &out, const std::string &input);
+// String field values, without the quotes: backslash before double quote and backslash
+void append_escaped_string(std::string &out, const std::string &input);
+
+// key=value, or key="value" for string values; value is used verbatim otherwise, so it may carry
+// further ",key=value" fields
+void append_field(std::string &out, const std::string &key, const std::string &value, bool is_string = false);
+
+// ",key=value" after the measurement or the previous tag
+void append_tag(std::string &out, const std::string &key, const std::string &value);
+
+// One line; fields as built by append_field(), timestamp empty (server time) or " <epoch>"
+void append_line(std::string &out, const std::string &measurement, const Tags &tags, const std::string &fields,
+                 const std::string &timestamp);
+
+}  // namespace line_protocol
+}  // namespace influxdb
+}  // namespace esphome
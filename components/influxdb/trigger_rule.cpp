@@ -0,0 +1,88 @@
+#include "trigger_rule.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace influxdb {
+
+const char *TriggerRule::type_name(TriggerType type) {
+  switch (type) {
+    case TRIGGER_ABOVE:
+      return "above";
+    case TRIGGER_BELOW:
+      return "below";
+    case TRIGGER_RATE:
+      return "rate";
+    case TRIGGER_ZSCORE:
+      return "zscore";
+    default:
+      return "unknown";
+  }
+}
+
+float TriggerRule::excess_(float value, uint32_t now) {
+  switch (this->type_) {
+    case TRIGGER_ABOVE:
+      return value - this->threshold_;
+    case TRIGGER_BELOW:
+      return this->threshold_ - value;
+    case TRIGGER_RATE: {
+      float excess = NAN;
+      if (this->count_ > 0 && now != this->previous_time_) {
+        float per_minute = (value - this->previous_value_) * 60000.0f / (now - this->previous_time_);
+        excess = std::fabs(per_minute) - this->threshold_;
+      }
+      this->previous_value_ = value;
+      this->previous_time_ = now;
+      this->count_++;
+      return excess;
+    }
+    case TRIGGER_ZSCORE: {
+      // Scored against the history before this value, then added to it
+      float excess = NAN;
+      float diff = value - this->mean_;
+      if (this->count_ >= static_cast<uint32_t>(1.0f / this->alpha_)) {
+        float z = this->variance_ > 0 ? std::fabs(diff) / std::sqrt(this->variance_) : (diff != 0 ? INFINITY : 0);
+        excess = z - this->threshold_;
+      }
+      if (this->count_ == 0) {
+        this->mean_ = value;
+      } else {
+        float increment = this->alpha_ * diff;
+        this->mean_ += increment;
+        this->variance_ = (1.0f - this->alpha_) * (this->variance_ + diff * increment);
+      }
+      this->count_++;
+      return excess;
+    }
+    default:
+      return NAN;
+  }
+}
+
+bool TriggerRule::check(float value, uint32_t now) {
+  if (std::isnan(value))
+    return false;
+  float excess = this->excess_(value, now);
+  if (std::isnan(excess))
+    return false;
+
+  if (excess <= -this->hysteresis_) {
+    this->armed_ = true;
+    return false;
+  }
+  if (excess <= 0 || !this->armed_)
+    return false;
+
+  this->armed_ = false;
+  if (this->fired_once_ && now - this->last_fire_ < this->min_interval_ms_) {
+    this->suppressed_++;
+    return false;
+  }
+  this->fired_once_ = true;
+  this->last_fire_ = now;
+  return true;
+}
+
+}  // namespace influxdb
+}  // namespace esphome
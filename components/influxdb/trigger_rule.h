@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace influxdb {
+
+enum TriggerType : uint8_t {
+  TRIGGER_ABOVE,   // value crosses above threshold
+  TRIGGER_BELOW,   // value crosses below threshold
+  TRIGGER_RATE,    // |change per minute| exceeds threshold
+  TRIGGER_ZSCORE,  // |value - EWMA mean| / EWMA SD exceeds threshold
+};
+
+/**
+ * @brief TriggerRule
+ *   - Edge triggered: fires when its condition starts to hold, then re-arms once the value is
+ *     back by more than the hysteresis, so a CO₂ level staying high is reported once.
+ *   - Rate limited: a fire within min_interval of the previous one is suppressed (and counted).
+ */
+class TriggerRule {
+ public:
+  TriggerRule(TriggerType type, float threshold) : type_(type), threshold_(threshold) {}
+
+  void set_hysteresis(float hysteresis) { hysteresis_ = hysteresis; }
+  // EWMA weight of new values for zscore rules; 1/alpha values are seen before the rule can fire
+  void set_alpha(float alpha) { alpha_ = alpha; }
+  void set_min_interval(uint32_t min_interval_ms) { min_interval_ms_ = min_interval_ms; }
+
+  // true if the rule fires for value, received at now (millis())
+  bool check(float value, uint32_t now);
+
+  TriggerType get_type() const { return type_; }
+  uint32_t get_suppressed() const { return suppressed_; }
+  static const char *type_name(TriggerType type);
+
+ protected:
+  TriggerType type_;
+  float threshold_;
+  float hysteresis_{0};
+  float alpha_{0.05f};
+  uint32_t min_interval_ms_{60000};
+
+  bool armed_{true};
+  bool fired_once_{false};
+  uint32_t last_fire_{0};
+  uint32_t suppressed_{0};
+
+  // rate and zscore state
+  uint32_t count_{0};
+  float previous_value_{0};
+  uint32_t previous_time_{0};
+  float mean_{0};
+  float variance_{0};
+
+  // How far past the threshold value is (> 0: condition holds), NaN while there is no history yet
+  float excess_(float value, uint32_t now);
+};
+
+}  // namespace influxdb
+}  // namespace esphome
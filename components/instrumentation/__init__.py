@@ -0,0 +1,8 @@
+"""
+Instrumentation macros for ESPHome
+- Header-only, auto-loaded by the components that mark code for the trace and the loop profiler.
+- trace_span.h: TRACE_SPAN / TRACE_SPAN_NAMED, no-ops unless the trace component is configured.
+- profile_scope.h: PROFILE_SCOPE, a no-op unless the loop profiler is configured.
+"""
+
+CODEOWNERS = ["@IEQLab"]
@@ -0,0 +1,9 @@
+#pragma once
+
+// PROFILE_SCOPE("section") for the loop profiler; it compiles to nothing when the profiler is not
+// configured.
+#ifdef USE_LOOP_PROFILER
+#include "esphome/components/loop_profiler/loop_profiler.h"
+#else
+#define PROFILE_SCOPE(name)
+#endif
@@ -0,0 +1,10 @@
+#pragma once
+
+// TRACE_SPAN("stage") and TRACE_SPAN_NAMED("stage", name) for the trace component; they compile
+// to nothing when it is not configured.
+#ifdef USE_TRACE
+#include "esphome/components/trace/trace.h"
+#else
+#define TRACE_SPAN(stage_name)
+#define TRACE_SPAN_NAMED(stage_name, name)
+#endif
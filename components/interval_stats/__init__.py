@@ -0,0 +1,50 @@
+"""
+Interval Statistics for ESPHome
+- Count, mean, SD, min, max, p5 and p95 of a sensor's raw values between InfluxDB publishes.
+- Constant memory: Welford mean/variance and P² quantile estimates, no stored samples.
+- Added as extra fields to the target sensor's InfluxDB line, e.g. samba_temperature.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.components.influxdb import InfluxDB
+from esphome.const import CONF_ID, CONF_LAMBDA, CONF_SENSOR
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["influxdb"]
+MULTI_CONF = True
+
+CONF_TARGET = "target"
+CONF_INFLUXDB_ID = "influxdb_id"
+
+interval_stats_ns = cg.esphome_ns.namespace("interval_stats")
+IntervalStats = interval_stats_ns.class_("IntervalStats", cg.Component)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(IntervalStats),
+    cv.GenerateID(CONF_INFLUXDB_ID): cv.use_id(InfluxDB),
+    # raw values of this sensor are summarised
+    cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+    # the statistics are added to this sensor's line
+    cv.Required(CONF_TARGET): cv.use_id(sensor.Sensor),
+    # applied to each value first, e.g. the target's calibration; return NAN to skip a value
+    cv.Optional(CONF_LAMBDA): cv.returning_lambda,
+}).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    source = await cg.get_variable(config[CONF_SENSOR])
+    cg.add(var.set_source(source))
+
+    if CONF_LAMBDA in config:
+        transform = await cg.process_lambda(config[CONF_LAMBDA], [(float, "x")], return_type=float)
+        cg.add(var.set_transform(transform))
+
+    # Register with InfluxDB for the target's line
+    influx = await cg.get_variable(config[CONF_INFLUXDB_ID])
+    target = await cg.get_variable(config[CONF_TARGET])
+    cg.add(influx.add_field_provider(target, var))
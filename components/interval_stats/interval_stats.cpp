@@ -0,0 +1,168 @@
+#include "interval_stats.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace interval_stats {
+
+static const char *const TAG = "interval_stats";
+
+// --- P² quantile estimate ---
+
+void P2Quantile::reset() {
+  this->count_ = 0;
+  this->increments_[0] = 0;
+  this->increments_[1] = this->p_ / 2;
+  this->increments_[2] = this->p_;
+  this->increments_[3] = (1 + this->p_) / 2;
+  this->increments_[4] = 1;
+}
+
+// Places the markers at their desired ranks in the sorted first EXACT_COUNT values
+void P2Quantile::init_markers_() {
+  std::sort(this->samples_, this->samples_ + EXACT_COUNT);
+  for (int i = 0; i < 5; i++) {
+    this->desired_[i] = 1 + (EXACT_COUNT - 1) * this->increments_[i];
+    // Markers must stay on distinct ranks within the samples: above marker i - 1, with room for
+    // the 4 - i markers above
+    float lowest = i > 0 ? this->positions_[i - 1] + 1 : 1;
+    float highest = EXACT_COUNT - (4 - i);
+    this->positions_[i] = std::clamp(std::round(this->desired_[i]), lowest, highest);
+    this->heights_[i] = this->samples_[static_cast<size_t>(this->positions_[i]) - 1];
+  }
+}
+
+void P2Quantile::add(float x) {
+  if (this->count_ < EXACT_COUNT) {
+    this->samples_[this->count_++] = x;
+    if (this->count_ == EXACT_COUNT)
+      this->init_markers_();
+    return;
+  }
+  this->count_++;
+
+  // Cell k containing x, extending the extreme markers if needed
+  int k;
+  if (x < this->heights_[0]) {
+    this->heights_[0] = x;
+    k = 0;
+  } else if (x >= this->heights_[4]) {
+    this->heights_[4] = x;
+    k = 3;
+  } else {
+    k = 0;
+    while (k < 3 && x >= this->heights_[k + 1])
+      k++;
+  }
+
+  for (int i = k + 1; i < 5; i++)
+    this->positions_[i]++;
+  for (int i = 0; i < 5; i++)
+    this->desired_[i] += this->increments_[i];
+
+  // Move the middle markers towards their desired positions
+  for (int i = 1; i < 4; i++) {
+    float d = this->desired_[i] - this->positions_[i];
+    if ((d >= 1 && this->positions_[i + 1] - this->positions_[i] > 1) ||
+        (d <= -1 && this->positions_[i - 1] - this->positions_[i] < -1)) {
+      int sign = d > 0 ? 1 : -1;
+      float height = this->parabolic_(i, sign);
+      if (this->heights_[i - 1] < height && height < this->heights_[i + 1]) {
+        this->heights_[i] = height;
+      } else {
+        this->heights_[i] = this->linear_(i, sign);
+      }
+      this->positions_[i] += sign;
+    }
+  }
+}
+
+float P2Quantile::parabolic_(int i, float d) const {
+  const float *q = this->heights_;
+  const float *n = this->positions_;
+  return q[i] + d / (n[i + 1] - n[i - 1]) *
+                    ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                     (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+float P2Quantile::linear_(int i, int d) const {
+  return this->heights_[i] +
+         d * (this->heights_[i + d] - this->heights_[i]) / (this->positions_[i + d] - this->positions_[i]);
+}
+
+float P2Quantile::value() const {
+  if (this->count_ == 0)
+    return NAN;
+  if (this->count_ > EXACT_COUNT)
+    return this->heights_[2];
+
+  // Nearest rank, as the stock quantile filter
+  float sorted[EXACT_COUNT];
+  std::copy(this->samples_, this->samples_ + this->count_, sorted);
+  std::sort(sorted, sorted + this->count_);
+  size_t position = static_cast<size_t>(std::ceil(this->count_ * this->p_));
+  position = position == 0 ? 0 : std::min<size_t>(position - 1, this->count_ - 1);
+  return sorted[position];
+}
+
+// --- Interval statistics ---
+
+void IntervalStats::setup() {
+  // Raw values: every reading of the source, before its filters thin them out
+  this->source_->add_on_raw_state_callback([this](float value) { this->add(value); });
+}
+
+void IntervalStats::add(float value) {
+  if (this->transform_)
+    value = this->transform_(value);
+  if (std::isnan(value))
+    return;
+
+  // Welford's running mean and sum of squared deviations
+  this->count_++;
+  float delta = value - this->mean_;
+  this->mean_ += delta / this->count_;
+  this->m2_ += delta * (value - this->mean_);
+
+  if (this->count_ == 1 || value < this->min_)
+    this->min_ = value;
+  if (this->count_ == 1 || value > this->max_)
+    this->max_ = value;
+  this->p5_.add(value);
+  this->p95_.add(value);
+}
+
+void IntervalStats::reset() {
+  this->count_ = 0;
+  this->mean_ = 0;
+  this->m2_ = 0;
+  this->min_ = NAN;
+  this->max_ = NAN;
+  this->p5_.reset();
+  this->p95_.reset();
+}
+
+void IntervalStats::append_fields(std::string &fields) {
+  if (this->count_ == 0)
+    return;
+
+  fields += ",mean=" + to_string(this->get_mean());
+  if (this->count_ > 1)
+    fields += ",sd=" + to_string(this->get_sd());
+  fields += ",min=" + to_string(this->get_min());
+  fields += ",max=" + to_string(this->get_max());
+  fields += ",p5=" + to_string(this->get_p5());
+  fields += ",p95=" + to_string(this->get_p95());
+  fields += ",n=" + to_string(this->count_) + "i";
+}
+
+void IntervalStats::dump_config() {
+  ESP_LOGCONFIG(TAG, "Interval Statistics:");
+  ESP_LOGCONFIG(TAG, "  Source: %s", this->source_->get_object_id().c_str());
+  ESP_LOGCONFIG(TAG, "  Transform: %s", this->transform_ ? "YES" : "NO");
+}
+
+}  // namespace interval_stats
+}  // namespace esphome
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/influxdb/influxdb.h"
+
+namespace esphome {
+namespace interval_stats {
+
+/**
+ * @brief P2Quantile
+ *   - P² estimate of one quantile in constant memory (Jain & Chlamtac, 1985): five markers
+ *     whose heights are adjusted with a piecewise-parabolic fit as values arrive.
+ *   - Exact (nearest rank) over the first EXACT_COUNT values, which then seed the markers, so
+ *     short intervals (e.g. ten SHT40 readings) are not left to the five-value start-up.
+ */
+class P2Quantile {
+ public:
+  explicit P2Quantile(float quantile) : p_(quantile) { reset(); }
+
+  void add(float x);
+  float value() const;
+  void reset();
+
+ protected:
+  static constexpr uint32_t EXACT_COUNT = 16;
+
+  float p_;
+  uint32_t count_{0};
+  float samples_[EXACT_COUNT];
+  float heights_[5];
+  float positions_[5];
+  float desired_[5];
+  float increments_[5];
+
+  float parabolic_(int i, float d) const;
+  float linear_(int i, int d) const;
+  void init_markers_();
+};
+
+/**
+ * @brief IntervalStats Component
+ *
+ * Summarises every raw value of a source sensor between two InfluxDB publishes: count, mean and
+ * standard deviation (Welford), min, max and P² estimates of p5 and p95. The statistics are added
+ * as extra fields to the target sensor's line and reset after each publish; no samples are stored.
+ */
+class IntervalStats : public Component, public influxdb::FieldProvider {
+ public:
+  // --- Component lifecycle ---
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  // --- Configuration setters (called by Python codegen) ---
+  void set_source(sensor::Sensor *source) { source_ = source; }
+  // applied to each value before it is added, e.g. the calibration of the target; NaN skips the value
+  void set_transform(std::function<float(float)> &&transform) { transform_ = std::move(transform); }
+
+  // --- influxdb::FieldProvider ---
+  void append_fields(std::string &fields) override;
+  void on_published() override { reset(); }
+
+  // --- Public API ---
+  void add(float value);
+  void reset();
+  uint32_t get_count() const { return count_; }
+  float get_mean() const { return count_ > 0 ? mean_ : NAN; }
+  float get_sd() const { return count_ > 1 ? std::sqrt(m2_ / (count_ - 1)) : NAN; }
+  float get_min() const { return count_ > 0 ? min_ : NAN; }
+  float get_max() const { return count_ > 0 ? max_ : NAN; }
+  float get_p5() const { return count_ > 0 ? p5_.value() : NAN; }
+  float get_p95() const { return count_ > 0 ? p95_.value() : NAN; }
+
+ protected:
+  // --- Configuration ---
+  sensor::Sensor *source_{nullptr};
+  std::function<float(float)> transform_;
+
+  // --- Running statistics ---
+  uint32_t count_{0};
+  float mean_{0};
+  float m2_{0};
+  float min_{NAN};
+  float max_{NAN};
+  P2Quantile p5_{0.05f};
+  P2Quantile p95_{0.95f};
+};
+
+}  // namespace interval_stats
+}  // namespace esphome
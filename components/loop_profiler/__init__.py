@@ -0,0 +1,104 @@
+"""
+Loop Profiler for ESPHome
+- Measures the main loop pass time and counts slow passes.
+- Times the update() of selected polling components and any code marked with PROFILE_SCOPE.
+- Tracks the free, minimum free and largest free block of heap (and PSRAM when present).
+- Publishes diagnostics sensors and logs a per-section table every update_interval.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    CONF_COMPONENTS,
+    CONF_ID,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_TIMER,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_BYTES,
+    UNIT_MILLISECOND,
+)
+
+CODEOWNERS = ["@IEQLab"]
+AUTO_LOAD = ["sensor", "instrumentation"]
+
+# Component namespace and class registration
+loop_profiler_ns = cg.esphome_ns.namespace("loop_profiler")
+LoopProfiler = loop_profiler_ns.class_("LoopProfiler", cg.PollingComponent)
+
+# YAML config options
+CONF_SLOW_LOOP_THRESHOLD = "slow_loop_threshold"
+CONF_LOOP_TIME = "loop_time"
+CONF_SLOW_LOOPS = "slow_loops"
+CONF_HEAP_FREE = "heap_free"
+CONF_HEAP_MIN_FREE = "heap_min_free"
+CONF_HEAP_LARGEST_BLOCK = "heap_largest_block"
+CONF_PSRAM_MIN_FREE = "psram_min_free"
+
+ICON_MEMORY = "mdi:memory"
+ICON_ALERT = "mdi:timer-alert-outline"
+
+
+def heap_sensor_schema():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_BYTES,
+        icon=ICON_MEMORY,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(LoopProfiler),
+        cv.Optional(CONF_SLOW_LOOP_THRESHOLD, default="30ms"): cv.positive_time_period_milliseconds,
+        # polling components whose update() is timed; not those polled by the I²C arbiter
+        cv.Optional(CONF_COMPONENTS, default=[]): cv.ensure_list(cv.use_id(cg.PollingComponent)),
+        # Diagnostics, published every update_interval
+        cv.Optional(CONF_LOOP_TIME): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            icon=ICON_TIMER,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_SLOW_LOOPS): sensor.sensor_schema(
+            icon=ICON_ALERT,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_HEAP_FREE): heap_sensor_schema(),
+        cv.Optional(CONF_HEAP_MIN_FREE): heap_sensor_schema(),
+        cv.Optional(CONF_HEAP_LARGEST_BLOCK): heap_sensor_schema(),
+        cv.Optional(CONF_PSRAM_MIN_FREE): heap_sensor_schema(),
+    }
+).extend(cv.polling_component_schema("300s"))
+
+
+async def to_code(config):
+    """Generate C++ code for the loop profiler."""
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add_define("USE_LOOP_PROFILER")
+
+    cg.add(var.set_slow_loop_threshold(config[CONF_SLOW_LOOP_THRESHOLD]))
+    for component_id in config[CONF_COMPONENTS]:
+        component = await cg.get_variable(component_id)
+        cg.add(var.add_component(component, component_id.id))
+
+    # Optional sensors
+    for key, setter in (
+        (CONF_LOOP_TIME, var.set_loop_time_sensor),
+        (CONF_SLOW_LOOPS, var.set_slow_loops_sensor),
+        (CONF_HEAP_FREE, var.set_heap_free_sensor),
+        (CONF_HEAP_MIN_FREE, var.set_heap_min_free_sensor),
+        (CONF_HEAP_LARGEST_BLOCK, var.set_heap_largest_block_sensor),
+        (CONF_PSRAM_MIN_FREE, var.set_psram_min_free_sensor),
+    ):
+        if sensor_config := config.get(key):
+            sens = await sensor.new_sensor(sensor_config)
+            cg.add(setter(sens))
@@ -0,0 +1,164 @@
+#include "loop_profiler.h"
+#include <algorithm>
+#include <cstring>
+#include "esphome/core/log.h"
+#ifdef USE_I2C_ARBITER
+#include "esphome/components/i2c_arbiter/i2c_arbiter.h"
+#endif
+#include "esphome/components/instrumentation/trace_span.h"
+
+namespace esphome {
+namespace loop_profiler {
+
+static const char *const TAG = "loop_profiler";
+
+LoopProfiler *global_loop_profiler = nullptr;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// --- Histogram ---
+
+void Histogram::record(uint32_t us) {
+  uint8_t bucket = 0;
+  while (bucket < HISTOGRAM_BUCKETS - 1 && us >= HISTOGRAM_EDGES_US[bucket])
+    bucket++;
+  this->buckets[bucket]++;
+  this->count++;
+  this->total_us += us;
+  if (us > this->max_us)
+    this->max_us = us;
+}
+
+uint32_t Histogram::quantile_us(float q) const {
+  if (this->count == 0)
+    return 0;
+  // Rank of the quantile, counted from 1
+  uint32_t rank = static_cast<uint32_t>(q * static_cast<float>(this->count - 1)) + 1;
+  uint32_t seen = 0;
+  for (uint8_t bucket = 0; bucket < HISTOGRAM_BUCKETS - 1; bucket++) {
+    seen += this->buckets[bucket];
+    if (seen >= rank)
+      return std::min(HISTOGRAM_EDGES_US[bucket], this->max_us);
+  }
+  return this->max_us;
+}
+
+// --- LoopProfiler ---
+
+LoopProfiler::LoopProfiler() { global_loop_profiler = this; }
+
+void LoopProfiler::add_component(PollingComponent *component, const char *name) {
+  this->wrapped_.push_back({component, this->section(name)});
+}
+
+Section *LoopProfiler::section(const char *name) {
+  for (auto *section : this->sections_) {
+    if (section->name == name || strcmp(section->name, name) == 0)
+      return section;
+  }
+  auto *section = new Section{};  // NOLINT(cppcoreguidelines-owning-memory)
+  section->name = name;
+  this->sections_.push_back(section);
+  return section;
+}
+
+void LoopProfiler::setup() {
+  for (auto &wrapped : this->wrapped_) {
+#ifdef USE_I2C_ARBITER
+    // The arbiter may set up after us; polling the device here as well would run update() twice
+    if (i2c_arbiter::global_i2c_arbiter != nullptr &&
+        i2c_arbiter::global_i2c_arbiter->is_arbitrated(wrapped.component)) {
+      ESP_LOGW(TAG, "%s is polled by the I2C arbiter, its update() is not wrapped", wrapped.section->name);
+      continue;
+    }
+#endif
+    uint32_t interval = wrapped.component->get_update_interval();
+    if (interval == SCHEDULER_DONT_RUN) {
+      // update_interval: never, or already polled by something else
+      ESP_LOGW(TAG, "%s is not polled by the scheduler, its update() is not wrapped", wrapped.section->name);
+      continue;
+    }
+    // Take over the polling: the component keeps its interval but its own poller never starts
+    wrapped.component->set_update_interval(SCHEDULER_DONT_RUN);
+    this->set_interval(wrapped.section->name, interval, [&wrapped]() {
+      if (wrapped.component->is_failed())
+        return;
+      ScopedProfile profile(wrapped.section);
+      TRACE_SPAN_NAMED("sensor.update", wrapped.section->name);
+      wrapped.component->update();
+    });
+  }
+  this->has_psram_ = heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+}
+
+void LoopProfiler::loop() {
+  uint32_t now = micros();
+  uint32_t elapsed = now - this->last_loop_us_;
+  bool first = this->last_loop_us_ == 0;  // the first pass would include the setup of later components
+  this->last_loop_us_ = now;
+  if (first)
+    return;
+  this->loop_time_.record(elapsed);
+  if (elapsed >= this->slow_loop_threshold_us_)
+    this->slow_loops_++;
+}
+
+void LoopProfiler::update() {
+  if (this->loop_time_sensor_ != nullptr)
+    this->loop_time_sensor_->publish_state(this->loop_time_.max_us / 1000.0f);
+  if (this->slow_loops_sensor_ != nullptr)
+    this->slow_loops_sensor_->publish_state(this->slow_loops_);
+  if (this->heap_free_sensor_ != nullptr)
+    this->heap_free_sensor_->publish_state(heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+  if (this->heap_min_free_sensor_ != nullptr)
+    this->heap_min_free_sensor_->publish_state(heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+  if (this->heap_largest_block_sensor_ != nullptr)
+    this->heap_largest_block_sensor_->publish_state(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+  if (this->psram_min_free_sensor_ != nullptr && this->has_psram_)
+    this->psram_min_free_sensor_->publish_state(heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+
+  this->dump_statistics_();
+
+  // Start a new window
+  this->loop_time_.reset();
+  this->slow_loops_ = 0;
+  for (auto *section : this->sections_)
+    section->reset();
+}
+
+void LoopProfiler::dump_statistics_() {
+  ESP_LOGI(TAG, "Loop: %u passes, p99 <= %u us, max %u us, %u slow; heap free %u, min %u, largest block %u",
+           this->loop_time_.count, this->loop_time_.quantile_us(0.99f), this->loop_time_.max_us, this->slow_loops_,
+           static_cast<uint32_t>(heap_caps_get_free_size(MALLOC_CAP_INTERNAL)),
+           static_cast<uint32_t>(heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL)),
+           static_cast<uint32_t>(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL)));
+  if (this->has_psram_)
+    ESP_LOGI(TAG, "PSRAM: free %u, min %u", static_cast<uint32_t>(heap_caps_get_free_size(MALLOC_CAP_SPIRAM)),
+             static_cast<uint32_t>(heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM)));
+
+  for (auto *section : this->sections_) {
+    const Histogram &time = section->time;
+    if (time.count == 0)
+      continue;
+    ESP_LOGI(TAG, "  %-20s %6u calls, mean %6u us, p99 <= %6u us, max %6u us, heap %6d B  [%u %u %u %u %u %u %u %u]",
+             section->name, time.count, static_cast<uint32_t>(time.total_us / time.count), time.quantile_us(0.99f),
+             time.max_us, section->worst_heap_delta, time.buckets[0], time.buckets[1], time.buckets[2],
+             time.buckets[3], time.buckets[4], time.buckets[5], time.buckets[6], time.buckets[7]);
+  }
+}
+
+void LoopProfiler::dump_config() {
+  ESP_LOGCONFIG(TAG, "Loop Profiler:");
+  ESP_LOGCONFIG(TAG, "  Slow loop threshold: %u ms", this->slow_loop_threshold_us_ / 1000);
+  ESP_LOGCONFIG(TAG, "  PSRAM: %s", YESNO(this->has_psram_));
+  for (auto &wrapped : this->wrapped_)
+    ESP_LOGCONFIG(TAG, "  Wrapped update(): %s", wrapped.section->name);
+  LOG_UPDATE_INTERVAL(this);
+  LOG_SENSOR("  ", "Loop Time", this->loop_time_sensor_);
+  LOG_SENSOR("  ", "Slow Loops", this->slow_loops_sensor_);
+  LOG_SENSOR("  ", "Heap Free", this->heap_free_sensor_);
+  LOG_SENSOR("  ", "Heap Min Free", this->heap_min_free_sensor_);
+  LOG_SENSOR("  ", "Heap Largest Block", this->heap_largest_block_sensor_);
+  LOG_SENSOR("  ", "PSRAM Min Free", this->psram_min_free_sensor_);
+}
+
+}  // namespace loop_profiler
+}  // namespace esphome
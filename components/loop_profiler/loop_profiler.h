@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esp_heap_caps.h"
+
+namespace esphome {
+namespace loop_profiler {
+
+// --- Histogram ---
+// Fixed log-spaced buckets: no allocation, one compare chain per sample
+static constexpr uint8_t HISTOGRAM_BUCKETS = 8;
+static constexpr uint32_t HISTOGRAM_EDGES_US[HISTOGRAM_BUCKETS - 1] = {100, 500, 1000, 5000, 10000, 30000, 100000};
+
+struct Histogram {
+  uint32_t buckets[HISTOGRAM_BUCKETS]{};
+  uint32_t count{0};
+  uint64_t total_us{0};
+  uint32_t max_us{0};
+
+  void record(uint32_t us);
+  void reset() { *this = Histogram{}; }
+  // Upper edge of the bucket holding the given quantile; max_us for the last bucket
+  uint32_t quantile_us(float q) const;
+};
+
+// A named piece of code timed with PROFILE_SCOPE, or the update() of a wrapped component
+struct Section {
+  const char *name;
+  Histogram time;
+  int32_t worst_heap_delta{0};  // largest drop of free internal heap across one call (bytes, <= 0)
+
+  void record(uint32_t us, int32_t heap_delta) {
+    this->time.record(us);
+    if (heap_delta < this->worst_heap_delta)
+      this->worst_heap_delta = heap_delta;
+  }
+  void reset() {
+    this->time.reset();
+    this->worst_heap_delta = 0;
+  }
+};
+
+/**
+ * @brief LoopProfiler
+ *   - Measures each pass of the main loop (the time between two calls of its own loop()), so
+ *     stalls caused by any component show up, and counts passes above slow_loop_threshold.
+ *   - Wraps the update() of selected polling components: like the I²C arbiter it takes over
+ *     their poller and calls update() itself, timed, at the configured update_interval.
+ *     Devices registered with the arbiter are left to it, with a warning.
+ *   - Times any block of main loop code marked with PROFILE_SCOPE("name").
+ *   - Every timed call also records the change in free internal heap, so a section that
+ *     allocates is visible next to one that is slow.
+ *   - Tracks free, minimum free and largest free block of internal heap and, when present,
+ *     the minimum free PSRAM.
+ *   - Every update_interval publishes the diagnostics sensors and logs a table of all sections
+ *     (calls, mean, p99 bucket, worst case, worst heap delta), then starts a new window.
+ *
+ * Histograms use fixed buckets (<100 µs ... >=100 ms); the p99 is the upper edge of its bucket.
+ * A pass shorter than the application's loop_interval (16 ms) is padded by its sleep, so only
+ * passes above that are time spent in components. Sections and wrapped updates are main loop
+ * only: nothing here is locked.
+ */
+class LoopProfiler : public PollingComponent {
+ public:
+  LoopProfiler();
+
+  // --- Configurable setters called by Python codegen ---
+  void add_component(PollingComponent *component, const char *name);
+  void set_slow_loop_threshold(uint32_t threshold) { slow_loop_threshold_us_ = threshold * 1000; }
+  void set_loop_time_sensor(sensor::Sensor *sensor) { loop_time_sensor_ = sensor; }
+  void set_slow_loops_sensor(sensor::Sensor *sensor) { slow_loops_sensor_ = sensor; }
+  void set_heap_free_sensor(sensor::Sensor *sensor) { heap_free_sensor_ = sensor; }
+  void set_heap_min_free_sensor(sensor::Sensor *sensor) { heap_min_free_sensor_ = sensor; }
+  void set_heap_largest_block_sensor(sensor::Sensor *sensor) { heap_largest_block_sensor_ = sensor; }
+  void set_psram_min_free_sensor(sensor::Sensor *sensor) { psram_min_free_sensor_ = sensor; }
+
+  // --- Public API ---
+  // Section with the given name, created on first use; the pointer stays valid for the lifetime
+  // of the profiler. name must be a string literal (it is not copied).
+  Section *section(const char *name);
+
+  // --- Component interface ---
+  void setup() override;
+  void loop() override;
+  void update() override;
+  void dump_config() override;
+  // before the wrapped components, so their pollers are never started
+  float get_setup_priority() const override { return setup_priority::IO; }
+
+ protected:
+  struct Wrapped {
+    PollingComponent *component;
+    Section *section;
+  };
+
+  // --- User options with sensible defaults ---
+  uint32_t slow_loop_threshold_us_{30000};
+  std::vector<Wrapped> wrapped_;
+
+  // --- Optional sensors ---
+  sensor::Sensor *loop_time_sensor_{nullptr};
+  sensor::Sensor *slow_loops_sensor_{nullptr};
+  sensor::Sensor *heap_free_sensor_{nullptr};
+  sensor::Sensor *heap_min_free_sensor_{nullptr};
+  sensor::Sensor *heap_largest_block_sensor_{nullptr};
+  sensor::Sensor *psram_min_free_sensor_{nullptr};
+
+  // --- Statistics since the last update() ---
+  std::vector<Section *> sections_;  // never freed, PROFILE_SCOPE keeps pointers in statics
+  Histogram loop_time_;
+  uint32_t slow_loops_{0};
+  uint32_t last_loop_us_{0};
+  bool has_psram_{false};
+
+  // --- Helper methods ---
+  void dump_statistics_();
+};
+
+extern LoopProfiler *global_loop_profiler;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Times its own lifetime into a section; a null section (no profiler) records nothing
+class ScopedProfile {
+ public:
+  explicit ScopedProfile(Section *section) : section_(section) {
+    if (section_ == nullptr)
+      return;
+    heap_ = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    start_us_ = micros();
+  }
+  ~ScopedProfile() {
+    if (section_ == nullptr)
+      return;
+    uint32_t elapsed = micros() - start_us_;
+    section_->record(elapsed, static_cast<int32_t>(heap_caps_get_free_size(MALLOC_CAP_INTERNAL) - heap_));
+  }
+  ScopedProfile(const ScopedProfile &) = delete;
+  ScopedProfile &operator=(const ScopedProfile &) = delete;
+
+ protected:
+  Section *section_;
+  size_t heap_{0};
+  uint32_t start_us_{0};
+};
+
+}  // namespace loop_profiler
+}  // namespace esphome
+
+// Times the rest of the enclosing scope as the named section. The section is looked up once per
+// call site. Components use it through instrumentation/profile_scope.h, which includes this header
+// when the profiler is configured.
+#define PROFILE_SCOPE_CONCAT_(a, b) a##b
+#define PROFILE_SCOPE_NAME_(a, b) PROFILE_SCOPE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) \
+  static ::esphome::loop_profiler::Section *const PROFILE_SCOPE_NAME_(profile_section_, __LINE__) = \
+      ::esphome::loop_profiler::global_loop_profiler != nullptr \
+          ? ::esphome::loop_profiler::global_loop_profiler->section(name) \
+          : nullptr; \
+  ::esphome::loop_profiler::ScopedProfile PROFILE_SCOPE_NAME_(profile_scope_, __LINE__)( \
+      PROFILE_SCOPE_NAME_(profile_section_, __LINE__))
@@ -0,0 +1,46 @@
+"""
+Local Metrics Endpoint for ESPHome
+- Serves the latest sample in Prometheus text format (/metrics) and as JSON (/metrics.json).
+- Series names and tags follow the influxdb component's sensor_names and global_tags.
+- Rendered once per sample snapshot; requests send the shared buffer without re-serializing.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import web_server_base
+from esphome.components.influxdb import InfluxDB
+from esphome.components.sample_snapshot import SampleSnapshot
+from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
+from esphome.const import CONF_ID
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["influxdb", "sample_snapshot", "network"]
+AUTO_LOAD = ["web_server_base"]
+
+CONF_INFLUXDB_ID = "influxdb_id"
+CONF_SNAPSHOT_ID = "snapshot_id"
+CONF_PREFIX = "prefix"
+
+metrics_ns = cg.esphome_ns.namespace("metrics")
+MetricsEndpoint = metrics_ns.class_("MetricsEndpoint", cg.Component)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(MetricsEndpoint),
+    cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+    cv.GenerateID(CONF_INFLUXDB_ID): cv.use_id(InfluxDB),
+    cv.GenerateID(CONF_SNAPSHOT_ID): cv.use_id(SampleSnapshot),
+    # prepended to the InfluxDB measurement names for the Prometheus metric names
+    cv.Optional(CONF_PREFIX, default="samba_"): cv.string,
+}).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    base = await cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
+    var = cg.new_Pvariable(config[CONF_ID], base)
+    await cg.register_component(var, config)
+
+    influx = await cg.get_variable(config[CONF_INFLUXDB_ID])
+    cg.add(var.set_influxdb(influx))
+    snapshot = await cg.get_variable(config[CONF_SNAPSHOT_ID])
+    cg.add(var.set_snapshot(snapshot))
+    cg.add(var.set_prefix(config[CONF_PREFIX]))
@@ -0,0 +1,247 @@
+#include "metrics.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <esp_http_server.h>
+
+#include <cmath>
+#include <cstdio>
+
+namespace esphome {
+namespace metrics {
+
+static const char *const TAG = "metrics";
+
+// Prometheus metric names: [a-zA-Z_:][a-zA-Z0-9_:]*
+static std::string metric_name(const std::string &prefix, const std::string &measurement) {
+  std::string name = prefix + measurement;
+  for (size_t i = 0; i < name.size(); i++) {
+    char c = name[i];
+    bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' ||
+                 (i > 0 && c >= '0' && c <= '9');
+    if (!valid)
+      name[i] = '_';
+  }
+  return name;
+}
+
+// Prometheus label names: [a-zA-Z_][a-zA-Z0-9_]*, no ':' unlike metric names
+static std::string label_name(const std::string &key) {
+  std::string name = key.empty() ? "_" : key;
+  for (size_t i = 0; i < name.size(); i++) {
+    char c = name[i];
+    bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (i > 0 && c >= '0' && c <= '9');
+    if (!valid)
+      name[i] = '_';
+  }
+  return name;
+}
+
+// Prometheus label values only escape \, " and newlines; other characters are taken as they are
+static void append_label_value(std::string &out, const std::string &value) {
+  out += '"';
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      out += '\\';
+      out += c;
+    } else if (c == '\n') {
+      out += "\\n";
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+// JSON strings escape \, " and every control character
+static void append_json_string(std::string &out, const std::string &value) {
+  out += '"';
+  for (char c : value) {
+    switch (c) {
+      case '\\':
+      case '"':
+        out += '\\';
+        out += c;
+        break;
+      case '\b':
+        out += "\\b";
+        break;
+      case '\f':
+        out += "\\f";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escape[8];
+          snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+          out += escape;
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+
+static void append_value(std::string &out, float value) {
+  char number[24];
+  snprintf(number, sizeof(number), "%.6g", value);
+  out += number;
+}
+
+// Value from the snapshot, or the current state for mapped sensors outside it (as InfluxDB does)
+static float value_of(const sample_snapshot::Snapshot &snapshot, sensor::Sensor *sensor) {
+  const auto *reading = snapshot.find(sensor);
+  return reading != nullptr ? reading->value : sensor->state;
+}
+
+void MetricsEndpoint::setup() {
+  this->snapshot_->add_on_snapshot_callback([this](const sample_snapshot::Snapshot &snapshot) {
+    this->render(snapshot);
+  });
+  this->base_->init();
+  this->base_->add_handler(this);
+}
+
+void MetricsEndpoint::render(const sample_snapshot::Snapshot &snapshot) {
+  Buffer prometheus = std::make_shared<const std::string>(this->render_prometheus_(snapshot));
+  Buffer json = std::make_shared<const std::string>(this->render_json_(snapshot));
+  this->prometheus_capacity_ = prometheus->size();
+  this->json_capacity_ = json->size();
+
+  // In-flight requests keep the previous buffers alive until they have been sent
+  std::lock_guard<std::mutex> guard(this->lock_);
+  this->prometheus_.swap(prometheus);
+  this->json_.swap(json);
+}
+
+std::string MetricsEndpoint::render_prometheus_(const sample_snapshot::Snapshot &snapshot) const {
+  struct Series {
+    std::string name;
+    std::string sensor_id;
+    float value;
+  };
+  std::vector<Series> series;
+  for (auto *sensor : this->influxdb_->get_sensors()) {
+    float value = value_of(snapshot, sensor);
+    if (std::isnan(value))
+      continue;
+    std::string sensor_id = sensor->get_object_id();
+    std::string name = metric_name(this->prefix_, this->influxdb_->get_measurement_name(sensor_id));
+    series.push_back({std::move(name), std::move(sensor_id), value});
+  }
+
+  // Sensors may share a measurement; a metric's series follow its single # TYPE line, metrics in
+  // the order they first appear
+  std::string out;
+  out.reserve(this->prometheus_capacity_ + 64);
+  std::vector<bool> written(series.size(), false);
+  for (size_t first = 0; first < series.size(); first++) {
+    if (written[first])
+      continue;
+    out += "# TYPE " + series[first].name + " gauge\n";
+    for (size_t i = first; i < series.size(); i++) {
+      if (written[i] || series[i].name != series[first].name)
+        continue;
+      written[i] = true;
+      out += series[i].name;
+      const auto tags = this->influxdb_->get_tags(series[i].sensor_id);
+      if (!tags.empty()) {
+        out += '{';
+        for (size_t t = 0; t < tags.size(); t++) {
+          if (t > 0)
+            out += ',';
+          out += label_name(tags[t].first);
+          out += '=';
+          append_label_value(out, tags[t].second);
+        }
+        out += '}';
+      }
+      out += ' ';
+      append_value(out, series[i].value);
+      out += '\n';
+    }
+  }
+  if (snapshot.timestamp != 0) {
+    std::string name = metric_name(this->prefix_, "sample_timestamp_seconds");
+    out += "# TYPE " + name + " gauge\n" + name + " " + to_string(snapshot.timestamp) + "\n";
+  }
+  return out;
+}
+
+// {"timestamp":1760000000,"series":[{"measurement":"air_temp","tags":{...},"value":22.5},...]}
+std::string MetricsEndpoint::render_json_(const sample_snapshot::Snapshot &snapshot) const {
+  std::string out;
+  out.reserve(this->json_capacity_ + 64);
+  out += "{\"timestamp\":";
+  out += snapshot.timestamp != 0 ? to_string(snapshot.timestamp) : "null";
+  out += ",\"series\":[";
+  bool first = true;
+  for (auto *sensor : this->influxdb_->get_sensors()) {
+    float value = value_of(snapshot, sensor);
+    if (std::isnan(value))
+      continue;
+    const std::string &sensor_id = sensor->get_object_id();
+    if (!first)
+      out += ',';
+    first = false;
+    out += "{\"measurement\":";
+    append_json_string(out, this->influxdb_->get_measurement_name(sensor_id));
+    out += ",\"tags\":{";
+    const auto tags = this->influxdb_->get_tags(sensor_id);
+    for (size_t i = 0; i < tags.size(); i++) {
+      if (i > 0)
+        out += ',';
+      append_json_string(out, tags[i].first);
+      out += ':';
+      append_json_string(out, tags[i].second);
+    }
+    out += "},\"value\":";
+    append_value(out, value);
+    out += '}';
+  }
+  out += "]}";
+  return out;
+}
+
+bool MetricsEndpoint::canHandle(AsyncWebServerRequest *request) const {
+  if (request->method() != HTTP_GET)
+    return false;
+  const std::string url = request->url();
+  return url == "/metrics" || url == "/metrics.json";
+}
+
+void MetricsEndpoint::handleRequest(AsyncWebServerRequest *request) {
+  const bool json = request->url() == "/metrics.json";
+  Buffer body;
+  {
+    std::lock_guard<std::mutex> guard(this->lock_);
+    body = json ? this->json_ : this->prometheus_;
+  }
+  if (body == nullptr) {
+    request->send(503, "text/plain", "No sample yet");
+    return;
+  }
+
+  // Sent straight from the shared buffer
+  httpd_req_t *req = *request;
+  httpd_resp_set_type(req, json ? "application/json" : "text/plain; version=0.0.4");
+  httpd_resp_send(req, body->data(), body->size());
+}
+
+void MetricsEndpoint::dump_config() {
+  ESP_LOGCONFIG(TAG, "Metrics Endpoint:");
+  ESP_LOGCONFIG(TAG, "  Paths: /metrics, /metrics.json");
+  ESP_LOGCONFIG(TAG, "  Prefix: %s", this->prefix_.c_str());
+}
+
+}  // namespace metrics
+}  // namespace esphome
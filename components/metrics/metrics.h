@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "esphome/core/component.h"
+#include "esphome/components/influxdb/influxdb.h"
+#include "esphome/components/sample_snapshot/sample_snapshot.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+
+namespace esphome {
+namespace metrics {
+
+/**
+ * @brief MetricsEndpoint Component
+ *
+ * Serves the latest sample to local pollers (Prometheus, BMS) without going through Home Assistant
+ * or InfluxDB:
+ *   GET /metrics       Prometheus text exposition format, one gauge per InfluxDB measurement
+ *   GET /metrics.json  the same values and tags as JSON
+ *
+ * Both bodies are rendered once per sample snapshot, with the series names and tags of the influxdb
+ * component, into immutable buffers that are swapped in under a mutex. A request only takes a
+ * reference to the current buffer and sends it as is; nothing is serialized or copied per request.
+ */
+class MetricsEndpoint : public Component, public AsyncWebHandler {
+ public:
+  explicit MetricsEndpoint(web_server_base::WebServerBase *base) : base_(base) {}
+
+  // --- Component lifecycle ---
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::WIFI - 1.0f; }
+
+  // --- Configuration setters (called by Python codegen) ---
+  void set_influxdb(influxdb::InfluxDB *influxdb) { influxdb_ = influxdb; }
+  void set_snapshot(sample_snapshot::SampleSnapshot *snapshot) { snapshot_ = snapshot; }
+  void set_prefix(const std::string &prefix) { prefix_ = prefix; }
+
+  // --- Public API ---
+  void render(const sample_snapshot::Snapshot &snapshot);
+
+  // --- AsyncWebHandler ---
+  bool canHandle(AsyncWebServerRequest *request) const override;
+  void handleRequest(AsyncWebServerRequest *request) override;
+
+ protected:
+  using Buffer = std::shared_ptr<const std::string>;
+
+  // --- Configuration ---
+  web_server_base::WebServerBase *base_;
+  influxdb::InfluxDB *influxdb_{nullptr};
+  sample_snapshot::SampleSnapshot *snapshot_{nullptr};
+  std::string prefix_{"samba_"};
+
+  // --- Rendered bodies (the web server runs in its own task) ---
+  std::mutex lock_;
+  Buffer prometheus_;
+  Buffer json_;
+  size_t prometheus_capacity_{512};  // previous sizes, to reserve once per render
+  size_t json_capacity_{512};
+
+  std::string render_prometheus_(const sample_snapshot::Snapshot &snapshot) const;
+  std::string render_json_(const sample_snapshot::Snapshot &snapshot) const;
+};
+
+}  // namespace metrics
+}  // namespace esphome
@@ -0,0 +1,94 @@
+"""
+Sensor Readiness for ESPHome
+- Tracks per source the valid states received since boot and a warm-up time.
+- Fires on_ready once all sources are ready (or after a timeout) and reports the time it took.
+- readiness.is_ready condition, e.g. to hold back sampling until then.
+"""
+
+from esphome import automation
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    CONF_ID,
+    CONF_SENSOR,
+    CONF_TIMEOUT,
+    CONF_TRIGGER_ID,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_TIMER,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_SECOND,
+)
+
+CODEOWNERS = ["@IEQLab"]
+AUTO_LOAD = ["sensor"]
+
+CONF_SOURCES = "sources"
+CONF_MIN_SAMPLES = "min_samples"
+CONF_WARMUP = "warmup"
+CONF_TIME_TO_READY = "time_to_ready"
+CONF_ON_READY = "on_ready"
+
+readiness_ns = cg.esphome_ns.namespace("readiness")
+Readiness = readiness_ns.class_("Readiness", cg.Component)
+ReadyTrigger = readiness_ns.class_("ReadyTrigger", automation.Trigger.template())
+IsReadyCondition = readiness_ns.class_("IsReadyCondition", automation.Condition)
+
+SOURCE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        # valid states needed; a median filter only publishes once send_first_at is reached
+        cv.Optional(CONF_MIN_SAMPLES, default=1): cv.positive_not_null_int,
+        # time since boot before the readings are meaningful
+        cv.Optional(CONF_WARMUP, default="0s"): cv.positive_time_period_milliseconds,
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(Readiness),
+    cv.Required(CONF_SOURCES): cv.All(cv.ensure_list(SOURCE_SCHEMA), cv.Length(min=1)),
+    # ready anyway after this, so a failed sensor does not hold back the others
+    cv.Optional(CONF_TIMEOUT, default="10min"): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_TIME_TO_READY): sensor.sensor_schema(
+        unit_of_measurement=UNIT_SECOND,
+        icon=ICON_TIMER,
+        accuracy_decimals=1,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_ON_READY): automation.validate_automation(
+        {
+            cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(ReadyTrigger),
+        }
+    ),
+}).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    for source in config[CONF_SOURCES]:
+        sens = await cg.get_variable(source[CONF_SENSOR])
+        cg.add(var.add_source(sens, source[CONF_SENSOR].id, source[CONF_MIN_SAMPLES], source[CONF_WARMUP]))
+    cg.add(var.set_timeout(config[CONF_TIMEOUT]))
+
+    if time_to_ready_config := config.get(CONF_TIME_TO_READY):
+        sens = await sensor.new_sensor(time_to_ready_config)
+        cg.add(var.set_time_to_ready_sensor(sens))
+
+    for conf in config.get(CONF_ON_READY, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [], conf)
+
+
+@automation.register_condition(
+    "readiness.is_ready",
+    IsReadyCondition,
+    automation.maybe_simple_id({cv.GenerateID(): cv.use_id(Readiness)}),
+)
+async def readiness_is_ready_to_code(config, condition_id, template_arg, args):
+    paren = await cg.get_variable(config[CONF_ID])
+    return cg.new_Pvariable(condition_id, template_arg, paren)
@@ -0,0 +1,72 @@
+#include "readiness.h"
+#include <cmath>
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace readiness {
+
+static const char *const TAG = "readiness";
+
+void Readiness::setup() {
+  for (size_t i = 0; i < this->sources_.size(); i++) {
+    this->sources_[i].sensor->add_on_state_callback([this, i](float state) {
+      if (std::isnan(state) || this->ready_)
+        return;
+      Source &source = this->sources_[i];
+      source.samples++;
+      this->check_source_(source, millis());
+    });
+  }
+}
+
+void Readiness::loop() {
+  // Runs until ready: warm-up times and the timeout pass without any new state
+  uint32_t now = millis();
+  bool all_ready = true;
+  for (auto &source : this->sources_)
+    all_ready &= this->check_source_(source, now);
+
+  if (all_ready) {
+    this->set_ready_(now, false);
+  } else if (now >= this->timeout_ms_) {
+    for (auto &source : this->sources_) {
+      if (source.ready_time == 0)
+        ESP_LOGW(TAG, "'%s' not ready after %u ms (%u samples)", source.name, this->timeout_ms_, source.samples);
+    }
+    this->set_ready_(now, true);
+  }
+}
+
+bool Readiness::check_source_(Source &source, uint32_t now) {
+  if (source.ready_time != 0)
+    return true;
+  if (source.samples < source.min_samples || now < source.warmup_ms)
+    return false;
+  source.ready_time = now;
+  ESP_LOGD(TAG, "'%s' ready after %u ms", source.name, now);
+  return true;
+}
+
+void Readiness::set_ready_(uint32_t now, bool timed_out) {
+  this->ready_ = true;
+  this->ready_time_ = now;
+  this->disable_loop();
+  ESP_LOGI(TAG, "Ready after %.1f s%s", now / 1000.0f, timed_out ? " (timed out)" : "");
+  if (this->time_to_ready_sensor_ != nullptr)
+    this->time_to_ready_sensor_->publish_state(now / 1000.0f);
+  this->on_ready_callback_.call();
+}
+
+void Readiness::dump_config() {
+  ESP_LOGCONFIG(TAG, "Readiness:");
+  ESP_LOGCONFIG(TAG, "  Timeout: %u ms", this->timeout_ms_);
+  for (const auto &source : this->sources_) {
+    ESP_LOGCONFIG(TAG, "  Source '%s': min samples %u, warm-up %u ms", source.name, source.min_samples,
+                  source.warmup_ms);
+  }
+  LOG_SENSOR("  ", "Time To Ready", this->time_to_ready_sensor_);
+}
+
+}  // namespace readiness
+}  // namespace esphome
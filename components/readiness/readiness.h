@@ -0,0 +1,91 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "esphome/core/automation.h"
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/sensor/sensor.h"
+
+namespace esphome {
+namespace readiness {
+
+/**
+ * @brief Readiness Component
+ *
+ * Tracks when each source sensor has produced usable data after boot, so the first sample can be
+ * taken as soon as everything is valid instead of after a fixed uptime:
+ *   - a source counts its valid (non-NaN) states; for filtered sensors (median, streaming_median)
+ *     the first state already means send_first_at was reached
+ *   - it is ready once it has min_samples of them and warmup has passed since boot (e.g. the K30,
+ *     PMS fan and SGP4x gas index algorithm need time before their first readings are meaningful);
+ *     warmup is a configured time, the stock pmsx003 and sgp4x drivers report no warm-up state
+ *   - once all sources are ready, or timeout has passed with some still pending (a failed sensor
+ *     must not hold back the others), on_ready fires once and the time since boot is published
+ */
+class Readiness : public Component {
+ public:
+  // --- Component lifecycle ---
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  // --- Public API ---
+  bool is_ready() const { return ready_; }
+  // millis() when the component became ready, 0 while it is not
+  uint32_t get_ready_time() const { return ready_time_; }
+  void add_on_ready_callback(std::function<void()> &&callback) { on_ready_callback_.add(std::move(callback)); }
+
+  // --- Configuration setters (called by Python codegen) ---
+  // name is the sensor id, for the log (internal sensors usually have no name)
+  void add_source(sensor::Sensor *sensor, const char *name, uint32_t min_samples, uint32_t warmup) {
+    sources_.push_back({sensor, name, min_samples, warmup, 0, 0});
+  }
+  void set_timeout(uint32_t timeout) { timeout_ms_ = timeout; }
+  void set_time_to_ready_sensor(sensor::Sensor *sensor) { time_to_ready_sensor_ = sensor; }
+
+ protected:
+  struct Source {
+    sensor::Sensor *sensor;
+    const char *name;
+    uint32_t min_samples;
+    uint32_t warmup_ms;       // since boot
+    uint32_t samples;         // valid states received
+    uint32_t ready_time;      // millis() when the source became ready, 0 while it is not
+  };
+
+  // --- Configuration ---
+  std::vector<Source> sources_;
+  uint32_t timeout_ms_{600000};
+  sensor::Sensor *time_to_ready_sensor_{nullptr};
+
+  // --- Runtime state ---
+  bool ready_{false};
+  uint32_t ready_time_{0};
+  CallbackManager<void()> on_ready_callback_;
+
+  // --- Helper methods ---
+  bool check_source_(Source &source, uint32_t now);
+  void set_ready_(uint32_t now, bool timed_out);
+};
+
+class ReadyTrigger : public Trigger<> {
+ public:
+  explicit ReadyTrigger(Readiness *parent) {
+    parent->add_on_ready_callback([this]() { this->trigger(); });
+  }
+};
+
+template<typename... Ts> class IsReadyCondition : public Condition<Ts...> {
+ public:
+  explicit IsReadyCondition(Readiness *parent) : parent_(parent) {}
+  bool check(Ts... x) override { return this->parent_->is_ready(); }
+
+ protected:
+  Readiness *parent_;
+};
+
+}  // namespace readiness
+}  // namespace esphome
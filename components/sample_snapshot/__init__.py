@@ -0,0 +1,52 @@
+"""
+Sample Snapshot for ESPHome
+- Updates a list of sensors in order and copies their states into one timestamped struct.
+- The snapshot is handed to consumers (e.g. InfluxDB) within the same main loop tick.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor, time
+from esphome.const import CONF_ID, CONF_SENSOR
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["time"]
+AUTO_LOAD = ["sensor", "instrumentation"]
+
+CONF_TIME_ID = "time_id"
+CONF_SOURCES = "sources"
+CONF_UPDATE = "update"
+
+sample_snapshot_ns = cg.esphome_ns.namespace("sample_snapshot")
+SampleSnapshot = sample_snapshot_ns.class_("SampleSnapshot", cg.Component)
+
+SOURCE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        # call update() before reading, e.g. for template sensors with update_interval: never;
+        # the sensor must then also be a PollingComponent
+        cv.Optional(CONF_UPDATE, default=True): cv.boolean,
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(SampleSnapshot),
+    cv.Optional(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+    cv.Required(CONF_SOURCES): cv.All(cv.ensure_list(SOURCE_SCHEMA), cv.Length(min=1)),
+}).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add_define("USE_SAMPLE_SNAPSHOT")
+
+    # Time component (optional)
+    if CONF_TIME_ID in config:
+        time_ = await cg.get_variable(config[CONF_TIME_ID])
+        cg.add(var.set_time_source(time_))
+
+    # Sources, in update order
+    for source in config[CONF_SOURCES]:
+        sens = await cg.get_variable(source[CONF_SENSOR])
+        cg.add(var.add_source(sens, sens if source[CONF_UPDATE] else cg.nullptr))
@@ -0,0 +1,65 @@
+#include "sample_snapshot.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/instrumentation/trace_span.h"
+
+namespace esphome {
+namespace sample_snapshot {
+
+static const char *const TAG = "sample_snapshot";
+
+const Reading *Snapshot::find(const sensor::Sensor *sensor) const {
+  for (const auto &reading : this->readings) {
+    if (reading.sensor == sensor)
+      return &reading;
+  }
+  return nullptr;
+}
+
+void SampleSnapshot::setup() {
+  // Allocate once; capture() only overwrites values
+  this->snapshot_.readings.reserve(this->sources_.size());
+  for (const auto &source : this->sources_)
+    this->snapshot_.readings.push_back({source.sensor, NAN});
+}
+
+const Snapshot &SampleSnapshot::capture() {
+#ifdef USE_TRACE
+  if (trace::global_trace != nullptr)
+    trace::global_trace->begin_sample();
+#endif
+  TRACE_SPAN("sample.snapshot");
+  // Update in configuration order, e.g. radiant temperature after globe temperature and air speed
+  for (const auto &source : this->sources_) {
+    if (source.updater != nullptr) {
+      TRACE_SPAN_NAMED("sensor.update", source.updater->get_component_source());
+      source.updater->update();
+    }
+  }
+
+  this->snapshot_.uptime_ms = millis();
+  this->snapshot_.timestamp = 0;
+  if (this->time_source_ != nullptr) {
+    auto now = this->time_source_->now();
+    if (now.is_valid())
+      this->snapshot_.timestamp = now.timestamp;
+  }
+  for (size_t i = 0; i < this->sources_.size(); i++)
+    this->snapshot_.readings[i].value = this->sources_[i].sensor->state;
+
+  ESP_LOGD(TAG, "Captured %u readings", static_cast<unsigned>(this->snapshot_.readings.size()));
+  this->on_snapshot_callback_.call(this->snapshot_);
+  return this->snapshot_;
+}
+
+void SampleSnapshot::dump_config() {
+  ESP_LOGCONFIG(TAG, "Sample Snapshot:");
+  ESP_LOGCONFIG(TAG, "  Time source: %s", this->time_source_ != nullptr ? "YES" : "NO");
+  for (const auto &source : this->sources_) {
+    ESP_LOGCONFIG(TAG, "  Source: %s%s", source.sensor->get_object_id().c_str(),
+                  source.updater != nullptr ? " (updated)" : "");
+  }
+}
+
+}  // namespace sample_snapshot
+}  // namespace esphome
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <ctime>
+#include <functional>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/time/real_time_clock.h"
+
+namespace esphome {
+namespace sample_snapshot {
+
+/**
+ * @brief One value per source, all taken in the same main loop tick
+ */
+struct Reading {
+  sensor::Sensor *sensor;
+  float value;
+};
+
+struct Snapshot {
+  uint32_t uptime_ms{0};   // millis() when the snapshot was taken
+  time_t timestamp{0};     // epoch seconds, 0 if no valid time was available
+  std::vector<Reading> readings;
+
+  // Reading for sensor, or nullptr if it is not a source
+  const Reading *find(const sensor::Sensor *sensor) const;
+};
+
+/**
+ * @brief SampleSnapshot Component
+ *
+ * Updates its sources in order (so derived template sensors see fresh inputs) and copies
+ * their states into one preallocated, timestamped Snapshot, which can then be handed to
+ * consumers such as InfluxDB::publish_snapshot() without going through the sensor states again.
+ */
+class SampleSnapshot : public Component {
+ public:
+  // --- Component lifecycle ---
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  // --- Public API ---
+  const Snapshot &capture();
+  const Snapshot &get_snapshot() const { return snapshot_; }
+  void add_on_snapshot_callback(std::function<void(const Snapshot &)> &&callback) {
+    on_snapshot_callback_.add(std::move(callback));
+  }
+
+  // --- Configuration setters (called by Python codegen) ---
+  // updater is called before the source is read, nullptr to read the current state only
+  void add_source(sensor::Sensor *sensor, PollingComponent *updater) { sources_.push_back({sensor, updater}); }
+  void set_time_source(time::RealTimeClock *time_source) { time_source_ = time_source; }
+
+ protected:
+  struct Source {
+    sensor::Sensor *sensor;
+    PollingComponent *updater;
+  };
+
+  // --- Configuration ---
+  std::vector<Source> sources_;
+  time::RealTimeClock *time_source_{nullptr};
+
+  // --- Runtime state ---
+  Snapshot snapshot_;
+  CallbackManager<void(const Snapshot &)> on_snapshot_callback_;
+};
+
+}  // namespace sample_snapshot
+}  // namespace esphome
@@ -0,0 +1,87 @@
+#pragma once
+
+// Senseair K30/K33 I²C framing, without ESPHome or ESP-IDF dependencies so it can be built
+// on a host (e.g. against a simulated sensor) as well as by the driver.
+//
+// Command:  [op << 4 | length] [address hi] [address lo] [data ...] [checksum]
+// Response: [status] [data ...] [checksum]  (status bit 0 set = command complete)
+// The checksum is the low byte of the sum of all preceding bytes of the frame.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace senseair_i2c {
+namespace k30 {
+
+// --- Operations (high nibble of the command byte) ---
+static constexpr uint8_t OP_WRITE_RAM = 0x1;
+static constexpr uint8_t OP_READ_RAM = 0x2;
+static constexpr uint8_t OP_WRITE_EEPROM = 0x3;
+static constexpr uint8_t OP_READ_EEPROM = 0x4;
+
+// --- Memory map ---
+static constexpr uint16_t RAM_CO2 = 0x08;          // signed, ppm
+static constexpr uint16_t RAM_TEMPERATURE = 0x12;  // signed, 0.01 °C
+static constexpr uint16_t EEPROM_METER_CONTROL = 0x3E;
+static constexpr uint8_t METER_CONTROL_ABC = 0x02;
+
+// --- Frame limits ---
+static constexpr size_t MAX_DATA_LENGTH = 15;      // length is a nibble
+static constexpr size_t COMMAND_OVERHEAD = 4;      // command, address hi/lo, checksum
+static constexpr size_t RESPONSE_OVERHEAD = 2;     // status, checksum
+
+enum class ResponseStatus : uint8_t {
+  OK,
+  NOT_COMPLETE,  // status bit 0 clear, the sensor has not finished the command
+  BAD_CHECKSUM,
+};
+
+inline uint8_t checksum(const uint8_t *data, size_t len) {
+  uint8_t sum = 0;
+  for (size_t i = 0; i < len; i++)
+    sum += data[i];
+  return sum;
+}
+
+// Builds a read command into frame (COMMAND_OVERHEAD bytes); returns the frame length
+inline size_t build_read(uint8_t *frame, uint8_t op, uint16_t address, uint8_t length) {
+  frame[0] = static_cast<uint8_t>(op << 4) | (length & 0x0F);
+  frame[1] = static_cast<uint8_t>(address >> 8);
+  frame[2] = static_cast<uint8_t>(address & 0xFF);
+  frame[3] = checksum(frame, 3);
+  return COMMAND_OVERHEAD;
+}
+
+// Builds a write command into frame (COMMAND_OVERHEAD + length bytes); returns the frame length
+inline size_t build_write(uint8_t *frame, uint8_t op, uint16_t address, const uint8_t *data, uint8_t length) {
+  frame[0] = static_cast<uint8_t>(op << 4) | (length & 0x0F);
+  frame[1] = static_cast<uint8_t>(address >> 8);
+  frame[2] = static_cast<uint8_t>(address & 0xFF);
+  for (uint8_t i = 0; i < length; i++)
+    frame[3 + i] = data[i];
+  frame[3 + length] = checksum(frame, 3 + length);
+  return COMMAND_OVERHEAD + length;
+}
+
+// Checks a response of data_length data bytes (RESPONSE_OVERHEAD + data_length bytes in frame)
+inline ResponseStatus parse_response(const uint8_t *frame, size_t data_length) {
+  if ((frame[0] & 0x01) != 0x01)
+    return ResponseStatus::NOT_COMPLETE;
+  if (checksum(frame, data_length + 1) != frame[data_length + 1])
+    return ResponseStatus::BAD_CHECKSUM;
+  return ResponseStatus::OK;
+}
+
+// Data bytes of a response
+inline const uint8_t *response_data(const uint8_t *frame) { return frame + 1; }
+
+// Big-endian 16 bit word at address, in a response read from base
+inline int16_t decode_word(const uint8_t *frame, uint16_t base, uint16_t address) {
+  const uint8_t *word = response_data(frame) + (address - base);
+  return static_cast<int16_t>((static_cast<uint16_t>(word[0]) << 8) | word[1]);
+}
+
+}  // namespace k30
+}  // namespace senseair_i2c
+}  // namespace esphome
@@ -2,6 +2,8 @@
 //  - k30: https://cdn.shopify.com/s/files/1/0019/5952/files/AN102-K30-Sensor-Arduino-I2C.zip?v=1653007039
 
 #include "senseair_i2c.h"
+#include "k30_protocol.h"
+#include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
 namespace esphome {
@@ -9,96 +11,141 @@ namespace senseair_i2c {
 
 static const char *const TAG = "senseair_i2c";
 
-// Command constants
-static const uint8_t SENSEAIR_MEASURE_CMD[] = {0x22, 0x00, 0x08, 0x2A};
-static const uint8_t READ_METER_CMD[] = {0x41, 0x00, 0x3E, 0x7F};
-
 // Timing constants
 static const uint32_t I2C_RESPONSE_DELAY_MS = 25;
-static const uint8_t ABC_ENABLE_MASK = 0x02;
 
 void SenseairI2CSensor::setup() {
   ESP_LOGCONFIG(TAG, "Setting up Senseair I2C sensor");
-  this->setup_step_ = SETUP_READ_METER;
-  this->setup_retry_count_ = 0;
-  this->setup_read_meter_control_();
+  this->retry_count_ = 0;
+  this->run_setup_read_meter_write_();
 }
 
-void SenseairI2CSensor::handle_retry_(std::function<void()> operation, uint8_t& retry_count, 
-                                    const char* operation_name, std::function<void()> on_failure) {
-  if (++retry_count < this->max_retries_) {
-    this->set_timeout(this->retry_delay_ms_, std::move(operation));
-  } else {
-    ESP_LOGW(TAG, "%s failed after %d retries", operation_name, this->max_retries_);
-    on_failure();
+void SenseairI2CSensor::loop() {
+  // Wait for the deadline of the current state; signed difference handles millis() rollover
+  if (static_cast<int32_t>(millis() - this->deadline_) < 0)
+    return;
+
+  switch (this->state_) {
+    case State::SETUP_READ_METER_WRITE:
+      this->run_setup_read_meter_write_();
+      break;
+    case State::SETUP_READ_METER_READ:
+      this->run_setup_read_meter_read_();
+      break;
+    case State::SETUP_CONFIGURE_ABC:
+      this->run_setup_configure_abc_();
+      break;
+    case State::MEASURE_WRITE:
+      this->run_measure_write_();
+      break;
+    case State::MEASURE_READ:
+      this->run_measure_read_();
+      break;
+    case State::IDLE:
+      this->disable_loop();
+      break;
+  }
+}
+
+// --- State machine helpers ---
+
+void SenseairI2CSensor::transition_(State state, uint32_t delay_ms) {
+  this->state_ = state;
+  this->deadline_ = millis() + delay_ms;
+  this->enable_loop();
+}
+
+bool SenseairI2CSensor::retry_(State state, const char *operation_name) {
+  if (++this->retry_count_ < this->max_retries_) {
+    this->transition_(state, this->retry_delay_ms_);
+    return true;
+  }
+  ESP_LOGW(TAG, "%s failed after %d retries", operation_name, this->max_retries_);
+  return false;
+}
+
+i2c::ErrorCode SenseairI2CSensor::timed_write_(const uint8_t *data, size_t len) {
+  uint32_t start = micros();
+  auto error = this->write(data, len);
+  this->bus_time_us_ += micros() - start;
+  return error;
+}
+
+i2c::ErrorCode SenseairI2CSensor::timed_read_(uint8_t *data, size_t len) {
+  uint32_t start = micros();
+  auto error = this->read(data, len);
+  this->bus_time_us_ += micros() - start;
+  return error;
+}
+
+// --- Setup: read meter control, then configure ABC if needed ---
+
+void SenseairI2CSensor::run_setup_read_meter_write_() {
+  uint8_t command[k30::COMMAND_OVERHEAD];
+  size_t length = k30::build_read(command, k30::OP_READ_EEPROM, k30::EEPROM_METER_CONTROL, 1);
+  if (this->timed_write_(command, length) != i2c::ERROR_OK) {
+    if (!this->retry_(State::SETUP_READ_METER_WRITE, "Meter control write"))
+      this->finish_setup_();
+    return;
   }
+  this->transition_(State::SETUP_READ_METER_READ, I2C_RESPONSE_DELAY_MS);
 }
 
-void SenseairI2CSensor::setup_read_meter_control_() {
-  auto error = this->write(READ_METER_CMD, sizeof(READ_METER_CMD));
-  if (error != i2c::ERROR_OK) {
-    this->handle_retry_([this]() { this->setup_read_meter_control_(); }, 
-                       this->setup_retry_count_, "Meter control write",
-                       [this]() { this->setup_step_ = SETUP_DONE; });
+void SenseairI2CSensor::run_setup_read_meter_read_() {
+  if (this->timed_read_(this->response_, k30::RESPONSE_OVERHEAD + 1) != i2c::ERROR_OK) {
+    if (!this->retry_(State::SETUP_READ_METER_WRITE, "Meter control read"))
+      this->finish_setup_();
     return;
   }
 
-  // Schedule read after I2C response delay
-  this->set_timeout(I2C_RESPONSE_DELAY_MS, [this]() {
-    auto read_err = this->read(this->setup_data_, 3);
-    if (read_err != i2c::ERROR_OK) {
-      this->handle_retry_([this]() { this->setup_read_meter_control_(); }, 
-                         this->setup_retry_count_, "Meter control read",
-                         [this]() { this->setup_step_ = SETUP_DONE; });
+  switch (k30::parse_response(this->response_, 1)) {
+    case k30::ResponseStatus::OK:
+      break;
+    case k30::ResponseStatus::NOT_COMPLETE:
+      if (!this->retry_(State::SETUP_READ_METER_READ, "Meter control read"))
+        this->finish_setup_();
       return;
-    }
-
-    // Validate checksum
-    if (!this->validate_checksum_(this->setup_data_, 2, this->setup_data_[2])) {
+    case k30::ResponseStatus::BAD_CHECKSUM:
       ESP_LOGE(TAG, "Meter control checksum mismatch");
-      this->setup_step_ = SETUP_DONE;
+      this->checksum_errors_++;
+      this->finish_setup_();
       return;
-    }
+  }
+  this->meter_control_ = k30::response_data(this->response_)[0];
 
-    // Check if ABC configuration change is needed
-    bool abc_should_enable = (this->abc_interval_ > 0);
-    bool abc_is_enabled = this->setup_data_[1] & ABC_ENABLE_MASK;
-    
-    ESP_LOGCONFIG(TAG, "ABC Status - Requested: %s (%us), Sensor: %s",
-                  abc_should_enable ? "ENABLED" : "DISABLED", 
-                  this->abc_interval_,
-                  abc_is_enabled ? "ENABLED" : "DISABLED");
-
-    if (abc_should_enable != abc_is_enabled) {
-      this->setup_step_ = SETUP_CONFIGURE_ABC;
-      this->setup_retry_count_ = 0;
-      this->setup_configure_abc_();
-    } else {
-      this->setup_step_ = SETUP_DONE;
-      ESP_LOGD(TAG, "ABC configuration matches request, no changes needed");
-    }
-  });
+  // Check if ABC configuration change is needed
+  bool abc_should_enable = (this->abc_interval_ > 0);
+  bool abc_is_enabled = this->meter_control_ & k30::METER_CONTROL_ABC;
+
+  ESP_LOGCONFIG(TAG, "ABC Status - Requested: %s (%us), Sensor: %s",
+                abc_should_enable ? "ENABLED" : "DISABLED",
+                this->abc_interval_,
+                abc_is_enabled ? "ENABLED" : "DISABLED");
+
+  if (abc_should_enable != abc_is_enabled) {
+    this->retry_count_ = 0;
+    this->run_setup_configure_abc_();
+  } else {
+    ESP_LOGD(TAG, "ABC configuration matches request, no changes needed");
+    this->finish_setup_();
+  }
 }
 
-void SenseairI2CSensor::setup_configure_abc_() {
+void SenseairI2CSensor::run_setup_configure_abc_() {
   bool abc_enable = (this->abc_interval_ > 0);
-  uint8_t configure_abc_command[] = {0x31, 0x00, 0x3E, 0x00, 0x00};
-  
+
   // Set ABC enable/disable bit
-  configure_abc_command[3] = abc_enable ? 
-    (this->setup_data_[1] | ABC_ENABLE_MASK) : 
-    (this->setup_data_[1] & ~ABC_ENABLE_MASK);
-  
-  // Calculate checksum
-  configure_abc_command[4] = this->calculate_checksum_(configure_abc_command, 4);
+  uint8_t meter_control = abc_enable ?
+    (this->meter_control_ | k30::METER_CONTROL_ABC) :
+    (this->meter_control_ & ~k30::METER_CONTROL_ABC);
+  uint8_t command[k30::COMMAND_OVERHEAD + 1];
+  size_t length = k30::build_write(command, k30::OP_WRITE_EEPROM, k30::EEPROM_METER_CONTROL, &meter_control, 1);
 
   ESP_LOGD(TAG, "Configuring ABC: %s", abc_enable ? "ENABLED" : "DISABLED");
 
-  auto error = this->write(configure_abc_command, sizeof(configure_abc_command));
-  if (error != i2c::ERROR_OK) {
-    this->handle_retry_([this]() { this->setup_configure_abc_(); }, 
-                       this->setup_retry_count_, "ABC configuration write",
-                       [this]() { this->setup_step_ = SETUP_DONE; });
+  if (this->timed_write_(command, length) != i2c::ERROR_OK) {
+    if (!this->retry_(State::SETUP_CONFIGURE_ABC, "ABC configuration write"))
+      this->finish_setup_();
     return;
   }
 
@@ -110,92 +157,98 @@ void SenseairI2CSensor::setup_configure_abc_() {
       static_cast<uint8_t>((this->abc_interval_ >> 8) & 0xFF),
       static_cast<uint8_t>(this->abc_interval_ & 0xFF)
     };
-    
-    if (this->write(interval_cmd, sizeof(interval_cmd)) == i2c::ERROR_OK) {
+
+    if (this->timed_write_(interval_cmd, sizeof(interval_cmd)) == i2c::ERROR_OK) {
       ESP_LOGD(TAG, "ABC interval configured successfully");
     } else {
       ESP_LOGW(TAG, "Failed to set ABC interval, using sensor default");
     }
   }
 
-  this->setup_step_ = SETUP_DONE;
+  this->finish_setup_();
 }
 
-void SenseairI2CSensor::update() {
-  if (this->setup_step_ != SETUP_DONE) {
-    ESP_LOGV(TAG, "Setup not complete, skipping measurement");
-    return;
-  }
+void SenseairI2CSensor::finish_setup_() {
+  this->state_ = State::IDLE;
+  this->disable_loop();
+}
+
+// --- Measurement ---
 
-  if (this->measure_step_ != MEASURE_IDLE) {
-    ESP_LOGV(TAG, "Measurement already in progress, skipping update");
+void SenseairI2CSensor::update() {
+  if (this->state_ != State::IDLE) {
+    ESP_LOGV(TAG, "Setup or measurement in progress, skipping update");
     return;
   }
 
   ESP_LOGV(TAG, "Starting CO2 measurement");
-  this->measure_step_ = MEASURE_WRITE;
-  this->measure_retry_count_ = 0;
-  this->attempt_measurement_();
+  this->retry_count_ = 0;
+  this->bus_time_us_ = 0;
+  this->run_measure_write_();
 }
 
-void SenseairI2CSensor::attempt_measurement_() {
-  if (this->measure_step_ == MEASURE_WRITE) {
-    auto error = this->write(SENSEAIR_MEASURE_CMD, sizeof(SENSEAIR_MEASURE_CMD));
-    if (error != i2c::ERROR_OK) {
-      this->handle_retry_([this]() { this->attempt_measurement_(); }, 
-                         this->measure_retry_count_, "Measurement write",
-                         [this]() { this->measure_step_ = MEASURE_IDLE; });
-      return;
-    }
-
-    this->measure_step_ = MEASURE_READ;
-    this->set_timeout(I2C_RESPONSE_DELAY_MS, [this]() { this->attempt_measurement_(); });
+void SenseairI2CSensor::run_measure_write_() {
+  uint8_t command[k30::COMMAND_OVERHEAD];
+  size_t length = k30::build_read(command, k30::OP_READ_RAM, k30::RAM_CO2, this->measure_length_());
+  if (this->timed_write_(command, length) != i2c::ERROR_OK) {
+    if (!this->retry_(State::MEASURE_WRITE, "Measurement write"))
+      this->finish_measurement_();
     return;
   }
+  this->transition_(State::MEASURE_READ, I2C_RESPONSE_DELAY_MS);
+}
 
-  if (this->measure_step_ == MEASURE_READ) {
-    auto error = this->read(this->measure_data_, 4);
-    if (error != i2c::ERROR_OK) {
-      this->handle_retry_([this]() { this->attempt_measurement_(); }, 
-                         this->measure_retry_count_, "Measurement read",
-                         [this]() { this->measure_step_ = MEASURE_IDLE; });
-      return;
-    }
+void SenseairI2CSensor::run_measure_read_() {
+  const size_t length = this->measure_length_();
+  if (this->timed_read_(this->response_, k30::RESPONSE_OVERHEAD + length) != i2c::ERROR_OK) {
+    if (!this->retry_(State::MEASURE_WRITE, "Measurement read"))
+      this->finish_measurement_();
+    return;
+  }
 
-    // Check if measurement is ready
-    if ((this->measure_data_[0] & 0x01) != 0x01) {
-      ESP_LOGW(TAG, "Measurement not ready (status: 0x%02X)", this->measure_data_[0]);
-      this->measure_step_ = MEASURE_IDLE;
+  switch (k30::parse_response(this->response_, length)) {
+    case k30::ResponseStatus::OK:
+      break;
+    case k30::ResponseStatus::NOT_COMPLETE:
+      ESP_LOGW(TAG, "Measurement not ready (status: 0x%02X)", this->response_[0]);
+      if (!this->retry_(State::MEASURE_READ, "Measurement"))
+        this->finish_measurement_();
       return;
-    }
-
-    // Validate checksum
-    if (!this->validate_checksum_(this->measure_data_, 3, this->measure_data_[3])) {
+    case k30::ResponseStatus::BAD_CHECKSUM:
       ESP_LOGE(TAG, "Measurement checksum validation failed");
-      this->measure_step_ = MEASURE_IDLE;
+      this->checksum_errors_++;
+      if (!this->retry_(State::MEASURE_READ, "Measurement"))
+        this->finish_measurement_();
       return;
-    }
+  }
 
-    // Extract and publish CO2 value
-    uint16_t co2_ppm = (static_cast<uint16_t>(this->measure_data_[1]) << 8) | this->measure_data_[2];
-    ESP_LOGV(TAG, "CO2 measurement: %u ppm", co2_ppm);
-    
-    this->publish_state(static_cast<float>(co2_ppm));
-    this->measure_step_ = MEASURE_IDLE;
+  // Extract and publish CO2 value
+  uint16_t co2_ppm = static_cast<uint16_t>(k30::decode_word(this->response_, k30::RAM_CO2, k30::RAM_CO2));
+  ESP_LOGV(TAG, "CO2 measurement: %u ppm", co2_ppm);
+  this->publish_state(static_cast<float>(co2_ppm));
+
+  // Sensor temperature
+  if (this->read_mode_ == READ_MODE_BURST && this->temperature_sensor_ != nullptr) {
+    int16_t centidegrees = k30::decode_word(this->response_, k30::RAM_CO2, k30::RAM_TEMPERATURE);
+    this->temperature_sensor_->publish_state(centidegrees / 100.0f);
   }
-}
 
-bool SenseairI2CSensor::validate_checksum_(const uint8_t *data, size_t data_len, uint8_t received_checksum) const {
-  uint8_t calculated_checksum = this->calculate_checksum_(data, data_len);
-  return calculated_checksum == received_checksum;
+  this->finish_measurement_();
 }
 
-uint8_t SenseairI2CSensor::calculate_checksum_(const uint8_t *data, size_t len) const {
-  uint8_t sum = 0;
-  for (size_t i = 0; i < len; i++) {
-    sum += data[i];
-  }
-  return sum & 0xFF;
+void SenseairI2CSensor::finish_measurement_() {
+  if (this->bus_time_sensor_ != nullptr)
+    this->bus_time_sensor_->publish_state(this->bus_time_us_ / 1000.0f);
+  if (this->retries_sensor_ != nullptr)
+    this->retries_sensor_->publish_state(this->retry_count_);
+  if (this->checksum_errors_sensor_ != nullptr)
+    this->checksum_errors_sensor_->publish_state(this->checksum_errors_);
+#ifdef USE_I2C_ARBITER
+  if (this->arbiter_ != nullptr)
+    this->arbiter_->release(this);
+#endif
+  this->state_ = State::IDLE;
+  this->disable_loop();
 }
 
 void SenseairI2CSensor::dump_config() {
@@ -205,6 +258,11 @@ void SenseairI2CSensor::dump_config() {
   ESP_LOGCONFIG(TAG, "  ABC: %s (%us), Retries: %u, Delay: %ums", 
                 this->abc_interval_ > 0 ? "enabled" : "disabled",
                 this->abc_interval_, this->max_retries_, this->retry_delay_ms_);
+  ESP_LOGCONFIG(TAG, "  Read mode: %s", this->read_mode_ == READ_MODE_BURST ? "burst" : "co2");
+  LOG_SENSOR("  ", "Temperature", this->temperature_sensor_);
+  LOG_SENSOR("  ", "Bus Time", this->bus_time_sensor_);
+  LOG_SENSOR("  ", "Retries", this->retries_sensor_);
+  LOG_SENSOR("  ", "Checksum Errors", this->checksum_errors_sensor_);
 }
 
 }  // namespace senseair_i2c
@@ -1,19 +1,31 @@
 #pragma once
 
 #include <cstdint>
-#include <functional>
 #include "esphome/core/component.h"
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/i2c/i2c.h"
+#ifdef USE_I2C_ARBITER
+#include "esphome/components/i2c_arbiter/i2c_arbiter.h"
+#endif
 
 namespace esphome {
 namespace senseair_i2c {
 
+enum ReadMode : uint8_t {
+  READ_MODE_CO2,    // 2 bytes of RAM: CO2 only
+  // 12 bytes of RAM from 0x08: CO2 and sensor temperature in one transaction. The meter status
+  // is not included: it lies past 0x16, the last byte a read from 0x08 can reach (the length of
+  // a command is a nibble), and a second transaction would defeat the burst.
+  READ_MODE_BURST,
+};
+
 /**
  * @brief SenseairI2CSensor
  *   - Platform sensor for K30/K33 (and compatible) CO₂ sensors over I²C.
- *   - Robust, non-blocking state-machine for configuration and measurement.
+ *   - Robust, non-blocking state-machine for configuration and measurement, driven from
+ *     loop() with millis() deadlines so no scheduler entries or closures are allocated.
  *   - Automatic baseline correction (ABC) configurable at boot.
+ *   - Optional diagnostics: I²C bus time, retries and checksum errors per measurement.
  */
 class SenseairI2CSensor : public sensor::Sensor, public PollingComponent, public i2c::I2CDevice {
  public:
@@ -21,9 +33,18 @@ class SenseairI2CSensor : public sensor::Sensor, public PollingComponent, public
   void set_abc_interval(uint32_t interval) { abc_interval_ = interval; }
   void set_retry_delay_ms(uint32_t delay) { retry_delay_ms_ = delay; }
   void set_max_retries(uint8_t retries) { max_retries_ = retries; }
+  void set_read_mode(ReadMode read_mode) { read_mode_ = read_mode; }
+  void set_temperature_sensor(sensor::Sensor *sensor) { temperature_sensor_ = sensor; }
+  void set_bus_time_sensor(sensor::Sensor *sensor) { bus_time_sensor_ = sensor; }
+  void set_retries_sensor(sensor::Sensor *sensor) { retries_sensor_ = sensor; }
+  void set_checksum_errors_sensor(sensor::Sensor *sensor) { checksum_errors_sensor_ = sensor; }
+#ifdef USE_I2C_ARBITER
+  void set_i2c_arbiter(i2c_arbiter::I2CArbiter *arbiter) { arbiter_ = arbiter; }
+#endif
 
   // --- Component interface ---
   void setup() override;
+  void loop() override;
   void update() override;
   void dump_config() override;
   float get_setup_priority() const override { return setup_priority::DATA; }
@@ -32,29 +53,57 @@ class SenseairI2CSensor : public sensor::Sensor, public PollingComponent, public
   // --- User options with sensible defaults ---
   uint32_t abc_interval_{648000};   // 180h default ABC interval (seconds)
   uint32_t retry_delay_ms_{200};    // Retry wait (ms)
-  uint8_t max_retries_{5};          // Max IÂ²C retries per state
-
-  // --- Setup state machine for ABC configuration ---
-  enum SetupStep { SETUP_IDLE, SETUP_READ_METER, SETUP_CONFIGURE_ABC, SETUP_DONE };
-  SetupStep setup_step_{SETUP_IDLE};
-  uint8_t setup_retry_count_{0};
-  uint8_t setup_data_[3];
-  void setup_read_meter_control_();
-  void setup_configure_abc_();
-
-  // --- Measurement state machine ---
-  enum MeasureStep { MEASURE_IDLE, MEASURE_WRITE, MEASURE_READ };
-  MeasureStep measure_step_{MEASURE_IDLE};
-  uint8_t measure_retry_count_{0};
-  uint8_t measure_data_[4];
-  void attempt_measurement_();
+  uint8_t max_retries_{5};          // Max I²C retries per state
+  ReadMode read_mode_{READ_MODE_CO2};
+
+  // --- Optional sensors ---
+  sensor::Sensor *temperature_sensor_{nullptr};
+  sensor::Sensor *bus_time_sensor_{nullptr};
+  sensor::Sensor *retries_sensor_{nullptr};
+  sensor::Sensor *checksum_errors_sensor_{nullptr};
+#ifdef USE_I2C_ARBITER
+  i2c_arbiter::I2CArbiter *arbiter_{nullptr};  // released once the response has been read
+#endif
+
+  // --- State machine ---
+  // Each *_WRITE state sends a command, the matching *_READ state fetches the response once
+  // the sensor has had I2C_RESPONSE_DELAY_MS to prepare it. A failed step is retried after
+  // retry_delay_ms_, at most max_retries_ times: a busy or corrupted response is read again,
+  // since sending the command again would restart it on the sensor; a bus error sends it again.
+  enum class State : uint8_t {
+    SETUP_READ_METER_WRITE,
+    SETUP_READ_METER_READ,
+    SETUP_CONFIGURE_ABC,
+    IDLE,
+    MEASURE_WRITE,
+    MEASURE_READ,
+  };
+  State state_{State::SETUP_READ_METER_WRITE};
+  uint32_t deadline_{0};    // millis() at which the current state runs
+  uint8_t retry_count_{0};
+  uint8_t meter_control_{0};
+  uint8_t response_[14];    // status + up to 12 bytes of RAM + checksum
+
+  // --- Per measurement statistics ---
+  uint32_t bus_time_us_{0};
+  uint32_t checksum_errors_{0};
+
+  void run_setup_read_meter_write_();
+  void run_setup_read_meter_read_();
+  void run_setup_configure_abc_();
+  void run_measure_write_();
+  void run_measure_read_();
 
   // --- Helper methods ---
-  void handle_retry_(std::function<void()> operation, uint8_t& retry_count, 
-                    const char* operation_name, std::function<void()> on_failure);
-  bool validate_checksum_(const uint8_t *data, size_t data_len, uint8_t received_checksum) const;
-  uint8_t calculate_checksum_(const uint8_t *data, size_t len) const;
+  void transition_(State state, uint32_t delay_ms);
+  bool retry_(State state, const char *operation_name);
+  void finish_setup_();
+  void finish_measurement_();
+  i2c::ErrorCode timed_write_(const uint8_t *data, size_t len);
+  i2c::ErrorCode timed_read_(uint8_t *data, size_t len);
+  // RAM bytes read per measurement: CO2, or CO2 up to and including the sensor temperature
+  uint8_t measure_length_() const { return this->read_mode_ == READ_MODE_BURST ? 12 : 2; }
 };
 
 }  // namespace senseair_i2c
-}  // namespace esphome
\ No newline at end of file
+}  // namespace esphome
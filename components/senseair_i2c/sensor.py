@@ -2,19 +2,29 @@
 Senseair I2C CO₂ Sensor Platform for ESPHome
 - Supports automatic baseline correction (ABC) configuration on boot.
 - Allows YAML configuration of retry/timing parameters for reliability.
+- Optional burst read of CO₂ and sensor temperature, plus I²C diagnostics.
 """
 
 from esphome import core
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import i2c, sensor
+from esphome.components.i2c_arbiter import CONF_I2C_ARBITER_ID, I2CArbiter
 from esphome.const import (
     CONF_ADDRESS,
     CONF_I2C_ID,
+    CONF_TEMPERATURE,
     CONF_UPDATE_INTERVAL,
     DEVICE_CLASS_CARBON_DIOXIDE,
+    DEVICE_CLASS_DURATION,
+    DEVICE_CLASS_TEMPERATURE,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     ICON_MOLECULE_CO2,
+    ICON_TIMER,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_CELSIUS,
+    UNIT_MILLISECOND,
     UNIT_PARTS_PER_MILLION,
 )
 
@@ -25,13 +35,33 @@ senseair_i2c_ns = cg.esphome_ns.namespace("senseair_i2c")
 SenseairI2CSensor = senseair_i2c_ns.class_(
     "SenseairI2CSensor", sensor.Sensor, cg.PollingComponent, i2c.I2CDevice
 )
+ReadMode = senseair_i2c_ns.enum("ReadMode")
+READ_MODES = {
+    "co2": ReadMode.READ_MODE_CO2,
+    "burst": ReadMode.READ_MODE_BURST,
+}
 
 # YAML config options
 CONF_ABC_INTERVAL = "abc_interval"
 CONF_RETRY_DELAY_MS = "retry_delay_ms"
 CONF_MAX_RETRIES = "max_retries"
+CONF_READ_MODE = "read_mode"
+CONF_BUS_TIME = "bus_time"
+CONF_RETRIES = "retries"
+CONF_CHECKSUM_ERRORS = "checksum_errors"
 
-CONFIG_SCHEMA = (
+# Bus reservation when polled by an i2c_arbiter: the 25ms response delay plus one loop pass,
+# released early once the response has been read
+ARBITER_HOLD_MS = 60
+
+
+def validate_read_mode(config):
+    if CONF_TEMPERATURE in config and config[CONF_READ_MODE] != "burst":
+        raise cv.Invalid(f"'{CONF_TEMPERATURE}' requires '{CONF_READ_MODE}: burst'")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
     sensor.sensor_schema(
         SenseairI2CSensor,
         unit_of_measurement=UNIT_PARTS_PER_MILLION,
@@ -52,10 +82,40 @@ CONFIG_SCHEMA = (
             # Robustness options
             cv.Optional(CONF_RETRY_DELAY_MS, default=200): cv.positive_int,
             cv.Optional(CONF_MAX_RETRIES, default=5): cv.positive_int,
+            # burst reads CO2 and sensor temperature in a single transaction
+            cv.Optional(CONF_READ_MODE, default="co2"): cv.enum(READ_MODES, lower=True),
+            cv.Optional(CONF_TEMPERATURE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_CELSIUS,
+                accuracy_decimals=2,
+                device_class=DEVICE_CLASS_TEMPERATURE,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            # poll through a shared bus arbiter instead of the scheduler
+            cv.Optional(CONF_I2C_ARBITER_ID): cv.use_id(I2CArbiter),
+            # Diagnostics, published after each measurement
+            cv.Optional(CONF_BUS_TIME): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MILLISECOND,
+                icon=ICON_TIMER,
+                accuracy_decimals=2,
+                device_class=DEVICE_CLASS_DURATION,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_RETRIES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_CHECKSUM_ERRORS): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
         }
     )
     .extend(cv.polling_component_schema("60s"))
-    .extend(i2c.i2c_device_schema(0x68))
+    .extend(i2c.i2c_device_schema(0x68)),
+    validate_read_mode,
 )
 
 
@@ -72,4 +132,25 @@ async def to_code(config):
 
     # Set retry parameters
     cg.add(var.set_retry_delay_ms(config[CONF_RETRY_DELAY_MS]))
-    cg.add(var.set_max_retries(config[CONF_MAX_RETRIES]))
\ No newline at end of file
+    cg.add(var.set_max_retries(config[CONF_MAX_RETRIES]))
+    cg.add(var.set_read_mode(config[CONF_READ_MODE]))
+
+    # Register with the bus arbiter, which then calls update() every update_interval
+    if arbiter_id := config.get(CONF_I2C_ARBITER_ID):
+        arbiter = await cg.get_variable(arbiter_id)
+        cg.add(arbiter.add_device(var, ARBITER_HOLD_MS, 0))
+        cg.add(var.set_i2c_arbiter(arbiter))
+
+    # Optional sensors
+    if temperature_config := config.get(CONF_TEMPERATURE):
+        sens = await sensor.new_sensor(temperature_config)
+        cg.add(var.set_temperature_sensor(sens))
+    if bus_time_config := config.get(CONF_BUS_TIME):
+        sens = await sensor.new_sensor(bus_time_config)
+        cg.add(var.set_bus_time_sensor(sens))
+    if retries_config := config.get(CONF_RETRIES):
+        sens = await sensor.new_sensor(retries_config)
+        cg.add(var.set_retries_sensor(sens))
+    if checksum_errors_config := config.get(CONF_CHECKSUM_ERRORS):
+        sens = await sensor.new_sensor(checksum_errors_config)
+        cg.add(var.set_checksum_errors_sensor(sens))
@@ -5,6 +5,7 @@ import esphome.config_validation as cv
 from esphome import automation, core
 from esphome.automation import maybe_simple_id
 from esphome.components import sensor, microphone
+from esphome.components.checkpoint import CONF_CHECKPOINT_ID, Checkpoint
 from esphome.components.esp32 import add_idf_component
 from esphome.const import (
     CONF_ID,
@@ -13,14 +14,28 @@ from esphome.const import (
     CONF_UPDATE_INTERVAL,
     CONF_TYPE,
     CONF_MICROPHONE,
+    CONF_PERIOD,
+    CONF_BITS_PER_SAMPLE,
+    CONF_SENSOR,
+    CONF_THRESHOLD,
+    CONF_SAMPLE_RATE,
+    CONF_TRIGGER_ID,
+    CONF_CHANNEL,
+    CONF_CHANNELS,
     UNIT_DECIBEL,
+    UNIT_PERCENT,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
     DEVICE_CLASS_SOUND_PRESSURE,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_COUNTER,
+    ICON_CURRENT_AC,
+    ICON_TIMER,
 )
 
 CODEOWNERS = ["@stas-sl"]
 DEPENDENCIES = ["esp32", "microphone"]
-AUTO_LOAD = ["sensor", "audio"]
+AUTO_LOAD = ["sensor", "audio", "instrumentation"]
 MULTI_CONF = True
 
 sound_level_meter_ns = cg.esphome_ns.namespace("sound_level_meter")
@@ -44,6 +59,10 @@ Filter = sound_level_meter_ns.class_("Filter")
 SOS_Filter = sound_level_meter_ns.class_("SOS_Filter", Filter)
 StartAction = sound_level_meter_ns.class_("StartAction", automation.Action)
 StopAction = sound_level_meter_ns.class_("StopAction", automation.Action)
+EventCapture = sound_level_meter_ns.class_("EventCapture", cg.Component)
+ClipTrigger = sound_level_meter_ns.class_(
+    "ClipTrigger", automation.Trigger.template(cg.float_)
+)
 
 
 CONF_EQ = "eq"
@@ -64,8 +83,40 @@ CONF_HIGH_FREQ = "high_freq"
 CONF_DSP_FILTERS = "dsp_filters"
 CONF_AUTO_START = "auto_start"
 CONF_USE_ESP_DSP = "use_esp_dsp"
+CONF_PROCESS_TIME_P50 = "process_time_p50"
+CONF_PROCESS_TIME_P99 = "process_time_p99"
+CONF_RING_BUFFER_PEAK = "ring_buffer_peak"
+CONF_DROPPED_BYTES = "dropped_bytes"
+CONF_DROPPED_FRAMES = "dropped_frames"
+CONF_TASK_STACK_HIGH_WATER = "task_stack_high_water"
+CONF_MAX_BLOCK_SIZE = "max_block_size"
+CONF_MEASUREMENT_GAP = "measurement_gap"
+CONF_DUTY_CYCLE = "duty_cycle"
+CONF_MEASURE_INTERVAL = "measure_interval"
+CONF_ACTIVE_CURRENT = "active_current"
+CONF_CPU_TIME_SAVED = "cpu_time_saved"
+CONF_CURRENT_SAVED = "current_saved"
+CONF_INGEST_BITS_PER_SAMPLE = "ingest_bits_per_sample"
+CONF_INGEST_SHIFT = "ingest_shift"
+CONF_PIPELINE = "pipeline"
+CONF_BLOCKS = "blocks"
+CONF_STAGE1_UTILIZATION = "stage1_utilization"
+CONF_STAGE2_UTILIZATION = "stage2_utilization"
+CONF_EVENT_CAPTURE = "event_capture"
+CONF_PRE_TRIGGER = "pre_trigger"
+CONF_POST_TRIGGER = "post_trigger"
+CONF_HOLD_OFF = "hold_off"
+CONF_MAX_CLIPS = "max_clips"
+CONF_ON_CLIP = "on_clip"
 
 ICON_WAVEFORM = "mdi:waveform"
+ICON_MEMORY = "mdi:memory"
+ICON_CPU = "mdi:cpu-32-bit"
+UNIT_MICROSECOND = "µs"
+UNIT_MILLISECOND = "ms"
+UNIT_MILLIAMP = "mA"
+UNIT_SECONDS_PER_HOUR = "s/h"
+UNIT_BYTES = "B"
 
 CONFIG_DSP_FILTER_SCHEMA = cv.typed_schema(
     {
@@ -94,6 +145,8 @@ CONFIG_SENSOR_SCHEMA = cv.typed_schema(
         ).extend(
             {
                 cv.Optional(CONF_UPDATE_INTERVAL): cv.positive_time_period_milliseconds,
+                # index into the microphone's channels
+                cv.Optional(CONF_CHANNEL, default=0): cv.int_range(0, 1),
                 cv.Optional(
                     CONF_DSP_FILTERS, default=[]
                 ): CONFIG_SENSOR_DSP_FILTER_SCHEMA,
@@ -109,6 +162,8 @@ CONFIG_SENSOR_SCHEMA = cv.typed_schema(
         ).extend(
             {
                 cv.Optional(CONF_UPDATE_INTERVAL): cv.positive_time_period_milliseconds,
+                # index into the microphone's channels
+                cv.Optional(CONF_CHANNEL, default=0): cv.int_range(0, 1),
                 cv.Required(CONF_WINDOW_SIZE): cv.positive_time_period_milliseconds,
                 cv.Optional(
                     CONF_DSP_FILTERS, default=[]
@@ -125,6 +180,8 @@ CONFIG_SENSOR_SCHEMA = cv.typed_schema(
         ).extend(
             {
                 cv.Optional(CONF_UPDATE_INTERVAL): cv.positive_time_period_milliseconds,
+                # index into the microphone's channels
+                cv.Optional(CONF_CHANNEL, default=0): cv.int_range(0, 1),
                 cv.Required(CONF_WINDOW_SIZE): cv.positive_time_period_milliseconds,
                 cv.Optional(
                     CONF_DSP_FILTERS, default=[]
@@ -141,6 +198,8 @@ CONFIG_SENSOR_SCHEMA = cv.typed_schema(
         ).extend(
             {
                 cv.Optional(CONF_UPDATE_INTERVAL): cv.positive_time_period_milliseconds,
+                # index into the microphone's channels
+                cv.Optional(CONF_CHANNEL, default=0): cv.int_range(0, 1),
                 cv.Optional(
                     CONF_DSP_FILTERS, default=[]
                 ): CONFIG_SENSOR_DSP_FILTER_SCHEMA,
@@ -149,6 +208,116 @@ CONFIG_SENSOR_SCHEMA = cv.typed_schema(
     }
 )
 
+
+def validate_block_size(config):
+    if config[CONF_MAX_BLOCK_SIZE] > config[CONF_RING_BUFFER_SIZE]:
+        raise cv.Invalid(
+            f"{CONF_MAX_BLOCK_SIZE} must not exceed {CONF_RING_BUFFER_SIZE}",
+            [CONF_MAX_BLOCK_SIZE],
+        )
+    return config
+
+
+def validate_ingest(config):
+    source_bits = config[CONF_MICROPHONE].get(CONF_BITS_PER_SAMPLE)
+    ingest_bits = config.get(CONF_INGEST_BITS_PER_SAMPLE, source_bits)
+    if source_bits is not None and ingest_bits > source_bits:
+        raise cv.Invalid(
+            f"{CONF_INGEST_BITS_PER_SAMPLE} must not exceed the microphone's {CONF_BITS_PER_SAMPLE}",
+            [CONF_INGEST_BITS_PER_SAMPLE],
+        )
+    return config
+
+
+def validate_channels(config):
+    channels = len(config[CONF_MICROPHONE].get(CONF_CHANNELS, [0]))
+    for i, sc in enumerate(config[CONF_SENSORS]):
+        if sc[CONF_CHANNEL] >= channels:
+            raise cv.Invalid(
+                f"{CONF_CHANNEL} must be less than the number of microphone {CONF_CHANNELS} ({channels})",
+                [CONF_SENSORS, i, CONF_CHANNEL],
+            )
+    return config
+
+
+def validate_duty_cycle(config):
+    duty_cycle = config.get(CONF_DUTY_CYCLE)
+    if duty_cycle is None:
+        for key in (CONF_CPU_TIME_SAVED, CONF_CURRENT_SAVED):
+            if key in config:
+                raise cv.Invalid(f"{key} requires {CONF_DUTY_CYCLE}", [key])
+        return config
+    if duty_cycle[CONF_MEASURE_INTERVAL] >= duty_cycle[CONF_PERIOD]:
+        raise cv.Invalid(
+            f"{CONF_MEASURE_INTERVAL} must be shorter than {CONF_PERIOD}",
+            [CONF_DUTY_CYCLE, CONF_MEASURE_INTERVAL],
+        )
+    return config
+
+
+CONFIG_DUTY_CYCLE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_MEASURE_INTERVAL): cv.positive_time_period_milliseconds,
+        cv.Required(CONF_PERIOD): cv.positive_time_period_milliseconds,
+        # extra current drawn while measuring (mic, I2S, CPU), only used for reporting
+        cv.Optional(CONF_ACTIVE_CURRENT, default="0mA"): cv.current,
+    }
+)
+
+
+def validate_pipeline(config):
+    pipeline = config.get(CONF_PIPELINE)
+    if pipeline is None:
+        if CONF_STAGE2_UTILIZATION in config:
+            raise cv.Invalid(
+                f"{CONF_STAGE2_UTILIZATION} requires {CONF_PIPELINE}",
+                [CONF_STAGE2_UTILIZATION],
+            )
+        return config
+    if pipeline[CONF_TASK_CORE] == config[CONF_TASK_CORE]:
+        raise cv.Invalid(
+            f"pipeline {CONF_TASK_CORE} must differ from the audio task's {CONF_TASK_CORE}",
+            [CONF_PIPELINE, CONF_TASK_CORE],
+        )
+    return config
+
+
+# Second stage running the per-sensor filters and statistics on the other core, fed with
+# blocks already filtered by the filters shared by all sensors
+CONFIG_PIPELINE_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_TASK_CORE, default=0): cv.int_range(0, 1),
+        # blocks in flight between the stages, each max_block_size long
+        cv.Optional(CONF_BLOCKS, default=3): cv.int_range(2, 8),
+    }
+)
+
+
+# Clips of decimated, IMA-ADPCM encoded audio (4 bits/sample, 8 kB/s at 16 kHz) around
+# the moment the trigger sensor rises above threshold. The trigger sensor must update
+# faster than pre_trigger, e.g. a short-window max/peak sensor rather than a 60s LAmax.
+# Uses (pre_trigger + post_trigger) * (max_clips + 1) + 1s of PSRAM, or internal RAM without it.
+CONFIG_EVENT_CAPTURE_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(EventCapture),
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        cv.Required(CONF_THRESHOLD): cv.Any(cv.decibel, cv.float_),
+        cv.Optional(CONF_SAMPLE_RATE, default=16000): cv.int_range(8000, 24000),
+        cv.Optional(
+            CONF_PRE_TRIGGER, default="3s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(
+            CONF_POST_TRIGGER, default="2s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_HOLD_OFF, default="60s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MAX_CLIPS, default=2): cv.int_range(1, 16),
+        cv.Optional(CONF_ON_CLIP): automation.validate_automation(
+            {cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(ClipTrigger)}
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
 CONFIG_SCHEMA = cv.All(
     cv.Schema(
         {
@@ -158,6 +327,7 @@ CONFIG_SCHEMA = cv.All(
             ): microphone.microphone_source_schema(
                 min_bits_per_sample=16,
                 max_bits_per_sample=32,
+                max_channels=2,
             ),
             cv.Optional(
                 CONF_UPDATE_INTERVAL, default="60s"
@@ -170,6 +340,17 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(
                 CONF_WARMUP_INTERVAL, default="0ms"
             ): cv.positive_time_period_milliseconds,
+            # Sample width stored in the ring buffer, defaults to the microphone's.
+            # Repacking 32 -> 16 bits halves the ring buffer memory, but adds quantization
+            # noise: at ingest_shift 0 with a -26 dBFS @ 94 dB mic, 16 bits floor out around
+            # 22 dB SPL, ~7 dB below the ICS-43434 self-noise (29 dBA), raising the lowest
+            # readings by ~0.8 dB. Each shift bit lowers that floor by 6 dB, and the clipping
+            # point (120 dB SPL) by 6 dB too. 24 bits are lossless for 24-bit microphones.
+            cv.Optional(CONF_INGEST_BITS_PER_SAMPLE): cv.one_of(16, 24, 32, int=True),
+            cv.Optional(CONF_INGEST_SHIFT, default=0): cv.int_range(0, 8),
+            cv.Optional(
+                CONF_MAX_BLOCK_SIZE, default="20ms"
+            ): cv.positive_time_period_milliseconds,
             cv.Optional(CONF_TASK_STACK_SIZE, default=4096): cv.positive_not_null_int,
             cv.Optional(CONF_TASK_PRIORITY, default=2): cv.uint8_t,
             cv.Optional(CONF_TASK_CORE, default=1): cv.int_range(0, 1),
@@ -181,9 +362,95 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(CONF_USE_ESP_DSP, default=False): cv.All(
                 cv.boolean, cv.only_with_esp_idf
             ),
+            cv.Optional(CONF_PROCESS_TIME_P50): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_TIMER,
+            ),
+            cv.Optional(CONF_PROCESS_TIME_P99): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_TIMER,
+            ),
+            cv.Optional(CONF_RING_BUFFER_PEAK): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_MEMORY,
+            ),
+            cv.Optional(CONF_DROPPED_BYTES): sensor.sensor_schema(
+                unit_of_measurement=UNIT_BYTES,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_COUNTER,
+            ),
+            cv.Optional(CONF_DROPPED_FRAMES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_COUNTER,
+            ),
+            cv.Optional(CONF_TASK_STACK_HIGH_WATER): sensor.sensor_schema(
+                unit_of_measurement=UNIT_BYTES,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_MEMORY,
+            ),
+            cv.Optional(CONF_MEASUREMENT_GAP): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MILLISECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_TIMER,
+            ),
+            cv.Optional(CONF_STAGE1_UTILIZATION): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_CPU,
+            ),
+            cv.Optional(CONF_STAGE2_UTILIZATION): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_CPU,
+            ),
+            cv.Optional(CONF_PIPELINE): CONFIG_PIPELINE_SCHEMA,
+            cv.Optional(CONF_EVENT_CAPTURE): CONFIG_EVENT_CAPTURE_SCHEMA,
+            # resume the sensor accumulators after a reset
+            cv.Optional(CONF_CHECKPOINT_ID): cv.use_id(Checkpoint),
+            cv.Optional(CONF_DUTY_CYCLE): CONFIG_DUTY_CYCLE_SCHEMA,
+            cv.Optional(CONF_CPU_TIME_SAVED): sensor.sensor_schema(
+                unit_of_measurement=UNIT_SECONDS_PER_HOUR,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_TIMER,
+            ),
+            cv.Optional(CONF_CURRENT_SAVED): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MILLIAMP,
+                accuracy_decimals=2,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon=ICON_CURRENT_AC,
+            ),
         }
     ).extend(cv.COMPONENT_SCHEMA),
     cv.only_on_esp32,
+    validate_block_size,
+    validate_ingest,
+    validate_channels,
+    validate_duty_cycle,
+    validate_pipeline,
 )
 
 SOUND_LEVEL_METER_ACTION_SCHEMA = maybe_simple_id(
@@ -207,6 +474,7 @@ async def add_sensor(config, parent):
         cg.add(s.set_window_size(config[CONF_WINDOW_SIZE]))
     if CONF_UPDATE_INTERVAL in config:
         cg.add(s.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    cg.add(s.set_channel(config[CONF_CHANNEL]))
     for fc in config[CONF_DSP_FILTERS]:
         f = None
         if isinstance(fc, core.ID):
@@ -218,6 +486,23 @@ async def add_sensor(config, parent):
     cg.add(parent.add_sensor(s))
 
 
+async def add_event_capture(config, parent):
+    cap = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(cap, config)
+    trigger_sensor = await cg.get_variable(config[CONF_SENSOR])
+    cg.add(cap.set_trigger_sensor(trigger_sensor))
+    cg.add(cap.set_threshold(config[CONF_THRESHOLD]))
+    cg.add(cap.set_sample_rate(config[CONF_SAMPLE_RATE]))
+    cg.add(cap.set_pre_trigger(config[CONF_PRE_TRIGGER]))
+    cg.add(cap.set_post_trigger(config[CONF_POST_TRIGGER]))
+    cg.add(cap.set_hold_off(config[CONF_HOLD_OFF]))
+    cg.add(cap.set_max_clips(config[CONF_MAX_CLIPS]))
+    for conf in config.get(CONF_ON_CLIP, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], cap)
+        await automation.build_automation(trigger, [(cg.float_, "x")], conf)
+    cg.add(parent.set_event_capture(cap))
+
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
@@ -227,7 +512,11 @@ async def to_code(config):
     cg.add(var.set_microphone_source(mic_source))
     cg.add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
     cg.add(var.set_ring_buffer_size(config[CONF_RING_BUFFER_SIZE]))
+    cg.add(var.set_max_block_size(config[CONF_MAX_BLOCK_SIZE]))
     cg.add(var.set_warmup_interval(config[CONF_WARMUP_INTERVAL]))
+    if CONF_INGEST_BITS_PER_SAMPLE in config:
+        cg.add(var.set_ingest_bits_per_sample(config[CONF_INGEST_BITS_PER_SAMPLE]))
+    cg.add(var.set_ingest_shift(config[CONF_INGEST_SHIFT]))
     cg.add(var.set_task_stack_size(config[CONF_TASK_STACK_SIZE]))
     cg.add(var.set_task_priority(config[CONF_TASK_PRIORITY]))
     cg.add(var.set_task_core(config[CONF_TASK_CORE]))
@@ -239,16 +528,50 @@ async def to_code(config):
         cg.add(var.set_mic_sensitivity_ref(config[CONF_MIC_SENSITIVITY_REF]))
     if CONF_OFFSET in config:
         cg.add(var.set_offset(config[CONF_OFFSET]))
+    if duty_cycle := config.get(CONF_DUTY_CYCLE):
+        cg.add(
+            var.set_duty_cycle(
+                duty_cycle[CONF_MEASURE_INTERVAL], duty_cycle[CONF_PERIOD]
+            )
+        )
+        cg.add(var.set_active_current(duty_cycle[CONF_ACTIVE_CURRENT]))
+    if pipeline := config.get(CONF_PIPELINE):
+        cg.add(var.set_pipeline(pipeline[CONF_TASK_CORE], pipeline[CONF_BLOCKS]))
     if config[CONF_USE_ESP_DSP]:
         add_idf_component(name="espressif/esp-dsp", ref="1.7.0")
         cg.add_define("USE_ESP_DSP")
 
+    for key, setter in (
+        (CONF_PROCESS_TIME_P50, var.set_process_time_p50_sensor),
+        (CONF_PROCESS_TIME_P99, var.set_process_time_p99_sensor),
+        (CONF_RING_BUFFER_PEAK, var.set_ring_buffer_peak_sensor),
+        (CONF_DROPPED_BYTES, var.set_dropped_bytes_sensor),
+        (CONF_DROPPED_FRAMES, var.set_dropped_frames_sensor),
+        (CONF_TASK_STACK_HIGH_WATER, var.set_task_stack_high_water_sensor),
+        (CONF_MEASUREMENT_GAP, var.set_measurement_gap_sensor),
+        (CONF_CPU_TIME_SAVED, var.set_cpu_time_saved_sensor),
+        (CONF_CURRENT_SAVED, var.set_current_saved_sensor),
+        (CONF_STAGE1_UTILIZATION, var.set_stage1_utilization_sensor),
+        (CONF_STAGE2_UTILIZATION, var.set_stage2_utilization_sensor),
+    ):
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(setter(sens))
+
     for fc in config[CONF_DSP_FILTERS]:
         await add_dsp_filter(fc, var)
 
     for sc in config[CONF_SENSORS]:
         await add_sensor(sc, var)
 
+    # after the sensors, as the trigger is usually one of them
+    if capture := config.get(CONF_EVENT_CAPTURE):
+        await add_event_capture(capture, var)
+
+    if CONF_CHECKPOINT_ID in config:
+        checkpoint = await cg.get_variable(config[CONF_CHECKPOINT_ID])
+        cg.add(var.set_checkpoint(checkpoint))
+
 
 @automation.register_action(
     "sound_level_meter.start", StartAction, SOUND_LEVEL_METER_ACTION_SCHEMA
@@ -0,0 +1,150 @@
+#include "dsp.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// USE_ESP_DSP and the ESP32 variant come from the generated defines when built by ESPHome
+#if __has_include("esphome/core/defines.h")
+#include "esphome/core/defines.h"
+#endif
+#ifdef USE_ESP_DSP
+#include "dsps_biquad.h"
+#endif
+
+namespace esphome::sound_level_meter {
+
+/* Filter */
+
+void Filter::process_pair(std::vector<float> &a, std::vector<float> &b, uint8_t first_channel) {
+  this->process(a, first_channel);
+  this->process(b, first_channel + 1);
+}
+
+/* SOS_Filter */
+
+SOS_Filter::SOS_Filter(std::initializer_list<std::initializer_list<float>> &&coeffs) {
+  this->coeffs_.resize(coeffs.size());
+  this->state_.resize(coeffs.size(), {});
+  int i = 0;
+  for (auto &row : coeffs)
+    std::copy(row.begin(), row.end(), coeffs_[i++].begin());
+}
+
+SOS_Filter::SOS_Filter(std::vector<std::array<float, 5>> &&coeffs) : coeffs_(std::move(coeffs)) {
+  this->state_.resize(this->coeffs_.size(), {});
+}
+
+void SOS_Filter::process(std::vector<float> &data, uint8_t channel) {
+  int n = data.size();
+  int m = this->coeffs_.size();
+  auto *state = &this->state_[channel * m];
+  for (int j = 0; j < m; j++) {
+#ifdef USE_ESP_DSP  // esp-dsp uses direct form 2
+#if defined(USE_ESP32_VARIANT_ESP32)
+    dsps_biquad_f32_ae32(&data[0], &data[0], data.size(), &this->coeffs_[j][0], &state[j][0]);
+#elif defined(USE_ESP32_VARIANT_ESP32S3)
+    dsps_biquad_f32_aes3(&data[0], &data[0], data.size(), &this->coeffs_[j][0], &state[j][0]);
+#elif defined(USE_ESP32_VARIANT_ESP32P4)
+    dsps_biquad_f32_arp4(&data[0], &data[0], data.size(), &this->coeffs_[j][0], &state[j][0]);
+#else
+    dsps_biquad_f32_ansi(&data[0], &data[0], data.size(), &this->coeffs_[j][0], &state[j][0]);
+#endif
+#else  // I'm using direct form 2 transposed, which should be a bit more numerically stable
+    for (int i = 0; i < n; i++) {
+      // y[i] = b0 * x[i] + s0
+      float yi = this->coeffs_[j][0] * data[i] + state[j][0];
+      // s0 = b1 * x[i] - a1 * y[i] + s1
+      state[j][0] = this->coeffs_[j][1] * data[i] - this->coeffs_[j][3] * yi + state[j][1];
+      // s1 = b2 * x[i] - a2 * y[i]
+      state[j][1] = this->coeffs_[j][2] * data[i] - this->coeffs_[j][4] * yi;
+
+      data[i] = yi;
+    }
+#endif
+  }
+}
+
+// The ESP32 (Xtensa LX6) FPU has no SIMD, but running two independent channels through
+// the same section in one loop interleaves their dependency chains, so the FPU pipeline
+// isn't stalled waiting on the previous output, and coefficients are loaded once for both.
+void SOS_Filter::process_pair(std::vector<float> &a, std::vector<float> &b, uint8_t first_channel) {
+#ifdef USE_ESP_DSP
+  Filter::process_pair(a, b, first_channel);
+#else
+  int n = std::min(a.size(), b.size());
+  int m = this->coeffs_.size();
+  auto *state_a = &this->state_[first_channel * m];
+  auto *state_b = &this->state_[(first_channel + 1) * m];
+  for (int j = 0; j < m; j++) {
+    const float b0 = this->coeffs_[j][0], b1 = this->coeffs_[j][1], b2 = this->coeffs_[j][2];
+    const float a1 = this->coeffs_[j][3], a2 = this->coeffs_[j][4];
+    float sa0 = state_a[j][0], sa1 = state_a[j][1];
+    float sb0 = state_b[j][0], sb1 = state_b[j][1];
+    for (int i = 0; i < n; i++) {
+      float xa = a[i], xb = b[i];
+      float ya = b0 * xa + sa0;
+      float yb = b0 * xb + sb0;
+      sa0 = b1 * xa - a1 * ya + sa1;
+      sb0 = b1 * xb - a1 * yb + sb1;
+      sa1 = b2 * xa - a2 * ya;
+      sb1 = b2 * xb - a2 * yb;
+      a[i] = ya;
+      b[i] = yb;
+    }
+    state_a[j] = {sa0, sa1};
+    state_b[j] = {sb0, sb1};
+  }
+#endif
+}
+
+void SOS_Filter::set_channels(uint8_t channels) { this->state_.resize(this->coeffs_.size() * channels, {}); }
+
+void SOS_Filter::reset() {
+  for (auto &s : this->state_)
+    s = {0.f, 0.f};
+}
+
+/* BufferStack */
+
+template<typename T> BufferStack<T>::BufferStack(uint32_t buffer_size) : buffer_size_(buffer_size) {
+  this->buffers_.resize(1);
+  this->buffers_[0].resize(buffer_size);
+}
+
+template<typename T> std::vector<T> &BufferStack<T>::current() { return this->buffers_[this->index_]; }
+
+template<typename T> void BufferStack<T>::push() {
+  this->index_++;
+  if (this->index_ == this->buffers_.capacity()) {
+    this->buffers_.reserve(this->index_ + 1);
+    this->buffers_.resize(this->index_ + 1);
+  }
+  auto &dst = this->buffers_[this->index_];
+  auto &src = this->buffers_[this->index_ - 1];
+  auto n = src.size();
+  dst.resize(n);
+  // this is faster than assigning one vector to another, which results in element-wise copying
+  memcpy(&dst[0], &src[0], n * sizeof(T));
+}
+
+template<typename T> void BufferStack<T>::pop() {
+  assert(this->index_ >= 1 && "Index out of bounds");
+  this->index_--;
+}
+
+template<typename T> void BufferStack<T>::reset() {
+  this->index_ = 0;
+  this->current().resize(this->buffer_size_);
+}
+
+template<typename T> void BufferStack<T>::reset(uint32_t buffer_size) {
+  this->index_ = 0;
+  this->current().resize(std::min(buffer_size, this->buffer_size_));
+}
+
+template<typename T> BufferStack<T>::operator std::vector<T> &() { return this->current(); }
+
+template class BufferStack<float>;
+
+}  // namespace esphome::sound_level_meter
@@ -0,0 +1,61 @@
+#pragma once
+
+// DSP building blocks of the sound level meter. Kept free of ESPHome and ESP-IDF
+// dependencies (esp-dsp is only used when USE_ESP_DSP is defined), so they can be
+// compiled on a host to check filter responses and kernel cost.
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace esphome::sound_level_meter {
+class SoundLevelMeter;
+
+// Filters keep separate state per channel, so one instance can be shared by sensors
+// bound to different channels of a multi-channel microphone.
+class Filter {
+  friend class SoundLevelMeter;
+
+ public:
+  virtual void process(std::vector<float> &data, uint8_t channel = 0) = 0;
+  // processes channels first_channel and first_channel + 1 together
+  virtual void process_pair(std::vector<float> &a, std::vector<float> &b, uint8_t first_channel = 0);
+  virtual void set_channels(uint8_t channels) = 0;
+
+ protected:
+  virtual void reset() = 0;
+};
+
+class SOS_Filter : public Filter {
+ public:
+  SOS_Filter(std::initializer_list<std::initializer_list<float>> &&coeffs);
+  explicit SOS_Filter(std::vector<std::array<float, 5>> &&coeffs);
+  virtual void process(std::vector<float> &data, uint8_t channel = 0) override;
+  virtual void process_pair(std::vector<float> &a, std::vector<float> &b, uint8_t first_channel = 0) override;
+  virtual void set_channels(uint8_t channels) override;
+
+ protected:
+  std::vector<std::array<float, 5>> coeffs_;  // {b0, b1, b2, a1, a2}
+  std::vector<std::array<float, 2>> state_;   // sections of channel 0, then channel 1, ...
+
+  virtual void reset() override;
+};
+
+template<typename T> class BufferStack {
+ public:
+  BufferStack(uint32_t buffer_size);
+  std::vector<T> &current();
+  void push();
+  void pop();
+  void reset();
+  void reset(uint32_t buffer_size);
+  operator std::vector<T> &();
+
+ private:
+  uint32_t buffer_size_;
+  uint32_t index_{0};
+  std::vector<std::vector<T>> buffers_;
+};
+
+}  // namespace esphome::sound_level_meter
@@ -0,0 +1,321 @@
+#include "event_capture.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "esphome/core/log.h"
+
+namespace esphome::sound_level_meter {
+
+static constexpr const char *TAG = "sound_level_meter.event_capture";
+
+// extra blocks in the ring, so the main loop may be late (e.g. blocked by a TLS handshake)
+// by up to about a second before the start of a pending clip gets overwritten
+static constexpr uint32_t RING_MARGIN_BLOCKS = 32;
+static constexpr size_t WAV_HEADER_SIZE = 60;
+// decimation filter: 4th order Butterworth low-pass at 0.35 of the capture sample rate,
+// enough to keep aliasing of loud high frequency content ~20 dB down, cheap enough to
+// run on every microphone callback
+static constexpr float DECIMATION_CUTOFF = 0.35f;
+static constexpr float BUTTERWORTH_Q[] = {0.54119610f, 1.3065630f};
+
+static const int16_t ADPCM_STEPS[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+static const int8_t ADPCM_INDEX[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+/* ImaAdpcmEncoder */
+
+bool ImaAdpcmEncoder::encode(int16_t sample, uint8_t *block) {
+  if (this->position_ == 0) {
+    // block header: the first sample is stored verbatim along with the current step index
+    this->predictor_ = sample;
+    block[0] = sample & 0xFF;
+    block[1] = (sample >> 8) & 0xFF;
+    block[2] = this->index_;
+    block[3] = 0;
+  } else {
+    uint8_t nibble = this->encode_nibble(sample);
+    uint8_t &byte = block[4 + (this->position_ - 1) / 2];
+    if ((this->position_ - 1) % 2 == 0) {
+      byte = nibble;
+    } else {
+      byte |= nibble << 4;
+    }
+  }
+  if (++this->position_ == SAMPLES_PER_BLOCK) {
+    this->position_ = 0;
+    return true;
+  }
+  return false;
+}
+
+void ImaAdpcmEncoder::reset() {
+  this->predictor_ = 0;
+  this->index_ = 0;
+  this->position_ = 0;
+}
+
+uint8_t ImaAdpcmEncoder::encode_nibble(int16_t sample) {
+  int32_t step = ADPCM_STEPS[this->index_];
+  int32_t diff = sample - this->predictor_;
+  uint8_t nibble = 0;
+  if (diff < 0) {
+    nibble = 8;
+    diff = -diff;
+  }
+  // the decoder reconstructs the difference from the same bits, so track its value exactly
+  int32_t delta = step >> 3;
+  for (uint8_t bit = 4; bit > 0; bit >>= 1, step >>= 1) {
+    if (diff >= step) {
+      nibble |= bit;
+      diff -= step;
+      delta += step;
+    }
+  }
+  this->predictor_ += (nibble & 8) ? -delta : delta;
+  this->predictor_ = std::clamp<int32_t>(this->predictor_, INT16_MIN, INT16_MAX);
+  this->index_ = std::clamp<int32_t>(this->index_ + ADPCM_INDEX[nibble], 0, 88);
+  return nibble;
+}
+
+/* EventCapture */
+
+void EventCapture::set_trigger_sensor(sensor::Sensor *trigger_sensor) { this->trigger_sensor_ = trigger_sensor; }
+void EventCapture::set_threshold(float threshold) { this->threshold_ = threshold; }
+void EventCapture::set_sample_rate(uint32_t sample_rate) { this->sample_rate_ = sample_rate; }
+void EventCapture::set_pre_trigger(uint32_t pre_trigger_ms) { this->pre_trigger_ms_ = pre_trigger_ms; }
+void EventCapture::set_post_trigger(uint32_t post_trigger_ms) { this->post_trigger_ms_ = post_trigger_ms; }
+void EventCapture::set_hold_off(uint32_t hold_off_ms) { this->hold_off_ms_ = hold_off_ms; }
+void EventCapture::set_max_clips(uint8_t max_clips) { this->max_clips_ = max_clips; }
+void EventCapture::add_on_clip_callback(std::function<void(float)> &&callback) {
+  this->on_clip_callback_.add(std::move(callback));
+}
+
+void EventCapture::setup() {
+  RAMAllocator<uint8_t> allocator;
+  uint32_t clip_blocks = this->ms_to_blocks(this->pre_trigger_ms_ + this->post_trigger_ms_);
+  this->ring_blocks_ = clip_blocks + RING_MARGIN_BLOCKS;
+  this->clip_capacity_ = WAV_HEADER_SIZE + clip_blocks * ImaAdpcmEncoder::BLOCK_SIZE;
+  this->clips_.resize(this->max_clips_);
+  for (auto &clip : this->clips_) {
+    clip.data = allocator.allocate(this->clip_capacity_);
+    if (clip.data == nullptr) {
+      ESP_LOGE(TAG, "Failed to allocate %u bytes for clip", this->clip_capacity_);
+      this->mark_failed();
+      return;
+    }
+  }
+  // allocated last, feed() does nothing until it is set
+  auto *ring = allocator.allocate(this->ring_blocks_ * ImaAdpcmEncoder::BLOCK_SIZE);
+  if (ring == nullptr) {
+    ESP_LOGE(TAG, "Failed to allocate %u bytes for pre-trigger ring",
+             this->ring_blocks_ * ImaAdpcmEncoder::BLOCK_SIZE);
+    this->mark_failed();
+    return;
+  }
+  this->ring_ = ring;
+
+  // rising edge only, so a sustained loud period yields a single clip
+  this->trigger_sensor_->add_on_raw_state_callback([this](float state) {
+    bool is_crossed =
+        !std::isnan(state) && state >= this->threshold_ && !(this->previous_state_ >= this->threshold_);
+    this->previous_state_ = state;
+    if (is_crossed)
+      this->trigger(state);
+  });
+  this->disable_loop();
+}
+
+// only enabled while a clip is waiting for its post-trigger audio
+void EventCapture::loop() {
+  if (!this->is_pending_)
+    return;
+  uint32_t written = this->blocks_written_.load(std::memory_order_acquire);
+  if (written - this->trigger_block_ >= this->ms_to_blocks(this->post_trigger_ms_))
+    this->finish_clip();
+}
+
+void EventCapture::dump_config() {
+  ESP_LOGCONFIG(TAG, "Event Capture:");
+  LOG_SENSOR("  ", "Trigger Sensor", this->trigger_sensor_);
+  ESP_LOGCONFIG(TAG, "  Threshold: %.1f", this->threshold_);
+  ESP_LOGCONFIG(TAG, "  Sample Rate: %lu Hz (IMA-ADPCM)", this->sample_rate_);
+  ESP_LOGCONFIG(TAG, "  Pre-Trigger: %lu ms, Post-Trigger: %lu ms", this->pre_trigger_ms_, this->post_trigger_ms_);
+  ESP_LOGCONFIG(TAG, "  Hold Off: %lu ms", this->hold_off_ms_);
+  ESP_LOGCONFIG(TAG, "  Clips: %u x %u bytes", this->max_clips_, this->clip_capacity_);
+}
+
+void EventCapture::feed(const std::vector<uint8_t> &data, const audio::AudioStreamInfo &stream_info) {
+  if (this->ring_ == nullptr)
+    return;
+  if (this->decimation_ == 0)
+    this->init_decimation(stream_info.get_sample_rate());
+
+  // first channel only
+  uint8_t bytes_per_sample = stream_info.samples_to_bytes(1);
+  size_t bytes_per_frame = stream_info.frames_to_bytes(1);
+  size_t frames = data.size() / bytes_per_frame;
+  this->scratch_.resize(frames);
+  for (size_t i = 0; i < frames; i++) {
+    this->scratch_[i] =
+        audio::unpack_audio_sample_to_q31(&data[i * bytes_per_frame], bytes_per_sample) / float(INT32_MAX);
+  }
+  if (this->decimation_filter_ != nullptr)
+    this->decimation_filter_->process(this->scratch_);
+
+  for (float x : this->scratch_) {
+    if (++this->decimation_phase_ < this->decimation_)
+      continue;
+    this->decimation_phase_ = 0;
+    auto sample = int16_t(std::clamp<float>(x * INT16_MAX, INT16_MIN, INT16_MAX));
+    uint32_t written = this->blocks_written_.load(std::memory_order_relaxed);
+    uint8_t *block = this->ring_ + (written % this->ring_blocks_) * ImaAdpcmEncoder::BLOCK_SIZE;
+    if (this->encoder_.encode(sample, block))
+      this->blocks_written_.store(written + 1, std::memory_order_release);
+  }
+}
+
+size_t EventCapture::get_clip_count() const { return this->clip_count_; }
+
+const uint8_t *EventCapture::get_clip_data(size_t index) const {
+  return this->clips_[(this->clip_head_ + index) % this->clips_.size()].data;
+}
+
+size_t EventCapture::get_clip_size(size_t index) const {
+  return this->clips_[(this->clip_head_ + index) % this->clips_.size()].size;
+}
+
+float EventCapture::get_clip_level(size_t index) const {
+  return this->clips_[(this->clip_head_ + index) % this->clips_.size()].level;
+}
+
+uint32_t EventCapture::get_clip_timestamp(size_t index) const {
+  return this->clips_[(this->clip_head_ + index) % this->clips_.size()].timestamp;
+}
+
+void EventCapture::pop_clip() {
+  if (this->clip_count_ == 0)
+    return;
+  this->clip_head_ = (this->clip_head_ + 1) % this->clips_.size();
+  this->clip_count_--;
+}
+
+void EventCapture::trigger(float level) {
+  if (this->ring_ == nullptr || this->is_pending_)
+    return;
+  uint32_t now = millis();
+  if (this->has_triggered_ && now - this->last_trigger_time_ < this->hold_off_ms_)
+    return;
+  this->is_pending_ = true;
+  this->has_triggered_ = true;
+  this->trigger_block_ = this->blocks_written_.load(std::memory_order_acquire);
+  this->trigger_level_ = level;
+  this->trigger_time_ = this->last_trigger_time_ = now;
+  ESP_LOGD(TAG, "Triggered at %.1f, recording %lu ms", level, this->post_trigger_ms_);
+  this->enable_loop();
+}
+
+uint32_t EventCapture::ms_to_blocks(uint32_t ms) const {
+  uint64_t samples = uint64_t(this->sample_rate_) * ms / 1000;
+  return (samples + ImaAdpcmEncoder::SAMPLES_PER_BLOCK - 1) / ImaAdpcmEncoder::SAMPLES_PER_BLOCK;
+}
+
+// Runs once in the microphone task, when the source sample rate is known
+void EventCapture::init_decimation(uint32_t source_rate) {
+  uint32_t decimation = std::max<uint32_t>(1, (source_rate + this->sample_rate_ / 2) / this->sample_rate_);
+  this->sample_rate_ = source_rate / decimation;
+  if (decimation > 1) {
+    std::vector<std::array<float, 5>> coeffs;
+    float w0 = 2 * M_PI * DECIMATION_CUTOFF * this->sample_rate_ / source_rate;
+    float cos_w0 = cosf(w0);
+    for (float q : BUTTERWORTH_Q) {
+      float alpha = sinf(w0) / (2 * q);
+      float a0 = 1 + alpha;
+      coeffs.push_back({(1 - cos_w0) / 2 / a0, (1 - cos_w0) / a0, (1 - cos_w0) / 2 / a0, -2 * cos_w0 / a0,
+                        (1 - alpha) / a0});
+    }
+    this->decimation_filter_ = std::make_unique<SOS_Filter>(std::move(coeffs));
+  }
+  this->decimation_ = decimation;
+}
+
+void EventCapture::finish_clip() {
+  this->is_pending_ = false;
+  this->disable_loop();
+
+  uint32_t written = this->blocks_written_.load(std::memory_order_acquire);
+  uint32_t pre_blocks = this->ms_to_blocks(this->pre_trigger_ms_);
+  uint32_t end = this->trigger_block_ + this->ms_to_blocks(this->post_trigger_ms_);
+  uint32_t start = this->trigger_block_ > pre_blocks ? this->trigger_block_ - pre_blocks : 0;
+  // skip blocks already overwritten, leaving one block of slack for the one about to be
+  if (written + 2 > this->ring_blocks_)
+    start = std::max(start, written + 2 - this->ring_blocks_);
+  if (start >= end) {
+    ESP_LOGW(TAG, "Clip was overwritten before it could be saved");
+    return;
+  }
+
+  if (this->clip_count_ == this->clips_.size()) {
+    ESP_LOGW(TAG, "No free clip slots, discarding the oldest clip");
+    this->pop_clip();
+  }
+  auto &clip = this->clips_[(this->clip_head_ + this->clip_count_) % this->clips_.size()];
+  uint32_t blocks = end - start;
+  size_t offset = this->write_wav_header(clip.data, blocks);
+  for (uint32_t b = start; b < end; b++, offset += ImaAdpcmEncoder::BLOCK_SIZE) {
+    memcpy(clip.data + offset, this->ring_ + (b % this->ring_blocks_) * ImaAdpcmEncoder::BLOCK_SIZE,
+           ImaAdpcmEncoder::BLOCK_SIZE);
+  }
+  clip.size = offset;
+  clip.level = this->trigger_level_;
+  clip.timestamp = this->trigger_time_;
+  this->clip_count_++;
+
+  ESP_LOGI(TAG, "Captured %.1f s clip at %.1f (%u bytes, %u stored)",
+           float(blocks * ImaAdpcmEncoder::SAMPLES_PER_BLOCK) / this->sample_rate_, clip.level, clip.size,
+           this->clip_count_);
+  this->on_clip_callback_.call(clip.level);
+}
+
+size_t EventCapture::write_wav_header(uint8_t *data, uint32_t blocks) const {
+  uint32_t data_size = blocks * ImaAdpcmEncoder::BLOCK_SIZE;
+  uint8_t *p = data;
+  auto put_tag = [&p](const char *tag) {
+    memcpy(p, tag, 4);
+    p += 4;
+  };
+  auto put_u16 = [&p](uint16_t v) {
+    *p++ = v & 0xFF;
+    *p++ = v >> 8;
+  };
+  auto put_u32 = [&p](uint32_t v) {
+    for (int i = 0; i < 4; i++)
+      *p++ = (v >> (8 * i)) & 0xFF;
+  };
+  put_tag("RIFF");
+  put_u32(WAV_HEADER_SIZE - 8 + data_size);
+  put_tag("WAVE");
+  put_tag("fmt ");
+  put_u32(20);
+  put_u16(0x11);  // IMA ADPCM
+  put_u16(1);
+  put_u32(this->sample_rate_);
+  put_u32(this->sample_rate_ * ImaAdpcmEncoder::BLOCK_SIZE / ImaAdpcmEncoder::SAMPLES_PER_BLOCK);
+  put_u16(ImaAdpcmEncoder::BLOCK_SIZE);
+  put_u16(4);
+  put_u16(2);
+  put_u16(ImaAdpcmEncoder::SAMPLES_PER_BLOCK);
+  put_tag("fact");
+  put_u32(4);
+  put_u32(blocks * ImaAdpcmEncoder::SAMPLES_PER_BLOCK);
+  put_tag("data");
+  put_u32(data_size);
+  return p - data;
+}
+
+}  // namespace esphome::sound_level_meter
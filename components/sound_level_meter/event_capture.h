@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+
+#include "esphome/core/automation.h"
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/audio/audio.h"
+
+#include "dsp.h"
+
+namespace esphome::sound_level_meter {
+
+// IMA-ADPCM encoder producing standard WAV blocks (format 0x11, mono): a 4 byte header
+// holding the first sample and the step index, followed by 4-bit codes, low nibble first.
+class ImaAdpcmEncoder {
+ public:
+  static constexpr size_t BLOCK_SIZE = 256;
+  static constexpr size_t SAMPLES_PER_BLOCK = (BLOCK_SIZE - 4) * 2 + 1;
+
+  // returns true when the sample completed the block
+  bool encode(int16_t sample, uint8_t *block);
+  void reset();
+
+ protected:
+  int32_t predictor_{0};
+  int32_t index_{0};
+  size_t position_{0};
+
+  uint8_t encode_nibble(int16_t sample);
+};
+
+// Keeps the last pre_trigger + post_trigger of decimated, ADPCM encoded audio in a ring of
+// blocks. The ring is fed from the microphone callback, so none of this runs in the audio task.
+// When the trigger sensor crosses the threshold, the clip is copied out of the ring as a WAV
+// file into one of max_clips preallocated slots (PSRAM if available) once post_trigger has
+// been recorded, where it stays until pop_clip().
+class EventCapture : public Component {
+ public:
+  void set_trigger_sensor(sensor::Sensor *trigger_sensor);
+  void set_threshold(float threshold);
+  void set_sample_rate(uint32_t sample_rate);
+  void set_pre_trigger(uint32_t pre_trigger);
+  void set_post_trigger(uint32_t post_trigger);
+  void set_hold_off(uint32_t hold_off);
+  void set_max_clips(uint8_t max_clips);
+  void add_on_clip_callback(std::function<void(float)> &&callback);
+  virtual void setup() override;
+  virtual void loop() override;
+  virtual void dump_config() override;
+
+  // called from the microphone task with the raw source samples
+  void feed(const std::vector<uint8_t> &data, const audio::AudioStreamInfo &stream_info);
+  // captured clips as WAV files, oldest first
+  size_t get_clip_count() const;
+  const uint8_t *get_clip_data(size_t index) const;
+  size_t get_clip_size(size_t index) const;
+  float get_clip_level(size_t index) const;
+  uint32_t get_clip_timestamp(size_t index) const;
+  void pop_clip();
+  // records a clip as if the threshold was crossed
+  void trigger(float level);
+
+ protected:
+  struct Clip {
+    uint8_t *data{nullptr};
+    size_t size{0};
+    float level{NAN};
+    uint32_t timestamp{0};
+  };
+
+  sensor::Sensor *trigger_sensor_{nullptr};
+  float threshold_{NAN};
+  uint32_t sample_rate_{16000};
+  uint32_t pre_trigger_ms_{3000};
+  uint32_t post_trigger_ms_{2000};
+  uint32_t hold_off_ms_{60000};
+  uint8_t max_clips_{2};
+  CallbackManager<void(float)> on_clip_callback_;
+
+  // written by the microphone task only
+  std::unique_ptr<SOS_Filter> decimation_filter_;
+  std::vector<float> scratch_;
+  uint32_t decimation_{0};
+  uint32_t decimation_phase_{0};
+  ImaAdpcmEncoder encoder_;
+  // ring of encoded blocks, blocks_written_ counts completed blocks since setup
+  uint8_t *ring_{nullptr};
+  uint32_t ring_blocks_{0};
+  std::atomic<uint32_t> blocks_written_{0};
+
+  // main loop only
+  std::vector<Clip> clips_;
+  size_t clip_head_{0};
+  size_t clip_count_{0};
+  size_t clip_capacity_{0};
+  bool is_pending_{false};
+  uint32_t trigger_block_{0};
+  float trigger_level_{NAN};
+  uint32_t trigger_time_{0};
+  uint32_t last_trigger_time_{0};
+  bool has_triggered_{false};
+  float previous_state_{NAN};
+
+  uint32_t ms_to_blocks(uint32_t ms) const;
+  void init_decimation(uint32_t source_rate);
+  void finish_clip();
+  size_t write_wav_header(uint8_t *data, uint32_t blocks) const;
+};
+
+class ClipTrigger : public Trigger<float> {
+ public:
+  explicit ClipTrigger(EventCapture *parent) {
+    parent->add_on_clip_callback([this](float level) { this->trigger(level); });
+  }
+};
+
+}  // namespace esphome::sound_level_meter
@@ -1,4 +1,6 @@
 #include "sound_level_meter.h"
+#include "event_capture.h"
+#include "esphome/components/instrumentation/profile_scope.h"
 
 namespace esphome::sound_level_meter {
 
@@ -11,6 +13,22 @@ static constexpr const char *TAG = "sound_level_meter";
 // see: https://dsp.stackexchange.com/a/50947/65262
 static constexpr float DBFS_OFFSET = 20 * log10(sqrt(2));
 static constexpr uint32_t AUDIO_BUFFER_DURATION_MS = 20;
+// ring buffer fill levels at which the audio task doubles / halves its read block size
+static constexpr float BLOCK_GROW_FILL = 0.5f;
+static constexpr float BLOCK_SHRINK_FILL = 0.125f;
+
+// Repacks little-endian PCM samples to a narrower width, keeping the most significant bytes.
+// The optional shift amplifies by 2^shift (saturating) before truncation, so quiet signals
+// keep more resolution at the cost of clipping 6 dB lower per bit.
+static void repack_samples(const uint8_t *src, uint8_t src_bytes, uint8_t *dst, uint8_t dst_bytes, size_t samples,
+                           uint8_t shift) {
+  for (size_t i = 0; i < samples; i++, src += src_bytes, dst += dst_bytes) {
+    int64_t sample = int64_t(audio::unpack_audio_sample_to_q31(src, src_bytes)) << shift;
+    int32_t q31 = std::clamp<int64_t>(sample, INT32_MIN, INT32_MAX);
+    for (uint8_t b = 0; b < dst_bytes; b++)
+      dst[b] = q31 >> (32 - 8 * (dst_bytes - b));
+  }
+}
 
 /* SoundLevelMeter */
 
@@ -22,6 +40,13 @@ void SoundLevelMeter::set_ring_buffer_size(uint32_t ring_buffer_size_ms) {
   this->ring_buffer_size_ms_ = ring_buffer_size_ms;
 }
 uint32_t SoundLevelMeter::get_ring_buffer_size() { return this->ring_buffer_size_ms_; }
+void SoundLevelMeter::set_max_block_size(uint32_t max_block_size_ms) {
+  this->max_block_size_ms_ = std::max(max_block_size_ms, AUDIO_BUFFER_DURATION_MS);
+}
+void SoundLevelMeter::set_ingest_bits_per_sample(uint8_t ingest_bits_per_sample) {
+  this->ingest_bytes_per_sample_ = ingest_bits_per_sample / 8;
+}
+void SoundLevelMeter::set_ingest_shift(uint8_t ingest_shift) { this->ingest_shift_ = ingest_shift; }
 void SoundLevelMeter::set_microphone_source(microphone::MicrophoneSource *microphone_source) {
   this->microphone_source_ = microphone_source;
 }
@@ -31,6 +56,11 @@ void SoundLevelMeter::set_warmup_interval(uint32_t warmup_interval_ms) {
 void SoundLevelMeter::set_task_stack_size(uint32_t task_stack_size) { this->task_stack_size_ = task_stack_size; }
 void SoundLevelMeter::set_task_priority(uint8_t task_priority) { this->task_priority_ = task_priority; }
 void SoundLevelMeter::set_task_core(uint8_t task_core) { this->task_core_ = task_core; }
+void SoundLevelMeter::set_pipeline(uint8_t pipeline_core, uint8_t pipeline_blocks) {
+  this->is_pipeline_ = true;
+  this->pipeline_core_ = pipeline_core;
+  this->pipeline_blocks_ = std::max<uint8_t>(pipeline_blocks, 2);
+}
 void SoundLevelMeter::set_mic_sensitivity(optional<float> mic_sensitivity) { this->mic_sensitivity_ = mic_sensitivity; }
 optional<float> SoundLevelMeter::get_mic_sensitivity() { return this->mic_sensitivity_; }
 void SoundLevelMeter::set_mic_sensitivity_ref(optional<float> mic_sensitivity_ref) {
@@ -43,6 +73,48 @@ void SoundLevelMeter::set_is_high_freq(bool is_high_freq) { this->is_high_freq_
 void SoundLevelMeter::set_is_auto_start(bool is_auto_start) { this->is_auto_start_ = is_auto_start; }
 void SoundLevelMeter::add_sensor(SoundLevelMeterSensor *sensor) { this->sensors_.push_back(sensor); }
 void SoundLevelMeter::add_dsp_filter(Filter *dsp_filter) { this->dsp_filters_.push_back(dsp_filter); }
+void SoundLevelMeter::set_process_time_p50_sensor(sensor::Sensor *process_time_p50_sensor) {
+  this->process_time_p50_sensor_ = process_time_p50_sensor;
+}
+void SoundLevelMeter::set_process_time_p99_sensor(sensor::Sensor *process_time_p99_sensor) {
+  this->process_time_p99_sensor_ = process_time_p99_sensor;
+}
+void SoundLevelMeter::set_ring_buffer_peak_sensor(sensor::Sensor *ring_buffer_peak_sensor) {
+  this->ring_buffer_peak_sensor_ = ring_buffer_peak_sensor;
+}
+void SoundLevelMeter::set_dropped_bytes_sensor(sensor::Sensor *dropped_bytes_sensor) {
+  this->dropped_bytes_sensor_ = dropped_bytes_sensor;
+}
+void SoundLevelMeter::set_dropped_frames_sensor(sensor::Sensor *dropped_frames_sensor) {
+  this->dropped_frames_sensor_ = dropped_frames_sensor;
+}
+void SoundLevelMeter::set_task_stack_high_water_sensor(sensor::Sensor *task_stack_high_water_sensor) {
+  this->task_stack_high_water_sensor_ = task_stack_high_water_sensor;
+}
+void SoundLevelMeter::set_measurement_gap_sensor(sensor::Sensor *measurement_gap_sensor) {
+  this->measurement_gap_sensor_ = measurement_gap_sensor;
+}
+void SoundLevelMeter::set_duty_cycle(uint32_t measure_interval_ms, uint32_t period_ms) {
+  this->duty_measure_ms_ = measure_interval_ms;
+  this->duty_period_ms_ = period_ms;
+}
+void SoundLevelMeter::set_active_current(float active_current) { this->active_current_ = active_current; }
+void SoundLevelMeter::set_cpu_time_saved_sensor(sensor::Sensor *cpu_time_saved_sensor) {
+  this->cpu_time_saved_sensor_ = cpu_time_saved_sensor;
+}
+void SoundLevelMeter::set_current_saved_sensor(sensor::Sensor *current_saved_sensor) {
+  this->current_saved_sensor_ = current_saved_sensor;
+}
+void SoundLevelMeter::set_stage1_utilization_sensor(sensor::Sensor *stage1_utilization_sensor) {
+  this->stage1_utilization_sensor_ = stage1_utilization_sensor;
+}
+void SoundLevelMeter::set_stage2_utilization_sensor(sensor::Sensor *stage2_utilization_sensor) {
+  this->stage2_utilization_sensor_ = stage2_utilization_sensor;
+}
+void SoundLevelMeter::set_event_capture(EventCapture *event_capture) { this->event_capture_ = event_capture; }
+#ifdef USE_CHECKPOINT
+void SoundLevelMeter::set_checkpoint(checkpoint::Checkpoint *checkpoint) { this->checkpoint_ = checkpoint; }
+#endif
 
 audio::AudioStreamInfo SoundLevelMeter::get_audio_stream_info() const {
   return this->microphone_source_->get_audio_stream_info();
@@ -52,32 +124,91 @@ uint32_t SoundLevelMeter::ms_to_frames(uint32_t ms) {
   return this->get_audio_stream_info().get_sample_rate() * (ms / 1000.f);
 }
 
+uint8_t SoundLevelMeter::get_ingest_bytes_per_sample() const {
+  if (this->ingest_bytes_per_sample_ > 0)
+    return this->ingest_bytes_per_sample_;
+  return this->get_audio_stream_info().samples_to_bytes(1);
+}
+
+size_t SoundLevelMeter::ingest_frames_to_bytes(uint32_t frames) const {
+  return frames * this->get_audio_stream_info().get_channels() * this->get_ingest_bytes_per_sample();
+}
+
+bool SoundLevelMeter::is_repack() const {
+  return this->ingest_shift_ > 0 ||
+         this->get_ingest_bytes_per_sample() != this->get_audio_stream_info().samples_to_bytes(1);
+}
+
 void SoundLevelMeter::dump_config() {
   ESP_LOGCONFIG(TAG, "Sound Level Meter:");
   ESP_LOGCONFIG(TAG, "  Ring Buffer Size: %u ms)", this->ring_buffer_size_ms_);
+  ESP_LOGCONFIG(TAG, "  Channels: %u", this->get_audio_stream_info().get_channels());
+  ESP_LOGCONFIG(TAG, "  Ingest: %u bits, %u bits headroom shift", this->get_ingest_bytes_per_sample() * 8,
+                this->ingest_shift_);
+  ESP_LOGCONFIG(TAG, "  Block Size: %lu-%lu ms", AUDIO_BUFFER_DURATION_MS, this->max_block_size_ms_);
   ESP_LOGCONFIG(TAG, "  Warmup Interval: %lu ms", this->warmup_interval_ms_);
   ESP_LOGCONFIG(TAG, "  Task Stack Size: %lu", this->task_stack_size_);
   ESP_LOGCONFIG(TAG, "  Task Priority: %u", this->task_priority_);
   ESP_LOGCONFIG(TAG, "  Task Core: %u", this->task_core_);
+  if (this->is_pipeline_) {
+    ESP_LOGCONFIG(TAG, "  Pipeline: Core %u, %u blocks, %u shared filters", this->pipeline_core_,
+                  this->pipeline_blocks_, this->shared_prefix_.size());
+  }
   ESP_LOGCONFIG(TAG, "  High Freq: %s", YESNO(this->is_high_freq_));
   ESP_LOGCONFIG(TAG, "  Auto Start: %s", YESNO(this->is_auto_start_));
+  if (this->duty_period_ms_ > 0)
+    ESP_LOGCONFIG(TAG, "  Duty Cycle: %lu ms every %lu ms", this->duty_measure_ms_, this->duty_period_ms_);
   LOG_UPDATE_INTERVAL(this);
   ESP_LOGCONFIG(TAG, "Sensors:");
   for (auto *s : this->sensors_)
     LOG_SENSOR("    ", "Sound Pressure Level", s);
+  LOG_SENSOR("  ", "Process Time p50", this->process_time_p50_sensor_);
+  LOG_SENSOR("  ", "Process Time p99", this->process_time_p99_sensor_);
+  LOG_SENSOR("  ", "Ring Buffer Peak", this->ring_buffer_peak_sensor_);
+  LOG_SENSOR("  ", "Dropped Bytes", this->dropped_bytes_sensor_);
+  LOG_SENSOR("  ", "Dropped Frames", this->dropped_frames_sensor_);
+  LOG_SENSOR("  ", "Task Stack High Water", this->task_stack_high_water_sensor_);
+  LOG_SENSOR("  ", "Measurement Gap", this->measurement_gap_sensor_);
+  LOG_SENSOR("  ", "CPU Time Saved", this->cpu_time_saved_sensor_);
+  LOG_SENSOR("  ", "Current Saved", this->current_saved_sensor_);
+  LOG_SENSOR("  ", "Stage 1 Utilization", this->stage1_utilization_sensor_);
+  LOG_SENSOR("  ", "Stage 2 Utilization", this->stage2_utilization_sensor_);
 }
 
 void SoundLevelMeter::setup() {
   this->sort_sensors();
+  this->find_shared_prefix();
+  for (auto f : this->dsp_filters_)
+    f->set_channels(this->get_audio_stream_info().get_channels());
+#ifdef USE_CHECKPOINT
+  // after sort_sensors(), the record follows the sensor order
+  if (this->checkpoint_ != nullptr)
+    this->setup_checkpoint();
+#endif
 
   this->microphone_source_->add_data_callback([this](const std::vector<uint8_t> &data) {
     auto ring_buffer = this->ring_buffer_weak_.lock();
     if (ring_buffer) {
+      if (this->event_capture_ != nullptr)
+        this->event_capture_->feed(data, this->get_audio_stream_info());
+      const uint8_t *bytes = data.data();
+      size_t size = data.size();
+      if (this->is_repack()) {
+        uint8_t src_bytes = this->get_audio_stream_info().samples_to_bytes(1);
+        uint8_t dst_bytes = this->get_ingest_bytes_per_sample();
+        size_t samples = size / src_bytes;
+        this->ingest_buffer_.resize(samples * dst_bytes);
+        repack_samples(bytes, src_bytes, this->ingest_buffer_.data(), dst_bytes, samples, this->ingest_shift_);
+        bytes = this->ingest_buffer_.data();
+        size = this->ingest_buffer_.size();
+      }
       size_t bytes_free = ring_buffer->free();
-      if (bytes_free < data.size()) {
+      if (bytes_free < size) {
+        // RingBuffer::write() discards the oldest data to make room for the new one
+        this->dropped_bytes_ += size - bytes_free;
         defer([] { ESP_LOGW(TAG, "Not enough free bytes in ring buffer to store incoming audio data."); });
       }
-      ring_buffer->write((void *) data.data(), data.size());
+      ring_buffer->write((void *) bytes, size);
       this->ring_buffer_stats_free_ = std::min(ring_buffer->free(), this->ring_buffer_stats_free_);
     }
   });
@@ -88,6 +219,7 @@ void SoundLevelMeter::setup() {
 }
 
 void SoundLevelMeter::loop() {
+  PROFILE_SCOPE("sound_level_meter.loop");
   // Process no more than 5 items per loop iteration.
   // When there are many sensors with short update intervals,
   // a large number of state updates (publish_state) may be queued.
@@ -105,7 +237,7 @@ void SoundLevelMeter::loop() {
   {
     uint32_t max_items = 5;
     std::lock_guard<std::mutex> lock(this->defer_mutex_);
-    for (int i = 0; i < max_items && !this->defer_queue_.empty(); i++) {
+    for (uint32_t i = 0; i < max_items && !this->defer_queue_.empty(); i++) {
       tasks.push_back(std::move(this->defer_queue_.front()));
       this->defer_queue_.pop_front();
     }
@@ -116,45 +248,133 @@ void SoundLevelMeter::loop() {
 }
 
 void SoundLevelMeter::start() {
+  if (this->duty_period_ms_ > 0) {
+    this->set_interval("duty_cycle", this->duty_period_ms_, [this]() { this->start_task(true); });
+  }
+#ifdef USE_CHECKPOINT
+  // continue from restored accumulators once
+  bool keep_state = this->is_restored_;
+  this->is_restored_ = false;
+  this->start_task(keep_state);
+#else
+  this->start_task(false);
+#endif
+}
+
+void SoundLevelMeter::stop() {
+  this->cancel_interval("duty_cycle");
+  this->cancel_timeout("duty_cycle");
+  this->stop_task(false);
+}
+
+// With duty cycling, the task is started and stopped every period, but filter state and
+// sensor accumulators are kept across the pause, so statistics continue where they left off.
+void SoundLevelMeter::start_task(bool keep_state) {
   if (!this->is_running_) {
+    this->is_keep_state_ = keep_state;
     xTaskCreatePinnedToCore(SoundLevelMeter::task, "sound_level_meter", this->task_stack_size_, this,
                             this->task_priority_, &this->task_handle_, this->task_core_);
     ESP_LOGD(TAG, "Sound Level Meter started");
+    if (this->duty_period_ms_ > 0) {
+      this->set_timeout("duty_cycle", this->warmup_interval_ms_ + this->duty_measure_ms_, [this]() {
+        this->stop_task(true);
+        this->publish_duty_cycle_savings();
+      });
+    }
   }
 }
 
-void SoundLevelMeter::stop() {
+void SoundLevelMeter::stop_task(bool keep_state) {
   if (this->is_running() && !this->is_pending_stop_) {
+    this->is_keep_state_ = keep_state;
     this->is_pending_stop_ = true;
     ESP_LOGD(TAG, "Sound Level Meter stopped");
   }
 }
 
+// fraction of wall-clock time during which samples are actually measured
+float SoundLevelMeter::get_duty_fraction() {
+  if (this->duty_period_ms_ == 0)
+    return 1.f;
+  return std::min(1.f, float(this->duty_measure_ms_) / this->duty_period_ms_);
+}
+
+void SoundLevelMeter::publish_duty_cycle_savings() {
+  // the task is off for the period minus measure and warmup intervals
+  uint32_t active_ms = this->duty_measure_ms_ + this->warmup_interval_ms_;
+  float idle_fraction = active_ms < this->duty_period_ms_ ? 1.f - float(active_ms) / this->duty_period_ms_ : 0.f;
+  // CPU seconds per hour the audio task would have spent processing if it ran continuously
+  float cpu_saved = this->cpu_util_ * idle_fraction * 3600;
+  // average current saved (mA) given the estimated extra draw while measuring
+  float current_saved = this->active_current_ * idle_fraction * 1000;
+  ESP_LOGD(TAG, "Duty Cycle: %.0f%% idle, saving %.1f CPU s/h and %.2f mA", idle_fraction * 100, cpu_saved,
+           current_saved);
+  if (this->cpu_time_saved_sensor_ != nullptr)
+    this->cpu_time_saved_sensor_->publish_state(cpu_saved);
+  if (this->current_saved_sensor_ != nullptr)
+    this->current_saved_sensor_->publish_state(current_saved);
+}
+
 bool SoundLevelMeter::is_running() { return this->is_running_; }
 
 void SoundLevelMeter::task(void *param) {
   SoundLevelMeter *this_ = reinterpret_cast<SoundLevelMeter *>(param);
   this_->is_running_ = true;
   {
-    this_->ring_buffer_ = RingBuffer::create(this_->get_audio_stream_info().ms_to_bytes(this_->ring_buffer_size_ms_));
+    this_->ring_buffer_ =
+        RingBuffer::create(this_->ingest_frames_to_bytes(this_->ms_to_frames(this_->ring_buffer_size_ms_)));
     this_->ring_buffer_weak_ = this_->ring_buffer_;
-    BufferStack<float> buffers(this_->ms_to_frames(AUDIO_BUFFER_DURATION_MS));
-
-    this_->reset();
+    // allocate for the largest block once, adaptive sizing only shrinks/grows within capacity,
+    // with the pipeline enabled blocks are read into the pool instead
+    uint32_t max_frames = this_->ms_to_frames(this_->max_block_size_ms_);
+    uint8_t channels = this_->get_audio_stream_info().get_channels();
+    ChannelBuffers buffers(channels, BufferStack<float>(this_->is_pipeline_ ? 0 : max_frames));
+    if (channels > 1)
+      this_->read_buffer_.resize(this_->ingest_frames_to_bytes(max_frames));
+    uint32_t block_size_ms = AUDIO_BUFFER_DURATION_MS;
+
+    if (!this_->is_keep_state_)
+      this_->reset();
 
     this_->microphone_source_->start();
 
+    // When duty cycling, statistics spanning more than one measure interval are computed
+    // over the sampled fraction of the update interval, so they are still published once
+    // per update_interval of wall-clock time. Shorter ones are unaffected.
+    float duty_fraction = this_->get_duty_fraction();
+    auto sampled_interval = [this_, duty_fraction](uint32_t update_interval_ms) -> uint32_t {
+      if (duty_fraction < 1.f && update_interval_ms > this_->duty_measure_ms_)
+        return update_interval_ms * duty_fraction;
+      return update_interval_ms;
+    };
     for (auto &s : this_->sensors_) {
-      s->update_samples_ = this_->ms_to_frames(s->update_interval_ms_);
+      s->update_samples_ = std::max<uint32_t>(1, this_->ms_to_frames(sampled_interval(s->update_interval_ms_)));
     }
+    uint32_t stats_frames = this_->ms_to_frames(sampled_interval(this_->update_interval_ms_));
 
     if (this_->is_high_freq_)
       this_->high_freq_.start();
 
+    if (this_->is_pipeline_)
+      this_->start_pipeline();
+
+    // samples read during warmup are run through the filters only, so that
+    // filter transients have settled by the time sensors start accumulating
     auto warmup_start = millis();
-    while (millis() - warmup_start < this_->warmup_interval_ms_)
-      this_->read_samples(buffers, 2 * pdMS_TO_TICKS(AUDIO_BUFFER_DURATION_MS));
+    while (millis() - warmup_start < this_->warmup_interval_ms_) {
+      auto *block = this_->acquire_block(buffers, block_size_ms);
+      if (block == nullptr)
+        continue;
+      if (this_->read_samples(*block, this_->ms_to_frames(block_size_ms), 2 * pdMS_TO_TICKS(block_size_ms)) > 0)
+        this_->dispatch_block(*block, false);
+    }
+    // overflows during warmup are not a measurement gap
+    this_->take_gap();
+#ifdef USE_CHECKPOINT
+    this_->process_restored_gap();
+#endif
 
+    Histogram process_time_histogram;
     uint32_t process_time = 0, process_count = 0;
     uint64_t process_start;
 
@@ -162,6 +382,7 @@ void SoundLevelMeter::task(void *param) {
       if (!this_->microphone_source_->is_running()) {
         if (!this_->status_has_warning()) {
           this_->status_set_warning("Microphone isn't running, can't compute statistics");
+          this_->wait_pipeline_idle();
           this_->reset();
         }
         delay(AUDIO_BUFFER_DURATION_MS);
@@ -172,38 +393,42 @@ void SoundLevelMeter::task(void *param) {
         this_->status_clear_warning();
       }
 
-      buffers.reset();
+      auto *block = this_->acquire_block(buffers, block_size_ms);
+      if (block == nullptr)
+        continue;
 
-      if (this_->read_samples(buffers, 2 * pdMS_TO_TICKS(AUDIO_BUFFER_DURATION_MS)) > 0) {
+      size_t frames = this_->read_samples(*block, this_->ms_to_frames(block_size_ms), 2 * pdMS_TO_TICKS(block_size_ms));
+      if (frames > 0) {
         process_start = esp_timer_get_time();
 
-        this_->process(buffers);
+        this_->dispatch_block(*block, true);
+        block_size_ms = this_->adapt_block_size(block_size_ms);
 
-        process_time += esp_timer_get_time() - process_start;
-        process_count += buffers.current().size();
+        uint32_t block_time = esp_timer_get_time() - process_start;
+        process_time_histogram.add(block_time);
+        process_time += block_time;
+        process_count += frames;
 
-        if (process_count >= this_->ms_to_frames(this_->update_interval_ms_)) {
-          auto cpu_util = float(process_time) / 1000 / this_->update_interval_ms_;
-          auto rb_size = this_->ring_buffer_->available() + this_->ring_buffer_->free();
-          auto rb_util = float(rb_size - this_->ring_buffer_stats_free_) / rb_size;
-          auto core = xPortGetCoreID();
-          this_->defer([cpu_util, rb_util, core]() {
-            ESP_LOGD(TAG, "CPU (Core %u) Utilization: %.1f%%, Ring Buffer Utilization: %.1f%%", core, cpu_util * 100,
-                     rb_util * 100);
-          });
+        if (process_count >= stats_frames) {
+          this_->publish_stats(process_time_histogram, process_time, process_count);
+          process_time_histogram.reset();
           process_time = process_count = 0;
-          this_->ring_buffer_stats_free_ = SIZE_MAX;
         }
       }
     }
+    if (this_->is_pipeline_)
+      this_->stop_pipeline();
   }
   this_->ring_buffer_.reset();
+  this_->read_buffer_.clear();
+  this_->read_buffer_.shrink_to_fit();
   this_->microphone_source_->stop();
 
   if (this_->is_high_freq_)
     this_->high_freq_.stop();
 
-  this_->reset();
+  if (!this_->is_keep_state_)
+    this_->reset();
 
   this_->is_running_ = false;
   this_->is_pending_stop_ = false;
@@ -212,68 +437,396 @@ void SoundLevelMeter::task(void *param) {
   vTaskDelete(handle);
 }
 
+// Stage 2 of the pipeline: runs the filters not shared by all sensors and the statistics
+// on blocks handed over by the audio task, until stop_pipeline() is called and the
+// remaining blocks are drained.
+void SoundLevelMeter::pipeline_task(void *param) {
+  SoundLevelMeter *this_ = reinterpret_cast<SoundLevelMeter *>(param);
+  while (true) {
+    auto *block = this_->pipeline_pool_->peek();
+    if (block == nullptr) {
+      if (this_->is_pipeline_stopping_ && this_->pipeline_pool_->empty())
+        break;
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(AUDIO_BUFFER_DURATION_MS));
+      continue;
+    }
+
+    uint64_t process_start = esp_timer_get_time();
+    size_t frames = block->channels[0].current().size();
+    if (block->update_sensors)
+      this_->process_gap(block->gap);
+    this_->process(block->channels, block->update_sensors, this_->shared_prefix_.size());
+    if (block->update_sensors) {
+      this_->stage2_time_ += esp_timer_get_time() - process_start;
+      this_->stage2_frames_ += frames;
+    }
+
+    this_->pipeline_pool_->release();
+    xTaskNotifyGive(this_->pipeline_producer_);
+  }
+  this_->pipeline_task_handle_ = nullptr;
+  vTaskDelete(nullptr);
+}
+
+void SoundLevelMeter::start_pipeline() {
+  this->pipeline_pool_ =
+      std::make_unique<BlockPool>(this->pipeline_blocks_, this->ms_to_frames(this->max_block_size_ms_),
+                                  this->get_audio_stream_info().get_channels());
+  this->pipeline_producer_ = xTaskGetCurrentTaskHandle();
+  this->is_pipeline_stopping_ = false;
+  this->stage2_time_ = this->stage2_frames_ = 0;
+  xTaskCreatePinnedToCore(SoundLevelMeter::pipeline_task, "sound_level_meter_stats", this->task_stack_size_, this,
+                          this->task_priority_, &this->pipeline_task_handle_, this->pipeline_core_);
+}
+
+void SoundLevelMeter::stop_pipeline() {
+  this->is_pipeline_stopping_ = true;
+  xTaskNotifyGive(this->pipeline_task_handle_);
+  while (this->pipeline_task_handle_ != nullptr)
+    delay(1);
+  this->pipeline_pool_.reset();
+}
+
+// waits until stage 2 has processed every block, so the sensors can be safely reset
+void SoundLevelMeter::wait_pipeline_idle() {
+  while (this->is_pipeline_ && !this->pipeline_pool_->empty())
+    delay(1);
+}
+
+// Returns the buffers to read the next block into: the task's own ones, or with the pipeline
+// enabled, a free pool block. If all blocks are in flight, it waits for stage 2 to release one
+// and returns nullptr on timeout, so the caller gets to check for a pending stop.
+ChannelBuffers *SoundLevelMeter::acquire_block(ChannelBuffers &buffers, uint32_t block_size_ms) {
+  if (!this->is_pipeline_)
+    return &buffers;
+  auto *block = this->pipeline_pool_->acquire();
+  if (block == nullptr) {
+    ulTaskNotifyTake(pdTRUE, 2 * pdMS_TO_TICKS(block_size_ms));
+    block = this->pipeline_pool_->acquire();
+  }
+  return block != nullptr ? &block->channels : nullptr;
+}
+
+// The shared filters are applied first (in place, without pushing a buffer). Without the
+// pipeline the rest of the block is processed right away, otherwise it's handed to stage 2.
+void SoundLevelMeter::dispatch_block(ChannelBuffers &buffers, bool update_sensors) {
+  this->apply_shared_prefix(buffers);
+  if (!this->is_pipeline_) {
+    if (update_sensors)
+      this->process_gap(this->take_gap());
+    this->process(buffers, update_sensors, this->shared_prefix_.size());
+    return;
+  }
+  // acquire() returns the same block until it's committed
+  auto *block = this->pipeline_pool_->acquire();
+  block->gap = update_sensors ? this->take_gap() : 0;
+  block->update_sensors = update_sensors;
+  this->pipeline_pool_->commit();
+  xTaskNotifyGive(this->pipeline_task_handle_);
+}
+
 // Arranging sensors in a sorted order so that those with the same
 // filters (or prefix) appear consecutively. This enables more efficient
 // computations by applying filters only once for each common prefix of filters
 void SoundLevelMeter::sort_sensors() {
   std::sort(this->sensors_.begin(), this->sensors_.end(), [](SoundLevelMeterSensor *a, SoundLevelMeterSensor *b) {
+    if (a->channel_ != b->channel_)
+      return a->channel_ < b->channel_;
     return std::lexicographical_compare(a->dsp_filters_.begin(), a->dsp_filters_.end(), b->dsp_filters_.begin(),
                                         b->dsp_filters_.end());
   });
 }
 
-size_t SoundLevelMeter::read_samples(std::vector<float> &data, TickType_t ticks_to_wait) {
-  uint8_t bytes_per_sample = this->get_audio_stream_info().samples_to_bytes(1);
+// Filters applied by every sensor (of every channel), in order. They are applied to channel
+// pairs at once, and with the pipeline enabled they run in stage 1.
+void SoundLevelMeter::find_shared_prefix() {
+  this->shared_prefix_.clear();
+  if (this->sensors_.empty())
+    return;
+  this->shared_prefix_ = this->sensors_.front()->dsp_filters_;
+  for (auto s : this->sensors_) {
+    size_t i = 0;
+    while (i < this->shared_prefix_.size() && i < s->dsp_filters_.size() &&
+           s->dsp_filters_[i] == this->shared_prefix_[i])
+      i++;
+    this->shared_prefix_.resize(i);
+  }
+}
+
+// Reads up to frames frames, converted to floats and split into one buffer per channel.
+// Returns the number of frames read.
+size_t SoundLevelMeter::read_samples(ChannelBuffers &channels, uint32_t frames, TickType_t ticks_to_wait) {
+  uint8_t bytes_per_sample = this->get_ingest_bytes_per_sample();
+  // undo the headroom shift applied on ingest, so levels are unaffected by it
+  float scale = 1.f / (float(INT32_MAX) * (1 << this->ingest_shift_));
+
+  for (auto &c : channels)
+    c.reset(frames);
+
+  if (channels.size() == 1) {
+    // mono samples are converted in place, back to front, as floats are at least as wide
+    std::vector<float> &data = channels[0];
+    size_t bytes_read = this->ring_buffer_->read(data.data(), data.size() * bytes_per_sample, ticks_to_wait);
+    size_t samples_read = bytes_read / bytes_per_sample;
+    if (samples_read > 0) {
+      data.resize(samples_read);
+      auto data_as_uint8 = reinterpret_cast<const uint8_t *>(data.data());
+      for (int i = bytes_read - bytes_per_sample, j = samples_read - 1; i >= 0; i -= bytes_per_sample, j--) {
+        data[j] = audio::unpack_audio_sample_to_q31(&data_as_uint8[i], bytes_per_sample) * scale;
+      }
+    }
+    return samples_read;
+  }
 
-  size_t bytes_read = this->ring_buffer_->read(data.data(), data.size() * bytes_per_sample, ticks_to_wait);
-  size_t samples_read = bytes_read / bytes_per_sample;
-  if (samples_read > 0) {
-    data.resize(samples_read);
-    auto data_as_uint8 = reinterpret_cast<const uint8_t *>(data.data());
-    for (int i = bytes_read - bytes_per_sample, j = samples_read - 1; i >= 0; i -= bytes_per_sample, j--) {
-      data[j] = audio::unpack_audio_sample_to_q31(&data_as_uint8[i], bytes_per_sample) / float(INT32_MAX);
+  size_t frame_bytes = bytes_per_sample * channels.size();
+  frames = std::min(channels[0].current().size(), this->read_buffer_.size() / frame_bytes);
+  size_t bytes_read = this->ring_buffer_->read(this->read_buffer_.data(), frames * frame_bytes, ticks_to_wait);
+  size_t frames_read = bytes_read / frame_bytes;
+  if (frames_read > 0) {
+    for (size_t c = 0; c < channels.size(); c++) {
+      std::vector<float> &data = channels[c];
+      data.resize(frames_read);
+      const uint8_t *src = &this->read_buffer_[c * bytes_per_sample];
+      for (size_t i = 0; i < frames_read; i++, src += frame_bytes)
+        data[i] = audio::unpack_audio_sample_to_q31(src, bytes_per_sample) * scale;
     }
   }
-  return samples_read;
+  return frames_read;
 }
 
-void SoundLevelMeter::process(BufferStack<float> &buffers) {
-  std::vector<Filter *> prefix;
-  for (auto s : this->sensors_) {
-    int i = 0, n = s->dsp_filters_.size(), m = prefix.size();
-    // finding common prefx
-    while (i < n && i < m && s->dsp_filters_[i] == prefix[i])
-      i++;
+// Filters shared by all sensors are applied in place, two channels at a time
+void SoundLevelMeter::apply_shared_prefix(ChannelBuffers &channels) {
+  for (auto f : this->shared_prefix_) {
+    size_t c = 0;
+    for (; c + 1 < channels.size(); c += 2)
+      f->process_pair(channels[c], channels[c + 1], c);
+    if (c < channels.size())
+      f->process(channels[c], c);
+  }
+}
 
-    // discard applied filters beyond common prefix (if any)
-    while (prefix.size() > i) {
-      prefix.pop_back();
-      buffers.pop();
-    }
+// prefix_depth filters of shared_prefix_ are already applied in place to the buffers
+void SoundLevelMeter::process(ChannelBuffers &channels, bool update_sensors, size_t prefix_depth) {
+#ifdef USE_CHECKPOINT
+  std::lock_guard<std::mutex> lock(this->state_mutex_);
+#endif
+  // sensors are sorted by channel, then by filters
+  for (uint8_t c = 0; c < channels.size(); c++) {
+    auto &buffers = channels[c];
+    std::vector<Filter *> prefix(this->shared_prefix_.begin(), this->shared_prefix_.begin() + prefix_depth);
+    for (auto s : this->sensors_) {
+      if (s->channel_ != c)
+        continue;
+      size_t i = 0, n = s->dsp_filters_.size(), m = prefix.size();
+      // finding common prefx
+      while (i < n && i < m && s->dsp_filters_[i] == prefix[i])
+        i++;
+
+      // discard applied filters beyond common prefix (if any)
+      while (prefix.size() > i) {
+        prefix.pop_back();
+        buffers.pop();
+      }
 
-    // apply new filters from current sensor on top of common prefix
-    for (; i < s->dsp_filters_.size(); i++) {
-      auto f = s->dsp_filters_[i];
-      buffers.push();
-      f->process(buffers);
-      prefix.push_back(f);
+      // apply new filters from current sensor on top of common prefix
+      for (; i < s->dsp_filters_.size(); i++) {
+        auto f = s->dsp_filters_[i];
+        buffers.push();
+        f->process(buffers, c);
+        prefix.push_back(f);
+      }
+      if (update_sensors)
+        s->process(buffers);
     }
-    s->process(buffers);
   }
 }
 
+// Audio discarded by the ring buffer on overflow is accounted as a measurement gap:
+// sensors advance their update counters over the lost samples without accumulating them,
+// so every value still spans update_interval of wall-clock time, but is normalised
+// only over the samples that were actually processed.
+uint32_t SoundLevelMeter::take_gap() {
+  uint32_t dropped_frames = this->dropped_bytes_ / this->ingest_frames_to_bytes(1);
+  uint32_t gap = dropped_frames - this->gap_frames_;
+  this->gap_frames_ = dropped_frames;
+  return gap;
+}
+
+void SoundLevelMeter::process_gap(uint32_t gap) {
+  if (gap == 0)
+    return;
+#ifdef USE_CHECKPOINT
+  std::lock_guard<std::mutex> lock(this->state_mutex_);
+#endif
+  for (auto s : this->sensors_)
+    s->skip(gap);
+}
+
+// Larger blocks amortise per-block overhead (ring buffer read, sample conversion,
+// BufferStack copies, filter setup) when the task falls behind, e.g. while Wi-Fi/TLS
+// work competes for the CPU. Once the backlog is drained it returns to short blocks.
+uint32_t SoundLevelMeter::adapt_block_size(uint32_t block_size_ms) {
+  size_t available = this->ring_buffer_->available();
+  float fill = float(available) / (available + this->ring_buffer_->free());
+  if (fill >= BLOCK_GROW_FILL)
+    return std::min(block_size_ms * 2, this->max_block_size_ms_);
+  if (fill <= BLOCK_SHRINK_FILL)
+    return std::max(block_size_ms / 2, AUDIO_BUFFER_DURATION_MS);
+  return block_size_ms;
+}
+
 void SoundLevelMeter::defer(std::function<void()> &&f) {
   std::lock_guard<std::mutex> lock(this->defer_mutex_);
   this->defer_queue_.push_back(std::move(f));
 }
 
 void SoundLevelMeter::reset() {
+#ifdef USE_CHECKPOINT
+  std::lock_guard<std::mutex> lock(this->state_mutex_);
+#endif
   for (auto f : this->dsp_filters_)
     f->reset();
   for (auto s : this->sensors_)
     s->reset();
 }
 
+#ifdef USE_CHECKPOINT
+// The record is just each sensor's accumulators in order, so its version covers the format and
+// the sensors: their ids, update intervals and channels. A firmware update that changes none of
+// them keeps the accumulators.
+void SoundLevelMeter::setup_checkpoint() {
+  std::string layout = "slm/1";  // bump when save_state() of any sensor changes
+  for (auto s : this->sensors_) {
+    char interval[24];
+    snprintf(interval, sizeof(interval), "/%u/%u", static_cast<unsigned>(s->update_interval_ms_),
+             static_cast<unsigned>(s->channel_));
+    layout += "/" + s->get_object_id() + interval;
+  }
+  this->is_restored_ = this->checkpoint_->add_client(
+      "sound_level_meter", fnv1_hash(layout),
+      [this](checkpoint::Writer &writer) {
+        std::lock_guard<std::mutex> lock(this->state_mutex_);
+        writer.write_u8(this->sensors_.size());
+        for (auto s : this->sensors_)
+          s->save_state(writer);
+      },
+      [this](checkpoint::Reader &reader, uint32_t age_ms) {
+        if (reader.read_u8() != this->sensors_.size())
+          return false;
+        for (auto s : this->sensors_)
+          s->restore_state(reader);
+        if (!reader.ok())
+          return false;
+        // a value spanning most of its interval unmeasured is not worth continuing
+        for (auto s : this->sensors_) {
+          if (age_ms >= s->update_interval_ms_)
+            s->reset();
+        }
+        this->restored_age_ms_ = age_ms;
+        this->restored_at_ms_ = millis();
+        return true;
+      });
+}
+
+// Called from the audio task after the first warmup following a restore
+void SoundLevelMeter::process_restored_gap() {
+  if (this->restored_at_ms_ == 0)
+    return;
+  uint32_t gap_ms = this->restored_age_ms_ + (millis() - this->restored_at_ms_);
+  this->restored_at_ms_ = 0;
+  this->process_gap(this->ms_to_frames(gap_ms));
+}
+#endif
+
+// Called from the audio task once per update_interval. Everything is sampled here
+// and the actual logging/publishing is deferred to the main loop.
+void SoundLevelMeter::publish_stats(Histogram &process_time, uint32_t process_time_total, uint32_t process_count) {
+  // relative to the duration of processed audio, i.e. to the time the task was active
+  float audio_ms = process_count * 1000.f / this->get_audio_stream_info().get_sample_rate();
+  auto cpu_util = float(process_time_total) / 1000 / audio_ms;
+  auto rb_size = this->ring_buffer_->available() + this->ring_buffer_->free();
+  auto rb_util = float(rb_size - std::min(this->ring_buffer_stats_free_, rb_size)) / rb_size;
+  auto core = xPortGetCoreID();
+  uint32_t p50 = process_time.percentile(0.5f);
+  uint32_t p99 = process_time.percentile(0.99f);
+  uint32_t max = process_time.max();
+  uint32_t dropped_bytes = this->dropped_bytes_.load();
+  uint32_t dropped_frames = dropped_bytes / this->ingest_frames_to_bytes(1);
+  // esp-idf reports stack high water mark in bytes, not in words as vanilla FreeRTOS does
+  uint32_t stack_free = uxTaskGetStackHighWaterMark(nullptr);
+  uint32_t gap_ms = uint64_t(this->gap_frames_) * 1000 / this->get_audio_stream_info().get_sample_rate();
+  this->ring_buffer_stats_free_ = SIZE_MAX;
+  // with the pipeline enabled, cpu_util above only covers stage 1
+  uint32_t stage2_time = this->stage2_time_.exchange(0);
+  uint32_t stage2_frames = this->stage2_frames_.exchange(0);
+  float stage2_ms = stage2_frames * 1000.f / this->get_audio_stream_info().get_sample_rate();
+  auto stage2_util = stage2_frames > 0 ? float(stage2_time) / 1000 / stage2_ms : 0.f;
+  this->cpu_util_ = cpu_util + stage2_util;
+
+  this->defer([this, cpu_util, stage2_util, rb_util, core, p50, p99, max, dropped_bytes, dropped_frames, stack_free,
+               gap_ms]() {
+    ESP_LOGD(TAG, "CPU (Core %u) Utilization: %.1f%%, Ring Buffer Utilization: %.1f%%", core, cpu_util * 100,
+             rb_util * 100);
+    if (this->is_pipeline_)
+      ESP_LOGD(TAG, "Stage 2 (Core %u) Utilization: %.1f%%", this->pipeline_core_, stage2_util * 100);
+    if (this->stage1_utilization_sensor_ != nullptr)
+      this->stage1_utilization_sensor_->publish_state(cpu_util * 100);
+    if (this->stage2_utilization_sensor_ != nullptr && this->is_pipeline_)
+      this->stage2_utilization_sensor_->publish_state(stage2_util * 100);
+    ESP_LOGD(TAG, "Block Process Time: p50 %lu us, p99 %lu us, max %lu us, Dropped: %lu bytes, Stack Free: %lu bytes",
+             p50, p99, max, dropped_bytes, stack_free);
+    if (this->process_time_p50_sensor_ != nullptr)
+      this->process_time_p50_sensor_->publish_state(p50);
+    if (this->process_time_p99_sensor_ != nullptr)
+      this->process_time_p99_sensor_->publish_state(p99);
+    if (this->ring_buffer_peak_sensor_ != nullptr)
+      this->ring_buffer_peak_sensor_->publish_state(rb_util * 100);
+    if (this->dropped_bytes_sensor_ != nullptr)
+      this->dropped_bytes_sensor_->publish_state(dropped_bytes);
+    if (this->dropped_frames_sensor_ != nullptr)
+      this->dropped_frames_sensor_->publish_state(dropped_frames);
+    if (this->task_stack_high_water_sensor_ != nullptr)
+      this->task_stack_high_water_sensor_->publish_state(stack_free);
+    if (this->measurement_gap_sensor_ != nullptr)
+      this->measurement_gap_sensor_->publish_state(gap_ms);
+  });
+}
+
+/* BlockPool */
+
+BlockPool::BlockPool(size_t size, uint32_t buffer_size, uint8_t channels) {
+  for (size_t i = 0; i < size; i++)
+    this->blocks_.push_back(std::make_unique<Block>(buffer_size, channels));
+}
+
+// head_ and tail_ count modulo twice the pool size, which tells a full pool from an empty one
+BlockPool::Block *BlockPool::acquire() {
+  uint32_t size = this->blocks_.size();
+  uint32_t head = this->head_.load(std::memory_order_relaxed);
+  if ((head + 2 * size - this->tail_.load(std::memory_order_acquire)) % (2 * size) == size)
+    return nullptr;
+  return this->blocks_[head % size].get();
+}
+
+void BlockPool::commit() {
+  uint32_t head = this->head_.load(std::memory_order_relaxed);
+  this->head_.store((head + 1) % (2 * this->blocks_.size()), std::memory_order_release);
+}
+
+BlockPool::Block *BlockPool::peek() {
+  uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+  if (tail == this->head_.load(std::memory_order_acquire))
+    return nullptr;
+  return this->blocks_[tail % this->blocks_.size()].get();
+}
+
+void BlockPool::release() {
+  uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+  this->tail_.store((tail + 1) % (2 * this->blocks_.size()), std::memory_order_release);
+}
+
+bool BlockPool::empty() const { return this->head_.load() == this->tail_.load(); }
+
 /* SoundLevelMeterSensor */
 
 void SoundLevelMeterSensor::set_parent(SoundLevelMeter *parent) {
@@ -288,6 +841,8 @@ void SoundLevelMeterSensor::set_update_interval(uint32_t update_interval_ms) {
 
 void SoundLevelMeterSensor::add_dsp_filter(Filter *dsp_filter) { this->dsp_filters_.push_back(dsp_filter); }
 
+void SoundLevelMeterSensor::set_channel(uint8_t channel) { this->channel_ = channel; }
+
 void SoundLevelMeterSensor::defer_publish_state(float state) {
   this->parent_->defer([this, state]() { this->publish_state(state); });
 }
@@ -318,27 +873,64 @@ void SoundLevelMeterSensorEq::process(std::vector<float> &buffer) {
   // for large accumulating periods (like 1 hour), therefore global sum (this->sum_)
   // is of type double
   float local_sum = 0;
-  for (int i = 0; i < buffer.size(); i++) {
+  for (size_t i = 0; i < buffer.size(); i++) {
     local_sum += buffer[i] * buffer[i];
     this->count_++;
-    if (this->count_ == this->update_samples_) {
-      float dB = 10 * log10((sum_ + local_sum) / count_);
-      dB = this->adjust_dB(dB);
-      this->defer_publish_state(dB);
-      this->sum_ = 0;
-      this->count_ = 0;
+    if (this->count_ >= this->update_samples_) {
+      this->publish_eq(this->sum_ + local_sum);
       local_sum = 0;
     }
   }
   this->sum_ += local_sum;
 }
 
+void SoundLevelMeterSensorEq::skip(uint32_t samples) {
+  while (samples > 0) {
+    uint32_t n = std::min(samples, this->update_samples_ - this->count_);
+    this->count_ += n;
+    this->gap_ += n;
+    samples -= n;
+    if (this->count_ >= this->update_samples_)
+      this->publish_eq(this->sum_);
+  }
+}
+
+void SoundLevelMeterSensorEq::publish_eq(double sum) {
+  // normalise over processed samples only, gaps just keep the update cadence
+  uint32_t processed = this->count_ - this->gap_;
+  if (processed > 0) {
+    float dB = 10 * log10(sum / processed);
+    dB = this->adjust_dB(dB);
+    this->defer_publish_state(dB);
+  } else {
+    this->defer_publish_state(NAN);
+  }
+  this->sum_ = 0;
+  this->count_ = 0;
+  this->gap_ = 0;
+}
+
 void SoundLevelMeterSensorEq::reset() {
   this->sum_ = 0.;
   this->count_ = 0;
+  this->gap_ = 0;
   this->defer_publish_state(NAN);
 }
 
+#ifdef USE_CHECKPOINT
+void SoundLevelMeterSensorEq::save_state(checkpoint::Writer &writer) {
+  writer.write_double(this->sum_);
+  writer.write_u32(this->count_);
+  writer.write_u32(this->gap_);
+}
+
+void SoundLevelMeterSensorEq::restore_state(checkpoint::Reader &reader) {
+  this->sum_ = reader.read_double();
+  this->count_ = reader.read_u32();
+  this->gap_ = reader.read_u32();
+}
+#endif
+
 /* SoundLevelMeterSensorMax */
 
 void SoundLevelMeterSensorMax::set_window_size(uint32_t window_size_ms) {
@@ -346,7 +938,7 @@ void SoundLevelMeterSensorMax::set_window_size(uint32_t window_size_ms) {
 }
 
 void SoundLevelMeterSensorMax::process(std::vector<float> &buffer) {
-  for (int i = 0; i < buffer.size(); i++) {
+  for (size_t i = 0; i < buffer.size(); i++) {
     this->sum_ += buffer[i] * buffer[i];
     this->count_sum_++;
     if (this->count_sum_ == this->window_samples_) {
@@ -355,16 +947,37 @@ void SoundLevelMeterSensorMax::process(std::vector<float> &buffer) {
       this->count_sum_ = 0;
     }
     this->count_max_++;
-    if (this->count_max_ == this->update_samples_) {
-      float dB = 10 * log10(this->max_);
-      dB = this->adjust_dB(dB);
-      this->defer_publish_state(dB);
-      this->max_ = std::numeric_limits<float>::min();
-      this->count_max_ = 0;
-    }
+    if (this->count_max_ >= this->update_samples_)
+      this->publish_max();
   }
 }
 
+void SoundLevelMeterSensorMax::skip(uint32_t samples) {
+  // a window interrupted by a gap is incomplete, so it's discarded
+  this->sum_ = 0.f;
+  this->count_sum_ = 0;
+  while (samples > 0) {
+    uint32_t n = std::min(samples, this->update_samples_ - this->count_max_);
+    this->count_max_ += n;
+    samples -= n;
+    if (this->count_max_ >= this->update_samples_)
+      this->publish_max();
+  }
+}
+
+void SoundLevelMeterSensorMax::publish_max() {
+  // no complete window within update interval (e.g. it was all gap)
+  if (this->max_ == std::numeric_limits<float>::min()) {
+    this->defer_publish_state(NAN);
+  } else {
+    float dB = 10 * log10(this->max_);
+    dB = this->adjust_dB(dB);
+    this->defer_publish_state(dB);
+  }
+  this->max_ = std::numeric_limits<float>::min();
+  this->count_max_ = 0;
+}
+
 void SoundLevelMeterSensorMax::reset() {
   this->sum_ = 0.f;
   this->max_ = std::numeric_limits<float>::min();
@@ -373,6 +986,22 @@ void SoundLevelMeterSensorMax::reset() {
   this->defer_publish_state(NAN);
 }
 
+#ifdef USE_CHECKPOINT
+void SoundLevelMeterSensorMax::save_state(checkpoint::Writer &writer) {
+  writer.write_float(this->sum_);
+  writer.write_float(this->max_);
+  writer.write_u32(this->count_sum_);
+  writer.write_u32(this->count_max_);
+}
+
+void SoundLevelMeterSensorMax::restore_state(checkpoint::Reader &reader) {
+  this->sum_ = reader.read_float();
+  this->max_ = reader.read_float();
+  this->count_sum_ = reader.read_u32();
+  this->count_max_ = reader.read_u32();
+}
+#endif
+
 /* SoundLevelMeterSensorMin */
 
 void SoundLevelMeterSensorMin::set_window_size(uint32_t window_size_ms) {
@@ -380,7 +1009,7 @@ void SoundLevelMeterSensorMin::set_window_size(uint32_t window_size_ms) {
 }
 
 void SoundLevelMeterSensorMin::process(std::vector<float> &buffer) {
-  for (int i = 0; i < buffer.size(); i++) {
+  for (size_t i = 0; i < buffer.size(); i++) {
     this->sum_ += buffer[i] * buffer[i];
     this->count_sum_++;
     if (this->count_sum_ == this->window_samples_) {
@@ -389,16 +1018,37 @@ void SoundLevelMeterSensorMin::process(std::vector<float> &buffer) {
       this->count_sum_ = 0;
     }
     this->count_min_++;
-    if (this->count_min_ == this->update_samples_) {
-      float dB = 10 * log10(this->min_);
-      dB = this->adjust_dB(dB);
-      this->defer_publish_state(dB);
-      this->min_ = std::numeric_limits<float>::max();
-      this->count_min_ = 0;
-    }
+    if (this->count_min_ >= this->update_samples_)
+      this->publish_min();
   }
 }
 
+void SoundLevelMeterSensorMin::skip(uint32_t samples) {
+  // a window interrupted by a gap is incomplete, so it's discarded
+  this->sum_ = 0.f;
+  this->count_sum_ = 0;
+  while (samples > 0) {
+    uint32_t n = std::min(samples, this->update_samples_ - this->count_min_);
+    this->count_min_ += n;
+    samples -= n;
+    if (this->count_min_ >= this->update_samples_)
+      this->publish_min();
+  }
+}
+
+void SoundLevelMeterSensorMin::publish_min() {
+  // no complete window within update interval (e.g. it was all gap)
+  if (this->min_ == std::numeric_limits<float>::max()) {
+    this->defer_publish_state(NAN);
+  } else {
+    float dB = 10 * log10(this->min_);
+    dB = this->adjust_dB(dB);
+    this->defer_publish_state(dB);
+  }
+  this->min_ = std::numeric_limits<float>::max();
+  this->count_min_ = 0;
+}
+
 void SoundLevelMeterSensorMin::reset() {
   this->sum_ = 0.f;
   this->min_ = std::numeric_limits<float>::max();
@@ -407,105 +1057,122 @@ void SoundLevelMeterSensorMin::reset() {
   this->defer_publish_state(NAN);
 }
 
+#ifdef USE_CHECKPOINT
+void SoundLevelMeterSensorMin::save_state(checkpoint::Writer &writer) {
+  writer.write_float(this->sum_);
+  writer.write_float(this->min_);
+  writer.write_u32(this->count_sum_);
+  writer.write_u32(this->count_min_);
+}
+
+void SoundLevelMeterSensorMin::restore_state(checkpoint::Reader &reader) {
+  this->sum_ = reader.read_float();
+  this->min_ = reader.read_float();
+  this->count_sum_ = reader.read_u32();
+  this->count_min_ = reader.read_u32();
+}
+#endif
+
 /* SoundLevelMeterSensorPeak */
 
 void SoundLevelMeterSensorPeak::process(std::vector<float> &buffer) {
-  for (int i = 0; i < buffer.size(); i++) {
+  for (size_t i = 0; i < buffer.size(); i++) {
     this->peak_ = std::max(this->peak_, abs(buffer[i]));
     this->count_++;
-    if (this->count_ == this->update_samples_) {
-      float dB = 20 * log10(this->peak_);
-      dB = this->adjust_dB(dB, false);
-      this->defer_publish_state(dB);
-      this->peak_ = 0.f;
-      this->count_ = 0;
-    }
+    if (this->count_ >= this->update_samples_)
+      this->publish_peak();
+  }
+}
+
+void SoundLevelMeterSensorPeak::skip(uint32_t samples) {
+  while (samples > 0) {
+    uint32_t n = std::min(samples, this->update_samples_ - this->count_);
+    this->count_ += n;
+    samples -= n;
+    if (this->count_ >= this->update_samples_)
+      this->publish_peak();
   }
 }
 
+void SoundLevelMeterSensorPeak::publish_peak() {
+  float dB = 20 * log10(this->peak_);
+  dB = this->adjust_dB(dB, false);
+  this->defer_publish_state(dB);
+  this->peak_ = 0.f;
+  this->count_ = 0;
+}
+
 void SoundLevelMeterSensorPeak::reset() {
   this->peak_ = 0.f;
   this->count_ = 0;
   this->defer_publish_state(NAN);
 }
 
-/* SOS_Filter */
-
-SOS_Filter::SOS_Filter(std::initializer_list<std::initializer_list<float>> &&coeffs) {
-  this->coeffs_.resize(coeffs.size());
-  this->state_.resize(coeffs.size(), {});
-  int i = 0;
-  for (auto &row : coeffs)
-    std::copy(row.begin(), row.end(), coeffs_[i++].begin());
+#ifdef USE_CHECKPOINT
+void SoundLevelMeterSensorPeak::save_state(checkpoint::Writer &writer) {
+  writer.write_float(this->peak_);
+  writer.write_u32(this->count_);
 }
 
-void SOS_Filter::process(std::vector<float> &data) {
-  int n = data.size();
-  int m = this->coeffs_.size();
-  for (int j = 0; j < m; j++) {
-#ifdef USE_ESP_DSP  // esp-dsp uses direct form 2
-#if defined(USE_ESP32_VARIANT_ESP32)
-    dsps_biquad_f32_ae32(&data[0], &data[0], data.size(), &this->coeffs_[j][0], &this->state_[j][0]);
-#elif defined(USE_ESP32_VARIANT_ESP32S3)
-    dsps_biquad_f32_aes3(&data[0], &data[0], data.size(), &this->coeffs_[j][0], &this->state_[j][0]);
-#elif defined(USE_ESP32_VARIANT_ESP32P4)
-    dsps_biquad_f32_arp4(&data[0], &data[0], data.size(), &this->coeffs_[j][0], &this->state_[j][0]);
-#else
-    dsps_biquad_f32_ansi(&data[0], &data[0], data.size(), &this->coeffs_[j][0], &this->state_[j][0]);
-#endif
-#else  // I'm using direct form 2 transposed, which should be a bit more numerically stable
-    for (int i = 0; i < n; i++) {
-      // y[i] = b0 * x[i] + s0
-      float yi = this->coeffs_[j][0] * data[i] + this->state_[j][0];
-      // s0 = b1 * x[i] - a1 * y[i] + s1
-      this->state_[j][0] = this->coeffs_[j][1] * data[i] - this->coeffs_[j][3] * yi + this->state_[j][1];
-      // s1 = b2 * x[i] - a2 * y[i]
-      this->state_[j][1] = this->coeffs_[j][2] * data[i] - this->coeffs_[j][4] * yi;
-
-      data[i] = yi;
-    }
-#endif
-  }
-}
-
-void SOS_Filter::reset() {
-  for (auto &s : this->state_)
-    s = {0.f, 0.f};
+void SoundLevelMeterSensorPeak::restore_state(checkpoint::Reader &reader) {
+  this->peak_ = reader.read_float();
+  this->count_ = reader.read_u32();
 }
+#endif
 
-/* BufferStack */
+/* Histogram */
 
-template<typename T> BufferStack<T>::BufferStack(uint32_t buffer_size) : buffer_size_(buffer_size) {
-  this->buffers_.resize(1);
-  this->buffers_[0].resize(buffer_size);
+void Histogram::add(uint32_t value) {
+  this->buckets_[bucket_index(value)]++;
+  this->count_++;
+  this->max_ = std::max(this->max_, value);
 }
 
-template<typename T> std::vector<T> &BufferStack<T>::current() { return this->buffers_[this->index_]; }
-
-template<typename T> void BufferStack<T>::push() {
-  this->index_++;
-  if (this->index_ == this->buffers_.capacity()) {
-    this->buffers_.reserve(this->index_ + 1);
-    this->buffers_.resize(this->index_ + 1);
+uint32_t Histogram::percentile(float q) const {
+  if (this->count_ == 0)
+    return 0;
+  uint32_t rank = std::max<uint32_t>(1, ceilf(q * this->count_));
+  uint32_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    if (this->buckets_[i] == 0)
+      continue;
+    if (seen + this->buckets_[i] >= rank) {
+      // interpolate linearly between the lowest and highest value of the bucket
+      uint32_t lo = bucket_lower_bound(i);
+      uint32_t hi = i + 1 < NUM_BUCKETS ? bucket_lower_bound(i + 1) - 1 : this->max_;
+      float frac = float(rank - seen) / this->buckets_[i];
+      return std::min<uint32_t>(lo + (hi - lo) * frac, this->max_);
+    }
+    seen += this->buckets_[i];
   }
-  auto &dst = this->buffers_[this->index_];
-  auto &src = this->buffers_[this->index_ - 1];
-  auto n = src.size();
-  dst.resize(n);
-  // this is faster than assigning one vector to another, which results in element-wise copying
-  memcpy(&dst[0], &src[0], n * sizeof(T));
+  return this->max_;
 }
 
-template<typename T> void BufferStack<T>::pop() {
-  assert(this->index_ >= 1 && "Index out of bounds");
-  this->index_--;
+uint32_t Histogram::max() const { return this->max_; }
+
+uint32_t Histogram::count() const { return this->count_; }
+
+void Histogram::reset() {
+  this->buckets_.fill(0);
+  this->count_ = 0;
+  this->max_ = 0;
 }
 
-template<typename T> void BufferStack<T>::reset() {
-  this->index_ = 0;
-  this->current().resize(this->buffer_size_);
+// values 0..3 map to their own bucket, above that every power of two [2^k, 2^(k+1))
+// is split into 4 equal sub-buckets selected by the two bits following the msb
+size_t Histogram::bucket_index(uint32_t value) {
+  if (value < 4)
+    return value;
+  uint32_t msb = 31 - __builtin_clz(value);
+  size_t index = 4 * (msb - 1) + ((value >> (msb - 2)) & 3);
+  return std::min(index, NUM_BUCKETS - 1);
 }
 
-template<typename T> BufferStack<T>::operator std::vector<T> &() { return this->current(); }
+uint32_t Histogram::bucket_lower_bound(size_t index) {
+  if (index < 4)
+    return index;
+  uint32_t msb = index / 4 + 1;
+  return (4 + index % 4) << (msb - 2);
+}
 
 }  // namespace esphome::sound_level_meter
\ No newline at end of file
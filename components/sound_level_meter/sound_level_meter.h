@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mutex>
+#include <atomic>
 #include <algorithm>
 
 #include "esp_timer.h"
@@ -11,15 +12,19 @@
 #include "esphome/core/ring_buffer.h"
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/microphone/microphone_source.h"
-
-#ifdef USE_ESP_DSP
-#include "dsps_biquad.h"
+#ifdef USE_CHECKPOINT
+#include "esphome/components/checkpoint/checkpoint.h"
 #endif
 
+#include "dsp.h"
+
 namespace esphome::sound_level_meter {
 class SoundLevelMeterSensor;
-class Filter;
-template<typename T> class BufferStack;
+class EventCapture;
+class Histogram;
+class BlockPool;
+// one buffer stack per microphone channel
+using ChannelBuffers = std::vector<BufferStack<float>>;
 
 class SoundLevelMeter : public Component {
   friend class SoundLevelMeterSensor;
@@ -31,11 +36,15 @@ class SoundLevelMeter : public Component {
   uint32_t get_update_interval();
   void set_ring_buffer_size(uint32_t ring_buffer_size);
   uint32_t get_ring_buffer_size();
+  void set_max_block_size(uint32_t max_block_size);
+  void set_ingest_bits_per_sample(uint8_t ingest_bits_per_sample);
+  void set_ingest_shift(uint8_t ingest_shift);
   void set_microphone_source(microphone::MicrophoneSource *microphone_source);
   void set_warmup_interval(uint32_t warmup_interval);
   void set_task_stack_size(uint32_t task_stack_size);
   void set_task_priority(uint8_t task_priority);
   void set_task_core(uint8_t task_core);
+  void set_pipeline(uint8_t pipeline_core, uint8_t pipeline_blocks);
   void set_mic_sensitivity(optional<float> mic_sensitivity);
   optional<float> get_mic_sensitivity();
   void set_mic_sensitivity_ref(optional<float> mic_sensitivity_ref);
@@ -46,6 +55,23 @@ class SoundLevelMeter : public Component {
   void set_is_auto_start(bool is_auto_start);
   void add_sensor(SoundLevelMeterSensor *sensor);
   void add_dsp_filter(Filter *dsp_filter);
+  void set_process_time_p50_sensor(sensor::Sensor *process_time_p50_sensor);
+  void set_process_time_p99_sensor(sensor::Sensor *process_time_p99_sensor);
+  void set_ring_buffer_peak_sensor(sensor::Sensor *ring_buffer_peak_sensor);
+  void set_dropped_bytes_sensor(sensor::Sensor *dropped_bytes_sensor);
+  void set_dropped_frames_sensor(sensor::Sensor *dropped_frames_sensor);
+  void set_task_stack_high_water_sensor(sensor::Sensor *task_stack_high_water_sensor);
+  void set_measurement_gap_sensor(sensor::Sensor *measurement_gap_sensor);
+  void set_duty_cycle(uint32_t measure_interval, uint32_t period);
+  void set_active_current(float active_current);
+  void set_cpu_time_saved_sensor(sensor::Sensor *cpu_time_saved_sensor);
+  void set_current_saved_sensor(sensor::Sensor *current_saved_sensor);
+  void set_stage1_utilization_sensor(sensor::Sensor *stage1_utilization_sensor);
+  void set_stage2_utilization_sensor(sensor::Sensor *stage2_utilization_sensor);
+  void set_event_capture(EventCapture *event_capture);
+#ifdef USE_CHECKPOINT
+  void set_checkpoint(checkpoint::Checkpoint *checkpoint);
+#endif
   virtual void setup() override;
   virtual void loop() override;
   virtual void dump_config() override;
@@ -58,6 +84,15 @@ class SoundLevelMeter : public Component {
   std::vector<Filter *> dsp_filters_;
   std::vector<SoundLevelMeterSensor *> sensors_;
   size_t ring_buffer_size_ms_{256};
+  uint32_t max_block_size_ms_{20};
+  // sample width stored in the ring buffer, 0 = same as the microphone source
+  uint8_t ingest_bytes_per_sample_{0};
+  // headroom bits traded for resolution when repacking to a narrower ingest width
+  uint8_t ingest_shift_{0};
+  // repacked samples, only touched from the microphone callback
+  std::vector<uint8_t> ingest_buffer_;
+  // interleaved multi-channel samples, before they are split into per channel buffers
+  std::vector<uint8_t> read_buffer_;
   uint32_t warmup_interval_ms_{500};
   uint32_t task_stack_size_{1024};
   uint8_t task_priority_{1};
@@ -72,23 +107,94 @@ class SoundLevelMeter : public Component {
   bool is_pending_stop_{false};
   bool is_high_freq_{false};
   bool is_auto_start_{true};
+  // duty cycle: measure for duty_measure_ms_ (after warmup) every duty_period_ms_, 0 = continuous
+  uint32_t duty_measure_ms_{0};
+  uint32_t duty_period_ms_{0};
+  float active_current_{0.f};
+  // when set, the task doesn't reset filters/sensors on start and stop (duty cycle pause)
+  bool is_keep_state_{false};
+  float cpu_util_{0.f};
+  sensor::Sensor *cpu_time_saved_sensor_{nullptr};
+  sensor::Sensor *current_saved_sensor_{nullptr};
+  // two-stage pipeline: stage 1 (task_core) reads, converts and applies the filters shared
+  // by all sensors, stage 2 (pipeline_core) runs the remaining filters and statistics
+  bool is_pipeline_{false};
+  uint8_t pipeline_core_{0};
+  uint8_t pipeline_blocks_{3};
+  std::vector<Filter *> shared_prefix_;
+  std::unique_ptr<BlockPool> pipeline_pool_;
+  TaskHandle_t pipeline_task_handle_{nullptr};
+  TaskHandle_t pipeline_producer_{nullptr};
+  std::atomic<bool> is_pipeline_stopping_{false};
+  // stage 2 processing time (us) and frames, collected by stage 1 in publish_stats()
+  std::atomic<uint32_t> stage2_time_{0};
+  std::atomic<uint32_t> stage2_frames_{0};
+  sensor::Sensor *stage1_utilization_sensor_{nullptr};
+  sensor::Sensor *stage2_utilization_sensor_{nullptr};
+  // fed from the microphone callback, outside of the audio task
+  EventCapture *event_capture_{nullptr};
   HighFrequencyLoopRequester high_freq_;
   std::shared_ptr<RingBuffer> ring_buffer_;
   std::weak_ptr<RingBuffer> ring_buffer_weak_;
   size_t ring_buffer_stats_free_{SIZE_MAX};
   TaskHandle_t task_handle_{nullptr};
+  // diagnostics, published every update_interval from the audio task
+  sensor::Sensor *process_time_p50_sensor_{nullptr};
+  sensor::Sensor *process_time_p99_sensor_{nullptr};
+  sensor::Sensor *ring_buffer_peak_sensor_{nullptr};
+  sensor::Sensor *dropped_bytes_sensor_{nullptr};
+  sensor::Sensor *dropped_frames_sensor_{nullptr};
+  sensor::Sensor *task_stack_high_water_sensor_{nullptr};
+  sensor::Sensor *measurement_gap_sensor_{nullptr};
+  // written from the microphone callback, read from the audio task
+  std::atomic<uint32_t> dropped_bytes_{0};
+  // dropped frames already accounted as measurement gap
+  uint32_t gap_frames_{0};
+#ifdef USE_CHECKPOINT
+  // sensor accumulators are kept across resets: restored in setup(), after which the first start
+  // keeps them, and the time between the checkpoint and the end of the warmup becomes a gap
+  checkpoint::Checkpoint *checkpoint_{nullptr};
+  bool is_restored_{false};
+  uint32_t restored_age_ms_{0};
+  uint32_t restored_at_ms_{0};
+  // held by the audio task(s) while sensors accumulate, and by the checkpoint while saving them
+  std::mutex state_mutex_;
+#endif
 
   audio::AudioStreamInfo get_audio_stream_info() const;
   uint32_t ms_to_frames(uint32_t ms);
+  uint8_t get_ingest_bytes_per_sample() const;
+  size_t ingest_frames_to_bytes(uint32_t frames) const;
+  bool is_repack() const;
   void sort_sensors();
-  size_t read_samples(std::vector<float> &data, TickType_t ticks_to_wait = portMAX_DELAY);
-  void process(BufferStack<float> &buffers);
+  size_t read_samples(ChannelBuffers &channels, uint32_t frames, TickType_t ticks_to_wait = portMAX_DELAY);
+  void process(ChannelBuffers &channels, bool update_sensors = true, size_t prefix_depth = 0);
+  void apply_shared_prefix(ChannelBuffers &channels);
+  uint32_t take_gap();
+  void process_gap(uint32_t gap);
+  void find_shared_prefix();
+  ChannelBuffers *acquire_block(ChannelBuffers &buffers, uint32_t block_size_ms);
+  void dispatch_block(ChannelBuffers &buffers, bool update_sensors);
+  void start_pipeline();
+  void stop_pipeline();
+  void wait_pipeline_idle();
+  uint32_t adapt_block_size(uint32_t block_size_ms);
   // epshome's scheduler is not thred safe, so we have to use custom thread safe implementation
   // to execute sensor updates in main loop
   void defer(std::function<void()> &&f);
   void reset();
+  void start_task(bool keep_state);
+  void stop_task(bool keep_state);
+  float get_duty_fraction();
+  void publish_duty_cycle_savings();
+  void publish_stats(Histogram &process_time, uint32_t process_time_total, uint32_t process_count);
+#ifdef USE_CHECKPOINT
+  void setup_checkpoint();
+  void process_restored_gap();
+#endif
 
   static void task(void *param);
+  static void pipeline_task(void *param);
 };
 
 class SoundLevelMeterSensor : public sensor::Sensor {
@@ -98,17 +204,26 @@ class SoundLevelMeterSensor : public sensor::Sensor {
   void set_parent(SoundLevelMeter *parent);
   void set_update_interval(uint32_t update_interval);
   void add_dsp_filter(Filter *dsp_filter);
+  void set_channel(uint8_t channel);
   virtual void process(std::vector<float> &buffer) = 0;
   void defer_publish_state(float state);
 
  protected:
   SoundLevelMeter *parent_{nullptr};
   std::vector<Filter *> dsp_filters_;
+  uint8_t channel_{0};
   uint32_t update_samples_{0};
   uint32_t update_interval_ms_{60000};
   float adjust_dB(float dB, bool is_rms = true);
 
   virtual void reset() = 0;
+  // advance update counters over samples lost to a ring buffer overflow
+  virtual void skip(uint32_t samples) = 0;
+#ifdef USE_CHECKPOINT
+  // accumulators only: filter state settles within the warmup interval
+  virtual void save_state(checkpoint::Writer &writer) = 0;
+  virtual void restore_state(checkpoint::Reader &reader) = 0;
+#endif
 };
 
 class SoundLevelMeterSensorEq : public SoundLevelMeterSensor {
@@ -118,8 +233,15 @@ class SoundLevelMeterSensorEq : public SoundLevelMeterSensor {
  protected:
   double sum_{0.};
   uint32_t count_{0};
+  uint32_t gap_{0};
 
   virtual void reset() override;
+  virtual void skip(uint32_t samples) override;
+#ifdef USE_CHECKPOINT
+  virtual void save_state(checkpoint::Writer &writer) override;
+  virtual void restore_state(checkpoint::Reader &reader) override;
+#endif
+  void publish_eq(double sum);
 };
 
 class SoundLevelMeterSensorMax : public SoundLevelMeterSensor {
@@ -134,6 +256,12 @@ class SoundLevelMeterSensorMax : public SoundLevelMeterSensor {
   uint32_t count_sum_{0}, count_max_{0};
 
   virtual void reset() override;
+  virtual void skip(uint32_t samples) override;
+#ifdef USE_CHECKPOINT
+  virtual void save_state(checkpoint::Writer &writer) override;
+  virtual void restore_state(checkpoint::Reader &reader) override;
+#endif
+  void publish_max();
 };
 
 class SoundLevelMeterSensorMin : public SoundLevelMeterSensor {
@@ -148,6 +276,12 @@ class SoundLevelMeterSensorMin : public SoundLevelMeterSensor {
   uint32_t count_sum_{0}, count_min_{0};
 
   virtual void reset() override;
+  virtual void skip(uint32_t samples) override;
+#ifdef USE_CHECKPOINT
+  virtual void save_state(checkpoint::Writer &writer) override;
+  virtual void restore_state(checkpoint::Reader &reader) override;
+#endif
+  void publish_min();
 };
 
 class SoundLevelMeterSensorPeak : public SoundLevelMeterSensor {
@@ -159,44 +293,61 @@ class SoundLevelMeterSensorPeak : public SoundLevelMeterSensor {
   uint32_t count_{0};
 
   virtual void reset() override;
+  virtual void skip(uint32_t samples) override;
+#ifdef USE_CHECKPOINT
+  virtual void save_state(checkpoint::Writer &writer) override;
+  virtual void restore_state(checkpoint::Reader &reader) override;
+#endif
+  void publish_peak();
 };
 
-class Filter {
-  friend SoundLevelMeter;
-
+// Lock-free single-producer/single-consumer pool of preallocated blocks, used to hand
+// audio from the first pipeline stage to the second without copying or allocating.
+// Blocks are acquired and committed by the producer, then peeked and released by the
+// consumer strictly in order, so each side only ever writes its own index.
+class BlockPool {
  public:
-  virtual void process(std::vector<float> &data) = 0;
+  struct Block {
+    Block(uint32_t buffer_size, uint8_t channels) : channels(channels, BufferStack<float>(buffer_size)) {}
+    ChannelBuffers channels;
+    // frames lost before this block, accounted as measurement gap
+    uint32_t gap{0};
+    bool update_sensors{true};
+  };
+
+  BlockPool(size_t size, uint32_t buffer_size, uint8_t channels);
+  // producer: next free block, or nullptr if all are in flight
+  Block *acquire();
+  void commit();
+  // consumer: oldest committed block, or nullptr if there is none
+  Block *peek();
+  void release();
+  bool empty() const;
 
  protected:
-  virtual void reset() = 0;
+  std::vector<std::unique_ptr<Block>> blocks_;
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
 };
 
-class SOS_Filter : public Filter {
+// Block processing time histogram (in microseconds) with 4 sub-buckets per power of two,
+// so percentiles are accurate to ~25% while keeping a fixed 256 byte footprint.
+class Histogram {
  public:
-  SOS_Filter(std::initializer_list<std::initializer_list<float>> &&coeffs);
-  virtual void process(std::vector<float> &data) override;
+  void add(uint32_t value);
+  uint32_t percentile(float q) const;
+  uint32_t max() const;
+  uint32_t count() const;
+  void reset();
 
  protected:
-  std::vector<std::array<float, 5>> coeffs_;  // {b0, b1, b2, a1, a2}
-  std::vector<std::array<float, 2>> state_;
-
-  virtual void reset() override;
-};
-
-template<typename T> class BufferStack {
- public:
-  BufferStack(uint32_t buffer_size);
-  std::vector<T> &current();
-  void push();
-  void pop();
-  void reset();
-  operator std::vector<T> &();
+  static constexpr size_t NUM_BUCKETS = 64;
+  std::array<uint32_t, NUM_BUCKETS> buckets_{};
+  uint32_t count_{0};
+  uint32_t max_{0};
 
- private:
-  uint32_t buffer_size_;
-  uint32_t max_depth_;
-  uint32_t index_{0};
-  std::vector<std::vector<T>> buffers_;
+  static size_t bucket_index(uint32_t value);
+  static uint32_t bucket_lower_bound(size_t index);
 };
 
 template<typename... Ts> class StartAction : public Action<Ts...> {
@@ -0,0 +1,90 @@
+"""
+Streaming Quantile Filters for ESPHome
+- Registers `streaming_median` and `streaming_quantile` sensor filters.
+- Same options and output as the stock `median` and `quantile` filters, but the window is kept
+  in an indexable skiplist: O(log n) per value instead of a copy and sort of the window per send.
+- Add an empty `streaming_quantile:` entry to the configuration to make the filters available.
+- With `checkpoint_id`, the window is kept in RTC memory and restored after a reset.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.components.checkpoint import CONF_CHECKPOINT_ID, Checkpoint
+from esphome.components.sensor import FILTER_REGISTRY, validate_send_first_at
+from esphome.const import CONF_SEND_EVERY, CONF_SEND_FIRST_AT, CONF_WINDOW_SIZE
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["sensor"]
+
+CONF_QUANTILE = "quantile"
+
+streaming_quantile_ns = cg.esphome_ns.namespace("streaming_quantile")
+StreamingQuantileFilter = streaming_quantile_ns.class_("StreamingQuantileFilter", sensor.Filter)
+StreamingMedianFilter = streaming_quantile_ns.class_("StreamingMedianFilter", StreamingQuantileFilter)
+
+# The order statistics are indexed with 16 bits
+MAX_WINDOW_SIZE = 65534
+
+CONFIG_SCHEMA = cv.Schema({})
+
+STREAMING_MEDIAN_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_WINDOW_SIZE, default=5): cv.int_range(min=1, max=MAX_WINDOW_SIZE),
+            cv.Optional(CONF_SEND_EVERY, default=5): cv.positive_not_null_int,
+            cv.Optional(CONF_SEND_FIRST_AT, default=1): cv.positive_not_null_int,
+            cv.Optional(CONF_CHECKPOINT_ID): cv.use_id(Checkpoint),
+        }
+    ),
+    validate_send_first_at,
+)
+
+STREAMING_QUANTILE_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_WINDOW_SIZE, default=5): cv.int_range(min=1, max=MAX_WINDOW_SIZE),
+            cv.Optional(CONF_SEND_EVERY, default=5): cv.positive_not_null_int,
+            cv.Optional(CONF_SEND_FIRST_AT, default=1): cv.positive_not_null_int,
+            cv.Optional(CONF_QUANTILE, default=0.9): cv.zero_to_one_float,
+            cv.Optional(CONF_CHECKPOINT_ID): cv.use_id(Checkpoint),
+        }
+    ),
+    validate_send_first_at,
+)
+
+
+async def setup_checkpoint(var, config, filter_id):
+    # the window is saved under the filter id, which is stable for a given configuration
+    if checkpoint_id := config.get(CONF_CHECKPOINT_ID):
+        checkpoint = await cg.get_variable(checkpoint_id)
+        cg.add(var.set_checkpoint(checkpoint, filter_id.id))
+
+
+@FILTER_REGISTRY.register("streaming_median", StreamingMedianFilter, STREAMING_MEDIAN_SCHEMA)
+async def streaming_median_filter_to_code(config, filter_id):
+    var = cg.new_Pvariable(
+        filter_id,
+        config[CONF_WINDOW_SIZE],
+        config[CONF_SEND_EVERY],
+        config[CONF_SEND_FIRST_AT],
+    )
+    await setup_checkpoint(var, config, filter_id)
+    return var
+
+
+@FILTER_REGISTRY.register("streaming_quantile", StreamingQuantileFilter, STREAMING_QUANTILE_SCHEMA)
+async def streaming_quantile_filter_to_code(config, filter_id):
+    var = cg.new_Pvariable(
+        filter_id,
+        config[CONF_WINDOW_SIZE],
+        config[CONF_SEND_EVERY],
+        config[CONF_SEND_FIRST_AT],
+        config[CONF_QUANTILE],
+    )
+    await setup_checkpoint(var, config, filter_id)
+    return var
+
+
+async def to_code(config):
+    pass
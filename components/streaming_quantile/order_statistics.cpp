@@ -0,0 +1,132 @@
+#include "order_statistics.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace streaming_quantile {
+
+// Node heights are fixed per slot from a hash of the slot index rather than drawn at insert
+// time, so the link storage can be sized exactly up front. Slots are reused in FIFO order,
+// which is unrelated to value order, so the heights still look random to the skiplist.
+static uint8_t slot_height(uint32_t slot, uint8_t max_level) {
+  uint32_t h = slot + 0x9E3779B9u;
+  h = (h ^ (h >> 16)) * 0x85EBCA6Bu;
+  h = (h ^ (h >> 13)) * 0xC2B2AE35u;
+  h ^= h >> 16;
+  uint8_t height = 1;
+  while (height < max_level && (h & 0x3) == 0) {
+    height++;
+    h >>= 2;
+  }
+  return height;
+}
+
+OrderStatisticWindow::OrderStatisticWindow(size_t capacity)
+    : capacity_(capacity == 0 ? 1 : (capacity > MAX_CAPACITY ? MAX_CAPACITY : capacity)) {
+  this->values_.resize(this->capacity_ + 1, NAN);
+  this->heights_.resize(this->capacity_ + 1);
+  this->offsets_.resize(this->capacity_ + 1);
+
+  uint32_t links = 0;
+  for (size_t slot = 0; slot <= this->capacity_; slot++) {
+    this->heights_[slot] = slot == this->capacity_ ? MAX_LEVEL : slot_height(slot, MAX_LEVEL);
+    this->offsets_[slot] = links;
+    links += this->heights_[slot];
+  }
+  this->next_.resize(links, NIL);
+  this->widths_.resize(links, 0);
+
+  // empty list: every head link spans to one past the (non-existent) last value
+  for (uint8_t level = 0; level < MAX_LEVEL; level++)
+    this->width(this->capacity_, level) = 1;
+}
+
+void OrderStatisticWindow::push(float value) {
+  size_t slot;
+  if (this->count_ == this->capacity_) {
+    slot = this->oldest_;
+    if (!std::isnan(this->values_[slot]))
+      this->erase(slot);
+    this->oldest_ = (this->oldest_ + 1) % this->capacity_;
+  } else {
+    slot = (this->oldest_ + this->count_) % this->capacity_;
+    this->count_++;
+  }
+
+  this->values_[slot] = value;
+  if (!std::isnan(value))
+    this->insert(slot);
+}
+
+float OrderStatisticWindow::at(size_t rank) const {
+  size_t node = this->capacity_;
+  size_t remaining = rank + 1;
+  for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+    while (this->next(node, level) != NIL && this->width(node, level) <= remaining) {
+      remaining -= this->width(node, level);
+      node = this->next(node, level);
+    }
+  }
+  return this->values_[node];
+}
+
+void OrderStatisticWindow::insert(size_t slot) {
+  const float value = this->values_[slot];
+  uint16_t update[MAX_LEVEL];
+  size_t update_rank[MAX_LEVEL];
+
+  // Equal values go after the ones already present, so among equals the oldest comes first
+  size_t node = this->capacity_;
+  size_t rank = 0;
+  for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+    while (this->next(node, level) != NIL && this->values_[this->next(node, level)] <= value) {
+      rank += this->width(node, level);
+      node = this->next(node, level);
+    }
+    update[level] = node;
+    update_rank[level] = rank;
+  }
+
+  const uint8_t height = this->heights_[slot];
+  for (uint8_t level = 0; level < MAX_LEVEL; level++) {
+    const size_t previous = update[level];
+    if (level < height) {
+      const size_t distance = rank - update_rank[level];
+      this->next(slot, level) = this->next(previous, level);
+      this->width(slot, level) = this->width(previous, level) - distance;
+      this->next(previous, level) = slot;
+      this->width(previous, level) = distance + 1;
+    } else {
+      this->width(previous, level)++;
+    }
+  }
+  this->size_++;
+}
+
+void OrderStatisticWindow::erase(size_t slot) {
+  const float value = this->values_[slot];
+  uint16_t update[MAX_LEVEL];
+
+  // The evicted slot is the oldest value, hence the first of any run of equal values
+  size_t node = this->capacity_;
+  for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+    while (this->next(node, level) != NIL && this->values_[this->next(node, level)] < value)
+      node = this->next(node, level);
+    update[level] = node;
+  }
+
+  const uint8_t height = this->heights_[slot];
+  for (uint8_t level = 0; level < MAX_LEVEL; level++) {
+    const size_t previous = update[level];
+    if (level < height) {
+      this->width(previous, level) += this->width(slot, level) - 1;
+      this->next(previous, level) = this->next(slot, level);
+    } else {
+      this->width(previous, level)--;
+    }
+  }
+  this->size_--;
+}
+
+}  // namespace streaming_quantile
+}  // namespace esphome
@@ -0,0 +1,64 @@
+#pragma once
+
+// Sliding window order statistics without ESPHome dependencies, so the structure can be
+// built on a host (e.g. to compare against sorting the window) as well as on the device.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace streaming_quantile {
+
+/**
+ * @brief OrderStatisticWindow
+ *   - FIFO window of the last capacity values with O(log n) push/evict and rank queries.
+ *   - Values are kept in an indexable skiplist whose nodes are the FIFO slots themselves,
+ *     so all storage is allocated once in the constructor.
+ *   - NaN values take a slot in the window but are left out of the order statistics.
+ */
+class OrderStatisticWindow {
+ public:
+  static constexpr size_t MAX_CAPACITY = 65534;
+
+  explicit OrderStatisticWindow(size_t capacity);
+
+  // Appends value, evicting the oldest value once the window is full
+  void push(float value);
+  // Number of non-NaN values in the window
+  size_t size() const { return size_; }
+  // rank-th smallest non-NaN value, 0 <= rank < size()
+  float at(size_t rank) const;
+  // Values in FIFO order including NaN, oldest first, 0 <= index < count(); pushing them in this
+  // order into an empty window rebuilds it
+  size_t count() const { return count_; }
+  size_t capacity() const { return capacity_; }
+  float value(size_t index) const { return this->values_[(this->oldest_ + index) % this->capacity_]; }
+
+ protected:
+  static constexpr uint8_t MAX_LEVEL = 8;  // promotion probability 1/4: 4^8 = 65536 values
+  static constexpr uint16_t NIL = 0xFFFF;
+
+  size_t capacity_;
+  size_t count_{0};   // values in the FIFO, including NaN
+  size_t oldest_{0};  // slot of the oldest value
+  size_t size_{0};    // values in the skiplist
+
+  // per slot; slot capacity_ is the head sentinel with MAX_LEVEL levels
+  std::vector<float> values_;
+  std::vector<uint8_t> heights_;
+  std::vector<uint32_t> offsets_;  // first link of the slot in next_/widths_
+  // links, widths count bottom level steps; links to NIL span to one past the last value
+  std::vector<uint16_t> next_;
+  std::vector<uint16_t> widths_;
+
+  void insert(size_t slot);
+  void erase(size_t slot);
+  uint16_t &next(size_t slot, uint8_t level) { return this->next_[this->offsets_[slot] + level]; }
+  uint16_t &width(size_t slot, uint8_t level) { return this->widths_[this->offsets_[slot] + level]; }
+  uint16_t next(size_t slot, uint8_t level) const { return this->next_[this->offsets_[slot] + level]; }
+  uint16_t width(size_t slot, uint8_t level) const { return this->widths_[this->offsets_[slot] + level]; }
+};
+
+}  // namespace streaming_quantile
+}  // namespace esphome
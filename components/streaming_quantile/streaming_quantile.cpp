@@ -0,0 +1,84 @@
+#include "streaming_quantile.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace esphome {
+namespace streaming_quantile {
+
+static const char *const TAG = "streaming_quantile";
+
+#ifdef USE_CHECKPOINT
+// count, send_at, then the window in half precision; the window size is checked on restore
+static const uint32_t CHECKPOINT_RECORD_VERSION = 1;
+#endif
+
+StreamingQuantileFilter::StreamingQuantileFilter(size_t window_size, size_t send_every, size_t send_first_at,
+                                                 float quantile)
+    : window_(window_size),
+      send_every_(send_every),
+      send_at_(send_every - send_first_at),
+      send_first_at_(send_first_at),
+      quantile_(quantile) {}
+
+optional<float> StreamingQuantileFilter::new_value(float value) {
+  this->window_.push(value);
+  ESP_LOGVV(TAG, "StreamingQuantileFilter(%p)::new_value(%f)", this, value);
+
+  if (++this->send_at_ >= this->send_every_) {
+    this->send_at_ = 0;
+    float result = this->compute_();
+    ESP_LOGVV(TAG, "StreamingQuantileFilter(%p)::new_value(%f) SENDING %f", this, value, result);
+    return result;
+  }
+  return {};
+}
+
+#ifdef USE_CHECKPOINT
+void StreamingQuantileFilter::set_checkpoint(checkpoint::Checkpoint *checkpoint, const char *name) {
+  checkpoint->add_client(
+      name, CHECKPOINT_RECORD_VERSION,
+      [this](checkpoint::Writer &writer) {
+        writer.write_u16(this->window_.count());
+        writer.write_u16(this->send_at_);
+        for (size_t i = 0; i < this->window_.count(); i++)
+          writer.write_half(this->window_.value(i));
+      },
+      [this](checkpoint::Reader &reader, uint32_t) {
+        size_t count = reader.read_u16();
+        size_t send_at = reader.read_u16();
+        if (count > this->window_.capacity() || reader.remaining() != count * sizeof(uint16_t))
+          return false;
+        for (size_t i = 0; i < count; i++)
+          this->window_.push(reader.read_half());
+        // The window is already full: send no later than send_first_at values from now
+        this->send_at_ = std::max(send_at, this->send_every_ - this->send_first_at_);
+        return true;
+      });
+}
+#endif
+
+float StreamingQuantileFilter::compute_() const {
+  const size_t size = this->window_.size();
+  if (size == 0)
+    return NAN;
+  // Same rank as the stock quantile filter
+  size_t position = static_cast<size_t>(std::ceil(size * this->quantile_));
+  position = position == 0 ? 0 : position - 1;
+  if (position >= size)
+    position = size - 1;
+  return this->window_.at(position);
+}
+
+float StreamingMedianFilter::compute_() const {
+  const size_t size = this->window_.size();
+  if (size == 0)
+    return NAN;
+  if (size % 2)
+    return this->window_.at(size / 2);
+  return (this->window_.at(size / 2) + this->window_.at(size / 2 - 1)) / 2.0f;
+}
+
+}  // namespace streaming_quantile
+}  // namespace esphome
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "esphome/core/optional.h"
+#include "esphome/components/sensor/filter.h"
+#ifdef USE_CHECKPOINT
+#include "esphome/components/checkpoint/checkpoint.h"
+#endif
+
+#include "order_statistics.h"
+
+namespace esphome {
+namespace streaming_quantile {
+
+/**
+ * @brief StreamingQuantileFilter
+ *   - Drop-in replacement for the stock quantile filter with the same window, send_every,
+ *     send_first_at and NaN semantics, but O(log n) per value instead of copying and sorting
+ *     the window every time it sends.
+ *   - Optionally kept in a checkpoint (half precision) so a full window is restored after a reset.
+ */
+class StreamingQuantileFilter : public sensor::Filter {
+ public:
+  StreamingQuantileFilter(size_t window_size, size_t send_every, size_t send_first_at, float quantile);
+
+  optional<float> new_value(float value) override;
+
+  void set_send_every(size_t send_every) { send_every_ = send_every; }
+  void set_quantile(float quantile) { quantile_ = quantile; }
+#ifdef USE_CHECKPOINT
+  // Restores the window saved under name, if any, and saves it with every checkpoint
+  void set_checkpoint(checkpoint::Checkpoint *checkpoint, const char *name);
+#endif
+
+ protected:
+  OrderStatisticWindow window_;
+  size_t send_every_;
+  size_t send_at_;
+  size_t send_first_at_;
+  float quantile_;
+
+  virtual float compute_() const;
+};
+
+/**
+ * @brief StreamingMedianFilter
+ *   - Drop-in replacement for the stock median filter: the mean of the two middle values
+ *     when the window holds an even number of values.
+ */
+class StreamingMedianFilter : public StreamingQuantileFilter {
+ public:
+  StreamingMedianFilter(size_t window_size, size_t send_every, size_t send_first_at)
+      : StreamingQuantileFilter(window_size, send_every, send_first_at, 0.5f) {}
+
+ protected:
+  float compute_() const override;
+};
+
+}  // namespace streaming_quantile
+}  // namespace esphome
@@ -0,0 +1,96 @@
+"""
+Sample Trace for ESPHome
+- Lightweight spans from the sensor update() and filter chain to the InfluxDB acknowledgment.
+- Stamped with esp_timer into a fixed, lock-free ring; any task can record.
+- GET /trace.json serves the ring as Chrome trace JSON (chrome://tracing, Perfetto).
+- Publishes the p50/p99 of each stage every update_interval.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor, web_server_base
+from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
+from esphome.const import (
+    CONF_ID,
+    CONF_SENSORS,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_TIMER,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_MILLISECOND,
+)
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["network"]
+AUTO_LOAD = ["sensor", "web_server_base"]
+
+CONF_RING_SIZE = "ring_size"
+CONF_STAGES = "stages"
+CONF_STAGE = "stage"
+CONF_P50 = "p50"
+CONF_P99 = "p99"
+
+# Stages recorded by the components; see trace.h
+STAGES = [
+    "sensor.update",
+    "sensor.filter",
+    "sample.snapshot",
+    "influxdb.serialize",
+    "influxdb.connect",
+    "influxdb.post",
+    "sample",
+]
+
+trace_ns = cg.esphome_ns.namespace("trace")
+Trace = trace_ns.class_("Trace", cg.PollingComponent)
+
+
+def stage_sensor_schema():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        icon=ICON_TIMER,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+
+STAGE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_STAGE): cv.one_of(*STAGES, lower=True),
+        cv.Optional(CONF_P50): stage_sensor_schema(),
+        cv.Optional(CONF_P99): stage_sensor_schema(),
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(Trace),
+    cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+    # spans kept; about 32 bytes each. Should hold at least one update_interval of spans
+    cv.Optional(CONF_RING_SIZE, default=512): cv.int_range(min=16, max=4096),
+    # sensors whose filter chain is traced (sensor.filter)
+    cv.Optional(CONF_SENSORS, default=[]): cv.ensure_list(cv.use_id(sensor.Sensor)),
+    cv.Optional(CONF_STAGES, default=[]): cv.ensure_list(STAGE_SCHEMA),
+}).extend(cv.polling_component_schema("60s"))
+
+
+async def to_code(config):
+    base = await cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
+    var = cg.new_Pvariable(config[CONF_ID], base)
+    await cg.register_component(var, config)
+    cg.add_define("USE_TRACE")
+
+    cg.add(var.set_ring_size(config[CONF_RING_SIZE]))
+    for sensor_id in config[CONF_SENSORS]:
+        sens = await cg.get_variable(sensor_id)
+        cg.add(var.add_sensor(sens, sensor_id.id))
+
+    for stage in config[CONF_STAGES]:
+        p50 = cg.nullptr
+        p99 = cg.nullptr
+        if p50_config := stage.get(CONF_P50):
+            p50 = await sensor.new_sensor(p50_config)
+        if p99_config := stage.get(CONF_P99):
+            p99 = await sensor.new_sensor(p99_config)
+        cg.add(var.set_stage_sensors(stage[CONF_STAGE], p50, p99))
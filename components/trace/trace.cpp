@@ -0,0 +1,220 @@
+#include "trace.h"
+#include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <esp_http_server.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace trace {
+
+static const char *const TAG = "trace";
+
+// Chrome trace output is sent in chunks of about this size
+static constexpr size_t CHUNK_SIZE = 1024;
+
+Trace *global_trace = nullptr;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+Trace::Trace(web_server_base::WebServerBase *base) : base_(base) {
+  // Set here rather than in setup(), so spans in the setup() of earlier components are not lost
+  global_trace = this;
+}
+
+Stage *Trace::stage(const char *name) {
+  std::lock_guard<std::mutex> guard(this->stages_lock_);
+  for (auto *stage : this->stages_) {
+    if (strcmp(stage->name, name) == 0)
+      return stage;
+  }
+  auto *stage = new Stage{name, nullptr, nullptr, {}};  // NOLINT(cppcoreguidelines-owning-memory)
+  this->stages_.push_back(stage);
+  return stage;
+}
+
+void Trace::set_stage_sensors(const char *stage, sensor::Sensor *p50, sensor::Sensor *p99) {
+  Stage *s = this->stage(stage);
+  s->p50_sensor = p50;
+  s->p99_sensor = p99;
+}
+
+void Trace::record(Stage *stage, const char *name, int64_t start_us, uint32_t duration_us) {
+  // record() can run before setup() allocated the ring
+  if (this->ring_ == nullptr)
+    return;
+  uint32_t index = this->head_.fetch_add(1, std::memory_order_relaxed);
+  Event &event = this->ring_[index % this->ring_size_];
+  event.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  event.stage = stage;
+  event.name = name;
+  event.start_us = start_us;
+  event.duration_us = duration_us;
+  event.sample = this->sample_.load(std::memory_order_relaxed);
+  event.core = xPortGetCoreID();
+  event.sequence.store(index + 1, std::memory_order_release);
+}
+
+bool Trace::read_event_(uint32_t index, Event &copy) const {
+  const Event &event = this->ring_[index % this->ring_size_];
+  if (event.sequence.load(std::memory_order_acquire) != index + 1)
+    return false;
+  copy.stage = event.stage;
+  copy.name = event.name;
+  copy.start_us = event.start_us;
+  copy.duration_us = event.duration_us;
+  copy.sample = event.sample;
+  copy.core = event.core;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // overwritten while it was copied
+  return event.sequence.load(std::memory_order_relaxed) == index + 1;
+}
+
+void Trace::begin_sample() {
+  this->sample_.fetch_add(1, std::memory_order_relaxed);
+  this->sample_start_us_ = esp_timer_get_time();
+}
+
+void Trace::end_sample() {
+  if (this->sample_start_us_ == 0)
+    return;
+  static Stage *const sample_stage = this->stage("sample");
+  int64_t now = esp_timer_get_time();
+  this->record(sample_stage, nullptr, this->sample_start_us_, now - this->sample_start_us_);
+  this->sample_start_us_ = 0;
+}
+
+void Trace::setup() {
+  this->ring_ = std::unique_ptr<Event[]>(new Event[this->ring_size_]);
+
+  // sensor.filter: from the raw state into the filter chain to the state coming out of it, for
+  // chains that publish synchronously (median windows publish from the raw state completing them)
+  Stage *filter_stage = this->stage("sensor.filter");
+  for (size_t i = 0; i < this->sensors_.size(); i++) {
+    sensor::Sensor *sensor = this->sensors_[i].sensor;
+    sensor->add_on_raw_state_callback([this, i](float) { this->sensors_[i].raw_us = esp_timer_get_time(); });
+    sensor->add_on_state_callback([this, i, filter_stage](float) {
+      TracedSensor &traced = this->sensors_[i];
+      if (traced.raw_us == 0)
+        return;
+      this->record(filter_stage, traced.name, traced.raw_us, esp_timer_get_time() - traced.raw_us);
+      traced.raw_us = 0;
+    });
+  }
+
+  this->base_->init();
+  this->base_->add_handler(this);
+}
+
+void Trace::update() {
+  uint32_t head = this->head_.load(std::memory_order_acquire);
+  uint32_t first = this->window_head_;
+  this->window_head_ = head;
+  if (head - first > this->ring_size_) {
+    ESP_LOGW(TAG, "%" PRIu32 " spans overwritten before they were summarised, increase ring_size",
+             head - first - this->ring_size_);
+    first = head - this->ring_size_;
+  }
+
+  std::vector<Stage *> stages;
+  {
+    std::lock_guard<std::mutex> guard(this->stages_lock_);
+    stages = this->stages_;
+  }
+  for (auto *stage : stages)
+    stage->durations.clear();
+  Event event;
+  for (uint32_t index = first; index != head; index++) {
+    if (this->read_event_(index, event))
+      event.stage->durations.push_back(event.duration_us);
+  }
+
+  ESP_LOGI(TAG, "Stage                  spans   p50 (us)   p99 (us)   max (us)");
+  for (auto *stage : stages) {
+    auto &durations = stage->durations;
+    if (durations.empty())
+      continue;
+    size_t p50_index = (durations.size() - 1) / 2;
+    size_t p99_index = (durations.size() - 1) * 99 / 100;
+    std::nth_element(durations.begin(), durations.begin() + p99_index, durations.end());
+    uint32_t p99 = durations[p99_index];
+    std::nth_element(durations.begin(), durations.begin() + p50_index, durations.begin() + p99_index);
+    uint32_t p50 = durations[p50_index];
+    uint32_t max = *std::max_element(durations.begin() + p99_index, durations.end());
+    ESP_LOGI(TAG, "%-20s %7u %10" PRIu32 " %10" PRIu32 " %10" PRIu32, stage->name,
+             static_cast<unsigned>(durations.size()), p50, p99, max);
+    if (stage->p50_sensor != nullptr)
+      stage->p50_sensor->publish_state(p50 / 1000.0f);
+    if (stage->p99_sensor != nullptr)
+      stage->p99_sensor->publish_state(p99 / 1000.0f);
+  }
+}
+
+bool Trace::canHandle(AsyncWebServerRequest *request) const {
+  return request->method() == HTTP_GET && request->url() == "/trace.json";
+}
+
+// Chrome trace event format: complete events ("ph":"X") in microseconds, one thread per core
+void Trace::handleRequest(AsyncWebServerRequest *request) {
+  if (this->ring_ == nullptr) {
+    request->send(503, "text/plain", "Trace unavailable");
+    return;
+  }
+  httpd_req_t *req = *request;
+  httpd_resp_set_type(req, "application/json");
+
+  std::string out;
+  out.reserve(CHUNK_SIZE + 256);
+  out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"";
+  out += App.get_name();
+  out += "\"}},";
+  out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"core 0\"}},";
+  out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"core 1\"}}";
+
+  // Spans recorded while the response is sent are left for the next request
+  uint32_t head = this->head_.load(std::memory_order_acquire);
+  uint32_t first = head > this->ring_size_ ? head - this->ring_size_ : 0;
+  Event event;
+  char line[192];
+  for (uint32_t index = first; index != head; index++) {
+    if (!this->read_event_(index, event))
+      continue;
+    snprintf(line, sizeof(line),
+             ",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%" PRId64 ",\"dur\":%" PRIu32
+             ",\"pid\":1,\"tid\":%u,\"args\":{\"sample\":%" PRIu32 "}}",
+             event.name != nullptr ? event.name : event.stage->name, event.stage->name, event.start_us,
+             event.duration_us, event.core, event.sample);
+    out += line;
+    if (out.size() >= CHUNK_SIZE) {
+      if (httpd_resp_send_chunk(req, out.data(), out.size()) != ESP_OK)
+        return;
+      out.clear();
+    }
+  }
+  out += "]}";
+  httpd_resp_send_chunk(req, out.data(), out.size());
+  httpd_resp_send_chunk(req, nullptr, 0);
+}
+
+void Trace::dump_config() {
+  ESP_LOGCONFIG(TAG, "Trace:");
+  ESP_LOGCONFIG(TAG, "  Ring size: %u spans (%u bytes)", this->ring_size_,
+                static_cast<unsigned>(this->ring_size_ * sizeof(Event)));
+  for (const auto &traced : this->sensors_)
+    ESP_LOGCONFIG(TAG, "  Filter chain: %s", traced.name);
+  for (auto *stage : this->stages_) {
+    if (stage->p50_sensor != nullptr || stage->p99_sensor != nullptr)
+      ESP_LOGCONFIG(TAG, "  Stage '%s' summarised", stage->name);
+  }
+  LOG_UPDATE_INTERVAL(this);
+}
+
+}  // namespace trace
+}  // namespace esphome
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+#include "esp_timer.h"
+
+namespace esphome {
+namespace trace {
+
+// A pipeline stage; spans of one stage are summarised together
+struct Stage {
+  const char *name;
+  sensor::Sensor *p50_sensor{nullptr};
+  sensor::Sensor *p99_sensor{nullptr};
+  std::vector<uint32_t> durations;  // of the current window, reused by update()
+};
+
+// One span in the ring. sequence is the ring index + 1 once the span is complete and 0 while it is
+// being written, so a reader can tell a torn slot from a valid one without a lock.
+struct Event {
+  std::atomic<uint32_t> sequence{0};
+  Stage *stage{nullptr};
+  const char *name{nullptr};  // e.g. the component or sensor, nullptr for the stage name
+  int64_t start_us{0};        // esp_timer_get_time()
+  uint32_t duration_us{0};
+  uint32_t sample{0};         // sample the span belongs to, 0 before the first
+  uint8_t core{0};
+};
+
+/**
+ * @brief Trace Component
+ *
+ * Follows a sample from the sensor reads to the InfluxDB acknowledgment with lightweight spans:
+ *   - spans are stamped with esp_timer and written to a fixed ring of ring_size events. Writers
+ *     claim a slot with one atomic increment and publish it with a sequence number, so any task
+ *     can record and readers never block them; the oldest spans are overwritten
+ *   - stages: sensor.update (update() dispatched by the I²C arbiter, the loop profiler or the
+ *     snapshot), sensor.filter (from the raw state to the filtered state of the listed sensors),
+ *     sample.snapshot, influxdb.serialize, influxdb.connect (incl. the TLS handshake),
+ *     influxdb.post (request to response status) and sample (capture to acknowledgment)
+ *   - every span carries the number of the sample it belongs to, counted by capture()
+ *   - GET /trace.json returns the ring as Chrome trace JSON (chrome://tracing, Perfetto)
+ *   - every update_interval the p50/p99 of each stage over the spans since the last update are
+ *     published and logged
+ *
+ * Code is marked with TRACE_SPAN("stage") or TRACE_SPAN_NAMED("stage", name) from
+ * instrumentation/trace_span.h, which includes this header when the component is configured.
+ */
+class Trace : public PollingComponent, public AsyncWebHandler {
+ public:
+  explicit Trace(web_server_base::WebServerBase *base);
+
+  // --- Component lifecycle ---
+  void setup() override;
+  void update() override;
+  void dump_config() override;
+  // before the components that record spans from their setup()
+  float get_setup_priority() const override { return setup_priority::BUS; }
+
+  // --- Configuration setters (called by Python codegen) ---
+  void set_ring_size(uint16_t ring_size) { ring_size_ = ring_size; }
+  // name is the sensor id (internal sensors usually have no name)
+  void add_sensor(sensor::Sensor *sensor, const char *name) { sensors_.push_back({sensor, name, 0}); }
+  void set_stage_sensors(const char *stage, sensor::Sensor *p50, sensor::Sensor *p99);
+
+  // --- Public API ---
+  // Stage with the given name, created on first use; the pointer stays valid for the lifetime of
+  // the component. name must be a string literal (it is not copied).
+  Stage *stage(const char *name);
+  // Lock free, from any task
+  void record(Stage *stage, const char *name, int64_t start_us, uint32_t duration_us);
+  // Main loop: a new sample starts (snapshot capture) and ends (acknowledged by InfluxDB)
+  void begin_sample();
+  void end_sample();
+
+  // --- AsyncWebHandler ---
+  bool canHandle(AsyncWebServerRequest *request) const override;
+  void handleRequest(AsyncWebServerRequest *request) override;
+
+ protected:
+  struct TracedSensor {
+    sensor::Sensor *sensor;
+    const char *name;
+    int64_t raw_us;  // time of the raw state not yet through the filters, 0 if none
+  };
+
+  // --- Configuration ---
+  web_server_base::WebServerBase *base_;
+  uint16_t ring_size_{512};
+  std::vector<TracedSensor> sensors_;
+
+  // --- Ring ---
+  std::unique_ptr<Event[]> ring_;
+  std::atomic<uint32_t> head_{0};  // spans recorded since boot
+
+  // --- Runtime state ---
+  std::mutex stages_lock_;  // only taken when a call site looks up its stage
+  std::vector<Stage *> stages_;  // never freed, TRACE_SPAN keeps pointers in statics
+  std::atomic<uint32_t> sample_{0};
+  int64_t sample_start_us_{0};
+  uint32_t window_head_{0};  // head_ at the last update()
+
+  // --- Helper methods ---
+  // Consistent copy of the span with ring index index, false if it was overwritten or is in progress
+  bool read_event_(uint32_t index, Event &copy) const;
+};
+
+extern Trace *global_trace;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Records its own lifetime as a span; a null stage (no trace component) records nothing
+class ScopedSpan {
+ public:
+  ScopedSpan(Stage *stage, const char *name) : stage_(stage), name_(name) {
+    if (stage_ != nullptr)
+      start_us_ = esp_timer_get_time();
+  }
+  ~ScopedSpan() {
+    if (stage_ != nullptr)
+      global_trace->record(stage_, name_, start_us_, esp_timer_get_time() - start_us_);
+  }
+  ScopedSpan(const ScopedSpan &) = delete;
+  ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+ protected:
+  Stage *stage_;
+  const char *name_;
+  int64_t start_us_{0};
+};
+
+}  // namespace trace
+}  // namespace esphome
+
+// Records the rest of the enclosing scope as a span of the named stage. The stage is looked up once
+// per call site.
+#define TRACE_SPAN_CONCAT_(a, b) a##b
+#define TRACE_SPAN_VAR_(a, b) TRACE_SPAN_CONCAT_(a, b)
+#define TRACE_SPAN_NAMED(stage_name, name) \
+  static ::esphome::trace::Stage *const TRACE_SPAN_VAR_(trace_stage_, __LINE__) = \
+      ::esphome::trace::global_trace != nullptr ? ::esphome::trace::global_trace->stage(stage_name) : nullptr; \
+  ::esphome::trace::ScopedSpan TRACE_SPAN_VAR_(trace_span_, __LINE__)(TRACE_SPAN_VAR_(trace_stage_, __LINE__), name)
+#define TRACE_SPAN(stage_name) TRACE_SPAN_NAMED(stage_name, nullptr)
@@ -0,0 +1,124 @@
+"""
+Wi-Fi Power Coordinator for ESPHome
+- Keeps the Wi-Fi radio in modem sleep between InfluxDB flushes and wakes it just before each one.
+- The flush, TLS handshake and backlog replay run in one awake window ended by the publish itself.
+- Optional exceptions for connected API clients and running OTA updates.
+- Reports time awake per hour and an average current estimate.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor, time
+from esphome.components.influxdb import InfluxDB
+from esphome.const import (
+    CONF_ID,
+    CONF_TIME_ID,
+    DEVICE_CLASS_CURRENT,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_TIMER,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_SECOND,
+)
+
+CODEOWNERS = ["@IEQLab"]
+DEPENDENCIES = ["wifi", "influxdb", "time"]
+AUTO_LOAD = ["sensor"]
+
+CONF_INFLUXDB_ID = "influxdb_id"
+CONF_SLEEP_MODE = "sleep_mode"
+CONF_FLUSH_INTERVAL = "flush_interval"
+CONF_WAKE_AHEAD = "wake_ahead"
+CONF_MAX_AWAKE = "max_awake"
+CONF_STAY_AWAKE_FOR_API = "stay_awake_for_api"
+CONF_STAY_AWAKE_FOR_OTA = "stay_awake_for_ota"
+CONF_AWAKE_CURRENT = "awake_current"
+CONF_SLEEP_CURRENT = "sleep_current"
+CONF_AWAKE_TIME = "awake_time"
+CONF_AVERAGE_CURRENT = "average_current"
+
+UNIT_MILLIAMPERE = "mA"
+ICON_CURRENT = "mdi:current-dc"
+
+wifi_power_ns = cg.esphome_ns.namespace("wifi_power")
+WiFiPowerCoordinator = wifi_power_ns.class_("WiFiPowerCoordinator", cg.PollingComponent)
+
+SleepMode = wifi_power_ns.enum("SleepMode")
+SLEEP_MODES = {
+    "MIN_MODEM": SleepMode.SLEEP_MODE_MIN_MODEM,
+    "MAX_MODEM": SleepMode.SLEEP_MODE_MAX_MODEM,
+}
+
+
+def validate_flush_interval(value):
+    value = cv.positive_time_period_milliseconds(value)
+    if value.total_milliseconds < 1000 or value.total_milliseconds % 1000 != 0:
+        raise cv.Invalid("flush_interval must be a whole number of seconds")
+    return value
+
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(WiFiPowerCoordinator),
+        cv.GenerateID(CONF_INFLUXDB_ID): cv.use_id(InfluxDB),
+        # wall clock the flushes are aligned to, e.g. on_time every 5 minutes
+        cv.Required(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+        cv.Optional(CONF_SLEEP_MODE, default="MAX_MODEM"): cv.enum(SLEEP_MODES, upper=True),
+        cv.Optional(CONF_FLUSH_INTERVAL, default="5min"): validate_flush_interval,
+        cv.Optional(CONF_WAKE_AHEAD, default="10s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MAX_AWAKE, default="60s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_STAY_AWAKE_FOR_API, default=True): cv.boolean,
+        cv.Optional(CONF_STAY_AWAKE_FOR_OTA, default=True): cv.boolean,
+        # board supply current in each state, for the average current estimate
+        cv.Optional(CONF_AWAKE_CURRENT, default=120.0): cv.positive_float,
+        cv.Optional(CONF_SLEEP_CURRENT, default=35.0): cv.positive_float,
+        # Diagnostics, published every update_interval
+        cv.Optional(CONF_AWAKE_TIME): sensor.sensor_schema(
+            unit_of_measurement=UNIT_SECOND,
+            icon=ICON_TIMER,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_AVERAGE_CURRENT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLIAMPERE,
+            icon=ICON_CURRENT,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_CURRENT,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+).extend(cv.polling_component_schema("1h"))
+
+
+async def to_code(config):
+    """Generate C++ code for the Wi-Fi power coordinator."""
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    influx = await cg.get_variable(config[CONF_INFLUXDB_ID])
+    cg.add(var.set_influxdb(influx))
+    time_ = await cg.get_variable(config[CONF_TIME_ID])
+    cg.add(var.set_time_source(time_))
+
+    cg.add(var.set_sleep_mode(config[CONF_SLEEP_MODE]))
+    cg.add(var.set_flush_interval(config[CONF_FLUSH_INTERVAL]))
+    cg.add(var.set_wake_ahead(config[CONF_WAKE_AHEAD]))
+    cg.add(var.set_max_awake(config[CONF_MAX_AWAKE]))
+    cg.add(var.set_stay_awake_for_api(config[CONF_STAY_AWAKE_FOR_API]))
+    cg.add(var.set_stay_awake_for_ota(config[CONF_STAY_AWAKE_FOR_OTA]))
+    if config[CONF_STAY_AWAKE_FOR_OTA]:
+        # OTA state callbacks for all OTA platforms
+        cg.add_define("USE_OTA_STATE_CALLBACK")
+    cg.add(var.set_awake_current(config[CONF_AWAKE_CURRENT]))
+    cg.add(var.set_sleep_current(config[CONF_SLEEP_CURRENT]))
+
+    # Optional sensors
+    if awake_time_config := config.get(CONF_AWAKE_TIME):
+        sens = await sensor.new_sensor(awake_time_config)
+        cg.add(var.set_awake_time_sensor(sens))
+    if average_current_config := config.get(CONF_AVERAGE_CURRENT):
+        sens = await sensor.new_sensor(average_current_config)
+        cg.add(var.set_average_current_sensor(sens))
@@ -0,0 +1,176 @@
+#include "wifi_power.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/wifi/wifi_component.h"
+
+#ifdef USE_API
+#include "esphome/components/api/api_server.h"
+#endif
+#if defined(USE_OTA) && defined(USE_OTA_STATE_CALLBACK)
+#include "esphome/components/ota/ota_backend.h"
+#endif
+
+#include <esp_wifi.h>
+
+namespace esphome {
+namespace wifi_power {
+
+static const char *const TAG = "wifi_power";
+
+// Signed difference handles millis() rollover
+static inline bool is_due(uint32_t deadline, uint32_t now) { return static_cast<int32_t>(now - deadline) >= 0; }
+
+void WiFiPowerCoordinator::setup() {
+  this->influxdb_->add_on_publish_begin_callback([this]() {
+    this->publishing_ = true;
+    // Synchronously, the publish connects right after this returns
+    this->apply_(true, millis());
+  });
+  this->influxdb_->add_on_publish_end_callback([this](influxdb::PublishKind kind, bool) {
+    this->publishing_ = false;
+    // An event sent while the window is open is not the flush it was opened for
+    if (kind == influxdb::PUBLISH_SAMPLE)
+      this->window_open_ = false;
+    this->apply_(this->wants_awake_(millis()), millis());
+  });
+
+#if defined(USE_OTA) && defined(USE_OTA_STATE_CALLBACK)
+  if (this->stay_awake_for_ota_) {
+    ota::get_global_ota_callback()->add_on_state_callback(
+        [this](ota::OTAState state, float progress, uint8_t error, ota::OTAComponent *comp) {
+          this->ota_active_ = state == ota::OTA_STARTED || state == ota::OTA_IN_PROGRESS;
+          if (this->ota_active_)
+            this->apply_(true, millis());
+        });
+  }
+#endif
+
+  uint32_t now = millis();
+  this->window_start_ = now;
+  this->state_since_ = now;
+}
+
+void WiFiPowerCoordinator::loop() {
+  uint32_t now = millis();
+
+  // The Wi-Fi component applies its own power save mode on every (re)connection
+  bool connected = wifi::global_wifi_component->is_connected();
+  if (connected && !this->connected_)
+    this->set_power_save_(this->awake_);
+  this->connected_ = connected;
+
+  // The wall clock has second resolution, no need to look more often
+  if (now - this->last_check_ < 1000)
+    return;
+  this->last_check_ = now;
+  this->check_schedule_(now);
+  this->apply_(this->wants_awake_(now), now);
+}
+
+// Opens a window wake_ahead_ms_ before the next flush_interval-aligned flush
+void WiFiPowerCoordinator::check_schedule_(uint32_t now) {
+  if (this->window_open_ && is_due(this->window_deadline_, now)) {
+    ESP_LOGW(TAG, "No publish within %ums, going back to sleep", this->max_awake_ms_);
+    this->window_open_ = false;
+  }
+  if (this->window_open_)
+    return;
+
+  auto time = this->time_source_->now();
+  if (!time.is_valid())
+    return;
+  time_t next_flush = (time.timestamp / this->flush_interval_s_ + 1) * this->flush_interval_s_;
+  uint32_t until_flush_ms = static_cast<uint32_t>(next_flush - time.timestamp) * 1000;
+  if (until_flush_ms <= this->wake_ahead_ms_ && next_flush != this->window_flush_) {
+    this->window_open_ = true;
+    this->window_flush_ = next_flush;
+    this->window_deadline_ = now + until_flush_ms + this->max_awake_ms_;
+    ESP_LOGD(TAG, "Waking for flush in %us", until_flush_ms / 1000);
+  }
+}
+
+bool WiFiPowerCoordinator::wants_awake_(uint32_t now) {
+  if (this->publishing_ || this->window_open_ || this->ota_active_)
+    return true;
+  if (this->holding_) {
+    if (!is_due(this->hold_until_, now))
+      return true;
+    this->holding_ = false;
+  }
+  // Without a valid clock the next flush cannot be anticipated (and SNTP needs the radio)
+  if (!this->time_source_->now().is_valid())
+    return true;
+#ifdef USE_API
+  if (this->stay_awake_for_api_ && api::global_api_server != nullptr && api::global_api_server->is_connected())
+    return true;
+#endif
+  return false;
+}
+
+void WiFiPowerCoordinator::hold_awake(uint32_t duration_ms) {
+  uint32_t now = millis();
+  uint32_t until = now + duration_ms;
+  if (!this->holding_ || static_cast<int32_t>(until - this->hold_until_) > 0)
+    this->hold_until_ = until;
+  this->holding_ = true;
+  this->apply_(true, now);
+}
+
+void WiFiPowerCoordinator::apply_(bool awake, uint32_t now) {
+  if (awake == this->awake_)
+    return;
+  if (this->awake_)
+    this->awake_ms_ += now - this->state_since_;
+  this->state_since_ = now;
+  this->awake_ = awake;
+  ESP_LOGV(TAG, "Radio %s", awake ? "awake" : "sleeping");
+  if (this->connected_)
+    this->set_power_save_(awake);
+}
+
+void WiFiPowerCoordinator::set_power_save_(bool awake) {
+  wifi_ps_type_t mode = WIFI_PS_NONE;
+  if (!awake)
+    mode = this->sleep_mode_ == SLEEP_MODE_MIN_MODEM ? WIFI_PS_MIN_MODEM : WIFI_PS_MAX_MODEM;
+  esp_err_t err = esp_wifi_set_ps(mode);
+  if (err != ESP_OK)
+    ESP_LOGW(TAG, "esp_wifi_set_ps failed: %s", esp_err_to_name(err));
+}
+
+void WiFiPowerCoordinator::update() {
+  uint32_t now = millis();
+  uint32_t elapsed_ms = now - this->window_start_;
+  uint32_t awake_ms = this->awake_ms_;
+  if (this->awake_)
+    awake_ms += now - this->state_since_;
+
+  if (elapsed_ms > 0) {
+    float awake_fraction = static_cast<float>(awake_ms) / elapsed_ms;
+    if (this->awake_time_sensor_ != nullptr)
+      this->awake_time_sensor_->publish_state(awake_fraction * 3600.0f);
+    if (this->average_current_sensor_ != nullptr)
+      this->average_current_sensor_->publish_state(awake_fraction * this->awake_current_ma_ +
+                                                   (1.0f - awake_fraction) * this->sleep_current_ma_);
+  }
+
+  this->window_start_ = now;
+  this->state_since_ = now;
+  this->awake_ms_ = 0;
+}
+
+void WiFiPowerCoordinator::dump_config() {
+  ESP_LOGCONFIG(TAG, "Wi-Fi Power Coordinator:");
+  ESP_LOGCONFIG(TAG, "  Sleep mode: %s", this->sleep_mode_ == SLEEP_MODE_MIN_MODEM ? "min modem" : "max modem");
+  ESP_LOGCONFIG(TAG, "  Flush every %us, wake %ums ahead, max awake %ums", this->flush_interval_s_,
+                this->wake_ahead_ms_, this->max_awake_ms_);
+  ESP_LOGCONFIG(TAG, "  Stay awake for API: %s, OTA: %s", YESNO(this->stay_awake_for_api_),
+                YESNO(this->stay_awake_for_ota_));
+  ESP_LOGCONFIG(TAG, "  Current estimate: %.0fmA awake, %.0fmA asleep", this->awake_current_ma_,
+                this->sleep_current_ma_);
+  LOG_UPDATE_INTERVAL(this);
+  LOG_SENSOR("  ", "Awake Time", this->awake_time_sensor_);
+  LOG_SENSOR("  ", "Average Current", this->average_current_sensor_);
+}
+
+}  // namespace wifi_power
+}  // namespace esphome
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/time/real_time_clock.h"
+#include "esphome/components/influxdb/influxdb.h"
+
+namespace esphome {
+namespace wifi_power {
+
+enum SleepMode : uint8_t {
+  SLEEP_MODE_MIN_MODEM,  // wake every DTIM beacon
+  SLEEP_MODE_MAX_MODEM,  // wake every listen interval, lowest current while associated
+};
+
+/**
+ * @brief WiFiPowerCoordinator
+ *   - Keeps the associated Wi-Fi radio in modem sleep between InfluxDB flushes and turns power
+ *     saving off flush_interval-aligned wake_ahead before each scheduled flush, so the flush, TLS
+ *     handshake and backlog replay run in one awake window that ends with the publish.
+ *   - Any publish wakes the radio through the InfluxDB begin hook, scheduled or not.
+ *   - Stays awake while an API client is connected or an OTA update runs (configurable), while
+ *     the wall clock is not valid (the next flush is unknown) and for explicit hold_awake() calls.
+ *   - Reports the time awake per hour and an average current estimate from configured currents.
+ */
+class WiFiPowerCoordinator : public PollingComponent {
+ public:
+  // --- Configurable setters called by Python codegen ---
+  void set_influxdb(influxdb::InfluxDB *influxdb) { influxdb_ = influxdb; }
+  void set_time_source(time::RealTimeClock *time_source) { time_source_ = time_source; }
+  void set_sleep_mode(SleepMode sleep_mode) { sleep_mode_ = sleep_mode; }
+  void set_flush_interval(uint32_t interval_ms) { flush_interval_s_ = interval_ms / 1000; }
+  void set_wake_ahead(uint32_t wake_ahead_ms) { wake_ahead_ms_ = wake_ahead_ms; }
+  void set_max_awake(uint32_t max_awake_ms) { max_awake_ms_ = max_awake_ms; }
+  void set_stay_awake_for_api(bool stay_awake) { stay_awake_for_api_ = stay_awake; }
+  void set_stay_awake_for_ota(bool stay_awake) { stay_awake_for_ota_ = stay_awake; }
+  void set_awake_current(float current_ma) { awake_current_ma_ = current_ma; }
+  void set_sleep_current(float current_ma) { sleep_current_ma_ = current_ma; }
+  void set_awake_time_sensor(sensor::Sensor *sensor) { awake_time_sensor_ = sensor; }
+  void set_average_current_sensor(sensor::Sensor *sensor) { average_current_sensor_ = sensor; }
+
+  // --- Public API ---
+  // Keeps power saving off for duration_ms from now, e.g. around a firmware check
+  void hold_awake(uint32_t duration_ms);
+  bool is_awake() const { return awake_; }
+
+  // --- Component interface ---
+  void setup() override;
+  void loop() override;
+  void update() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::AFTER_WIFI; }
+
+ protected:
+  // --- User options with sensible defaults ---
+  influxdb::InfluxDB *influxdb_{nullptr};
+  time::RealTimeClock *time_source_{nullptr};
+  SleepMode sleep_mode_{SLEEP_MODE_MAX_MODEM};
+  uint32_t flush_interval_s_{300};
+  uint32_t wake_ahead_ms_{10000};
+  uint32_t max_awake_ms_{60000};   // closes a window whose flush never came
+  bool stay_awake_for_api_{true};
+  bool stay_awake_for_ota_{true};
+  float awake_current_ma_{120.0f};
+  float sleep_current_ma_{35.0f};
+
+  // --- Optional sensors ---
+  sensor::Sensor *awake_time_sensor_{nullptr};
+  sensor::Sensor *average_current_sensor_{nullptr};
+
+  // --- Wake reasons ---
+  bool publishing_{false};
+  bool ota_active_{false};
+  bool window_open_{false};
+  uint32_t window_deadline_{0};     // millis() at which an open window is closed regardless
+  time_t window_flush_{0};          // epoch of the flush the current/last window was opened for
+  uint32_t hold_until_{0};
+  bool holding_{false};
+  uint32_t last_check_{0};
+
+  // --- Radio state ---
+  bool awake_{true};                // power saving is off until the first decision
+  bool connected_{false};
+
+  // --- Statistics since the last update() ---
+  uint32_t window_start_{0};
+  uint32_t state_since_{0};
+  uint32_t awake_ms_{0};
+
+  // --- Helper methods ---
+  bool wants_awake_(uint32_t now);
+  void check_schedule_(uint32_t now);
+  void apply_(bool awake, uint32_t now);
+  void set_power_save_(bool awake);
+};
+
+}  // namespace wifi_power
+}  // namespace esphome
@@ -0,0 +1,123 @@
+// Size and speed of the archive on the host: bytes per sample of the block codec for the series
+// of config/sample.yaml, encode and decode cost, and query throughput through the HTTP handler.
+//
+//   bench_archive [days of 5 minute samples per query, default 7]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "esphome/components/archive/archive_codec.h"
+#include "harness.h"
+
+using namespace esphome;
+using namespace esphome::archive;
+using namespace esphome::archive::testing;
+
+static constexpr uint32_t START = 1760000000;
+static constexpr uint32_t INTERVAL = 300;
+
+static volatile uint32_t sink;
+
+// Runs body repeatedly for about 200 ms; returns the ns per call
+static double time_ns(const std::function<void()> &body) {
+  body();
+  size_t calls = 0;
+  auto start = std::chrono::steady_clock::now();
+  double ns = 0;
+  while (ns < 2e8) {
+    body();
+    calls++;
+    ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+  return ns / calls;
+}
+
+static void codec(Profile profile, uint8_t count) {
+  const uint8_t series = samba_series().size();
+  const size_t blocks = 100;
+  std::vector<uint32_t> timestamps(count);
+  for (uint8_t i = 0; i < count; i++)
+    timestamps[i] = START + i * INTERVAL + (i % 3 == 1 ? 1 : 0);  // a little jitter, as from SNTP
+  std::vector<float> values = sample_values(profile, count * blocks, series, 1);
+
+  std::vector<uint8_t> block(max_block_size(count, series));
+  size_t bytes = 0;
+  for (size_t b = 0; b < blocks; b++)
+    bytes += encode_block(timestamps.data(), &values[b * count * series], count, series, 0, block.data(), block.size());
+  double per_sample = double(bytes) / (blocks * count);
+  double raw = sizeof(uint32_t) + series * sizeof(float);
+
+  size_t b = 0;
+  double encode = time_ns([&]() {
+    sink = encode_block(timestamps.data(), &values[b * count * series], count, series, 0, block.data(), block.size());
+    b = (b + 1) % blocks;
+  });
+  encode_block(timestamps.data(), values.data(), count, series, 0, block.data(), block.size());
+  std::vector<uint32_t> decoded_timestamps(count);
+  std::vector<float> decoded(count);
+  double decode = time_ns([&]() {
+    decode_timestamps(block.data(), decoded_timestamps.data());
+    for (uint8_t s = 0; s < series; s++)
+      decode_series(block.data(), s, decoded.data());
+    sink = decoded_timestamps[0];
+  });
+  double decode_one = time_ns([&]() {
+    decode_timestamps(block.data(), decoded_timestamps.data());
+    decode_series(block.data(), 5, decoded.data());
+    sink = decoded_timestamps[0];
+  });
+  printf("%-9s %6u %10.1f %7.1f %%  %11.0f %11.0f %13.0f\n", profile_name(profile), count, per_sample,
+         100.0 * per_sample / raw, encode / count, decode / count, decode_one / count);
+}
+
+static void query(HostArchive &rig, const char *name, const std::string &url) {
+  auto &stats = host::partition_stats(rig.partition);
+  size_t bytes_read = stats.bytes_read;
+  auto request = rig.query(url);
+  size_t read = stats.bytes_read - bytes_read;
+  size_t rows = std::count(request->req().body.begin(), request->req().body.end(), '\n') - 1;
+  size_t csv = request->req().body.size();
+  double ns = time_ns([&]() { sink = rig.query(url)->req().body.size(); });
+  printf("%-26s %9zu %9zu %8zu %12.0f %10.1f %10.0f\n", name, rows, csv, read / 4096, rows / (ns / 1e9),
+         csv / (ns / 1e3), ns / 1e3);
+}
+
+int main(int argc, char **argv) {
+  double days = argc > 1 ? atof(argv[1]) : 7.0;
+  host::set_log_level(ESPHOME_LOG_LEVEL_WARN);
+
+  printf("Codec, %zu series (config/sample.yaml), raw sample %zu bytes\n", samba_series().size(),
+         sizeof(uint32_t) + samba_series().size() * sizeof(float));
+  printf("%-9s %6s %10s %9s  %11s %11s %13s\n", "profile", "block", "B/sample", "of raw", "enc ns/smp",
+         "dec ns/smp", "dec 1 ns/smp");
+  for (Profile profile : {Profile::SAMBA, Profile::CONSTANT, Profile::NOISE}) {
+    for (uint8_t count : {uint8_t(1), uint8_t(12), uint8_t(MAX_BLOCK_SAMPLES)})
+      codec(profile, count);
+  }
+
+  // a partition large enough for the whole run, filled with the SAMBA profile
+  size_t samples = days * 86400 / INTERVAL;
+  const size_t series = samba_series().size();
+  host::remove_partitions();
+  HostArchive rig(samples * 64 / 4096 + 4);
+  std::vector<float> values = sample_values(Profile::SAMBA, samples, series, 2);
+  for (size_t i = 0; i < samples; i++)
+    rig.capture(START + i * INTERVAL, &values[i * series]);
+  uint32_t end = START + samples * INTERVAL;
+  auto &stats = host::partition_stats(rig.partition);
+  printf("\n%zu samples (%.1f days) in %zu bytes of flash, %.1f B/sample including page headers and padding\n",
+         samples, days, stats.bytes_written, double(stats.bytes_written) / samples);
+
+  printf("\nQuery through Archive::handleRequest\n");
+  printf("%-26s %9s %9s %8s %12s %10s %10s\n", "query", "rows", "CSV B", "pages", "rows/s", "CSV MB/s", "us/query");
+  query(rig, "everything", "/archive");
+  query(rig, "one sensor", "/archive?sensor=samba_co2");
+  query(rig, "last hour", "/archive?from=" + std::to_string(end - 3600));
+  query(rig, "last hour, one sensor", "/archive?sensor=samba_co2&from=" + std::to_string(end - 3600));
+  query(rig, "one day in the middle",
+        "/archive?from=" + std::to_string(START + (end - START) / 2) +
+            "&to=" + std::to_string(START + (end - START) / 2 + 86400));
+  return 0;
+}
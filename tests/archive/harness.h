@@ -0,0 +1,176 @@
+#pragma once
+
+// The archive on the host: the sources of config/sample.yaml behind a SampleSnapshot, a RAM
+// partition and the web server stub, plus synthetic sensor data shaped like the SAMBA's.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "esphome/components/archive/archive.h"
+
+namespace esphome::archive::testing {
+
+// Sources of config/sample.yaml, in order
+inline const std::vector<std::string> &samba_series() {
+  static const std::vector<std::string> SERIES = {
+      "samba_temperature", "samba_globe", "samba_humidity", "samba_airspeed", "samba_mrt",
+      "samba_co2",         "samba_lux",   "samba_pm25",     "samba_tvoc",     "samba_nox",
+      "samba_laeq",        "samba_lamin", "samba_lamax",
+  };
+  return SERIES;
+}
+
+enum class Profile {
+  SAMBA,     // values as the SAMBA sensors produce them: raw readings through float conversions
+  CONSTANT,  // nothing changes
+  NOISE,     // independent random floats, the worst case for XOR coding
+};
+
+inline const char *profile_name(Profile profile) {
+  switch (profile) {
+    case Profile::SAMBA:
+      return "samba";
+    case Profile::CONSTANT:
+      return "constant";
+    default:
+      return "noise";
+  }
+}
+
+// samples x series values, row major like the archive's pending block
+inline std::vector<float> sample_values(Profile profile, size_t samples, size_t series, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  std::uniform_int_distribution<uint32_t> bits;
+  std::vector<float> values(samples * series);
+  for (size_t i = 0; i < samples; i++) {
+    double day = 2 * M_PI * i / 288.0;  // 5 minute samples
+    for (size_t s = 0; s < series; s++) {
+      float &v = values[i * series + s];
+      if (profile == Profile::CONSTANT) {
+        v = 20.0f + s;
+        continue;
+      }
+      if (profile == Profile::NOISE) {
+        uint32_t b = bits(rng);
+        std::memcpy(&v, &b, sizeof(v));
+        continue;
+      }
+      double slow = std::sin(day + s);
+      switch (s % 13) {
+        case 0:  // SHT4x: -45 + 175 * raw / 65535
+        case 1:
+        case 4: {
+          double celsius = 23.0 + 2.0 * slow + 0.05 * normal(rng);
+          uint16_t raw = std::lround((celsius + 45.0) * 65535.0 / 175.0);
+          v = -45.0f + 175.0f * raw / 65535.0f;
+          break;
+        }
+        case 2: {
+          uint16_t raw = std::lround((45.0 + 10.0 * slow + 0.2 * normal(rng)) * 65535.0 / 100.0);
+          v = 100.0f * raw / 65535.0f;
+          break;
+        }
+        case 3:  // ADS1115 counts through the airspeed calibration
+          v = std::max(0.0f, 0.08f + 0.002f * std::lround(20 * slow + 3 * normal(rng)));
+          break;
+        case 5:
+          v = std::lround(600 + 200 * slow + 10 * normal(rng));
+          break;
+        case 6:
+          v = std::max(0.0, 1.2 * std::lround(250 + 200 * slow + 5 * normal(rng)));
+          break;
+        case 7:
+          v = std::max(0L, std::lround(6 + 3 * slow + normal(rng)));
+          break;
+        case 8:
+          v = std::lround(100 + 20 * slow + 2 * normal(rng));
+          break;
+        case 9:
+          v = 1.0f;
+          break;
+        default:  // dB levels, medians of float Leq values
+          v = static_cast<float>(45.0 + 8.0 * slow + normal(rng) + (s % 13 - 11) * 6.0);
+          break;
+      }
+    }
+  }
+  return values;
+}
+
+// The archive fed by a SampleSnapshot of samba_series()
+class HostArchive {
+ public:
+  explicit HostArchive(uint32_t pages, uint8_t block_samples = 12, bool erase = true) {
+    if (erase || esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "archive") == nullptr)
+      this->partition = host::add_partition("archive", pages * 4096);
+    else
+      this->partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "archive");
+    for (const auto &name : samba_series()) {
+      this->sensors.push_back(std::make_unique<sensor::Sensor>());
+      this->sensors.back()->set_object_id(name);
+      this->snapshot.add_source(this->sensors.back().get(), nullptr);
+    }
+    this->snapshot.set_time_source(&this->clock);
+    this->archive = std::make_unique<Archive>(&this->server);
+    this->archive->set_snapshot(&this->snapshot);
+    this->archive->set_block_samples(block_samples);
+    this->snapshot.setup();
+    this->archive->setup();
+  }
+
+  // One snapshot at timestamp with the given values (one per series)
+  void capture(uint32_t timestamp, const float *values) {
+    this->clock.set_epoch(timestamp);
+    for (size_t s = 0; s < this->sensors.size(); s++)
+      this->sensors[s]->state = values[s];
+    this->snapshot.capture();
+  }
+
+  std::unique_ptr<AsyncWebServerRequest> query(const std::string &url) {
+    auto request = std::make_unique<AsyncWebServerRequest>(url);
+    this->server.handle(request.get());
+    return request;
+  }
+
+  const esp_partition_t *partition;
+  std::vector<std::unique_ptr<sensor::Sensor>> sensors;
+  time::RealTimeClock clock;
+  sample_snapshot::SampleSnapshot snapshot;
+  web_server_base::WebServerBase server;
+  std::unique_ptr<Archive> archive;
+};
+
+// The CSV the archive serves for timestamps and values (row major, all series), columns selected
+inline std::string expected_csv(const std::vector<uint32_t> &timestamps, const std::vector<float> &values,
+                                size_t series, const std::vector<size_t> &columns, uint32_t from = 0,
+                                uint32_t to = UINT32_MAX) {
+  std::string out = "timestamp";
+  for (size_t c : columns)
+    out += "," + samba_series()[c];
+  out += '\n';
+  char number[24];
+  for (size_t i = 0; i < timestamps.size(); i++) {
+    if (timestamps[i] < from || timestamps[i] > to)
+      continue;
+    out += std::to_string(timestamps[i]);
+    for (size_t c : columns) {
+      out += ',';
+      float value = values[i * series + c];
+      if (!std::isnan(value)) {
+        snprintf(number, sizeof(number), "%.6g", value);
+        out += number;
+      }
+    }
+    out += '\n';
+  }
+  return out;
+}
+
+}  // namespace esphome::archive::testing
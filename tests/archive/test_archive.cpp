@@ -0,0 +1,328 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include "esphome/components/archive/archive_codec.h"
+#include "harness.h"
+
+namespace esphome::archive::testing {
+namespace {
+
+static constexpr uint32_t START = 1760000000;  // 2025-10-09
+
+uint32_t bits_of(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// Encodes, checks and decodes one block, expecting every timestamp and value bit for bit
+void expect_round_trip(const std::vector<uint32_t> &timestamps, const std::vector<float> &values, uint8_t series) {
+  uint8_t count = timestamps.size();
+  std::vector<uint8_t> block(max_block_size(count, series));
+  size_t length = encode_block(timestamps.data(), values.data(), count, series, 0x1234, block.data(), block.size());
+  ASSERT_GT(length, 0u);
+  ASSERT_LE(length, max_block_size(count, series));
+  ASSERT_TRUE(check_block(block.data(), length));
+  const auto *header = reinterpret_cast<const BlockHeader *>(block.data());
+  EXPECT_EQ(header->first_timestamp, timestamps.front());
+  EXPECT_EQ(header->last_timestamp, timestamps.back());
+  EXPECT_EQ(header->layout, 0x1234u);
+
+  std::vector<uint32_t> decoded_timestamps(count);
+  decode_timestamps(block.data(), decoded_timestamps.data());
+  ASSERT_EQ(decoded_timestamps, timestamps);
+  std::vector<float> decoded(count);
+  for (uint8_t s = 0; s < series; s++) {
+    decode_series(block.data(), s, decoded.data());
+    for (uint8_t i = 0; i < count; i++)
+      ASSERT_EQ(bits_of(decoded[i]), bits_of(values[i * series + s])) << "series " << int(s) << " sample " << int(i);
+  }
+}
+
+std::vector<uint32_t> regular_timestamps(size_t count, uint32_t start = START, uint32_t step = 300) {
+  std::vector<uint32_t> timestamps(count);
+  for (size_t i = 0; i < count; i++)
+    timestamps[i] = start + i * step;
+  return timestamps;
+}
+
+// --- Codec ---
+
+class RoundTripTest : public ::testing::TestWithParam<std::tuple<Profile, int, int>> {};
+
+TEST_P(RoundTripTest, BitExact) {
+  auto [profile, count, series] = GetParam();
+  std::mt19937 rng(count * 100 + series);
+  std::uniform_int_distribution<int> jitter(-2, 2);
+  std::vector<uint32_t> timestamps = regular_timestamps(count);
+  for (size_t i = 1; i < timestamps.size(); i++)
+    timestamps[i] = timestamps[i - 1] + 300 + jitter(rng);
+  expect_round_trip(timestamps, sample_values(profile, count, series, series), series);
+}
+
+INSTANTIATE_TEST_SUITE_P(Blocks, RoundTripTest,
+                         ::testing::Combine(::testing::Values(Profile::SAMBA, Profile::CONSTANT, Profile::NOISE),
+                                            ::testing::Values(1, 2, 12, 63, MAX_BLOCK_SAMPLES),
+                                            ::testing::Values(1, 13, 40)),
+                         [](const auto &info) {
+                           return std::string(profile_name(std::get<0>(info.param))) + "_" +
+                                  std::to_string(std::get<1>(info.param)) + "x" +
+                                  std::to_string(std::get<2>(info.param));
+                         });
+
+TEST(Codec, SpecialValues) {
+  const float specials[] = {
+      0.0f, -0.0f, NAN, -NAN, std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::min(), 1.0f, 1.0f, 1.0f, -1.0f, 1e-30f, 1e30f,
+  };
+  std::vector<float> values;
+  // every pair of specials next to each other, and a NaN with a payload
+  for (float a : specials) {
+    for (float b : specials) {
+      values.push_back(a);
+      values.push_back(b);
+    }
+  }
+  uint32_t payload = 0x7FC01234;
+  std::memcpy(&values[5], &payload, sizeof(payload));
+  for (size_t start = 0; start < values.size(); start += MAX_BLOCK_SAMPLES) {
+    size_t count = std::min<size_t>(MAX_BLOCK_SAMPLES, values.size() - start);
+    std::vector<float> block(values.begin() + start, values.begin() + start + count);
+    expect_round_trip(regular_timestamps(count), block, 1);
+  }
+}
+
+TEST(Codec, TimestampSteps) {
+  // every delta-of-delta range, both signs, around each boundary
+  std::vector<uint32_t> timestamps = {START};
+  for (int64_t dod : {0L, 1L, -1L, 63L, 64L, 65L, -63L, -64L, 255L, 256L, 257L, -255L, -256L, 2047L, 2048L, 2049L,
+                      -2047L, -2048L, 86400L, -86000L, 5000000L}) {
+    int64_t delta = 100000 + dod;
+    timestamps.push_back(timestamps.back() + 100000);
+    timestamps.push_back(timestamps.back() + delta);
+  }
+  for (size_t start = 0; start < timestamps.size(); start += MAX_BLOCK_SAMPLES) {
+    size_t count = std::min<size_t>(MAX_BLOCK_SAMPLES, timestamps.size() - start);
+    std::vector<uint32_t> block(timestamps.begin() + start, timestamps.begin() + start + count);
+    expect_round_trip(block, std::vector<float>(count, 1.0f), 1);
+  }
+  // deltas beyond 32 bit delta-of-delta: from the epoch to the end of uint32
+  expect_round_trip({1, 2, 4000000000u, 4000000001u, 4000000002u, UINT32_MAX}, std::vector<float>(6, 0.0f), 1);
+}
+
+// Random bit patterns in every column stay within the size the archive reserves
+TEST(Codec, MaxBlockSizeIsBound) {
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<uint32_t> any;
+  for (int round = 0; round < 50; round++) {
+    std::vector<uint32_t> timestamps(MAX_BLOCK_SAMPLES);
+    uint32_t t = any(rng) / 4;
+    for (auto &timestamp : timestamps) {
+      t += 1 + any(rng) % 50000000;
+      timestamp = t;
+    }
+    const uint8_t series = 13;
+    std::vector<float> values = sample_values(Profile::NOISE, MAX_BLOCK_SAMPLES, series, round);
+    std::vector<uint8_t> block(max_block_size(MAX_BLOCK_SAMPLES, series));
+    EXPECT_GT(encode_block(timestamps.data(), values.data(), MAX_BLOCK_SAMPLES, series, 0, block.data(), block.size()),
+              0u);
+  }
+  // and a buffer smaller than the block is refused
+  std::vector<uint32_t> timestamps = regular_timestamps(12);
+  std::vector<float> values = sample_values(Profile::NOISE, 12, 13, 1);
+  std::vector<uint8_t> block(64);
+  EXPECT_EQ(encode_block(timestamps.data(), values.data(), 12, 13, 0, block.data(), block.size()), 0u);
+}
+
+TEST(Codec, DamagedBlockRejected) {
+  const uint8_t series = 13;
+  std::vector<uint32_t> timestamps = regular_timestamps(12);
+  std::vector<float> values = sample_values(Profile::SAMBA, 12, series, 2);
+  std::vector<uint8_t> block(max_block_size(12, series));
+  size_t length = encode_block(timestamps.data(), values.data(), 12, series, 0, block.data(), block.size());
+  ASSERT_TRUE(check_block(block.data(), length));
+  EXPECT_FALSE(check_block(block.data(), length - 1));
+  EXPECT_FALSE(check_block(block.data(), sizeof(BlockHeader) - 1));
+  for (size_t i = 0; i < length; i++) {
+    for (uint8_t flip : {0x01, 0x80, 0xFF}) {
+      std::vector<uint8_t> damaged(block.begin(), block.begin() + length);
+      damaged[i] ^= flip;
+      // the CRC covers the columns; of the header, magic, length and CRC are checked, while layout,
+      // timestamps, count and series are not
+      bool unchecked = i >= offsetof(BlockHeader, layout) && i < offsetof(BlockHeader, crc);
+      if (!unchecked) {
+        EXPECT_FALSE(check_block(damaged.data(), length)) << "byte " << i << " ^ " << int(flip);
+      }
+    }
+  }
+  // erased flash
+  std::vector<uint8_t> erased(64, 0xFF);
+  EXPECT_FALSE(check_block(erased.data(), erased.size()));
+}
+
+// --- Archive ---
+
+class ArchiveTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::remove_partitions();
+    host::set_log_level(ESPHOME_LOG_LEVEL_NONE);
+  }
+  void TearDown() override {
+    host::remove_partitions();
+    host::set_log_level(ESPHOME_LOG_LEVEL_WARN);
+  }
+
+  // Captures count samples every 300 s from start, recording what was captured
+  void capture(HostArchive &rig, size_t count, uint32_t start = START) {
+    const size_t series = samba_series().size();
+    std::vector<float> values = sample_values(Profile::SAMBA, count, series, this->timestamps_.size());
+    for (size_t i = 0; i < count; i++) {
+      values[i * series + 7] = i % 17 == 3 ? NAN : values[i * series + 7];  // PM2.5 sensor dropouts
+      uint32_t timestamp = start + i * 300;
+      rig.capture(timestamp, &values[i * series]);
+      this->timestamps_.push_back(timestamp);
+      this->values_.insert(this->values_.end(), values.begin() + i * series, values.begin() + (i + 1) * series);
+    }
+  }
+
+  std::vector<size_t> all_columns() const {
+    std::vector<size_t> columns(samba_series().size());
+    for (size_t c = 0; c < columns.size(); c++)
+      columns[c] = c;
+    return columns;
+  }
+
+  std::vector<uint32_t> timestamps_;
+  std::vector<float> values_;
+};
+
+TEST_F(ArchiveTest, QueryReturnsEverySample) {
+  HostArchive rig(16);
+  // 41 samples: three full blocks and 5 pending
+  this->capture(rig, 41);
+  auto request = rig.query("/archive");
+  EXPECT_EQ(request->req().content_type, "text/csv");
+  EXPECT_TRUE(request->req().finished);
+  EXPECT_EQ(request->req().body, expected_csv(this->timestamps_, this->values_, 13, this->all_columns()));
+}
+
+TEST_F(ArchiveTest, QueryRangeAndSensors) {
+  HostArchive rig(16);
+  this->capture(rig, 500);
+  uint32_t from = START + 100 * 300 + 1, to = START + 377 * 300;
+  auto request = rig.query("/archive?from=" + std::to_string(from) + "&to=" + std::to_string(to) +
+                           "&sensor=samba_co2,samba_temperature");
+  EXPECT_EQ(request->req().body, expected_csv(this->timestamps_, this->values_, 13, {5, 0}, from, to));
+
+  EXPECT_EQ(rig.query("/archive?sensor=samba_nothing")->code(), 404);
+  // a range before the first sample
+  auto empty = rig.query("/archive?to=" + std::to_string(START - 1));
+  EXPECT_EQ(empty->req().body, expected_csv({}, {}, 13, this->all_columns()));
+}
+
+// A partition of 4 pages keeps the newest 3 to 4 pages once it wraps
+TEST_F(ArchiveTest, RingDropsOldestPages) {
+  HostArchive rig(4);
+  this->capture(rig, 3000);
+  EXPECT_GT(host::partition_stats(rig.partition).sectors_erased, 10u);
+  std::string body = rig.query("/archive")->req().body;
+
+  // the rows served are the newest samples, contiguous up to the last one
+  size_t rows = std::count(body.begin(), body.end(), '\n') - 1;
+  ASSERT_GT(rows, 100u);
+  ASSERT_LT(rows, 3000u);
+  std::vector<uint32_t> newest(this->timestamps_.end() - rows, this->timestamps_.end());
+  std::vector<float> newest_values(this->values_.end() - rows * 13, this->values_.end());
+  EXPECT_EQ(body, expected_csv(newest, newest_values, 13, this->all_columns()));
+}
+
+// A new instance (i.e. after a reboot) finds the head page and appends after it
+TEST_F(ArchiveTest, ResumesAfterRestart) {
+  {
+    HostArchive rig(16);
+    this->capture(rig, 100);
+    rig.archive->on_shutdown();
+  }
+  HostArchive rig(16, 12, false);
+  this->capture(rig, 50, START + 100 * 300);
+  EXPECT_EQ(rig.query("/archive")->req().body,
+            expected_csv(this->timestamps_, this->values_, 13, this->all_columns()));
+}
+
+// Power lost in the middle of a write leaves a torn block; after a reboot the torn block closes the
+// head page and the archive continues on the next one
+TEST_F(ArchiveTest, TornWrite) {
+  std::vector<uint32_t> lost;
+  {
+    HostArchive rig(16);
+    this->capture(rig, 36);
+    host::fail_partition_writes(1);
+    this->capture(rig, 12, START + 36 * 300);
+    lost.assign(this->timestamps_.end() - 12, this->timestamps_.end());
+  }
+  HostArchive rig(16, 12, false);
+  this->capture(rig, 30, START + 48 * 300);
+  std::string body = rig.query("/archive")->req().body;
+
+  // everything but the torn block
+  std::vector<uint32_t> kept;
+  std::vector<float> kept_values;
+  for (size_t i = 0; i < this->timestamps_.size(); i++) {
+    if (std::find(lost.begin(), lost.end(), this->timestamps_[i]) != lost.end())
+      continue;
+    kept.push_back(this->timestamps_[i]);
+    kept_values.insert(kept_values.end(), this->values_.begin() + i * 13, this->values_.begin() + (i + 1) * 13);
+  }
+  EXPECT_EQ(body, expected_csv(kept, kept_values, 13, this->all_columns()));
+  EXPECT_EQ(host::partition_stats(rig.partition).sectors_erased, 2u);
+}
+
+// A clock stepping back closes the pending block, so blocks stay in time order
+TEST_F(ArchiveTest, ClockStepBack) {
+  HostArchive rig(16);
+  this->capture(rig, 5);
+  uint32_t back = START - 3600;
+  this->capture(rig, 5, back);
+  rig.archive->flush();
+  // every sample is kept, in the order written
+  EXPECT_EQ(rig.query("/archive")->req().body,
+            expected_csv(this->timestamps_, this->values_, 13, this->all_columns()));
+}
+
+TEST_F(ArchiveTest, SamplesWithoutTimeAreSkipped) {
+  HostArchive rig(16);
+  std::vector<float> values(13, 1.0f);
+  rig.capture(0, values.data());
+  rig.archive->flush();
+  EXPECT_EQ(rig.query("/archive")->req().body, expected_csv({}, {}, 13, this->all_columns()));
+}
+
+TEST_F(ArchiveTest, ClientGoneStopsQuery) {
+  HostArchive rig(16);
+  this->capture(rig, 2000);
+  auto request = std::make_unique<AsyncWebServerRequest>("/archive");
+  request->req().chunk_limit = 2;
+  rig.server.handle(request.get());
+  EXPECT_EQ(request->req().chunks, 2u);
+  EXPECT_FALSE(request->req().finished);
+}
+
+TEST_F(ArchiveTest, NoPartition) {
+  host::remove_partitions();
+  sample_snapshot::SampleSnapshot snapshot;
+  web_server_base::WebServerBase server;
+  Archive archive(&server);
+  archive.set_snapshot(&snapshot);
+  archive.setup();
+  EXPECT_TRUE(archive.is_failed());
+}
+
+}  // namespace
+}  // namespace esphome::archive::testing
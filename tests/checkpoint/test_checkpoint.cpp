@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "esphome/components/checkpoint/checkpoint.h"
+#include "esphome/components/streaming_quantile/streaming_quantile.h"
+#include "esphome/core/log.h"
+
+namespace esphome::checkpoint::testing {
+namespace {
+
+// The RTC buffer is a static of checkpoint.cpp, so a new Checkpoint in the same process sees what
+// the previous one saved, like the firmware after a reset or an OTA; registering clients with
+// other versions stands in for a firmware that changed them.
+struct Client {
+  std::string name;
+  uint32_t version;
+  uint32_t value;
+  bool restored{false};
+  uint32_t restored_value{0};
+
+  bool add_to(Checkpoint &checkpoint) {
+    return checkpoint.add_client(
+        this->name.c_str(), this->version, [this](Writer &writer) { writer.write_u32(this->value); },
+        [this](Reader &reader, uint32_t) {
+          this->restored = true;
+          this->restored_value = reader.read_u32();
+          return reader.ok() && reader.remaining() == 0;
+        });
+  }
+};
+
+class CheckpointTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::set_log_level(ESPHOME_LOG_LEVEL_NONE);
+    // a checkpoint without clients leaves nothing to restore
+    Checkpoint empty(600000);
+    empty.save();
+  }
+  void TearDown() override { host::set_log_level(ESPHOME_LOG_LEVEL_WARN); }
+};
+
+TEST(HalfPrecision, RoundTrip) {
+  for (float value : {0.0f, -0.0f, 1.0f, -2.5f, 415.0f, 65504.0f, 6.1e-5f, 21.53f})
+    EXPECT_NEAR(half_to_float(float_to_half(value)), value, std::fabs(value) / 1024) << value;
+  EXPECT_TRUE(std::isnan(half_to_float(float_to_half(NAN))));
+  EXPECT_TRUE(std::isinf(half_to_float(float_to_half(1e6f))));
+  EXPECT_EQ(half_to_float(float_to_half(1e-9f)), 0.0f);
+}
+
+TEST(Serialization, WriterOverflowAndReaderPastEnd) {
+  uint8_t buffer[8];
+  Writer writer(buffer, sizeof(buffer));
+  writer.write_u32(7);
+  writer.write_string("abc");
+  EXPECT_TRUE(writer.overflow());
+  EXPECT_EQ(writer.remaining(), 0u);
+  writer.truncate(4);
+  writer.write_u16(9);
+  EXPECT_FALSE(writer.overflow());
+
+  Reader reader(buffer, writer.size());
+  EXPECT_EQ(reader.read_u32(), 7u);
+  EXPECT_EQ(reader.read_u16(), 9u);
+  EXPECT_TRUE(reader.ok());
+  EXPECT_EQ(reader.read_u32(), 0u);
+  EXPECT_FALSE(reader.ok());
+}
+
+TEST_F(CheckpointTest, RestoredAfterReset) {
+  {
+    Checkpoint before(600000);
+    Client a{"a", 1, 1234};
+    EXPECT_FALSE(a.add_to(before));
+    before.save();
+  }
+  Checkpoint after(600000);
+  Client a{"a", 1, 0};
+  EXPECT_TRUE(a.add_to(after));
+  EXPECT_EQ(a.restored_value, 1234u);
+}
+
+// A firmware update keeps the records of the clients it did not change, whatever its build
+TEST_F(CheckpointTest, VersionIsPerClient) {
+  {
+    Checkpoint before(600000);
+    Client a{"a", 1, 11}, b{"b", 1, 22};
+    a.add_to(before);
+    b.add_to(before);
+    before.save();
+  }
+  Checkpoint after(600000);
+  Client a{"a", 1, 0}, b{"b", 2, 0}, c{"c", 1, 0};
+  EXPECT_TRUE(a.add_to(after));
+  EXPECT_EQ(a.restored_value, 11u);
+  EXPECT_FALSE(b.add_to(after));
+  EXPECT_FALSE(b.restored);
+  EXPECT_FALSE(c.add_to(after));
+
+  // and the next save writes the new versions
+  after.save();
+  Checkpoint again(600000);
+  Client b2{"b", 2, 0};
+  EXPECT_TRUE(b2.add_to(again));
+  EXPECT_EQ(b2.restored_value, 0u);
+}
+
+TEST_F(CheckpointTest, ClientRejectingItsRecord) {
+  {
+    Checkpoint before(600000);
+    before.add_client(
+        "long", 1, [](Writer &writer) { writer.write_u32(1); writer.write_u32(2); },
+        [](Reader &, uint32_t) { return true; });
+    before.save();
+  }
+  Checkpoint after(600000);
+  Client same_name{"long", 1, 0};
+  EXPECT_FALSE(same_name.add_to(after));
+  EXPECT_TRUE(same_name.restored);
+}
+
+// A record that does not fit is left out; the others are still saved
+TEST_F(CheckpointTest, RecordTooLargeLeftOut) {
+  {
+    Checkpoint before(600000);
+    Client small{"small", 1, 5};
+    small.add_to(before);
+    before.add_client(
+        "large", 1, [](Writer &writer) { writer.write(std::vector<uint8_t>(8192).data(), 8192); },
+        [](Reader &, uint32_t) { return true; });
+    before.save();
+  }
+  Checkpoint after(600000);
+  Client small{"small", 1, 0};
+  EXPECT_TRUE(small.add_to(after));
+  EXPECT_EQ(small.restored_value, 5u);
+  bool large_restored = after.add_client(
+      "large", 1, [](Writer &) {}, [](Reader &, uint32_t) { return true; });
+  EXPECT_FALSE(large_restored);
+}
+
+// The median filter of a sensor resumes with its full window after a reset
+TEST_F(CheckpointTest, StreamingMedianWindowRestored) {
+  {
+    Checkpoint before(600000);
+    streaming_quantile::StreamingMedianFilter filter(5, 5, 1);
+    filter.set_checkpoint(&before, "co2_median");
+    for (float value : {400.0f, 410.0f, 420.0f, 430.0f, 440.0f, 450.0f})
+      filter.new_value(value);
+    before.save();
+  }
+  Checkpoint after(600000);
+  streaming_quantile::StreamingMedianFilter filter(5, 5, 1);
+  filter.set_checkpoint(&after, "co2_median");
+  // one more value, sent right away since the window is already full: 420..460
+  optional<float> median = filter.new_value(460.0f);
+  ASSERT_TRUE(median.has_value());
+  EXPECT_FLOAT_EQ(*median, 440.0f);
+}
+
+}  // namespace
+}  // namespace esphome::checkpoint::testing
@@ -0,0 +1,58 @@
+// Microseconds per PMV/PPD evaluation on the host: from a cold start on every call, warm started
+// from the previous solution as consecutive samples are, and with the saturation pressure table.
+//
+//   bench_pmv [evaluations per case, default 1000000]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "esphome/components/comfort/pmv.h"
+#include "iso7730.h"
+
+using namespace esphome::comfort;
+using namespace esphome::comfort::testing;
+
+static volatile float sink;
+
+static void report(const char *name, size_t evaluations, const std::function<PMVResult(size_t)> &eval) {
+  unsigned iterations = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < evaluations; i++) {
+    PMVResult result = eval(i);
+    sink = result.pmv;
+    iterations += result.iterations;
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  printf("%-34s %8.3f us/eval %6.2f iterations/eval\n", name, us / evaluations, double(iterations) / evaluations);
+}
+
+int main(int argc, char **argv) {
+  size_t evaluations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  const auto &cases = annex_d_cases();
+
+  PMVSolver solver;
+  report("Annex D cases, cold start", evaluations, [&](size_t i) {
+    const auto &c = cases[i % cases.size()];
+    solver.reset();
+    return solver.solve(c.ta, c.tr, c.air_speed, c.rh, c.met, c.clo);
+  });
+
+  // a room drifting by 0.01 °C per sample around each case
+  PMVSolver warm;
+  report("slow drift, warm start", evaluations, [&](size_t i) {
+    const auto &c = cases[(i / 1000) % cases.size()];
+    float drift = 0.01f * (i % 1000);
+    return warm.solve(c.ta + drift, c.tr + drift, c.air_speed, c.rh, c.met, c.clo);
+  });
+
+  PMVSolver table;
+  table.set_use_table(true);
+  report("slow drift, warm start, table", evaluations, [&](size_t i) {
+    const auto &c = cases[(i / 1000) % cases.size()];
+    float drift = 0.01f * (i % 1000);
+    return table.solve(c.ta + drift, c.tr + drift, c.air_speed, c.rh, c.met, c.clo);
+  });
+  return 0;
+}
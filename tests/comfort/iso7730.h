@@ -0,0 +1,81 @@
+#pragma once
+
+// The reference cases of ISO 7730:2005 Annex D, Table D.1, and the Annex D program in double
+// precision.
+
+#include <cmath>
+#include <vector>
+
+namespace esphome::comfort::testing {
+
+struct ReferenceCase {
+  float ta;         // °C
+  float tr;         // °C
+  float air_speed;  // m/s
+  float rh;         // %
+  float met;
+  float clo;
+  float pmv;
+  float ppd;  // %, rounded to whole percent in the standard
+};
+
+// Table D.1 without case 7 (23.5 °C, 0.1 m/s, 40 %, 1.2 met, 1.0 clo), whose printed PMV of 0.50
+// the Annex D program does not reproduce (it gives 0.36); the solver is checked on those inputs
+// against annex_d_program() instead
+inline const std::vector<ReferenceCase> &annex_d_cases() {
+  static const std::vector<ReferenceCase> CASES = {
+      {22.0f, 22.0f, 0.10f, 60.0f, 1.2f, 0.5f, -0.75f, 17.0f}, {27.0f, 27.0f, 0.10f, 60.0f, 1.2f, 0.5f, 0.77f, 17.0f},
+      {27.0f, 27.0f, 0.30f, 60.0f, 1.2f, 0.5f, 0.44f, 9.0f},   {23.5f, 25.5f, 0.10f, 60.0f, 1.2f, 0.5f, -0.01f, 5.0f},
+      {23.5f, 25.5f, 0.30f, 60.0f, 1.2f, 0.5f, -0.55f, 11.0f}, {19.0f, 19.0f, 0.10f, 40.0f, 1.2f, 1.0f, -0.60f, 13.0f},
+      {23.5f, 23.5f, 0.30f, 40.0f, 1.2f, 1.0f, 0.12f, 5.0f},
+      {23.0f, 21.0f, 0.10f, 40.0f, 1.2f, 1.0f, 0.05f, 5.0f},   {23.0f, 21.0f, 0.30f, 40.0f, 1.2f, 1.0f, -0.16f, 6.0f},
+      {22.0f, 22.0f, 0.10f, 60.0f, 1.6f, 0.5f, 0.05f, 5.0f},   {27.0f, 27.0f, 0.10f, 60.0f, 1.6f, 0.5f, 1.17f, 34.0f},
+      {27.0f, 27.0f, 0.30f, 60.0f, 1.6f, 0.5f, 0.95f, 24.0f},
+  };
+  return CASES;
+}
+
+struct ReferenceResult {
+  double pmv;
+  double ppd;
+};
+
+// The BASIC program of Annex D, transcribed in double precision with its own iteration
+inline ReferenceResult annex_d_program(double ta, double tr, double vel, double rh, double met, double clo,
+                                       double wme = 0.0) {
+  double pa = rh * 10 * std::exp(16.6536 - 4030.183 / (ta + 235));
+  double icl = 0.155 * clo;
+  double m = met * 58.15;
+  double w = wme * 58.15;
+  double mw = m - w;
+  double fcl = icl <= 0.078 ? 1 + 1.29 * icl : 1.05 + 0.645 * icl;
+  double hcf = 12.1 * std::sqrt(vel);
+  double taa = ta + 273;
+  double tra = tr + 273;
+  double tcla = taa + (35.5 - ta) / (3.5 * icl + 0.1);
+  double p1 = icl * fcl;
+  double p2 = p1 * 3.96;
+  double p3 = p1 * 100;
+  double p4 = p1 * taa;
+  double p5 = 308.7 - 0.028 * mw + p2 * std::pow(tra / 100, 4);
+  double xn = tcla / 100;
+  double xf = tcla / 50;
+  double hc = hcf;
+  for (int n = 0; n < 150 && std::fabs(xn - xf) > 0.00015; n++) {
+    xf = (xf + xn) / 2;
+    hc = std::fmax(hcf, 2.38 * std::pow(std::fabs(100 * xf - taa), 0.25));
+    xn = (p5 + p4 * hc - p2 * std::pow(xf, 4)) / (100 + p3 * hc);
+  }
+  double tcl = 100 * xn - 273;
+  double hl1 = 3.05e-3 * (5733 - 6.99 * mw - pa);
+  double hl2 = mw > 58.15 ? 0.42 * (mw - 58.15) : 0;
+  double hl3 = 1.7e-5 * m * (5867 - pa);
+  double hl4 = 0.0014 * m * (34 - ta);
+  double hl5 = 3.96 * fcl * (std::pow(xn, 4) - std::pow(tra / 100, 4));
+  double hl6 = fcl * hc * (tcl - ta);
+  double ts = 0.303 * std::exp(-0.036 * m) + 0.028;
+  double pmv = ts * (mw - hl1 - hl2 - hl3 - hl4 - hl5 - hl6);
+  return {pmv, 100 - 95 * std::exp(-0.03353 * std::pow(pmv, 4) - 0.2179 * pmv * pmv)};
+}
+
+}  // namespace esphome::comfort::testing
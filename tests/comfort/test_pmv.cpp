@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "esphome/components/comfort/pmv.h"
+#include "iso7730.h"
+
+namespace esphome::comfort::testing {
+namespace {
+
+static constexpr float PMV_TOLERANCE = 0.01f;
+static constexpr float PPD_TOLERANCE = 1.0f;  // percentage points
+
+void expect_annex_d(PMVSolver &solver, bool warm_start) {
+  for (size_t i = 0; i < annex_d_cases().size(); i++) {
+    const auto &c = annex_d_cases()[i];
+    if (!warm_start)
+      solver.reset();
+    PMVResult result = solver.solve(c.ta, c.tr, c.air_speed, c.rh, c.met, c.clo);
+    EXPECT_TRUE(result.converged) << "case " << i + 1;
+    EXPECT_NEAR(result.pmv, c.pmv, PMV_TOLERANCE) << "case " << i + 1;
+    EXPECT_NEAR(result.ppd, c.ppd, PPD_TOLERANCE) << "case " << i + 1;
+  }
+}
+
+TEST(AnnexD, ColdStart) {
+  PMVSolver solver;
+  expect_annex_d(solver, false);
+}
+
+// Each case starts from the solution of the previous one
+TEST(AnnexD, WarmStart) {
+  PMVSolver solver;
+  expect_annex_d(solver, true);
+}
+
+TEST(AnnexD, SaturationTable) {
+  PMVSolver solver;
+  solver.set_use_table(true);
+  expect_annex_d(solver, false);
+}
+
+// Single precision against the double precision program over the office range of every input:
+// PMV within PMV_TOLERANCE and PPD within 1 % of its value
+TEST(AnnexD, MatchesDoublePrecisionProgram) {
+  PMVSolver solver, table;
+  table.set_use_table(true);
+  size_t evaluated = 0;
+  for (float ta = 16.0f; ta <= 32.0f; ta += 2.0f) {
+    for (float dt : {-3.0f, 0.0f, 3.0f}) {
+      for (float air_speed : {0.05f, 0.1f, 0.3f, 1.0f}) {
+        for (float rh : {20.0f, 50.0f, 80.0f}) {
+          for (float met : {1.0f, 1.2f, 1.6f, 2.0f}) {
+            for (float clo : {0.3f, 0.5f, 1.0f, 1.5f}) {
+              ReferenceResult expected = annex_d_program(ta, ta + dt, air_speed, rh, met, clo);
+              solver.reset();
+              for (PMVSolver *s : {&solver, &table}) {
+                PMVResult result = s->solve(ta, ta + dt, air_speed, rh, met, clo);
+                ASSERT_NEAR(result.pmv, expected.pmv, PMV_TOLERANCE)
+                    << ta << " " << ta + dt << " " << air_speed << " " << rh << " " << met << " " << clo;
+                ASSERT_NEAR(result.ppd, expected.ppd, std::max(PPD_TOLERANCE / 100 * expected.ppd, 0.05));
+              }
+              evaluated++;
+            }
+          }
+        }
+      }
+    }
+  }
+  EXPECT_EQ(evaluated, 9u * 3 * 4 * 3 * 4 * 4);
+}
+
+// Table D.1 case 7
+TEST(AnnexD, Case7MatchesProgram) {
+  PMVSolver solver;
+  PMVResult result = solver.solve(23.5f, 23.5f, 0.1f, 40.0f, 1.2f, 1.0f);
+  ReferenceResult expected = annex_d_program(23.5, 23.5, 0.1, 40.0, 1.2, 1.0);
+  EXPECT_NEAR(result.pmv, expected.pmv, PMV_TOLERANCE);
+  EXPECT_NEAR(result.ppd, expected.ppd, PPD_TOLERANCE);
+}
+
+// A warm start from the same inputs converges in fewer iterations to the same solution
+TEST(Solver, WarmStartConvergesFaster) {
+  for (const auto &c : annex_d_cases()) {
+    PMVSolver solver;
+    PMVResult cold = solver.solve(c.ta, c.tr, c.air_speed, c.rh, c.met, c.clo);
+    PMVResult warm = solver.solve(c.ta + 0.1f, c.tr, c.air_speed, c.rh, c.met, c.clo);
+    solver.reset();
+    PMVResult reference = solver.solve(c.ta + 0.1f, c.tr, c.air_speed, c.rh, c.met, c.clo);
+    EXPECT_LT(warm.iterations, cold.iterations);
+    EXPECT_NEAR(warm.pmv, reference.pmv, PMV_TOLERANCE / 2);
+  }
+}
+
+TEST(Solver, NotConvergedStartsCold) {
+  PMVSolver solver;
+  solver.set_max_iterations(1);
+  const auto &c = annex_d_cases()[0];
+  PMVResult result = solver.solve(c.ta, c.tr, c.air_speed, c.rh, c.met, c.clo);
+  EXPECT_FALSE(result.converged);
+  EXPECT_EQ(result.iterations, 1);
+  solver.set_max_iterations(50);
+  result = solver.solve(c.ta, c.tr, c.air_speed, c.rh, c.met, c.clo);
+  EXPECT_TRUE(result.converged);
+  EXPECT_NEAR(result.pmv, c.pmv, PMV_TOLERANCE);
+}
+
+TEST(Solver, NanInputs) {
+  PMVSolver solver;
+  PMVResult result = solver.solve(NAN, 22.0f, 0.1f, 50.0f, 1.2f, 0.5f);
+  EXPECT_TRUE(std::isnan(result.pmv));
+  EXPECT_TRUE(std::isnan(result.ppd));
+  EXPECT_FALSE(result.converged);
+}
+
+// ISO 7726: the mean of air and radiant temperature below 0.2 m/s, weighted towards the air above
+TEST(OperativeTemperature, WeightsByAirSpeed) {
+  EXPECT_FLOAT_EQ(PMVSolver::operative_temperature(20.0f, 30.0f, 0.1f), 25.0f);
+  EXPECT_FLOAT_EQ(PMVSolver::operative_temperature(20.0f, 30.0f, 0.3f), 24.0f);
+  EXPECT_FLOAT_EQ(PMVSolver::operative_temperature(20.0f, 30.0f, 1.0f), 23.0f);
+}
+
+}  // namespace
+}  // namespace esphome::comfort::testing
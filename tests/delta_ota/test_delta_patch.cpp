@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <openssl/evp.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "esphome/components/delta_ota/delta_patch.h"
+
+namespace esphome::delta_ota::testing {
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// Small synthetic images laid out like firmware/, with patches built by tools/delta_ota.py diff:
+// v0.2.0 inserts code, which moves the addresses past it; v0.3.0 drops code and changes data
+const std::filesystem::path FIRMWARE_DIR = std::filesystem::path(SAMBA_DIR) / "tests" / "delta_ota" / "firmware";
+
+Bytes read_file(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  return Bytes(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+Bytes md5(const uint8_t *data, size_t len) {
+  Bytes digest(EVP_MAX_MD_SIZE);
+  unsigned int size = 0;
+  EVP_Digest(data, len, digest.data(), &size, EVP_md5(), nullptr);
+  digest.resize(size);
+  return digest;
+}
+
+// Inflates a zlib stream whole, as the ROM inflater does on the device chunk by chunk
+Bytes inflate_all(const uint8_t *data, size_t len) {
+  z_stream stream{};
+  inflateInit(&stream);
+  stream.next_in = const_cast<uint8_t *>(data);
+  stream.avail_in = len;
+  Bytes out;
+  uint8_t buffer[32768];
+  int status;
+  do {
+    stream.next_out = buffer;
+    stream.avail_out = sizeof(buffer);
+    status = inflate(&stream, Z_NO_FLUSH);
+    out.insert(out.end(), buffer, buffer + sizeof(buffer) - stream.avail_out);
+  } while (status == Z_OK);
+  inflateEnd(&stream);
+  EXPECT_EQ(status, Z_STREAM_END);
+  return out;
+}
+
+// The running partition and the next OTA partition
+class ImageTarget : public PatchTarget {
+ public:
+  explicit ImageTarget(const Bytes &old_image) : old_image(old_image) {}
+
+  bool read_old(uint32_t offset, uint8_t *data, size_t len) override {
+    if (offset + len > this->old_image.size() || offset >= this->fail_reads_at)
+      return false;
+    memcpy(data, this->old_image.data() + offset, len);
+    return true;
+  }
+  bool write_new(const uint8_t *data, size_t len) override {
+    this->new_image.insert(this->new_image.end(), data, data + len);
+    return true;
+  }
+
+  const Bytes &old_image;
+  Bytes new_image;
+  uint32_t fail_reads_at{UINT32_MAX};
+};
+
+struct Patch {
+  std::string name;
+  PatchHeader header;
+  Bytes base;    // samba_<from>.bin
+  Bytes target;  // samba_<to>.bin
+  Bytes entries;  // the inflated stream
+};
+
+// delta/samba_<from>-<to>.patch with the images it was built from
+std::vector<Patch> load_patches() {
+  static const std::regex NAME(R"(samba_(v[0-9.]+)-(v[0-9.]+)\.patch)");
+  std::vector<Patch> patches;
+  for (const auto &entry : std::filesystem::directory_iterator(FIRMWARE_DIR / "delta")) {
+    std::string name = entry.path().filename().string();
+    std::smatch match;
+    if (!std::regex_match(name, match, NAME))
+      continue;
+    Patch patch;
+    patch.name = name;
+    Bytes file = read_file(entry.path());
+    if (file.size() < sizeof(PatchHeader)) {
+      ADD_FAILURE() << name << " is shorter than its header";
+      continue;
+    }
+    memcpy(&patch.header, file.data(), sizeof(PatchHeader));
+    patch.base = read_file(FIRMWARE_DIR / ("samba_" + match[1].str() + ".bin"));
+    patch.target = read_file(FIRMWARE_DIR / ("samba_" + match[2].str() + ".bin"));
+    patch.entries = inflate_all(file.data() + sizeof(PatchHeader), file.size() - sizeof(PatchHeader));
+    patches.push_back(std::move(patch));
+  }
+  std::sort(patches.begin(), patches.end(), [](const Patch &a, const Patch &b) { return a.name < b.name; });
+  return patches;
+}
+
+const std::vector<Patch> &patches() {
+  static const std::vector<Patch> PATCHES = load_patches();
+  return PATCHES;
+}
+
+// Feeds the inflated stream in chunks of 1 to max_chunk bytes; returns whether every feed()
+// succeeded
+bool apply(PatchDecoder &decoder, const Bytes &entries, size_t max_chunk, uint32_t seed = 1) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> chunk(1, max_chunk);
+  for (size_t pos = 0; pos < entries.size();) {
+    size_t n = std::min(chunk(rng), entries.size() - pos);
+    if (!decoder.feed(entries.data() + pos, n))
+      return false;
+    pos += n;
+  }
+  return true;
+}
+
+TEST(DeltaPatch, PatchesFound) { EXPECT_EQ(patches().size(), 2u); }
+
+// Every patch turns its base image into the next one, byte for byte, with the MD5s of its header,
+// fed in chunks like the inflater's output
+TEST(DeltaPatch, PatchesReproduceTarget) {
+  for (const auto &patch : patches()) {
+    SCOPED_TRACE(patch.name);
+    ASSERT_FALSE(patch.base.empty());
+    ASSERT_FALSE(patch.target.empty());
+    EXPECT_EQ(patch.header.magic, PATCH_MAGIC);
+    ASSERT_EQ(patch.header.old_size, patch.base.size());
+    ASSERT_EQ(patch.header.new_size, patch.target.size());
+    EXPECT_EQ(md5(patch.base.data(), patch.base.size()), Bytes(patch.header.old_md5, patch.header.old_md5 + 16));
+
+    ImageTarget target(patch.base);
+    PatchDecoder decoder(&target, patch.header.old_size, patch.header.new_size);
+    ASSERT_TRUE(apply(decoder, patch.entries, 1024));
+    EXPECT_TRUE(decoder.is_done());
+    EXPECT_EQ(decoder.get_error(), PatchError::NONE);
+    EXPECT_EQ(decoder.get_new_position(), patch.header.new_size);
+    EXPECT_EQ(md5(target.new_image.data(), target.new_image.size()),
+              Bytes(patch.header.new_md5, patch.header.new_md5 + 16));
+    EXPECT_TRUE(target.new_image == patch.target);
+  }
+}
+
+// Entries split at every possible point
+TEST(DeltaPatch, ByteByByte) {
+  const Patch &patch = patches().back();
+  ImageTarget target(patch.base);
+  PatchDecoder decoder(&target, patch.header.old_size, patch.header.new_size);
+  ASSERT_TRUE(apply(decoder, patch.entries, 1));
+  EXPECT_TRUE(decoder.is_done());
+  EXPECT_TRUE(target.new_image == patch.target);
+}
+
+TEST(DeltaPatch, TruncatedStreamNotDone) {
+  const Patch &patch = patches().back();
+  ImageTarget target(patch.base);
+  PatchDecoder decoder(&target, patch.header.old_size, patch.header.new_size);
+  Bytes truncated(patch.entries.begin(), patch.entries.end() - 100);
+  EXPECT_TRUE(apply(decoder, truncated, 1024));
+  EXPECT_FALSE(decoder.is_done());
+  EXPECT_LT(decoder.get_new_position(), patch.header.new_size);
+}
+
+TEST(DeltaPatch, TrailingDataIsCorrupt) {
+  const Patch &patch = patches().back();
+  ImageTarget target(patch.base);
+  PatchDecoder decoder(&target, patch.header.old_size, patch.header.new_size);
+  Bytes trailing = patch.entries;
+  trailing.push_back(0);
+  EXPECT_FALSE(apply(decoder, trailing, 1024));
+  EXPECT_EQ(decoder.get_error(), PatchError::CORRUPT);
+}
+
+// Lengths beyond either image are rejected before anything is read or written
+TEST(DeltaPatch, OversizedEntryIsCorrupt) {
+  const Patch &patch = patches().back();
+  for (uint32_t diff_length : {patch.header.new_size + 1, UINT32_MAX}) {
+    ImageTarget target(patch.base);
+    PatchDecoder decoder(&target, patch.header.old_size, patch.header.new_size);
+    Bytes entries = patch.entries;
+    memcpy(entries.data(), &diff_length, sizeof(diff_length));
+    EXPECT_FALSE(apply(decoder, entries, 1024));
+    EXPECT_EQ(decoder.get_error(), PatchError::CORRUPT);
+    EXPECT_TRUE(target.new_image.empty());
+  }
+}
+
+TEST(DeltaPatch, SeekBeforeStartIsCorrupt) {
+  // one empty entry seeking back from 0
+  uint8_t entry[12] = {};
+  int32_t seek = -1;
+  memcpy(entry + 8, &seek, sizeof(seek));
+  Bytes old_image(16);
+  ImageTarget target(old_image);
+  PatchDecoder decoder(&target, 16, 16);
+  EXPECT_FALSE(decoder.feed(entry, sizeof(entry)));
+  EXPECT_EQ(decoder.get_error(), PatchError::CORRUPT);
+}
+
+TEST(DeltaPatch, FailedReadStops) {
+  const Patch &patch = patches().back();
+  ImageTarget target(patch.base);
+  target.fail_reads_at = patch.header.old_size / 2;
+  PatchDecoder decoder(&target, patch.header.old_size, patch.header.new_size);
+  EXPECT_FALSE(apply(decoder, patch.entries, 1024));
+  EXPECT_EQ(decoder.get_error(), PatchError::READ_OLD);
+  EXPECT_FALSE(decoder.is_done());
+}
+
+}  // namespace
+}  // namespace esphome::delta_ota::testing
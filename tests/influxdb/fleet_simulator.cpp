@@ -0,0 +1,127 @@
+// A fleet of SAMBAs publishing to one InfluxDB: each device is the influxdb component as in
+// config/influx.yaml, in its own thread on the shared host clock, posting through the host
+// esp_http_client to a WriteSink. Devices publish on the 5 minute boundaries their SNTP clocks
+// agree on, within jitter; the report shows what the server sees and what the devices see per
+// server behaviour and fleet size.
+//
+//   fleet_simulator [largest fleet, default 1000] [intervals, default 4]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "harness.h"
+#include "write_sink.h"
+
+using namespace esphome;
+using namespace esphome::influxdb;
+using namespace esphome::influxdb::testing;
+
+struct Scenario {
+  SinkConfig sink;
+  uint32_t jitter_ms;   // spread of the publishes around each boundary
+  uint32_t outage_s;    // server down from the start for this long
+};
+
+struct Result {
+  size_t publishes{0};
+  size_t failed{0};
+  size_t backlog{0};  // publishes still waiting for a replay at the end
+  std::vector<int64_t> latency_us;
+  SinkStats stats;
+};
+
+static Result run(const Scenario &scenario, uint32_t devices, uint32_t intervals) {
+  WriteSink sink(scenario.sink);
+  sink.set_down_until(int64_t(scenario.outage_s) * 1000000);
+  host::set_http_server(&sink);
+  host::use_fake_clock(0);
+
+  std::vector<std::unique_ptr<VirtualSamba>> fleet;
+  for (uint32_t id = 0; id < devices; id++) {
+    fleet.push_back(std::make_unique<VirtualSamba>(id));
+    fleet.back()->setup();
+  }
+
+  host::use_shared_clock(0, devices);
+  std::vector<std::thread> threads;
+  for (uint32_t id = 0; id < devices; id++) {
+    threads.emplace_back([&scenario, &device = *fleet[id], intervals]() {
+      host::seed_random(device.id + 1);
+      std::mt19937 rng(device.id);
+      std::uniform_int_distribution<uint32_t> jitter(0, scenario.jitter_ms);
+      for (uint32_t k = 0; k < intervals; k++) {
+        int64_t at_us = int64_t(k) * SAMPLE_INTERVAL_S * 1000000 + int64_t(jitter(rng)) * 1000;
+        if (at_us > host::clock_us())
+          delay((at_us - host::clock_us()) / 1000);
+        device.sample();
+      }
+      host::leave_shared_clock();
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  host::set_http_server(nullptr);
+
+  Result result;
+  for (const auto &device : fleet) {
+    for (const auto &publish : device->publishes) {
+      result.publishes++;
+      result.failed += publish.ok ? 0 : 1;
+      result.latency_us.push_back(publish.end_us - publish.begin_us);
+    }
+    result.backlog += device->influxdb.get_backlog_size();
+  }
+  std::sort(result.latency_us.begin(), result.latency_us.end());
+  result.stats = sink.stats();
+  return result;
+}
+
+static double percentile_s(const std::vector<int64_t> &sorted, double p) {
+  if (sorted.empty())
+    return 0;
+  return sorted[std::min(sorted.size() - 1, size_t(p * sorted.size()))] / 1e6;
+}
+
+int main(int argc, char **argv) {
+  uint32_t largest = argc > 1 ? atoi(argv[1]) : 1000;
+  uint32_t intervals = argc > 2 ? atoi(argv[2]) : 4;
+  host::set_log_level(ESPHOME_LOG_LEVEL_NONE);
+
+  SinkConfig slow{.name = "slow (2 workers, 250 ms)", .base_latency_us = 250000, .workers = 2};
+  SinkConfig limited{.name = "rate limited 50/s", .rate_limit = 50};
+  SinkConfig errors{.name = "5% 503s", .error_rate = 0.05};
+  SinkConfig outage{.name = "down 10 min, then back"};
+  const Scenario scenarios[] = {
+      {SinkConfig{}, 1000, 0},
+      {slow, 1000, 0},
+      {limited, 1000, 0},
+      {SinkConfig{.name = "rate limited, 60 s jitter", .rate_limit = 50}, 60000, 0},
+      {errors, 1000, 0},
+      {outage, 1000, 2 * SAMPLE_INTERVAL_S},
+  };
+
+  printf("%u publishes per device, %u s apart\n\n", intervals, SAMPLE_INTERVAL_S);
+  printf("%-28s %7s %8s %7s %7s %6s %6s %8s %5s %8s %8s %8s %9s %9s %7s %7s\n", "server", "devices", "publish",
+         "failed", "req/pub", "429", "5xx", "refused", "dup", "p50 s", "p99 s", "max s", "peak kB/s", "mean B/s",
+         "waiting", "backlog");
+  for (const auto &scenario : scenarios) {
+    for (uint32_t devices : {10u, 100u, 1000u}) {
+      if (devices > largest)
+        continue;
+      Result r = run(scenario, devices, intervals);
+      const SinkStats &s = r.stats;
+      double span_s = double(intervals) * SAMPLE_INTERVAL_S;
+      printf("%-28s %7u %8zu %7zu %7.2f %6zu %6zu %8zu %5zu %8.2f %8.2f %8.2f %9.1f %9.1f %7zu %7zu\n",
+             scenario.sink.name, devices, r.publishes, r.failed, double(s.requests + s.refused) / r.publishes,
+             s.throttled, s.errors, s.refused, s.duplicates, percentile_s(r.latency_us, 0.5),
+             percentile_s(r.latency_us, 0.99), percentile_s(r.latency_us, 1.0), s.peak_bytes_per_second() / 1024.0,
+             s.bytes / span_s, s.peak_waiting, r.backlog);
+    }
+  }
+  return 0;
+}
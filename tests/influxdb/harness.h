@@ -0,0 +1,133 @@
+#pragma once
+
+// A SAMBA's upload path on the host: the sensors of config/influx.yaml behind a SampleSnapshot,
+// and the influxdb component configured like config/influx.yaml posting through the host
+// esp_http_client, with sensor traces shaped like the deployed sensors'.
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "esphome/core/application.h"
+#include "influx_yaml.h"
+
+namespace esphome::influxdb::testing {
+
+static constexpr time_t EPOCH = 1760000400;  // 2025-10-09 09:00 UTC, on a 5 minute boundary
+static constexpr uint32_t SAMPLE_INTERVAL_S = 300;
+
+// Value of sensor (index into influx_yaml_names()) of device at epoch seconds: a daily cycle,
+// office hours and noise, quantised like the sensor reports it; PM2.5 drops out now and then
+inline float trace_value(size_t sensor, time_t epoch, uint32_t device) {
+  std::mt19937 rng(epoch * 131 + device * 7919 + sensor);
+  std::normal_distribution<double> noise(0.0, 1.0);
+  double hour = std::fmod(epoch / 3600.0 + 10.0, 24.0);  // AEST
+  double day = std::sin(2 * M_PI * (hour - 9.0) / 24.0);
+  bool occupied = hour >= 8.0 && hour < 18.0;
+  double offset = (device % 17) * 0.1;
+  switch (sensor) {
+    case 0:  // air, globe, radiant and operative temperature
+    case 2:
+    case 3:
+    case 15:
+      return std::round((22.5 + offset + 1.5 * day + 0.1 * noise(rng)) * 100) / 100;
+    case 1:
+      return std::round((50.0 - 8.0 * day + 0.5 * noise(rng)) * 100) / 100;
+    case 4:
+      return std::max(0.0, std::round((0.1 + 0.03 * noise(rng)) * 1000) / 1000);
+    case 5:
+      return std::round(occupied ? 650 + 150 * day + 20 * noise(rng) : 430 + 5 * noise(rng));
+    case 6:
+      return (device + epoch / SAMPLE_INTERVAL_S) % 23 == 0 ? NAN : std::max(0L, std::lround(6 + 2 * noise(rng)));
+    case 7:
+      return std::lround(100 + 15 * noise(rng));
+    case 8:
+      return 1;
+    case 9:
+      return std::max(0.0, std::round(occupied ? 450 + 50 * noise(rng) : 5 + noise(rng)));
+    case 10:
+    case 11:
+    case 12:
+      return std::round(((occupied ? 52.0 : 35.0) + (double(sensor) - 11) * 6.0 + 2 * noise(rng)) * 10) / 10;
+    case 13:
+      return std::round((0.2 + 0.5 * day + 0.05 * noise(rng)) * 100) / 100;
+    case 14:
+      return std::round((6.0 + 3.0 * std::fabs(day)) * 10) / 10;
+    case 16:
+      return std::lround(-60 + 3 * noise(rng) - device % 20);
+    default:
+      return epoch - EPOCH + 3600;
+  }
+}
+
+// One device: sensors, snapshot and the influxdb component, with its own token and MAC address
+class VirtualSamba {
+ public:
+  struct Publish {
+    PublishKind kind;
+    bool ok;
+    int64_t begin_us;
+    int64_t end_us;
+  };
+
+  explicit VirtualSamba(uint32_t id, size_t max_backlog = 6) : id(id) {
+    this->influxdb.set_host("influx.local");
+    this->influxdb.set_token("samba-" + std::to_string(id));
+    this->influxdb.set_bucket("samba");
+    this->influxdb.set_org("usyd");
+    this->influxdb.set_http_request(&this->http);
+    this->influxdb.set_time_source(&this->clock);
+    this->influxdb.set_update_interval(UINT32_MAX);
+    this->influxdb.set_max_backlog(max_backlog);
+    add_influx_yaml_tags(this->influxdb);
+    for (const auto &name : influx_yaml_names()) {
+      this->sensors.push_back(std::make_unique<sensor::Sensor>());
+      this->sensors.back()->set_object_id(name.first);
+      this->influxdb.add_sensor_mapping(name.first, name.second);
+      this->snapshot.add_source(this->sensors.back().get(), nullptr);
+    }
+    this->snapshot.set_time_source(&this->clock);
+    this->influxdb.add_on_publish_begin_callback([this]() { this->begin_us_ = host::clock_us(); });
+    this->influxdb.add_on_publish_end_callback([this](PublishKind kind, bool ok) {
+      this->publishes.push_back({kind, ok, this->begin_us_, host::clock_us()});
+    });
+  }
+
+  // Not thread safe: the component finds its sensors in App, and takes the MAC address at setup
+  void setup() {
+    App.clear();
+    for (auto &sensor : this->sensors)
+      App.register_sensor(sensor.get());
+    char mac[13];
+    snprintf(mac, sizeof(mac), "a0b1c2%06x", this->id);
+    host::set_mac_address(mac);
+    this->influxdb.setup();
+    this->snapshot.setup();
+    App.clear();
+  }
+
+  // Sensor states at the host time (as seconds since EPOCH), then a snapshot and its publish
+  void sample() {
+    time_t epoch = EPOCH + host::clock_us() / 1000000;
+    this->clock.set_epoch(epoch);
+    for (size_t s = 0; s < this->sensors.size(); s++)
+      this->sensors[s]->state = trace_value(s, epoch, this->id);
+    this->influxdb.publish_snapshot(this->snapshot.capture());
+  }
+
+  uint32_t id;
+  std::vector<std::unique_ptr<sensor::Sensor>> sensors;
+  http_request::HttpRequestComponent http;
+  InfluxDB influxdb;
+  time::RealTimeClock clock;
+  sample_snapshot::SampleSnapshot snapshot;
+  std::vector<Publish> publishes;
+
+ protected:
+  int64_t begin_us_{0};
+};
+
+}  // namespace esphome::influxdb::testing
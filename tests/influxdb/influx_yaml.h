@@ -0,0 +1,38 @@
+#pragma once
+
+// The influxdb component as configured in config/influx.yaml, for tests of it and of the
+// components that take their series names from it.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/components/influxdb/influxdb.h"
+
+namespace esphome::influxdb::testing {
+
+// object id and measurement of each sensor
+using Names = std::vector<std::pair<std::string, std::string>>;
+
+// sensor_names of config/influx.yaml
+inline const Names &influx_yaml_names() {
+  static const Names NAMES = {
+      {"air_temperature", "air_temp"},  {"relative_humidity", "rel_humidity"}, {"globe_temperature", "globe_temp"},
+      {"radiant_temperature", "rad_temp"}, {"air_speed", "air_speed"},      {"carbon_dioxide", "co2"},
+      {"pm2_5", "pm25"},                {"tvoc", "tvoc"},                     {"nox_index", "nox"},
+      {"illuminance", "illuminance"},   {"laeq", "la_eq"},                    {"lamin", "la_min"},
+      {"lamax", "la_max"},              {"pmv", "pmv"},                       {"ppd", "ppd"},
+      {"operative_temperature", "op_temp"}, {"wifi_signal", "wifi"},        {"device_uptime", "uptime"},
+  };
+  return NAMES;
+}
+
+// global_tags and send_mac of config/influx.yaml
+inline void add_influx_yaml_tags(InfluxDB &influxdb) {
+  influxdb.add_global_tag("building", "wilkinson");
+  influxdb.add_global_tag("level", "420");
+  influxdb.add_global_tag("zone", "testing");
+  influxdb.set_send_mac(true);
+}
+
+}  // namespace esphome::influxdb::testing
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include "esphome/components/influxdb/line_protocol.h"
+#include "harness.h"
+#include "write_sink.h"
+
+namespace esphome::influxdb::testing {
+namespace {
+
+class InfluxDBTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::use_fake_clock(0);
+    host::set_log_level(ESPHOME_LOG_LEVEL_NONE);
+    host::seed_random(1);
+    this->sink.keep_bodies(true);
+    host::set_http_server(&this->sink);
+  }
+  void TearDown() override {
+    host::set_http_server(nullptr);
+    host::use_real_clock();
+    host::set_log_level(ESPHOME_LOG_LEVEL_WARN);
+  }
+
+  // Body of a sample at epoch as get_measurement_name() and get_tags() describe the series
+  std::string expected_body(VirtualSamba &device, time_t epoch, const std::string &field_of_co2 = "value") {
+    std::string body;
+    for (size_t s = 0; s < device.sensors.size(); s++) {
+      float value = trace_value(s, epoch, device.id);
+      if (std::isnan(value))
+        continue;
+      const std::string sensor_id = device.sensors[s]->get_object_id();
+      std::string fields;
+      line_protocol::append_field(fields, s == 5 ? field_of_co2 : "value", to_string(value));
+      line_protocol::append_line(body, device.influxdb.get_measurement_name(sensor_id),
+                                 device.influxdb.get_tags(sensor_id), fields, " " + to_string(epoch));
+    }
+    return body;
+  }
+
+  WriteSink sink;
+};
+
+// Lines are written from the configuration maps directly; they match the series naming the
+// component exposes to local exporters, byte for byte
+TEST_F(InfluxDBTest, BodyMatchesSeriesNaming) {
+  VirtualSamba device(7);
+  device.influxdb.add_static_tag("carbon_dioxide", "sensor type", "k30,i2c");
+  device.influxdb.add_static_tag("carbon_dioxide", "calibrated", "yes");
+  device.influxdb.set_field_name("carbon_dioxide", "ppm");
+  device.setup();
+  host::advance_us(int64_t(SAMPLE_INTERVAL_S) * 4 * 1000000);  // a PM2.5 dropout
+  device.sample();
+
+  ASSERT_EQ(this->sink.bodies().size(), 1u);
+  time_t epoch = EPOCH + SAMPLE_INTERVAL_S * 4;
+  EXPECT_EQ(this->sink.bodies()[0], this->expected_body(device, epoch, "ppm"));
+  EXPECT_EQ(this->sink.bodies()[0].find("pm25,"), std::string::npos);
+  EXPECT_NE(this->sink.bodies()[0].find(",building=wilkinson"), std::string::npos);
+  EXPECT_NE(this->sink.bodies()[0].find(",sensor\\ type=k30\\,i2c"), std::string::npos);
+  EXPECT_NE(this->sink.bodies()[0].find(",device=a0b1c2000007 ppm="), std::string::npos);
+  EXPECT_EQ(this->sink.urls()[0], "http://influx.local:8086/api/v2/write?org=usyd&bucket=samba&precision=s");
+  EXPECT_EQ(this->sink.stats().points, device.sensors.size() - 1);
+}
+
+TEST_F(InfluxDBTest, RetriesUntilAccepted) {
+  VirtualSamba device(1);
+  device.setup();
+  this->sink.script({503, 429});
+  device.sample();
+  auto stats = this->sink.stats();
+  EXPECT_EQ(stats.requests, 3u);
+  EXPECT_EQ(stats.accepted, 1u);
+  ASSERT_EQ(device.publishes.size(), 1u);
+  EXPECT_TRUE(device.publishes[0].ok);
+  // two backoffs of 500 to 2000 ms
+  int64_t ms = (device.publishes[0].end_us - device.publishes[0].begin_us) / 1000;
+  EXPECT_GE(ms, 1000);
+  EXPECT_LE(ms, 4000 + 3 * 100);
+  EXPECT_EQ(device.influxdb.get_backlog_size(), 0u);
+}
+
+// A publish that fails every attempt is kept, and replayed after the next successful one
+TEST_F(InfluxDBTest, FailedPublishReplayedInOrder) {
+  VirtualSamba device(2);
+  device.setup();
+  this->sink.script({503, 503, 503});
+  device.sample();
+  ASSERT_EQ(device.publishes.size(), 1u);
+  EXPECT_FALSE(device.publishes[0].ok);
+  EXPECT_EQ(device.influxdb.get_backlog_size(), 1u);
+
+  host::advance_us(int64_t(SAMPLE_INTERVAL_S) * 1000000 - host::clock_us());
+  device.sample();
+  EXPECT_TRUE(device.publishes[1].ok);
+  EXPECT_EQ(device.influxdb.get_backlog_size(), 0u);
+  ASSERT_EQ(this->sink.bodies().size(), 2u);
+  EXPECT_EQ(this->sink.bodies()[0], this->expected_body(device, EPOCH + SAMPLE_INTERVAL_S));
+  EXPECT_EQ(this->sink.bodies()[1], this->expected_body(device, EPOCH));
+}
+
+// While the server is unreachable the backlog keeps the newest max_backlog publishes
+TEST_F(InfluxDBTest, OutageKeepsNewestBacklog) {
+  VirtualSamba device(3, 2);
+  device.setup();
+  this->sink.set_down_until(int64_t(4) * SAMPLE_INTERVAL_S * 1000000);
+  for (int i = 0; i < 5; i++) {
+    device.sample();
+    host::advance_us(int64_t(SAMPLE_INTERVAL_S) * 1000000 - host::clock_us() % (int64_t(SAMPLE_INTERVAL_S) * 1000000));
+  }
+  auto stats = this->sink.stats();
+  EXPECT_EQ(stats.refused, 4u * 3);
+  // the sample after the outage, then the last two of the outage
+  ASSERT_EQ(this->sink.bodies().size(), 3u);
+  EXPECT_EQ(this->sink.bodies()[1], this->expected_body(device, EPOCH + 2 * SAMPLE_INTERVAL_S));
+  EXPECT_EQ(this->sink.bodies()[2], this->expected_body(device, EPOCH + 3 * SAMPLE_INTERVAL_S));
+}
+
+// A server slower than the client's 12 s timeout still writes the data, and each retry writes it
+// again
+TEST_F(InfluxDBTest, TimeoutRetriesDuplicateWrites) {
+  SinkConfig slow;
+  slow.base_latency_us = 13000000;
+  WriteSink slow_sink(slow);
+  host::set_http_server(&slow_sink);
+  VirtualSamba device(4);
+  device.setup();
+  device.sample();
+  auto stats = slow_sink.stats();
+  EXPECT_EQ(stats.accepted, 3u);
+  EXPECT_EQ(stats.duplicates, 2u);
+  EXPECT_FALSE(device.publishes[0].ok);
+  EXPECT_EQ(device.influxdb.get_backlog_size(), 1u);
+}
+
+// An event line goes out on the next loop() with its tag after the device tag, and is reported as
+// an event publish
+TEST_F(InfluxDBTest, EventPublish) {
+  VirtualSamba device(5);
+  TriggerRule rule(TRIGGER_ABOVE, 1500);
+  device.influxdb.add_trigger(&rule, device.sensors[5].get(), device.sensors[5].get(), "co2_high");
+  device.setup();
+  host::advance_us(60000000);
+  device.clock.set_epoch(EPOCH + 60);
+  device.sensors[5]->publish_state(1800);
+  device.influxdb.loop();
+  ASSERT_EQ(device.publishes.size(), 1u);
+  EXPECT_EQ(device.publishes[0].kind, PUBLISH_EVENTS);
+  EXPECT_TRUE(device.publishes[0].ok);
+  ASSERT_EQ(this->sink.bodies().size(), 1u);
+  line_protocol::Tags tags = device.influxdb.get_tags("carbon_dioxide");
+  tags.emplace_back("event", "co2_high");
+  std::string expected;
+  line_protocol::append_line(expected, "co2", tags, "value=1800.000000", " " + to_string(EPOCH + 60));
+  EXPECT_EQ(this->sink.bodies()[0], expected);
+  EXPECT_NE(expected.find(",device=a0b1c2000005,event=co2_high "), std::string::npos);
+}
+
+TEST_F(InfluxDBTest, SinkChecksLines) {
+  EXPECT_EQ(WriteSink::count_points("a,b=c value=1 10\nd value=2\n"), 2u);
+  EXPECT_EQ(WriteSink::count_points("a\\ b value=1\n"), 1u);
+  EXPECT_EQ(WriteSink::count_points("a value=1\nnofields\n"), 0u);
+  EXPECT_EQ(WriteSink::count_points(" value=1\n"), 0u);
+}
+
+}  // namespace
+}  // namespace esphome::influxdb::testing
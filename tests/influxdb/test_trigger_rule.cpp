@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "esphome/components/influxdb/trigger_rule.h"
+
+namespace esphome::influxdb::testing {
+namespace {
+
+// Fires once per excursion and re-arms only once the value is back past the hysteresis
+TEST(TriggerRule, HysteresisRearm) {
+  TriggerRule rule(TRIGGER_ABOVE, 1000);
+  rule.set_hysteresis(50);
+  rule.set_min_interval(0);
+  EXPECT_FALSE(rule.check(900, 0));
+  EXPECT_TRUE(rule.check(1100, 1000));
+  EXPECT_FALSE(rule.check(1200, 2000));
+  // below the threshold, within the hysteresis
+  EXPECT_FALSE(rule.check(980, 3000));
+  EXPECT_FALSE(rule.check(1100, 4000));
+  EXPECT_FALSE(rule.check(950, 5000));
+  EXPECT_TRUE(rule.check(1100, 6000));
+  EXPECT_FALSE(rule.check(NAN, 7000));
+  EXPECT_EQ(rule.get_suppressed(), 0u);
+}
+
+TEST(TriggerRule, Below) {
+  TriggerRule rule(TRIGGER_BELOW, 19.5f);
+  rule.set_min_interval(0);
+  EXPECT_FALSE(rule.check(21.0f, 0));
+  EXPECT_TRUE(rule.check(19.0f, 1000));
+  EXPECT_FALSE(rule.check(18.0f, 2000));
+  EXPECT_FALSE(rule.check(20.0f, 3000));
+  EXPECT_TRUE(rule.check(19.0f, 4000));
+}
+
+// |change per minute| against the previous value, in either direction
+TEST(TriggerRule, Rate) {
+  TriggerRule rule(TRIGGER_RATE, 100);
+  rule.set_min_interval(0);
+  // no previous value
+  EXPECT_FALSE(rule.check(400, 0));
+  EXPECT_FALSE(rule.check(450, 60000));
+  // 150 ppm in 30 s
+  EXPECT_TRUE(rule.check(600, 90000));
+  EXPECT_FALSE(rule.check(700, 120000));
+  EXPECT_FALSE(rule.check(700, 180000));
+  EXPECT_TRUE(rule.check(500, 240000));
+  // same timestamp as the previous value: no rate, but it becomes the previous value
+  EXPECT_FALSE(rule.check(3000, 240000));
+  EXPECT_FALSE(rule.check(3010, 300000));
+}
+
+TEST(TriggerRule, ZscoreWarmUpAndFlatHistory) {
+  TriggerRule rule(TRIGGER_ZSCORE, 3);
+  rule.set_alpha(0.25f);
+  rule.set_min_interval(0);
+  // 1 / alpha values before the rule can fire
+  for (uint32_t i = 0; i < 4; i++)
+    EXPECT_FALSE(rule.check(i == 1 ? 1000 : 10, i * 1000)) << i;
+  TriggerRule flat(TRIGGER_ZSCORE, 3);
+  flat.set_alpha(0.25f);
+  flat.set_min_interval(0);
+  for (uint32_t i = 0; i < 4; i++)
+    EXPECT_FALSE(flat.check(10, i * 1000));
+  // without variance any change is an outlier, and no change is not
+  EXPECT_FALSE(flat.check(10, 4000));
+  EXPECT_TRUE(flat.check(10.5f, 5000));
+}
+
+TEST(TriggerRule, Zscore) {
+  TriggerRule rule(TRIGGER_ZSCORE, 3);
+  rule.set_alpha(0.1f);
+  rule.set_min_interval(0);
+  uint32_t now = 0;
+  for (int i = 0; i < 100; i++, now += 1000)
+    EXPECT_FALSE(rule.check(i % 2 == 0 ? 10 : 12, now)) << i;
+  EXPECT_FALSE(rule.check(12.5f, now += 1000));
+  EXPECT_TRUE(rule.check(30, now += 1000));
+  // the outlier widened the history: back to normal re-arms, a second outlier fires again
+  EXPECT_FALSE(rule.check(11, now += 1000));
+  EXPECT_TRUE(rule.check(-40, now += 1000));
+}
+
+// A fire within min_interval of the previous one is suppressed and counted; it still disarms
+TEST(TriggerRule, MinInterval) {
+  TriggerRule rule(TRIGGER_ABOVE, 0);
+  rule.set_min_interval(60000);
+  EXPECT_TRUE(rule.check(1, 0));
+  EXPECT_FALSE(rule.check(-1, 10000));
+  EXPECT_FALSE(rule.check(1, 20000));
+  EXPECT_EQ(rule.get_suppressed(), 1u);
+  EXPECT_FALSE(rule.check(1, 70000));
+  EXPECT_EQ(rule.get_suppressed(), 1u);
+  EXPECT_FALSE(rule.check(-1, 80000));
+  EXPECT_TRUE(rule.check(1, 90000));
+
+  // across the millis() rollover
+  TriggerRule wrap(TRIGGER_ABOVE, 0);
+  wrap.set_min_interval(60000);
+  EXPECT_TRUE(wrap.check(1, UINT32_MAX - 1000));
+  EXPECT_FALSE(wrap.check(-1, 1000));
+  EXPECT_FALSE(wrap.check(1, 5000));
+  EXPECT_EQ(wrap.get_suppressed(), 1u);
+  EXPECT_FALSE(wrap.check(-1, 60000));
+  EXPECT_TRUE(wrap.check(1, 60000));
+}
+
+TEST(TriggerRule, TypeNames) {
+  EXPECT_STREQ(TriggerRule::type_name(TRIGGER_ABOVE), "above");
+  EXPECT_STREQ(TriggerRule::type_name(TRIGGER_RATE), "rate");
+  EXPECT_STREQ(TriggerRule::type_name(TRIGGER_ZSCORE), "zscore");
+}
+
+}  // namespace
+}  // namespace esphome::influxdb::testing
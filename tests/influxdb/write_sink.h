@@ -0,0 +1,257 @@
+#pragma once
+
+// A stand-in for InfluxDB's /api/v2/write behind the host esp_http_client, on the host clock.
+//
+// Requests are served by a fixed number of workers in arrival order; a request waits for the
+// first free worker and then takes base_latency_us plus us_per_kb per KiB of body, so a burst of
+// devices queues up like on a real server. Beyond queue_limit waiting requests, or above
+// rate_limit requests per second (token bucket, one second of burst), the sink answers 429 like
+// InfluxDB Cloud; error_rate of the requests get a 503, and while down the sink refuses
+// connections. Bodies are checked like the server does: org, bucket and a token are required, and
+// every line needs a measurement and a field set.
+//
+// Everything is counted per second of host time and per token, so a fleet of devices with their
+// own tokens can be told apart.
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <esp_http_client.h>
+
+#include "esphome/core/hal.h"
+
+namespace esphome::influxdb::testing {
+
+struct SinkConfig {
+  const char *name{"healthy"};
+  uint32_t connect_us{30000};      // TCP and TLS handshake
+  uint32_t base_latency_us{5000};  // per request, once a worker takes it
+  uint32_t us_per_kb{500};         // parsing and writing
+  unsigned workers{8};             // requests served at once
+  unsigned queue_limit{1000};      // waiting requests before 429s
+  double rate_limit{0};            // admitted requests per second, 0 for none
+  double error_rate{0};            // 503s
+};
+
+struct SinkStats {
+  size_t requests{0};  // complete requests received
+  size_t accepted{0};  // 204
+  size_t throttled{0};  // 429
+  size_t errors{0};     // 503
+  size_t rejected{0};   // 400, 401, 404
+  size_t refused{0};    // connections refused while down
+  size_t points{0};     // lines accepted
+  size_t duplicates{0};  // accepted bodies accepted before, e.g. a retry after a client timeout
+  size_t bytes{0};       // bodies received
+  size_t peak_waiting{0};
+  std::map<int64_t, size_t> bytes_per_second;  // by second of host time
+  std::map<int64_t, size_t> requests_per_second;
+  std::unordered_map<std::string, size_t> requests_per_token;
+
+  size_t peak_bytes_per_second() const {
+    size_t peak = 0;
+    for (const auto &second : this->bytes_per_second)
+      peak = std::max(peak, second.second);
+    return peak;
+  }
+  size_t peak_requests_per_second() const {
+    size_t peak = 0;
+    for (const auto &second : this->requests_per_second)
+      peak = std::max(peak, second.second);
+    return peak;
+  }
+};
+
+class WriteSink : public host::HttpServer {
+ public:
+  explicit WriteSink(const SinkConfig &config = {}, uint32_t seed = 1) : config_(config), rng_(seed) {
+    this->free_at_.assign(std::max(1u, config.workers), 0);
+    this->tokens_ = config.rate_limit;
+  }
+
+  // Connections are refused until host time until_us
+  void set_down_until(int64_t until_us) {
+    std::lock_guard<std::mutex> guard(this->lock_);
+    this->down_until_us_ = until_us;
+  }
+  // Statuses for the next requests, before any other check
+  void script(std::deque<int> statuses) {
+    std::lock_guard<std::mutex> guard(this->lock_);
+    this->script_ = std::move(statuses);
+  }
+  // Bodies of the accepted requests, if kept
+  void keep_bodies(bool keep) { this->keep_bodies_ = keep; }
+  const std::vector<std::string> &bodies() const { return this->bodies_; }
+  const std::vector<std::string> &urls() const { return this->urls_; }
+
+  SinkStats stats() {
+    std::lock_guard<std::mutex> guard(this->lock_);
+    return this->stats_;
+  }
+
+  esp_err_t connect(const std::string &) override {
+    {
+      std::lock_guard<std::mutex> guard(this->lock_);
+      if (host::clock_us() < this->down_until_us_) {
+        this->stats_.refused++;
+        return ESP_ERR_HTTP_CONNECT;
+      }
+    }
+    delayMicroseconds(this->config_.connect_us);
+    return ESP_OK;
+  }
+
+  host::HttpResponse handle(const host::HttpRequest &request) override {
+    std::lock_guard<std::mutex> guard(this->lock_);
+    int64_t now = host::clock_us();
+    this->stats_.requests++;
+    this->stats_.bytes += request.body.size();
+    this->stats_.bytes_per_second[now / 1000000] += request.body.size();
+    this->stats_.requests_per_second[now / 1000000]++;
+    std::string token = request.header("Authorization");
+    this->stats_.requests_per_token[token]++;
+    if (this->keep_bodies_)
+      this->urls_.push_back(request.url);
+
+    host::HttpResponse response;
+    response.latency_us = this->config_.base_latency_us;
+    if (!this->script_.empty()) {
+      response.status = this->script_.front();
+      this->script_.pop_front();
+      return this->count_(response, request);
+    }
+
+    // Checks of the write API, before any queueing
+    if (request.url.find("/api/v2/write?") == std::string::npos) {
+      response.status = 404;
+      return this->count_(response, request);
+    }
+    if (token.rfind("Token ", 0) != 0 || token.size() <= 6) {
+      response.status = 401;
+      return this->count_(response, request);
+    }
+    if (request.url.find("org=") == std::string::npos || request.url.find("bucket=") == std::string::npos) {
+      response.status = 400;
+      return this->count_(response, request);
+    }
+
+    if (this->config_.rate_limit > 0) {
+      this->tokens_ = std::min(this->config_.rate_limit,
+                               this->tokens_ + (now - this->refilled_us_) * this->config_.rate_limit / 1e6);
+      this->refilled_us_ = now;
+      if (this->tokens_ < 1) {
+        response.status = 429;
+        return this->count_(response, request);
+      }
+      this->tokens_ -= 1;
+    }
+
+    // Requests still waiting for a worker
+    while (!this->waiting_.empty() && *this->waiting_.begin() <= now)
+      this->waiting_.erase(this->waiting_.begin());
+    if (this->waiting_.size() >= this->config_.queue_limit) {
+      response.status = 429;
+      return this->count_(response, request);
+    }
+    auto worker = std::min_element(this->free_at_.begin(), this->free_at_.end());
+    int64_t start = std::max(now, *worker);
+    if (start > now)
+      this->waiting_.insert(start);
+    this->stats_.peak_waiting = std::max(this->stats_.peak_waiting, this->waiting_.size());
+    int64_t service = this->config_.base_latency_us + int64_t(this->config_.us_per_kb) * request.body.size() / 1024;
+    *worker = start + service;
+    response.latency_us = *worker - now;
+
+    if (this->config_.error_rate > 0 && this->uniform_(this->rng_) < this->config_.error_rate) {
+      response.status = 503;
+      return this->count_(response, request);
+    }
+    size_t points = count_points(request.body);
+    if (points == 0) {
+      response.status = 400;
+      response.body = R"({"code":"invalid","message":"unable to parse"})";
+      return this->count_(response, request);
+    }
+    this->stats_.points += points;
+    response.status = 204;
+    return this->count_(response, request);
+  }
+
+  // Lines of a line protocol body, 0 if any is malformed
+  static size_t count_points(const std::string &body) {
+    size_t points = 0, start = 0;
+    while (start < body.size()) {
+      size_t end = body.find('\n', start);
+      if (end == std::string::npos)
+        end = body.size();
+      std::string line = body.substr(start, end - start);
+      start = end + 1;
+      if (line.empty())
+        continue;
+      // measurement[,tags] fields[ timestamp], with escaped spaces in keys
+      size_t space = std::string::npos;
+      for (size_t i = 0; i < line.size(); i++) {
+        if (line[i] == '\\') {
+          i++;
+        } else if (line[i] == ' ') {
+          space = i;
+          break;
+        }
+      }
+      if (space == 0 || space == std::string::npos || line.find('=', space) == std::string::npos)
+        return 0;
+      points++;
+    }
+    return points;
+  }
+
+ protected:
+  host::HttpResponse &count_(host::HttpResponse &response, const host::HttpRequest &request) {
+    switch (response.status) {
+      case 204:
+        this->stats_.accepted++;
+        if (!this->seen_.insert(std::hash<std::string>()(request.body)).second)
+          this->stats_.duplicates++;
+        if (this->keep_bodies_)
+          this->bodies_.push_back(request.body);
+        break;
+      case 429:
+        this->stats_.throttled++;
+        response.body = R"({"code":"too many requests","message":"write limit exceeded"})";
+        break;
+      case 503:
+        this->stats_.errors++;
+        break;
+      default:
+        this->stats_.rejected++;
+        break;
+    }
+    return response;
+  }
+
+  SinkConfig config_;
+  std::mutex lock_;
+  std::mt19937 rng_;
+  std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+  std::vector<int64_t> free_at_;    // per worker
+  std::multiset<int64_t> waiting_;  // start times of the queued requests
+  double tokens_{0};
+  int64_t refilled_us_{0};
+  int64_t down_until_us_{0};
+  std::deque<int> script_;
+  bool keep_bodies_{false};
+  std::vector<std::string> bodies_;
+  std::vector<std::string> urls_;
+  std::unordered_set<size_t> seen_;
+  SinkStats stats_;
+};
+
+}  // namespace esphome::influxdb::testing
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "esphome/components/interval_stats/interval_stats.h"
+
+namespace esphome::interval_stats::testing {
+namespace {
+
+// Nearest rank of the sorted values, as P2Quantile reports up to EXACT_COUNT values
+float exact_quantile(std::vector<float> values, float p) {
+  std::sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(std::ceil(values.size() * p));
+  return values[rank == 0 ? 0 : rank - 1];
+}
+
+// Values with a spread of about 1 around 20, e.g. a temperature over an interval
+std::vector<float> normal_values(size_t n, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> normal(20.0f, 1.0f);
+  std::vector<float> values(n);
+  for (auto &value : values)
+    value = normal(rng);
+  return values;
+}
+
+// Ascending and descending values put every sample of the start-up in one tail
+std::vector<float> ramp(size_t n, bool descending) {
+  std::vector<float> values(n);
+  for (size_t i = 0; i < n; i++)
+    values[i] = descending ? float(n - i) : float(i + 1);
+  return values;
+}
+
+class P2QuantileTest : public ::testing::TestWithParam<float> {};
+
+// Up to EXACT_COUNT values the quantile is the nearest rank of all of them
+TEST_P(P2QuantileTest, ExactOverFirstValues) {
+  const float p = GetParam();
+  std::vector<float> values = normal_values(16, 1);
+  P2Quantile quantile(p);
+  EXPECT_TRUE(std::isnan(quantile.value()));
+  for (size_t n = 1; n <= values.size(); n++) {
+    quantile.add(values[n - 1]);
+    std::vector<float> seen(values.begin(), values.begin() + n);
+    EXPECT_EQ(quantile.value(), exact_quantile(seen, p)) << n << " values";
+  }
+}
+
+// The markers of the P² estimate
+class Markers : public P2Quantile {
+ public:
+  using P2Quantile::P2Quantile;
+  using P2Quantile::EXACT_COUNT;
+  float height(int i) const { return this->heights_[i]; }
+  float position(int i) const { return this->positions_[i]; }
+};
+
+// Seeded from the exact values: the extremes on the smallest and largest, all on distinct ranks
+// within them, whatever the quantile
+TEST_P(P2QuantileTest, MarkersSeededWithinSamples) {
+  std::vector<float> values = normal_values(Markers::EXACT_COUNT, 2);
+  Markers markers(GetParam());
+  for (float value : values)
+    markers.add(value);
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(markers.position(0), 1.0f);
+  EXPECT_EQ(markers.position(4), float(Markers::EXACT_COUNT));
+  for (int i = 0; i < 5; i++) {
+    if (i > 0) {
+      EXPECT_GT(markers.position(i), markers.position(i - 1)) << i;
+    }
+    EXPECT_EQ(markers.height(i), values[static_cast<size_t>(markers.position(i)) - 1]) << i;
+  }
+}
+
+// From the first value past the exact start-up on, the estimate lies within the values seen, and
+// it converges on the exact quantile as the tails fill
+TEST_P(P2QuantileTest, EstimateNearExactQuantile) {
+  const float p = GetParam();
+  for (uint32_t seed = 1; seed <= 5; seed++) {
+    std::vector<float> values = normal_values(2000, seed);
+    P2Quantile quantile(p);
+    for (size_t n = 1; n <= values.size(); n++) {
+      quantile.add(values[n - 1]);
+      std::vector<float> seen(values.begin(), values.begin() + n);
+      if (n == 17) {
+        EXPECT_GE(quantile.value(), *std::min_element(seen.begin(), seen.end())) << "seed " << seed;
+        EXPECT_LE(quantile.value(), *std::max_element(seen.begin(), seen.end())) << "seed " << seed;
+      } else if (n == 200 || n == values.size()) {
+        float tolerance = n < values.size() ? 0.4f : 0.1f;
+        EXPECT_NEAR(quantile.value(), exact_quantile(seen, p), tolerance) << "seed " << seed << ", " << n << " values";
+      }
+    }
+  }
+}
+
+TEST_P(P2QuantileTest, Ramps) {
+  const float p = GetParam();
+  for (bool descending : {false, true}) {
+    std::vector<float> values = ramp(1000, descending);
+    P2Quantile quantile(p);
+    for (float value : values)
+      quantile.add(value);
+    EXPECT_NEAR(quantile.value(), exact_quantile(values, p), 10.0f) << descending;
+  }
+}
+
+// The markers are seeded again after a reset
+TEST_P(P2QuantileTest, Reset) {
+  const float p = GetParam();
+  P2Quantile quantile(p);
+  for (float value : normal_values(100, 7))
+    quantile.add(value + 100);
+  quantile.reset();
+  EXPECT_TRUE(std::isnan(quantile.value()));
+  std::vector<float> values = normal_values(500, 8);
+  for (float value : values)
+    quantile.add(value);
+  EXPECT_NEAR(quantile.value(), exact_quantile(values, p), 0.2f);
+}
+
+INSTANTIATE_TEST_SUITE_P(Quantiles, P2QuantileTest, ::testing::Values(0.05f, 0.5f, 0.95f),
+                         [](const ::testing::TestParamInfo<float> &info) {
+                           return "p" + std::to_string(static_cast<int>(std::lround(info.param * 100)));
+                         });
+
+TEST(IntervalStats, RawValuesSummarised) {
+  sensor::Sensor source;
+  IntervalStats stats;
+  stats.set_source(&source);
+  stats.setup();
+  std::vector<float> values = normal_values(600, 3);
+  for (float value : values)
+    source.publish_state(value);
+
+  double sum = 0;
+  for (float value : values)
+    sum += value;
+  double mean = sum / values.size();
+  double squares = 0;
+  for (float value : values)
+    squares += (value - mean) * (value - mean);
+  EXPECT_EQ(stats.get_count(), 600u);
+  EXPECT_NEAR(stats.get_mean(), mean, 1e-4);
+  EXPECT_NEAR(stats.get_sd(), std::sqrt(squares / (values.size() - 1)), 1e-3);
+  EXPECT_EQ(stats.get_min(), *std::min_element(values.begin(), values.end()));
+  EXPECT_EQ(stats.get_max(), *std::max_element(values.begin(), values.end()));
+  EXPECT_NEAR(stats.get_p5(), exact_quantile(values, 0.05f), 0.15f);
+  EXPECT_NEAR(stats.get_p95(), exact_quantile(values, 0.95f), 0.15f);
+
+  std::string fields;
+  stats.append_fields(fields);
+  EXPECT_NE(fields.find(",mean="), std::string::npos);
+  EXPECT_NE(fields.find(",p95="), std::string::npos);
+  EXPECT_NE(fields.find(",n=600i"), std::string::npos);
+
+  // published: the next interval starts empty
+  stats.on_published();
+  EXPECT_EQ(stats.get_count(), 0u);
+  EXPECT_TRUE(std::isnan(stats.get_p95()));
+  fields.clear();
+  stats.append_fields(fields);
+  EXPECT_TRUE(fields.empty());
+}
+
+TEST(IntervalStats, TransformAndNaN) {
+  sensor::Sensor source;
+  IntervalStats stats;
+  stats.set_source(&source);
+  stats.set_transform([](float value) { return value < 0 ? NAN : value * 2; });
+  stats.setup();
+  for (float value : {1.0f, NAN, -1.0f, 3.0f})
+    source.publish_state(value);
+  EXPECT_EQ(stats.get_count(), 2u);
+  EXPECT_FLOAT_EQ(stats.get_mean(), 4.0f);
+  EXPECT_FLOAT_EQ(stats.get_min(), 2.0f);
+  EXPECT_FLOAT_EQ(stats.get_max(), 6.0f);
+  std::string fields;
+  stats.append_fields(fields);
+  EXPECT_NE(fields.find(",sd="), std::string::npos);
+}
+
+}  // namespace
+}  // namespace esphome::interval_stats::testing
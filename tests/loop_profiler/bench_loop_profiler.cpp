@@ -0,0 +1,71 @@
+// Cost of the loop profiler's instrumentation on the host clock: a PROFILE_SCOPE around an empty
+// block, Histogram::record, a LoopProfiler::loop() pass and the update() that publishes and
+// resets a window with ten sections in use (logging off).
+//
+//   bench_loop_profiler [seconds per measurement, default 1]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "esphome/components/loop_profiler/loop_profiler.h"
+#include "esphome/core/log.h"
+
+using namespace esphome;
+using namespace esphome::loop_profiler;
+
+static volatile uint32_t sink;
+
+// Calls body until seconds have passed and prints ns per call
+static void report(const char *name, double seconds, const std::function<void()> &body) {
+  body();
+  size_t calls = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  while (elapsed < seconds) {
+    for (int i = 0; i < 1000; i++)
+      body();
+    calls += 1000;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  printf("%-40s %8.1f ns/call\n", name, elapsed * 1e9 / calls);
+}
+
+static void scoped(uint32_t i) {
+  PROFILE_SCOPE("bench");
+  sink = i;
+}
+
+static void unprofiled(uint32_t i) { sink = i; }
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+  host::set_log_level(ESPHOME_LOG_LEVEL_NONE);
+
+  LoopProfiler profiler;
+  sensor::Sensor loop_time, slow_loops, heap_free;
+  profiler.set_loop_time_sensor(&loop_time);
+  profiler.set_slow_loops_sensor(&slow_loops);
+  profiler.set_heap_free_sensor(&heap_free);
+  profiler.setup();
+
+  uint32_t i = 0;
+  report("empty block (baseline)", seconds, [&]() { unprofiled(i++); });
+  report("PROFILE_SCOPE around the empty block", seconds, [&]() { scoped(i++); });
+  report("micros()", seconds, [&]() { sink = micros(); });
+  Histogram histogram;
+  report("Histogram::record", seconds, [&]() { histogram.record((i++ * 2654435761u) >> 14); });
+  report("LoopProfiler::loop", seconds, [&]() { profiler.loop(); });
+
+  static const char *const NAMES[] = {"s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9"};
+  Section *sections[10];
+  for (int s = 0; s < 10; s++)
+    sections[s] = profiler.section(NAMES[s]);
+  report("LoopProfiler::update (10 sections)", seconds / 10, [&]() {
+    for (auto *section : sections)
+      section->record(1000, 0);
+    profiler.update();
+  });
+  return 0;
+}
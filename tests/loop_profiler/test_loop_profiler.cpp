@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include "esphome/components/i2c_arbiter/i2c_arbiter.h"
+#include "esphome/components/loop_profiler/loop_profiler.h"
+
+namespace esphome::loop_profiler::testing {
+namespace {
+
+// A polling component whose update() takes update_us of the fake clock and keeps heap_bytes
+class Poller : public PollingComponent {
+ public:
+  explicit Poller(uint32_t interval, uint32_t update_us = 3000, size_t heap_bytes = 0)
+      : PollingComponent(interval), update_us(update_us), heap_bytes(heap_bytes) {}
+  void update() override {
+    this->updates++;
+    host::advance_us(this->update_us);
+    host::heap_take(this->heap_bytes);
+  }
+  uint32_t update_us;
+  size_t heap_bytes;
+  unsigned updates{0};
+};
+
+class LoopProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::use_fake_clock(1000000);
+    host::reset_scheduler();
+    this->heap_ = host::heap(MALLOC_CAP_INTERNAL);
+  }
+  void TearDown() override {
+    host::reset_scheduler();
+    host::heap(MALLOC_CAP_INTERNAL) = this->heap_;
+    host::use_real_clock();
+  }
+
+  // The application loop for ms milliseconds: the arbiter, then the scheduler, a pass per ms
+  void run_ms(uint32_t ms, i2c_arbiter::I2CArbiter *arbiter = nullptr) {
+    uint32_t start = millis();
+    while (millis() - start < ms) {
+      if (arbiter != nullptr)
+        arbiter->loop();
+      host::run_scheduler();
+      host::advance_us(1000);
+    }
+  }
+
+  host::Heap heap_;
+};
+
+TEST(Histogram, BucketsAndQuantiles) {
+  Histogram h;
+  EXPECT_EQ(h.quantile_us(0.99f), 0u);
+  for (uint32_t us : {50u, 99u, 100u, 600u, 4999u, 29999u, 30000u, 250000u})
+    h.record(us);
+  const uint32_t expected[HISTOGRAM_BUCKETS] = {2, 1, 1, 1, 0, 1, 1, 1};
+  for (uint8_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+    EXPECT_EQ(h.buckets[b], expected[b]) << int(b);
+  EXPECT_EQ(h.count, 8u);
+  EXPECT_EQ(h.max_us, 250000u);
+  EXPECT_EQ(h.quantile_us(0.0f), 100u);
+  EXPECT_EQ(h.quantile_us(0.5f), 1000u);
+  // the 7th of 8 is in the 30-100 ms bucket
+  EXPECT_EQ(h.quantile_us(0.99f), 100000u);
+  EXPECT_EQ(h.quantile_us(1.0f), 250000u);
+  h.reset();
+  EXPECT_EQ(h.count, 0u);
+  EXPECT_EQ(h.max_us, 0u);
+}
+
+// The quantile never reports more than the worst case
+TEST(Histogram, QuantileCappedByMax) {
+  Histogram h;
+  for (int i = 0; i < 100; i++)
+    h.record(5100);
+  EXPECT_EQ(h.quantile_us(0.99f), 5100u);
+}
+
+TEST_F(LoopProfilerTest, WrapsUpdate) {
+  LoopProfiler profiler;
+  Poller poller(1000, 3000, 512);
+  profiler.add_component(&poller, "poller");
+  profiler.setup();
+  EXPECT_EQ(poller.get_update_interval(), SCHEDULER_DONT_RUN);
+  this->run_ms(10000);
+  EXPECT_EQ(poller.updates, 10u);
+  const Section *section = profiler.section("poller");
+  EXPECT_EQ(section->time.count, 10u);
+  EXPECT_EQ(section->time.max_us, 3000u);
+  EXPECT_EQ(section->time.total_us, 30000u);
+  EXPECT_EQ(section->worst_heap_delta, -512);
+}
+
+TEST_F(LoopProfilerTest, LeavesUnpolledComponentAlone) {
+  LoopProfiler profiler;
+  Poller poller(SCHEDULER_DONT_RUN);
+  profiler.add_component(&poller, "never");
+  profiler.setup();
+  this->run_ms(5000);
+  EXPECT_EQ(poller.updates, 0u);
+  EXPECT_EQ(host::scheduled_count(&profiler), 0u);
+}
+
+// A device of the arbiter is polled by the arbiter alone, whichever of the two sets up first
+TEST_F(LoopProfilerTest, SkipsArbitratedDevice) {
+  for (bool arbiter_first : {false, true}) {
+    host::reset_scheduler();
+    i2c_arbiter::I2CArbiter arbiter;
+    LoopProfiler profiler;
+    Poller device(1000, 0);
+    Poller other(1000, 0);
+    arbiter.add_device(&device, 0, 0);
+    profiler.add_component(&device, "device");
+    profiler.add_component(&other, "other");
+    if (arbiter_first)
+      arbiter.setup();
+    profiler.setup();
+    if (!arbiter_first)
+      arbiter.setup();
+    this->run_ms(10000, &arbiter);
+    EXPECT_EQ(device.updates, 10u) << arbiter_first;
+    EXPECT_EQ(profiler.section("device")->time.count, 0u) << arbiter_first;
+    EXPECT_EQ(other.updates, 10u) << arbiter_first;
+    EXPECT_EQ(profiler.section("other")->time.count, 10u) << arbiter_first;
+    i2c_arbiter::global_i2c_arbiter = nullptr;
+  }
+}
+
+TEST_F(LoopProfilerTest, LoopPassesAndWindow) {
+  LoopProfiler profiler;
+  sensor::Sensor loop_time, slow_loops, heap_free, heap_min_free;
+  profiler.set_loop_time_sensor(&loop_time);
+  profiler.set_slow_loops_sensor(&slow_loops);
+  profiler.set_heap_free_sensor(&heap_free);
+  profiler.set_heap_min_free_sensor(&heap_min_free);
+  profiler.set_slow_loop_threshold(30);
+  profiler.setup();
+  // the first pass only starts the measurement
+  profiler.loop();
+  for (uint32_t us : {16000u, 16000u, 45000u, 16000u, 30000u}) {
+    host::advance_us(us);
+    profiler.loop();
+  }
+  host::heap_take(4096);
+  host::heap_give(4096);
+  profiler.update();
+  EXPECT_FLOAT_EQ(loop_time.state, 45.0f);
+  EXPECT_FLOAT_EQ(slow_loops.state, 2);
+  EXPECT_FLOAT_EQ(heap_free.state, this->heap_.free);
+  EXPECT_FLOAT_EQ(heap_min_free.state, std::min(this->heap_.minimum_free, this->heap_.free - 4096));
+
+  // a new window
+  host::advance_us(16000);
+  profiler.loop();
+  profiler.update();
+  EXPECT_FLOAT_EQ(loop_time.state, 16.0f);
+  EXPECT_FLOAT_EQ(slow_loops.state, 0);
+}
+
+void timed_work(uint32_t us) {
+  PROFILE_SCOPE("timed_work");
+  host::advance_us(us);
+}
+
+TEST_F(LoopProfilerTest, ProfileScope) {
+  LoopProfiler profiler;
+  for (uint32_t us : {200u, 800u, 12000u})
+    timed_work(us);
+  const Section *section = profiler.section("timed_work");
+  EXPECT_EQ(section->time.count, 3u);
+  EXPECT_EQ(section->time.max_us, 12000u);
+  EXPECT_EQ(section->worst_heap_delta, 0);
+  // the section is cached at the call site, and the name is found by content too
+  char name[] = "timed_work";
+  EXPECT_EQ(profiler.section(name), section);
+}
+
+}  // namespace
+}  // namespace esphome::loop_profiler::testing
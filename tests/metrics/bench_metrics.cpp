@@ -0,0 +1,100 @@
+// Cost of the metrics endpoint on the host with the sensors and tags of config/influx.yaml: the
+// render once per sample, and requests per second through MetricsEndpoint::handleRequest, from one
+// client and from several at once while samples keep being rendered.
+//
+//   bench_metrics [seconds per measurement, default 1]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+
+#include "harness.h"
+
+using namespace esphome;
+using namespace esphome::metrics::testing;
+
+static volatile size_t sink;
+
+// Calls body until seconds have passed; returns the calls per second
+static double rate(double seconds, const std::function<void()> &body) {
+  body();
+  size_t calls = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  while (elapsed < seconds) {
+    for (int i = 0; i < 100; i++)
+      body();
+    calls += 100;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  return calls / elapsed;
+}
+
+// Requests per second of clients threads, with a sample rendered every millisecond meanwhile
+static double concurrent(HostMetrics &rig, const std::string &url, unsigned clients, double seconds,
+                         const std::vector<float> &values) {
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> requests{0};
+  std::vector<std::thread> threads;
+  for (unsigned c = 0; c < clients; c++) {
+    threads.emplace_back([&]() {
+      size_t count = 0;
+      while (!stop) {
+        sink = rig.get(url)->req().body.size();
+        count++;
+      }
+      requests += count;
+    });
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t renders = 0;
+  while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+    rig.capture(values);
+    renders++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  stop = true;
+  for (auto &thread : threads)
+    thread.join();
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return requests / elapsed;
+}
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+  host::set_log_level(ESPHOME_LOG_LEVEL_WARN);
+
+  HostMetrics rig;
+  rig.add_influx_yaml_tags();
+  rig.setup();
+  std::vector<float> values(rig.sensors.size());
+  for (size_t i = 0; i < values.size(); i++)
+    values[i] = 20.0f + i * 1.37f;
+  rig.capture(values);
+  size_t prometheus = rig.get("/metrics")->req().body.size();
+  size_t json = rig.get("/metrics.json")->req().body.size();
+  printf("%zu sensors, 3 global tags and the device tag: /metrics %zu B, /metrics.json %zu B\n\n",
+         rig.sensors.size(), prometheus, json);
+
+  double renders = rate(seconds, [&]() { rig.capture(values); });
+  printf("%-44s %10.2f us\n", "render (both bodies) per sample", 1e6 / renders);
+
+  // the host stub copies the body into the request; on the device httpd_resp_send() writes it to
+  // the socket from the shared buffer, so these are the endpoint's own limits
+  printf("\n%-44s %12s\n", "requests", "req/s");
+  for (const char *url : {"/metrics", "/metrics.json"}) {
+    double per_second = rate(seconds, [&]() { sink = rig.get(url)->req().body.size(); });
+    char name[64];
+    snprintf(name, sizeof(name), "%s, one client", url);
+    printf("%-44s %12.0f\n", name, per_second);
+    for (unsigned clients : {4u}) {
+      double parallel = concurrent(rig, url, clients, seconds, values);
+      snprintf(name, sizeof(name), "%s, %u clients, a render every ms", url, clients);
+      printf("%-44s %12.0f\n", name, parallel);
+    }
+  }
+  return 0;
+}
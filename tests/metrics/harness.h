@@ -0,0 +1,76 @@
+#pragma once
+
+// The metrics endpoint on the host, with the series names and tags of an influxdb component as
+// configured in config/influx.yaml, fed by a SampleSnapshot of its sensors.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esphome/components/influxdb/influxdb.h"
+#include "esphome/components/metrics/metrics.h"
+#include "esphome/core/application.h"
+#include "../influxdb/influx_yaml.h"
+
+namespace esphome::metrics::testing {
+
+using influxdb::testing::influx_yaml_names;
+using influxdb::testing::Names;
+
+class HostMetrics {
+ public:
+  // every sensor is a snapshot source
+  explicit HostMetrics(const Names &names = influx_yaml_names()) {
+    App.clear();
+    this->influxdb.set_host("localhost");
+    this->influxdb.set_token("token");
+    this->influxdb.set_bucket("samba");
+    this->influxdb.set_org("usyd");
+    this->influxdb.set_http_request(&this->http);
+    this->influxdb.set_update_interval(UINT32_MAX);
+    for (const auto &name : names) {
+      this->sensors.push_back(std::make_unique<sensor::Sensor>());
+      this->sensors.back()->set_object_id(name.first);
+      App.register_sensor(this->sensors.back().get());
+      this->influxdb.add_sensor_mapping(name.first, name.second);
+      this->snapshot.add_source(this->sensors.back().get(), nullptr);
+    }
+    this->snapshot.set_time_source(&this->clock);
+    this->endpoint = std::make_unique<MetricsEndpoint>(&this->server);
+    this->endpoint->set_influxdb(&this->influxdb);
+    this->endpoint->set_snapshot(&this->snapshot);
+  }
+  ~HostMetrics() { App.clear(); }
+
+  void add_influx_yaml_tags() { influxdb::testing::add_influx_yaml_tags(this->influxdb); }
+
+  void setup() {
+    this->influxdb.setup();
+    this->snapshot.setup();
+    this->endpoint->setup();
+  }
+
+  // One sample with the given values (one per sensor) at timestamp
+  void capture(const std::vector<float> &values, time_t timestamp = 1760000000) {
+    this->clock.set_epoch(timestamp);
+    for (size_t i = 0; i < this->sensors.size(); i++)
+      this->sensors[i]->state = values[i];
+    this->snapshot.capture();
+  }
+
+  std::unique_ptr<AsyncWebServerRequest> get(const std::string &url) {
+    auto request = std::make_unique<AsyncWebServerRequest>(url);
+    this->server.handle(request.get());
+    return request;
+  }
+
+  std::vector<std::unique_ptr<sensor::Sensor>> sensors;
+  http_request::HttpRequestComponent http;
+  influxdb::InfluxDB influxdb;
+  time::RealTimeClock clock;
+  sample_snapshot::SampleSnapshot snapshot;
+  web_server_base::WebServerBase server;
+  std::unique_ptr<MetricsEndpoint> endpoint;
+};
+
+}  // namespace esphome::metrics::testing
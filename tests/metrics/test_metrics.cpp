@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "harness.h"
+
+namespace esphome::metrics::testing {
+namespace {
+
+class MetricsTest : public ::testing::Test {
+ protected:
+  void SetUp() override { host::set_log_level(ESPHOME_LOG_LEVEL_WARN); }
+};
+
+TEST_F(MetricsTest, NoSampleYet) {
+  HostMetrics rig(Names{{"air_temperature", "air_temp"}});
+  rig.setup();
+  auto request = rig.get("/metrics");
+  EXPECT_EQ(request->code(), 503);
+  EXPECT_EQ(rig.get("/metrics.json")->code(), 503);
+  EXPECT_EQ(rig.get("/other")->code(), 404);
+}
+
+TEST_F(MetricsTest, Prometheus) {
+  HostMetrics rig({{"air_temperature", "air_temp"}, {"carbon_dioxide", "co2"}, {"pm2_5", "pm2.5"}});
+  rig.influxdb.add_global_tag("building", "wilkinson \"420\"");
+  rig.influxdb.add_static_tag("carbon_dioxide", "sensor-type", "k30");
+  rig.setup();
+  rig.capture({22.5f, 612.0f, NAN});
+  auto request = rig.get("/metrics");
+  EXPECT_EQ(request->code(), 200);
+  EXPECT_EQ(request->req().content_type, "text/plain; version=0.0.4");
+  EXPECT_EQ(request->req().body,
+            "# TYPE samba_air_temp gauge\n"
+            "samba_air_temp{building=\"wilkinson \\\"420\\\"\"} 22.5\n"
+            "# TYPE samba_co2 gauge\n"
+            "samba_co2{building=\"wilkinson \\\"420\\\"\",sensor_type=\"k30\"} 612\n"
+            "# TYPE samba_sample_timestamp_seconds gauge\n"
+            "samba_sample_timestamp_seconds 1760000000\n");
+}
+
+// Sensors sharing a measurement, e.g. one per location, are series of one metric: a single # TYPE,
+// followed by all of them
+TEST_F(MetricsTest, SharedNameHasOneType) {
+  HostMetrics rig({{"air_temperature_low", "air_temp"},
+                   {"carbon_dioxide", "co2"},
+                   {"air_temperature_mid", "air_temp"},
+                   {"air_temperature_high", "air_temp"}});
+  rig.influxdb.add_static_tag("air_temperature_low", "height", "0.1");
+  rig.influxdb.add_static_tag("air_temperature_mid", "height", "0.6");
+  rig.influxdb.add_static_tag("air_temperature_high", "height", "1.1");
+  rig.setup();
+  rig.capture({21.0f, 600.0f, NAN, 23.0f}, 0);
+  EXPECT_EQ(rig.get("/metrics")->req().body,
+            "# TYPE samba_air_temp gauge\n"
+            "samba_air_temp{height=\"0.1\"} 21\n"
+            "samba_air_temp{height=\"1.1\"} 23\n"
+            "# TYPE samba_co2 gauge\n"
+            "samba_co2 600\n");
+
+  // a metric without any value has no # TYPE either
+  rig.capture({NAN, 600.0f, NAN, NAN}, 0);
+  EXPECT_EQ(rig.get("/metrics")->req().body, "# TYPE samba_co2 gauge\nsamba_co2 600\n");
+}
+
+TEST_F(MetricsTest, EveryNameOnceWithInfluxYaml) {
+  HostMetrics rig;
+  rig.add_influx_yaml_tags();
+  rig.setup();
+  std::vector<float> values(rig.sensors.size());
+  for (size_t i = 0; i < values.size(); i++)
+    values[i] = i * 1.5f;
+  rig.capture(values);
+  std::string body = rig.get("/metrics")->req().body;
+  for (const auto &name : influx_yaml_names()) {
+    std::string type = "# TYPE samba_" + name.second + " gauge\n";
+    size_t at = body.find(type);
+    ASSERT_NE(at, std::string::npos) << name.second;
+    EXPECT_EQ(body.find(type, at + 1), std::string::npos) << name.second;
+  }
+  EXPECT_NE(body.find("device=\"a0b1c2d3e4f5\""), std::string::npos);
+}
+
+TEST_F(MetricsTest, Json) {
+  HostMetrics rig({{"air_temperature", "air_temp"}, {"carbon_dioxide", "co2"}});
+  rig.influxdb.add_static_tag("carbon_dioxide", "sensor", "k30");
+  rig.setup();
+  rig.capture({NAN, 612.0f}, 0);
+  auto request = rig.get("/metrics.json");
+  EXPECT_EQ(request->req().content_type, "application/json");
+  EXPECT_EQ(request->req().body,
+            "{\"timestamp\":null,\"series\":[{\"measurement\":\"co2\",\"tags\":{\"sensor\":\"k30\"},\"value\":612}]}");
+}
+
+// Label names are sanitised without the ':' metric names allow; JSON escapes every control
+// character, Prometheus label values only \\, " and newlines
+TEST_F(MetricsTest, TagKeysAndControlCharacters) {
+  HostMetrics rig(Names{{"carbon_dioxide", "co2"}});
+  rig.influxdb.add_static_tag("carbon_dioxide", "sensor:type", "k30\tv2");
+  rig.influxdb.add_static_tag("carbon_dioxide", "2nd-room", "a\x01\r\n");
+  rig.setup();
+  rig.capture({612.0f}, 0);
+  EXPECT_EQ(rig.get("/metrics")->req().body,
+            "# TYPE samba_co2 gauge\n"
+            "samba_co2{_nd_room=\"a\x01\r\\n\",sensor_type=\"k30\tv2\"} 612\n");
+  EXPECT_EQ(rig.get("/metrics.json")->req().body,
+            "{\"timestamp\":null,\"series\":[{\"measurement\":\"co2\",\"tags\":"
+            "{\"2nd-room\":\"a\\u0001\\r\\n\",\"sensor:type\":\"k30\\tv2\"},\"value\":612}]}");
+}
+
+// The name of an unmapped sensor is its id, returned by value so a temporary id cannot dangle
+TEST_F(MetricsTest, MeasurementNameOfUnmappedSensor) {
+  HostMetrics rig(Names{{"air_temperature", "air_temp"}});
+  rig.setup();
+  std::string name = rig.influxdb.get_measurement_name(std::string("not_") + "mapped");
+  EXPECT_EQ(name, "not_mapped");
+  EXPECT_EQ(rig.influxdb.get_measurement_name("air_temperature"), "air_temp");
+}
+
+}  // namespace
+}  // namespace esphome::metrics::testing
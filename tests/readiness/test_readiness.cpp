@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "esphome/components/readiness/readiness.h"
+#include "esphome/core/log.h"
+
+namespace esphome::readiness::testing {
+namespace {
+
+// Boot at millis() 0, loop() every 100 ms
+class ReadinessTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::use_fake_clock(0);
+    host::set_log_level(ESPHOME_LOG_LEVEL_NONE);
+    this->readiness.set_time_to_ready_sensor(&this->time_to_ready);
+    this->readiness.add_on_ready_callback([this]() { this->ready_calls++; });
+  }
+  void TearDown() override {
+    host::set_log_level(ESPHOME_LOG_LEVEL_WARN);
+    host::use_real_clock();
+  }
+
+  // Runs loop() until ms since boot, while it is enabled
+  void run_until(uint32_t ms) {
+    while (millis() < ms) {
+      if (this->readiness.is_loop_enabled())
+        this->readiness.loop();
+      host::advance_us(100000);
+    }
+  }
+
+  Readiness readiness;
+  sensor::Sensor time_to_ready;
+  unsigned ready_calls{0};
+};
+
+TEST_F(ReadinessTest, WaitsForSamplesOfEverySource) {
+  sensor::Sensor a, b;
+  this->readiness.add_source(&a, "a", 2, 0);
+  this->readiness.add_source(&b, "b", 1, 0);
+  this->readiness.setup();
+  this->run_until(1000);
+  a.publish_state(1);
+  // NaN is not a valid sample
+  a.publish_state(NAN);
+  b.publish_state(1);
+  this->run_until(2000);
+  EXPECT_FALSE(this->readiness.is_ready());
+  a.publish_state(2);
+  this->run_until(2100);
+  EXPECT_TRUE(this->readiness.is_ready());
+  EXPECT_EQ(this->readiness.get_ready_time(), 2000u);
+  EXPECT_FLOAT_EQ(this->time_to_ready.state, 2.0f);
+  EXPECT_EQ(this->ready_calls, 1u);
+  EXPECT_FALSE(this->readiness.is_loop_enabled());
+}
+
+// A source with samples early is held back until its warm-up since boot has passed
+TEST_F(ReadinessTest, WarmupSinceBoot) {
+  sensor::Sensor co2, temperature;
+  this->readiness.add_source(&co2, "co2", 1, 60000);
+  this->readiness.add_source(&temperature, "temperature", 1, 0);
+  this->readiness.setup();
+  this->run_until(5000);
+  co2.publish_state(415);
+  temperature.publish_state(21);
+  this->run_until(59900);
+  EXPECT_FALSE(this->readiness.is_ready());
+  this->run_until(60100);
+  EXPECT_TRUE(this->readiness.is_ready());
+  EXPECT_EQ(this->readiness.get_ready_time(), 60000u);
+}
+
+// A source that never produces a sample does not hold back the others past the timeout
+TEST_F(ReadinessTest, TimeoutWithPendingSource) {
+  sensor::Sensor working, failed;
+  this->readiness.add_source(&working, "working", 1, 0);
+  this->readiness.add_source(&failed, "failed", 1, 0);
+  this->readiness.set_timeout(30000);
+  this->readiness.setup();
+  working.publish_state(1);
+  this->run_until(29900);
+  EXPECT_FALSE(this->readiness.is_ready());
+  this->run_until(30100);
+  EXPECT_TRUE(this->readiness.is_ready());
+  EXPECT_FLOAT_EQ(this->time_to_ready.state, 30.0f);
+  EXPECT_EQ(this->ready_calls, 1u);
+}
+
+// on_ready fires once; later states and loop passes change nothing
+TEST_F(ReadinessTest, ReadyOnce) {
+  sensor::Sensor a;
+  this->readiness.add_source(&a, "a", 1, 0);
+  this->readiness.setup();
+  a.publish_state(1);
+  this->run_until(1000);
+  ASSERT_TRUE(this->readiness.is_ready());
+  uint32_t ready_time = this->readiness.get_ready_time();
+  a.publish_state(2);
+  this->run_until(5000);
+  EXPECT_EQ(this->ready_calls, 1u);
+  EXPECT_EQ(this->readiness.get_ready_time(), ready_time);
+}
+
+TEST_F(ReadinessTest, TriggerAndCondition) {
+  sensor::Sensor a;
+  this->readiness.add_source(&a, "a", 1, 0);
+  ReadyTrigger trigger(&this->readiness);
+  unsigned triggered = 0;
+  trigger.add_action([&triggered]() { triggered++; });
+  IsReadyCondition<> is_ready(&this->readiness);
+  this->readiness.setup();
+  this->run_until(1000);
+  EXPECT_FALSE(is_ready.check());
+  a.publish_state(1);
+  this->run_until(1200);
+  EXPECT_TRUE(is_ready.check());
+  EXPECT_EQ(triggered, 1u);
+}
+
+}  // namespace
+}  // namespace esphome::readiness::testing
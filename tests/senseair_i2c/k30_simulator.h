@@ -0,0 +1,154 @@
+#pragma once
+
+// A K30 on a simulated I2C bus, on the fake clock. Commands are parsed with the driver's own
+// framing (k30_protocol.h); a response is ready response_ms after its command, and reading it
+// earlier returns a status without the complete bit, like the sensor while it is busy. Every
+// transaction advances the clock by its time on a 100 kHz bus plus any clock stretching.
+//
+// Faults are drawn per transaction from a seeded generator, so a run is reproducible.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "esphome/components/i2c/i2c.h"
+#include "esphome/components/senseair_i2c/k30_protocol.h"
+#include "esphome/core/hal.h"
+
+namespace esphome::senseair_i2c::testing {
+
+struct Faults {
+  const char *name;
+  double nack{0};          // probability that a transaction is not acknowledged
+  double bad_checksum{0};  // probability that a response has a corrupted checksum
+  double busy{0};          // probability that a ready response still reports busy
+  double slow{0};          // probability that a command takes slow_ms instead of response_ms
+  uint32_t slow_ms{40};
+  double stretch{0};         // probability that the sensor stretches the clock ...
+  uint32_t stretch_us{5000};  // ... by up to this long
+};
+
+class K30Simulator : public i2c::I2CBus {
+ public:
+  static constexpr uint8_t ADDRESS = 0x68;
+  static constexpr uint32_t BYTE_US = 90;  // 9 clocks at 100 kHz
+
+  explicit K30Simulator(Faults faults = {"none"}, uint32_t seed = 1) : faults_(faults), rng_(seed) {
+    this->eeprom.fill(0);
+    this->ram.fill(0);
+    this->set_co2(415);
+    this->set_temperature(21.5f);
+  }
+
+  void set_co2(int16_t ppm) { this->set_word_(k30::RAM_CO2, ppm); }
+  void set_temperature(float celsius) { this->set_word_(k30::RAM_TEMPERATURE, static_cast<int16_t>(celsius * 100)); }
+
+  i2c::ErrorCode write(uint8_t address, const uint8_t *data, size_t len, bool) override {
+    if (address != ADDRESS)
+      return i2c::ERROR_NOT_ACKNOWLEDGED;
+    this->transaction_(len);
+    if (this->draw_(this->faults_.nack)) {
+      this->nacks++;
+      return i2c::ERROR_NOT_ACKNOWLEDGED;
+    }
+    this->writes.emplace_back(data, data + len);
+    this->command_(data, len);
+    return i2c::ERROR_OK;
+  }
+
+  i2c::ErrorCode read(uint8_t address, uint8_t *data, size_t len) override {
+    if (address != ADDRESS)
+      return i2c::ERROR_NOT_ACKNOWLEDGED;
+    this->transaction_(len);
+    if (this->draw_(this->faults_.nack)) {
+      this->nacks++;
+      return i2c::ERROR_NOT_ACKNOWLEDGED;
+    }
+    std::memset(data, 0, len);
+    if (this->response_.empty() || host::clock_us() < this->ready_us_ || this->draw_(this->faults_.busy)) {
+      this->busy_reads++;
+      return i2c::ERROR_OK;
+    }
+    std::memcpy(data, this->response_.data(), std::min(len, this->response_.size()));
+    if (len >= this->response_.size() && this->draw_(this->faults_.bad_checksum)) {
+      data[this->response_.size() - 1] ^= 0x5A;
+      this->corrupted++;
+    }
+    return i2c::ERROR_OK;
+  }
+
+  std::array<uint8_t, 256> eeprom;
+  std::array<uint8_t, 256> ram;
+  uint32_t response_ms{25};
+
+  // --- What happened on the bus ---
+  std::vector<std::vector<uint8_t>> writes;  // acknowledged writes, as sent
+  unsigned eeprom_writes{0};                 // well-formed EEPROM write commands
+  unsigned rejected{0};                      // frames ignored for their length or checksum
+  unsigned nacks{0};
+  unsigned busy_reads{0};
+  unsigned corrupted{0};
+
+ protected:
+  void set_word_(uint16_t address, int16_t value) {
+    this->ram[address] = static_cast<uint16_t>(value) >> 8;
+    this->ram[address + 1] = value & 0xFF;
+  }
+
+  bool draw_(double probability) { return probability > 0 && this->uniform_(this->rng_) < probability; }
+
+  void transaction_(size_t len) {
+    int64_t us = (len + 1) * BYTE_US;
+    if (this->draw_(this->faults_.stretch))
+      us += std::uniform_int_distribution<uint32_t>(0, this->faults_.stretch_us)(this->rng_);
+    host::advance_us(us);
+  }
+
+  // A new command replaces the pending response
+  void command_(const uint8_t *frame, size_t len) {
+    this->response_.clear();
+    if (len < k30::COMMAND_OVERHEAD) {
+      this->rejected++;
+      return;
+    }
+    uint8_t op = frame[0] >> 4, length = frame[0] & 0x0F;
+    uint16_t address = (frame[1] << 8) | frame[2];
+    bool is_write = op == k30::OP_WRITE_RAM || op == k30::OP_WRITE_EEPROM;
+    size_t expected = k30::COMMAND_OVERHEAD + (is_write ? length : 0);
+    if (len != expected || k30::checksum(frame, len - 1) != frame[len - 1] || address + length > 256) {
+      this->rejected++;
+      return;
+    }
+    auto &memory = op == k30::OP_READ_RAM || op == k30::OP_WRITE_RAM ? this->ram : this->eeprom;
+    this->response_.push_back(static_cast<uint8_t>(op << 4) | 0x01);
+    switch (op) {
+      case k30::OP_READ_RAM:
+      case k30::OP_READ_EEPROM:
+        this->response_.insert(this->response_.end(), memory.begin() + address, memory.begin() + address + length);
+        break;
+      case k30::OP_WRITE_RAM:
+      case k30::OP_WRITE_EEPROM:
+        std::memcpy(&memory[address], frame + 3, length);
+        if (op == k30::OP_WRITE_EEPROM)
+          this->eeprom_writes++;
+        break;
+      default:
+        this->response_.clear();
+        this->rejected++;
+        return;
+    }
+    this->response_.push_back(k30::checksum(this->response_.data(), this->response_.size()));
+    uint32_t delay_ms = this->draw_(this->faults_.slow) ? this->faults_.slow_ms : this->response_ms;
+    this->ready_us_ = host::clock_us() + int64_t(delay_ms) * 1000;
+  }
+
+  Faults faults_;
+  std::mt19937 rng_;
+  std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+  std::vector<uint8_t> response_;
+  int64_t ready_us_{0};
+};
+
+}  // namespace esphome::senseair_i2c::testing
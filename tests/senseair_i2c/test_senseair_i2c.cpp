@@ -0,0 +1,299 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "esphome/components/senseair_i2c/senseair_i2c.h"
+#include "esphome/core/component.h"
+#include "k30_simulator.h"
+
+namespace esphome::senseair_i2c::testing {
+namespace {
+
+static constexpr uint32_t RESPONSE_DELAY_MS = 25;  // I2C_RESPONSE_DELAY_MS of the driver
+static constexpr uint32_t RETRY_DELAY_MS = 200;
+static constexpr uint8_t MAX_RETRIES = 5;
+
+// The driver on a simulated K30, with every optional sensor, and a loop() every millisecond
+class Rig {
+ public:
+  explicit Rig(Faults faults = {"none"}, ReadMode read_mode = READ_MODE_CO2, uint32_t seed = 1) : k30(faults, seed) {
+    host::use_fake_clock(1000000);
+    host::reset_scheduler();
+    this->driver.set_i2c_bus(&this->k30);
+    this->driver.set_i2c_address(K30Simulator::ADDRESS);
+    this->driver.set_update_interval(60000);
+    this->driver.set_read_mode(read_mode);
+    this->driver.set_retry_delay_ms(RETRY_DELAY_MS);
+    this->driver.set_max_retries(MAX_RETRIES);
+    this->driver.set_temperature_sensor(&this->temperature);
+    this->driver.set_bus_time_sensor(&this->bus_time);
+    this->driver.set_retries_sensor(&this->retries);
+    this->driver.set_checksum_errors_sensor(&this->checksum_errors);
+  }
+  ~Rig() { host::use_real_clock(); }
+
+  // Runs loop() until the state machine is idle again; returns the milliseconds it took
+  uint32_t run_loop(uint32_t limit_ms = 60000) {
+    uint32_t start = millis();
+    while (this->driver.is_loop_enabled() && millis() - start < limit_ms) {
+      this->driver.loop();
+      if (this->driver.is_loop_enabled())
+        host::advance_us(1000);
+    }
+    return millis() - start;
+  }
+
+  uint32_t setup() {
+    uint32_t start = millis();
+    this->driver.setup();
+    this->run_loop();
+    return millis() - start;
+  }
+
+  uint32_t measure() {
+    uint32_t start = millis();
+    this->driver.update();
+    this->run_loop();
+    return millis() - start;
+  }
+
+  K30Simulator k30;
+  SenseairI2CSensor driver;
+  sensor::Sensor temperature, bus_time, retries, checksum_errors;
+};
+
+uint8_t meter_control(const Rig &rig) { return rig.k30.eeprom[k30::EEPROM_METER_CONTROL]; }
+
+// --- Setup: ABC in the meter control register ---
+
+TEST(Setup, EnablesAbcKeepingOtherBits) {
+  Rig rig;
+  rig.k30.eeprom[k30::EEPROM_METER_CONTROL] = 0x11;
+  rig.driver.set_abc_interval(648000);
+  rig.setup();
+  EXPECT_EQ(meter_control(rig), 0x11 | k30::METER_CONTROL_ABC);
+  EXPECT_EQ(rig.k30.eeprom_writes, 1u);
+  EXPECT_FALSE(rig.driver.is_loop_enabled());
+}
+
+TEST(Setup, DisablesAbc) {
+  Rig rig;
+  rig.k30.eeprom[k30::EEPROM_METER_CONTROL] = 0x13;
+  rig.driver.set_abc_interval(0);
+  rig.setup();
+  EXPECT_EQ(meter_control(rig), 0x11);
+  EXPECT_EQ(rig.k30.eeprom_writes, 1u);
+}
+
+TEST(Setup, LeavesMatchingConfigurationAlone) {
+  for (uint32_t interval : {0u, 648000u}) {
+    Rig rig;
+    rig.k30.eeprom[k30::EEPROM_METER_CONTROL] = interval > 0 ? k30::METER_CONTROL_ABC : 0;
+    rig.driver.set_abc_interval(interval);
+    uint32_t ms = rig.setup();
+    EXPECT_EQ(rig.k30.eeprom_writes, 0u) << interval;
+    // one command, the response delay and one read
+    EXPECT_LE(ms, RESPONSE_DELAY_MS + 2) << interval;
+  }
+}
+
+TEST(Setup, RetriesBusyMeterControlRead) {
+  Rig rig({.name = "busy", .busy = 0.5}, READ_MODE_CO2, 3);
+  rig.driver.set_abc_interval(648000);
+  rig.setup();
+  EXPECT_GT(rig.k30.busy_reads, 0u);
+  EXPECT_EQ(meter_control(rig), k30::METER_CONTROL_ABC);
+}
+
+// A sensor that never answers leaves setup after max_retries attempts without touching the EEPROM
+TEST(Setup, GivesUpOnDeadBus) {
+  Rig rig({.name = "dead", .nack = 1.0});
+  uint32_t ms = rig.setup();
+  EXPECT_EQ(rig.k30.nacks, MAX_RETRIES);
+  EXPECT_EQ(rig.k30.eeprom_writes, 0u);
+  EXPECT_FALSE(rig.driver.is_loop_enabled());
+  EXPECT_LE(ms, (MAX_RETRIES - 1) * (RETRY_DELAY_MS + 1) + 1);
+  // and measurements are still attempted
+  rig.measure();
+  EXPECT_FALSE(rig.driver.has_state());
+  EXPECT_EQ(rig.retries.state, MAX_RETRIES);
+}
+
+// --- Measurement ---
+
+TEST(Measure, Co2) {
+  Rig rig;
+  rig.setup();
+  rig.k30.set_co2(1234);
+  uint32_t ms = rig.measure();
+  EXPECT_EQ(rig.driver.state, 1234);
+  EXPECT_FALSE(rig.temperature.has_state());
+  EXPECT_EQ(rig.retries.state, 0);
+  // 4 byte command and 4 byte response, each with the address byte
+  EXPECT_FLOAT_EQ(rig.bus_time.state, 2 * 5 * K30Simulator::BYTE_US / 1000.0f);
+  EXPECT_LE(ms, RESPONSE_DELAY_MS + 2);
+}
+
+TEST(Measure, BurstReadsTemperature) {
+  Rig rig({"none"}, READ_MODE_BURST);
+  rig.setup();
+  rig.k30.set_co2(-5);
+  rig.k30.set_temperature(-3.25f);
+  rig.measure();
+  // the driver reports CO2 as unsigned
+  EXPECT_EQ(rig.driver.state, 65531);
+  EXPECT_FLOAT_EQ(rig.temperature.state, -3.25f);
+  EXPECT_FLOAT_EQ(rig.bus_time.state, (5 + 15) * K30Simulator::BYTE_US / 1000.0f);
+}
+
+TEST(Measure, SkipsUpdateWhileBusy) {
+  Rig rig;
+  rig.setup();
+  rig.driver.update();
+  size_t writes = rig.k30.writes.size();
+  rig.driver.update();
+  EXPECT_EQ(rig.k30.writes.size(), writes);
+  rig.run_loop();
+  EXPECT_EQ(rig.driver.state, 415);
+}
+
+TEST(Measure, CountsChecksumErrors) {
+  Rig rig({.name = "bad checksum", .bad_checksum = 1.0});
+  rig.setup();
+  size_t writes = rig.k30.writes.size();
+  uint32_t ms = rig.measure();
+  EXPECT_FALSE(rig.driver.has_state());
+  EXPECT_EQ(rig.retries.state, MAX_RETRIES);
+  // one from the meter control read during setup, then one per read of the same response
+  EXPECT_EQ(rig.checksum_errors.state, 1 + MAX_RETRIES);
+  EXPECT_EQ(rig.k30.writes.size(), writes + 1);
+  EXPECT_GE(ms, (MAX_RETRIES - 1) * RETRY_DELAY_MS + RESPONSE_DELAY_MS);
+}
+
+// A sensor slower than the response delay answers the read after a retry: the pending command is
+// read again rather than sent again, which would restart it on the sensor
+TEST(Measure, ResponseSlowerThanDelayReadAgain) {
+  Rig rig;
+  rig.setup();
+  size_t writes = rig.k30.writes.size();
+  rig.k30.response_ms = RESPONSE_DELAY_MS + 5;
+  uint32_t ms = rig.measure();
+  EXPECT_EQ(rig.driver.state, 415);
+  EXPECT_EQ(rig.k30.busy_reads, 1u);
+  EXPECT_EQ(rig.retries.state, 1);
+  EXPECT_EQ(rig.k30.writes.size(), writes + 1);
+  EXPECT_LE(ms, RESPONSE_DELAY_MS + RETRY_DELAY_MS + 3);
+}
+
+// A corrupted response is read again too; the command is sent again only after a bus error
+TEST(Measure, ChecksumErrorReadAgainNackSendsAgain) {
+  Rig corrupted({.name = "bad checksum", .bad_checksum = 0.5}, READ_MODE_CO2, 7);
+  corrupted.setup();
+  size_t writes = corrupted.k30.writes.size();
+  corrupted.measure();
+  ASSERT_GT(corrupted.k30.corrupted, 1u);
+  EXPECT_EQ(corrupted.k30.writes.size(), writes + 1);
+
+  Rig nack({.name = "nack", .nack = 0.3}, READ_MODE_CO2, 5);
+  nack.setup();
+  for (int i = 0; i < 20; i++)
+    nack.measure();
+  ASSERT_GT(nack.k30.nacks, 0u);
+  EXPECT_GT(nack.k30.writes.size(), 1 + 20u);
+  EXPECT_EQ(nack.driver.state, 415);
+}
+
+// update() from the poller and loop() interleaved like the application loop
+TEST(Measure, PollerAndLoop) {
+  Rig rig;
+  std::vector<float> values;
+  rig.driver.add_on_state_callback([&values](float state) { values.push_back(state); });
+  rig.driver.call_setup();
+  for (uint32_t ms = 0; ms <= 301000; ms++) {
+    if (ms == 150000)
+      rig.k30.set_co2(900);
+    host::run_scheduler();
+    if (rig.driver.is_loop_enabled())
+      rig.driver.loop();
+    host::advance_us(1000);
+  }
+  rig.driver.stop_poller();
+  // the poll at 0 finds setup in progress
+  ASSERT_EQ(values.size(), 5u);
+  EXPECT_EQ(values.front(), 415);
+  EXPECT_EQ(values.back(), 900);
+}
+
+// --- Fault mixes: worst-case time per measurement and retries ---
+
+struct MixResult {
+  uint32_t worst_ms{0};
+  double mean_ms{0};
+  uint32_t worst_retries{0};
+  double mean_retries{0};
+  unsigned failed{0};
+};
+
+MixResult run_mix(const Faults &faults, unsigned measurements) {
+  Rig rig(faults, READ_MODE_BURST, 42);
+  rig.setup();
+  MixResult result;
+  for (unsigned i = 0; i < measurements; i++) {
+    rig.k30.set_co2(400 + i % 1000);
+    rig.driver.state = NAN;
+    uint32_t ms = rig.measure();
+    bool published = rig.driver.state == 400 + i % 1000;
+    uint32_t retries = rig.retries.state;
+    result.worst_ms = std::max(result.worst_ms, ms);
+    result.mean_ms += ms / double(measurements);
+    result.worst_retries = std::max(result.worst_retries, retries);
+    result.mean_retries += retries / double(measurements);
+    if (!published)
+      result.failed++;
+    host::advance_us(60000000);
+  }
+  return result;
+}
+
+TEST(FaultMixes, WorstCaseTimeAndRetries) {
+  const Faults mixes[] = {
+      {"none"},
+      {.name = "nack 5%", .nack = 0.05},
+      {.name = "bad checksum 5%", .bad_checksum = 0.05},
+      {.name = "busy bit 10%", .busy = 0.10},
+      {.name = "slow response 10%", .slow = 0.10},
+      {.name = "clock stretch 20% <=5ms", .stretch = 0.20},
+      {.name = "all of the above", .nack = 0.05, .bad_checksum = 0.05, .busy = 0.10, .slow = 0.10, .stretch = 0.20},
+      {.name = "noisy bus: nack 30%", .nack = 0.30},
+  };
+  const unsigned measurements = 2000;
+  host::set_log_level(ESPHOME_LOG_LEVEL_NONE);
+  printf("%-26s %10s %10s %12s %12s %8s\n", "fault mix", "worst ms", "mean ms", "worst retry", "mean retry",
+         "failed");
+  for (const auto &faults : mixes) {
+    MixResult r = run_mix(faults, measurements);
+    printf("%-26s %10u %10.1f %12u %12.3f %8u\n", faults.name, r.worst_ms, r.mean_ms, r.worst_retries,
+           r.mean_retries, r.failed);
+
+    // each attempt is a command, the response delay and a read, each transaction stretched at most
+    // once; attempts are retry_delay_ms apart
+    double stretch_ms = faults.stretch > 0 ? faults.stretch_us / 1000.0 : 0.0;
+    double attempt_ms = RESPONSE_DELAY_MS + 1 + 2 * (stretch_ms + 15 * K30Simulator::BYTE_US / 1000.0);
+    double bound_ms = MAX_RETRIES * attempt_ms + (MAX_RETRIES - 1) * (RETRY_DELAY_MS + 1);
+    EXPECT_LE(r.worst_ms, bound_ms) << faults.name;
+    EXPECT_LE(r.worst_retries, MAX_RETRIES) << faults.name;
+    // a measurement fails only when every attempt hits a fault; stretching only costs time
+    double attempt_fails = 1 - (1 - faults.nack) * (1 - faults.nack) * (1 - faults.bad_checksum) *
+                                   (1 - faults.busy) * (1 - faults.slow);
+    EXPECT_LE(r.failed, 2 * measurements * std::pow(attempt_fails, MAX_RETRIES) + 2) << faults.name;
+    if (attempt_fails == 0) {
+      EXPECT_EQ(r.worst_retries, 0u) << faults.name;
+    }
+  }
+  host::set_log_level(ESPHOME_LOG_LEVEL_WARN);
+}
+
+}  // namespace
+}  // namespace esphome::senseair_i2c::testing
@@ -0,0 +1,121 @@
+// Cost per sample of the sound level meter kernels on the host, and of a whole block with the
+// filters and sensors of config/spl.yaml.
+//
+//   bench_sound_level_meter [seconds of audio per kernel, default 20]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "harness.h"
+
+using namespace esphome::sound_level_meter;
+using namespace esphome::sound_level_meter::testing;
+
+static constexpr uint32_t SAMPLE_RATE = 48000;
+static constexpr uint32_t BLOCK = SAMPLE_RATE / 50;  // 20 ms
+
+static volatile float sink;
+
+// Runs kernel, which processes one 20 ms block per channel, for the given seconds of audio and
+// prints ns per sample of one channel
+static void report(const char *name, double seconds, const std::function<void()> &kernel, uint8_t channels = 1) {
+  size_t blocks = seconds * SAMPLE_RATE / BLOCK / channels;
+  for (size_t i = 0; i < blocks / 10 + 1; i++)
+    kernel();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < blocks; i++)
+    kernel();
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  printf("%-44s %8.2f ns/sample\n", name, ns / (blocks * BLOCK * channels));
+}
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? atof(argv[1]) : 20.0;
+  std::vector<double> noise = white_noise(70.0, 1.0, 1);
+  std::vector<float> input(noise.begin(), noise.begin() + BLOCK);
+  std::vector<float> block = input, block2 = input;
+
+  printf("%zu-sample blocks, %.0f s of audio per kernel\n", size_t(BLOCK), seconds);
+
+  SOS_Filter mic_eq(load_sos("f_ics43434"));
+  SOS_Filter a(load_sos("f_a"));
+  SOS_Filter a_pair(load_sos("f_a"));
+  a_pair.set_channels(2);
+  report("SOS_Filter::process (2 sections)", seconds, [&]() {
+    block = input;
+    mic_eq.process(block);
+  });
+  report("SOS_Filter::process (3 sections)", seconds, [&]() {
+    block = input;
+    a.process(block);
+  });
+  report(
+      "SOS_Filter::process_pair (3 sections)", seconds,
+      [&]() {
+        block = input;
+        block2 = input;
+        a_pair.process_pair(block, block2);
+      },
+      2);
+  report("copy of the input (baseline)", seconds, [&]() {
+    block = input;
+    sink = block[0];
+  });
+
+  BufferStack<float> stack(BLOCK);
+  report("BufferStack::push + pop", seconds, [&]() {
+    stack.push();
+    sink = stack.current()[0];
+    stack.pop();
+  });
+
+  // sensors with update intervals long enough not to publish while measured
+  HostSoundLevelMeter meter;
+  auto *eq = meter.add_level_sensor<SoundLevelMeterSensorEq>(3600000, {});
+  auto *max = meter.add_level_sensor<SoundLevelMeterSensorMax>(3600000, {}, 1000);
+  auto *min = meter.add_level_sensor<SoundLevelMeterSensorMin>(3600000, {}, 1000);
+  auto *peak = meter.add_level_sensor<SoundLevelMeterSensorPeak>(3600000, {});
+  report("SoundLevelMeterSensorEq::process", seconds, [&]() { eq->process(block); });
+  report("SoundLevelMeterSensorMax::process", seconds, [&]() { max->process(block); });
+  report("SoundLevelMeterSensorMin::process", seconds, [&]() { min->process(block); });
+  report("SoundLevelMeterSensorPeak::process", seconds, [&]() { peak->process(block); });
+
+  // 32 bit microphone samples through the callback (repacking to 16 bits with a 1 bit shift), the
+  // ring buffer and read_samples(); the host ring buffer is a plain FIFO under a mutex
+  for (uint8_t bits : {32, 16}) {
+    HostSoundLevelMeter io;
+    if (bits == 16) {
+      io.set_ingest_bits_per_sample(16);
+      io.set_ingest_shift(1);
+    }
+    io.begin();
+    std::vector<uint8_t> pcm = to_pcm(std::vector<double>(noise.begin(), noise.begin() + BLOCK), 32);
+    char name[64];
+    snprintf(name, sizeof(name), "ingest and read (%u bit ring buffer)", bits);
+    report(name, seconds, [&]() {
+      io.source().inject(pcm);
+      io.read_block(BLOCK);
+    });
+  }
+
+  // the whole block as deployed: mic eq and A-weighting shared by LAeq, LAmin and LAmax
+  HostSoundLevelMeter deployed;
+  deployed.set_ingest_bits_per_sample(16);
+  deployed.set_ingest_shift(1);
+  auto *f_mic = deployed.add_filter(load_sos("f_ics43434"));
+  auto *f_a = deployed.add_filter(load_sos("f_a"));
+  deployed.add_level_sensor<SoundLevelMeterSensorEq>(500, {f_mic, f_a});
+  deployed.add_level_sensor<SoundLevelMeterSensorMin>(60000, {f_mic, f_a}, 1000);
+  deployed.add_level_sensor<SoundLevelMeterSensorMax>(60000, {f_mic, f_a}, 1000);
+  deployed.begin();
+  std::vector<uint8_t> pcm = to_pcm(std::vector<double>(noise.begin(), noise.begin() + BLOCK), 32);
+  report("block as in config/spl.yaml", seconds, [&]() {
+    deployed.source().inject(pcm);
+    deployed.read_block(BLOCK);
+    deployed.process_block();
+    deployed.publish();
+  });
+  return 0;
+}
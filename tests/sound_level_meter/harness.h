@@ -0,0 +1,281 @@
+#pragma once
+
+// Runs audio through the sound level meter on the host: PCM goes through the microphone callback
+// (repacking to the ingest width), the ring buffer, read_samples() and dispatch_block() as in the
+// audio task, then loop() publishes the deferred states. No audio task is started, so a test
+// decides exactly which samples every value covers. With set_pipeline(), stage 2 runs in its own
+// thread as on the device and play() waits for it to drain before publishing.
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "esphome/components/sound_level_meter/sound_level_meter.h"
+
+namespace esphome::sound_level_meter::testing {
+
+using Sos = std::vector<std::array<float, 5>>;
+
+// dB SPL of a full scale sine, from mic_sensitivity: -26dB and mic_sensitivity_ref: 94dB
+static constexpr double FULL_SCALE_SPL = 94.0 + 26.0;
+// 20 log10(sqrt(2)), RMS levels are relative to a full scale sine
+static const double DBFS_OFFSET = 20 * std::log10(std::sqrt(2.0));
+
+// SOS sections {b0, b1, b2, a1, a2} of the dsp filter with the given id in config/spl.yaml
+inline Sos load_sos(const std::string &id, const std::string &path = SAMBA_DIR "/config/spl.yaml") {
+  std::ifstream file(path);
+  std::string line;
+  const std::regex id_line("^\\s*-\\s*id:\\s*(\\S+)\\s*$");
+  const std::regex row_line("^\\s*-\\s*\\[([^\\]]*)\\]\\s*$");
+  std::smatch match;
+  Sos sos;
+  bool in_filter = false;
+  while (std::getline(file, line)) {
+    if (std::regex_match(line, match, id_line)) {
+      if (in_filter)
+        break;
+      in_filter = match[1] == id;
+      continue;
+    }
+    if (!in_filter || !std::regex_match(line, match, row_line))
+      continue;
+    std::stringstream row(match[1]);
+    std::array<float, 5> section{};
+    std::string value;
+    for (size_t i = 0; i < 5 && std::getline(row, value, ','); i++)
+      section[i] = std::stof(value);
+    sos.push_back(section);
+  }
+  return sos;
+}
+
+// Magnitude response of the sections in dB at frequency f
+inline double sos_gain_db(const Sos &sos, double f, double sample_rate) {
+  std::complex<double> z1 = std::polar(1.0, -2 * M_PI * f / sample_rate);
+  std::complex<double> h = 1.0;
+  for (auto &s : sos)
+    h *= (double(s[0]) + double(s[1]) * z1 + double(s[2]) * z1 * z1) / (1.0 + double(s[3]) * z1 + double(s[4]) * z1 * z1);
+  return 20 * std::log10(std::abs(h));
+}
+
+// Double precision direct form 2 transposed, the reference for SOS_Filter
+class ReferenceFilter {
+ public:
+  explicit ReferenceFilter(const Sos &sos) : sos_(sos), state_(sos.size(), {0.0, 0.0}) {}
+  void process(std::vector<double> &data) {
+    for (size_t j = 0; j < this->sos_.size(); j++) {
+      const auto &c = this->sos_[j];
+      auto &s = this->state_[j];
+      for (double &x : data) {
+        double y = c[0] * x + s[0];
+        s[0] = c[1] * x - c[3] * y + s[1];
+        s[1] = c[2] * x - c[4] * y;
+        x = y;
+      }
+    }
+  }
+
+ protected:
+  Sos sos_;
+  std::vector<std::array<double, 2>> state_;
+};
+
+// Reference levels of one update interval, in dB SPL
+struct ReferenceLevels {
+  double eq;
+  double min;  // of the windows
+  double max;
+  double peak;
+};
+
+// window and update interval in samples; the update interval is a multiple of the window
+inline std::vector<ReferenceLevels> reference_levels(const std::vector<double> &x, size_t window, size_t update) {
+  std::vector<ReferenceLevels> levels;
+  for (size_t start = 0; start + update <= x.size(); start += update) {
+    double sum = 0, peak = 0, min = INFINITY, max = 0;
+    for (size_t w = start; w < start + update; w += window) {
+      double window_sum = 0;
+      for (size_t i = w; i < w + window; i++) {
+        window_sum += x[i] * x[i];
+        peak = std::max(peak, std::abs(x[i]));
+      }
+      sum += window_sum;
+      min = std::min(min, window_sum / window);
+      max = std::max(max, window_sum / window);
+    }
+    auto rms_db = [](double mean_square) { return 10 * std::log10(mean_square) + DBFS_OFFSET + FULL_SCALE_SPL; };
+    levels.push_back({rms_db(sum / update), rms_db(min), rms_db(max), 20 * std::log10(peak) + FULL_SCALE_SPL});
+  }
+  return levels;
+}
+
+// Full scale samples as little endian PCM, rounded and saturated
+inline std::vector<uint8_t> to_pcm(const std::vector<double> &x, uint8_t bits_per_sample) {
+  uint8_t bytes = bits_per_sample / 8;
+  std::vector<uint8_t> pcm(x.size() * bytes);
+  for (size_t i = 0; i < x.size(); i++) {
+    double q31 = std::round(std::clamp(x[i], -1.0, 1.0) * 2147483648.0);
+    auto sample = static_cast<int32_t>(std::clamp(q31, double(INT32_MIN), double(INT32_MAX)));
+    audio::pack_q31_as_audio_sample(sample, &pcm[i * bytes], bytes);
+  }
+  return pcm;
+}
+
+inline std::vector<double> from_pcm(const std::vector<uint8_t> &pcm, uint8_t bits_per_sample, uint8_t channels = 1,
+                                    uint8_t channel = 0) {
+  size_t bytes = bits_per_sample / 8;
+  std::vector<double> x(pcm.size() / bytes / channels);
+  for (size_t i = 0; i < x.size(); i++)
+    x[i] = audio::unpack_audio_sample_to_q31(&pcm[(i * channels + channel) * bytes], bytes) / 2147483648.0;
+  return x;
+}
+
+inline std::vector<double> sine(double f, double spl, double seconds, double sample_rate = 48000) {
+  double amplitude = std::pow(10.0, (spl - FULL_SCALE_SPL) / 20);
+  std::vector<double> x(std::lround(seconds * sample_rate));
+  for (size_t i = 0; i < x.size(); i++)
+    x[i] = amplitude * std::sin(2 * M_PI * f * i / sample_rate);
+  return x;
+}
+
+inline std::vector<double> white_noise(double spl, double seconds, uint32_t seed, double sample_rate = 48000) {
+  // RMS relative to a full scale sine, as the meter reports it
+  double rms = std::pow(10.0, (spl - FULL_SCALE_SPL - DBFS_OFFSET) / 20);
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> normal(0.0, rms);
+  std::vector<double> x(std::lround(seconds * sample_rate));
+  for (auto &v : x)
+    v = normal(rng);
+  return x;
+}
+
+// Collects the published values of a sensor, without the NaN published on reset
+class Recorder {
+ public:
+  explicit Recorder(sensor::Sensor *sensor) {
+    sensor->add_on_state_callback([this](float state) {
+      if (!std::isnan(state))
+        this->values.push_back(state);
+    });
+  }
+  std::vector<float> values;
+};
+
+class HostSoundLevelMeter : public SoundLevelMeter {
+ public:
+  static constexpr uint32_t BLOCK_MS = 20;
+
+  // configured like config/spl.yaml
+  explicit HostSoundLevelMeter(audio::AudioStreamInfo stream_info = audio::AudioStreamInfo(32, 1, 48000))
+      : source_(stream_info) {
+    this->set_microphone_source(&this->source_);
+    this->set_ring_buffer_size(200);
+    this->set_max_block_size(60);
+    this->set_mic_sensitivity(-26.0f);
+    this->set_mic_sensitivity_ref(94.0f);
+    this->set_offset(0.0f);
+    this->set_is_auto_start(false);
+  }
+  ~HostSoundLevelMeter() {
+    if (this->pipeline_pool_ != nullptr)
+      this->stop_pipeline();
+  }
+
+  Filter *add_filter(Sos sos) {
+    this->filters_.push_back(std::make_unique<SOS_Filter>(std::move(sos)));
+    this->add_dsp_filter(this->filters_.back().get());
+    return this->filters_.back().get();
+  }
+
+  template<class S>
+  S *add_level_sensor(uint32_t update_interval_ms, std::vector<Filter *> filters, uint32_t window_ms = 0,
+                      uint8_t channel = 0) {
+    auto sensor = std::make_unique<S>();
+    S *s = sensor.get();
+    s->set_parent(this);
+    if constexpr (std::is_same_v<S, SoundLevelMeterSensorMax> || std::is_same_v<S, SoundLevelMeterSensorMin>)
+      s->set_window_size(window_ms);
+    s->set_update_interval(update_interval_ms);
+    s->set_channel(channel);
+    for (auto *f : filters)
+      s->add_dsp_filter(f);
+    this->add_sensor(s);
+    this->level_sensors_.push_back(std::move(sensor));
+    return s;
+  }
+
+  // setup() and what the audio task does before its warmup
+  void begin() {
+    this->setup();
+    this->ring_buffer_ =
+        RingBuffer::create(this->ingest_frames_to_bytes(this->ms_to_frames(this->ring_buffer_size_ms_)));
+    this->ring_buffer_weak_ = this->ring_buffer_;
+    uint32_t max_frames = this->ms_to_frames(this->max_block_size_ms_);
+    uint8_t channels = this->get_audio_stream_info().get_channels();
+    this->buffers_ = ChannelBuffers(channels, BufferStack<float>(max_frames));
+    if (channels > 1)
+      this->read_buffer_.resize(this->ingest_frames_to_bytes(max_frames));
+    this->reset();
+    if (this->is_pipeline_)
+      this->start_pipeline();
+    this->publish();
+  }
+
+  // Feeds the microphone callback BLOCK_MS at a time and processes each block like the audio
+  // task, with update_sensors false like during the warmup
+  void play(const std::vector<uint8_t> &pcm, bool update_sensors = true) {
+    size_t block_bytes = this->source_.get_audio_stream_info().frames_to_bytes(this->ms_to_frames(BLOCK_MS));
+    std::vector<uint8_t> block;
+    for (size_t pos = 0; pos < pcm.size(); pos += block_bytes) {
+      block.assign(pcm.begin() + pos, pcm.begin() + std::min(pos + block_bytes, pcm.size()));
+      this->source_.inject(block);
+      while (this->ring_buffer_->available() > 0) {
+        auto *buffers = this->acquire_block(this->buffers_, BLOCK_MS);
+        if (buffers == nullptr)
+          continue;
+        if (this->read_samples(*buffers, this->ms_to_frames(BLOCK_MS), 0) == 0)
+          break;
+        this->dispatch_block(*buffers, update_sensors);
+      }
+    }
+    this->publish();
+  }
+  void play(const std::vector<double> &x, bool update_sensors = true) {
+    this->play(to_pcm(x, this->source_.get_audio_stream_info().get_bits_per_sample()), update_sensors);
+  }
+
+  // runs loop() until every deferred state is published
+  void publish() {
+    this->wait_pipeline_idle();
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(this->defer_mutex_);
+        if (this->defer_queue_.empty())
+          return;
+      }
+      this->loop();
+    }
+  }
+
+  // kernels of the audio task, for the benchmark
+  size_t read_block(uint32_t frames) { return this->read_samples(this->buffers_, frames, 0); }
+  void process_block() { this->dispatch_block(this->buffers_, true); }
+  microphone::MicrophoneSource &source() { return this->source_; }
+  // frames processed by stage 2 since the pipeline started
+  uint32_t stage2_frames() const { return this->stage2_frames_; }
+
+ protected:
+  microphone::MicrophoneSource source_;
+  ChannelBuffers buffers_;
+  std::vector<std::unique_ptr<SOS_Filter>> filters_;
+  std::vector<std::unique_ptr<SoundLevelMeterSensor>> level_sensors_;
+};
+
+}  // namespace esphome::sound_level_meter::testing
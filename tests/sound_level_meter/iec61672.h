@@ -0,0 +1,51 @@
+#pragma once
+
+// Frequency weightings of IEC 61672-1:2013 and the class 1 acceptance limits of Table 3.
+
+#include <cmath>
+#include <vector>
+
+namespace esphome::sound_level_meter::testing {
+
+// Annex E: pole frequencies of the A and C weightings
+static constexpr double F1 = 20.598997;
+static constexpr double F2 = 107.65265;
+static constexpr double F3 = 737.86223;
+static constexpr double F4 = 12194.217;
+
+inline double c_weighting_raw(double f) { return 20 * std::log10(F4 * F4 * f * f / ((f * f + F1 * F1) * (f * f + F4 * F4))); }
+
+inline double a_weighting_raw(double f) {
+  return 20 * std::log10(F4 * F4 * f * f * f * f /
+                         ((f * f + F1 * F1) * std::sqrt(f * f + F2 * F2) * std::sqrt(f * f + F3 * F3) * (f * f + F4 * F4)));
+}
+
+// normalised to 0 dB at 1 kHz
+inline double a_weighting(double f) { return a_weighting_raw(f) - a_weighting_raw(1000); }
+inline double c_weighting(double f) { return c_weighting_raw(f) - c_weighting_raw(1000); }
+
+struct Tolerance {
+  double nominal;  // Hz
+  double upper;    // dB
+  double lower;    // dB, -INFINITY where the standard has no lower limit
+};
+
+// Class 1 acceptance limits at the nominal one-third-octave frequencies (Table 3). The exact
+// frequencies are 1000 * 10^(n / 10).
+inline const std::vector<Tolerance> &class1_tolerances() {
+  static const std::vector<Tolerance> TOLERANCES = {
+      {10, 3.5, -INFINITY}, {12.5, 3.0, -INFINITY}, {16, 2.5, -4.5},  {20, 2.5, -2.5},   {25, 2.5, -2.0},
+      {31.5, 2.0, -2.0},    {40, 1.5, -1.5},        {50, 1.5, -1.5},  {63, 1.5, -1.5},   {80, 1.5, -1.5},
+      {100, 1.5, -1.5},     {125, 1.5, -1.5},       {160, 1.5, -1.5}, {200, 1.4, -1.4},  {250, 1.4, -1.4},
+      {315, 1.4, -1.4},     {400, 1.4, -1.4},       {500, 1.4, -1.4}, {630, 1.4, -1.4},  {800, 1.4, -1.4},
+      {1000, 1.1, -1.1},    {1250, 1.4, -1.4},      {1600, 1.6, -1.6}, {2000, 1.6, -1.6}, {2500, 1.6, -1.6},
+      {3150, 1.6, -1.6},    {4000, 1.6, -1.6},      {5000, 2.1, -2.1}, {6300, 2.1, -2.6}, {8000, 2.1, -3.1},
+      {10000, 2.6, -3.6},   {12500, 3.0, -6.0},     {16000, 3.5, -17.0}, {20000, 4.0, -INFINITY},
+  };
+  return TOLERANCES;
+}
+
+// exact frequency of the i-th entry of class1_tolerances()
+inline double exact_frequency(size_t index) { return 1000 * std::pow(10.0, (int(index) - 20) / 10.0); }
+
+}  // namespace esphome::sound_level_meter::testing
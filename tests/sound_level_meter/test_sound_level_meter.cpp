@@ -0,0 +1,477 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+#include "harness.h"
+#include "iec61672.h"
+#include "wav.h"
+
+namespace esphome::sound_level_meter::testing {
+namespace {
+
+static constexpr double SAMPLE_RATE = 48000;
+
+class WeightingTest : public ::testing::TestWithParam<const char *> {
+ protected:
+  double weighting(double f) const {
+    return std::string(GetParam()) == "f_a" ? a_weighting(f) : c_weighting(f);
+  }
+};
+
+// Response of the coefficients in config/spl.yaml against the weighting at every one-third-octave
+// frequency of Table 3
+TEST_P(WeightingTest, CoefficientsWithinClass1) {
+  Sos sos = load_sos(GetParam());
+  ASSERT_EQ(sos.size(), 3u);
+  const auto &tolerances = class1_tolerances();
+  for (size_t i = 0; i < tolerances.size(); i++) {
+    double f = exact_frequency(i);
+    double deviation = sos_gain_db(sos, f, SAMPLE_RATE) - this->weighting(f);
+    EXPECT_LE(deviation, tolerances[i].upper) << tolerances[i].nominal << " Hz";
+    EXPECT_GE(deviation, tolerances[i].lower) << tolerances[i].nominal << " Hz";
+  }
+}
+
+// Tones through the meter as configured in config/spl.yaml (16 bit ingest, 1 bit shift), with
+// the weighting as its only filter
+TEST_P(WeightingTest, TonesWithinClass1) {
+  Sos sos = load_sos(GetParam());
+  const auto &tolerances = class1_tolerances();
+  for (double nominal : {31.5, 63.0, 125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0, 12500.0, 16000.0}) {
+    HostSoundLevelMeter meter;
+    meter.set_ingest_bits_per_sample(16);
+    meter.set_ingest_shift(1);
+    auto *weighting = meter.add_filter(sos);
+    auto *leq = meter.add_level_sensor<SoundLevelMeterSensorEq>(2000, {weighting});
+    Recorder values(leq);
+    meter.begin();
+    // the first interval lets the filter settle, 2s are whole periods of every tone
+    meter.play(sine(nominal, 94.0, 4.0));
+    ASSERT_EQ(values.values.size(), 2u) << nominal << " Hz";
+
+    auto it = std::find_if(tolerances.begin(), tolerances.end(), [nominal](auto &t) { return t.nominal == nominal; });
+    double deviation = values.values[1] - 94.0 - this->weighting(nominal);
+    EXPECT_LE(deviation, it->upper) << nominal << " Hz";
+    EXPECT_GE(deviation, it->lower) << nominal << " Hz";
+    // and the meter adds nothing to the response of the coefficients
+    EXPECT_NEAR(values.values[1], 94.0 + sos_gain_db(sos, nominal, SAMPLE_RATE), 0.02) << nominal << " Hz";
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(SplYaml, WeightingTest, ::testing::Values("f_a", "f_c"));
+
+// Signal with quiet and loud seconds, tone bursts and single loud samples, which
+// exercises the windows of min/max and the peak
+std::vector<double> test_signal(double seconds) {
+  std::vector<double> x = white_noise(55.0, seconds, 1);
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> gain_db(-20.0, 25.0);
+  for (size_t second = 0; second < seconds; second++) {
+    double gain = std::pow(10.0, gain_db(rng) / 20);
+    for (size_t i = second * SAMPLE_RATE; i < (second + 1) * SAMPLE_RATE; i++)
+      x[i] *= gain;
+  }
+  // 200 ms 1 kHz bursts at 90 dB SPL every 3 s
+  std::vector<double> burst = sine(1000.0, 90.0, 0.2);
+  for (size_t start = 0.5 * SAMPLE_RATE; start + burst.size() <= x.size(); start += 3 * SAMPLE_RATE) {
+    for (size_t i = 0; i < burst.size(); i++)
+      x[start + i] += burst[i];
+  }
+  // single samples just below the clipping level of the 1 bit ingest shift
+  for (size_t i = 1.7 * SAMPLE_RATE; i < x.size(); i += 5 * SAMPLE_RATE)
+    x[i] = 0.4;
+  return x;
+}
+
+struct LevelSensors {
+  SoundLevelMeterSensorEq *eq;
+  SoundLevelMeterSensorMin *min;
+  SoundLevelMeterSensorMax *max;
+  SoundLevelMeterSensorPeak *peak;
+};
+
+// Leq, min and max over 1s windows, and peak, every 4s, from the meter (float) and from a double
+// precision reference over the same samples through the same filter chain
+void check_levels(uint8_t ingest_bits, uint8_t ingest_shift, double tolerance_db) {
+  const size_t window = 1 * SAMPLE_RATE, update = 4 * SAMPLE_RATE;
+  std::vector<double> x = test_signal(24.0);
+
+  HostSoundLevelMeter meter;
+  meter.set_ingest_bits_per_sample(ingest_bits);
+  meter.set_ingest_shift(ingest_shift);
+  auto *mic_eq = meter.add_filter(load_sos("f_ics43434"));
+  auto *a = meter.add_filter(load_sos("f_a"));
+  auto *c = meter.add_filter(load_sos("f_c"));
+  // two chains sharing the mic eq, so the buffer stack is pushed and popped between them
+  std::vector<LevelSensors> chains;
+  for (auto *weighting : {a, c}) {
+    chains.push_back({meter.add_level_sensor<SoundLevelMeterSensorEq>(4000, {mic_eq, weighting}),
+                      meter.add_level_sensor<SoundLevelMeterSensorMin>(4000, {mic_eq, weighting}, 1000),
+                      meter.add_level_sensor<SoundLevelMeterSensorMax>(4000, {mic_eq, weighting}, 1000),
+                      meter.add_level_sensor<SoundLevelMeterSensorPeak>(4000, {mic_eq, weighting})});
+  }
+  std::vector<std::array<std::unique_ptr<Recorder>, 4>> recorders;
+  for (auto &chain : chains) {
+    recorders.push_back({std::make_unique<Recorder>(chain.eq), std::make_unique<Recorder>(chain.min),
+                         std::make_unique<Recorder>(chain.max), std::make_unique<Recorder>(chain.peak)});
+  }
+  meter.begin();
+  std::vector<uint8_t> pcm = to_pcm(x, 32);
+  meter.play(pcm);
+
+  // the reference sees the samples after ingest, i.e. the source quantisation but not the repacking
+  std::vector<double> source = from_pcm(pcm, 32);
+  const char *names[] = {"eq", "min", "max", "peak"};
+  for (size_t k = 0; k < chains.size(); k++) {
+    std::vector<double> y = source;
+    ReferenceFilter(load_sos("f_ics43434")).process(y);
+    ReferenceFilter(load_sos(k == 0 ? "f_a" : "f_c")).process(y);
+    auto levels = reference_levels(y, window, update);
+    for (size_t s = 0; s < 4; s++) {
+      const auto &values = recorders[k][s]->values;
+      ASSERT_EQ(values.size(), levels.size()) << names[s];
+      for (size_t i = 0; i < levels.size(); i++) {
+        double expected[] = {levels[i].eq, levels[i].min, levels[i].max, levels[i].peak};
+        EXPECT_NEAR(values[i], expected[s], tolerance_db) << (k == 0 ? "A " : "C ") << names[s] << " #" << i;
+      }
+    }
+  }
+}
+
+TEST(Levels, MatchDoubleReference32BitIngest) { check_levels(32, 0, 0.01); }
+
+// 16 bit samples with a 1 bit shift, as configured in config/spl.yaml; the quietest seconds are
+// ~35 dB SPL, where the quantisation noise is ~20 dB lower
+TEST(Levels, MatchDoubleReference16BitIngest) { check_levels(16, 1, 0.05); }
+
+// Samples lost to a ring buffer overflow do not count towards Leq, but the update cadence is kept
+TEST(Levels, GapKeepsCadence) {
+  HostSoundLevelMeter meter;
+  auto *leq = meter.add_level_sensor<SoundLevelMeterSensorEq>(1000, {});
+  Recorder values(leq);
+  meter.begin();
+  meter.play(sine(1000.0, 80.0, 0.5));
+  // 500 ms without reading in between: 300 ms more than the 200 ms ring buffer holds are dropped
+  meter.source().inject(to_pcm(sine(1000.0, 80.0, 0.5), 32));
+  meter.play(sine(1000.0, 80.0, 0.6));
+  ASSERT_EQ(values.values.size(), 1u);
+  EXPECT_NEAR(values.values[0], 80.0, 0.01);
+}
+
+// Two channels through a shared mic eq (applied to the pair at once) and per channel weightings
+TEST(Levels, TwoChannels) {
+  HostSoundLevelMeter meter(audio::AudioStreamInfo(32, 2, 48000));
+  auto *mic_eq = meter.add_filter(load_sos("f_ics43434"));
+  auto *a = meter.add_filter(load_sos("f_a"));
+  auto *c = meter.add_filter(load_sos("f_c"));
+  SoundLevelMeterSensorEq *sensors[2][2];
+  for (uint8_t channel = 0; channel < 2; channel++) {
+    sensors[channel][0] = meter.add_level_sensor<SoundLevelMeterSensorEq>(1000, {mic_eq, a}, 0, channel);
+    sensors[channel][1] = meter.add_level_sensor<SoundLevelMeterSensorEq>(1000, {mic_eq, c}, 0, channel);
+  }
+  Recorder values[2][2] = {{Recorder(sensors[0][0]), Recorder(sensors[0][1])},
+                           {Recorder(sensors[1][0]), Recorder(sensors[1][1])}};
+  meter.begin();
+  std::vector<double> left = white_noise(70.0, 3.0, 4), right = sine(100.0, 60.0, 3.0);
+  std::vector<double> interleaved(2 * left.size());
+  for (size_t i = 0; i < left.size(); i++) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+  std::vector<uint8_t> pcm = to_pcm(interleaved, 32);
+  meter.play(pcm);
+
+  for (uint8_t channel = 0; channel < 2; channel++) {
+    for (size_t k = 0; k < 2; k++) {
+      std::vector<double> y = from_pcm(pcm, 32, 2, channel);
+      ReferenceFilter(load_sos("f_ics43434")).process(y);
+      ReferenceFilter(load_sos(k == 0 ? "f_a" : "f_c")).process(y);
+      auto levels = reference_levels(y, SAMPLE_RATE, SAMPLE_RATE);
+      ASSERT_EQ(values[channel][k].values.size(), levels.size());
+      for (size_t i = 0; i < levels.size(); i++)
+        EXPECT_NEAR(values[channel][k].values[i], levels[i].eq, 0.01) << int(channel) << " " << k << " #" << i;
+    }
+  }
+}
+
+// --- Duty cycle ---
+
+// The audio task itself, started and stopped by the duty cycle on the real clock, while the
+// microphone delivers a steady tone in real time: measuring 150 ms (after a 50 ms warmup) every
+// 500 ms, a 500 ms Leq is computed over the 150 ms sampled per period, so one value is still
+// published per period, and the accumulators carry over the pauses.
+TEST(DutyCycle, TaskCyclesAndKeepsCadence) {
+  host::use_real_clock();
+  host::reset_scheduler();
+  HostSoundLevelMeter meter;
+  meter.set_warmup_interval(50);
+  meter.set_duty_cycle(150, 500);
+  meter.set_active_current(0.02f);
+  auto *leq = meter.add_level_sensor<SoundLevelMeterSensorEq>(500, {});
+  sensor::Sensor cpu_time_saved, current_saved;
+  meter.set_cpu_time_saved_sensor(&cpu_time_saved);
+  meter.set_current_saved_sensor(&current_saved);
+  Recorder values(leq), current(&current_saved);
+  meter.setup();
+
+  std::vector<uint8_t> tone = to_pcm(sine(1000.0, 80.0, 1.0), 32);
+  const size_t frame_bytes = 4, second_bytes = tone.size();
+  size_t injected = 0;
+  unsigned polls = 0, idle_polls = 0;
+  uint32_t start = millis();
+  meter.start();
+  while (millis() - start < 2300) {
+    // the frames due by now, continuing the tone
+    size_t due = size_t(millis() - start) * 48 * frame_bytes;
+    std::vector<uint8_t> block;
+    for (; injected < due; injected += frame_bytes)
+      block.insert(block.end(), &tone[injected % second_bytes], &tone[injected % second_bytes] + frame_bytes);
+    if (!block.empty())
+      meter.source().inject(block);
+    host::run_scheduler();
+    meter.loop();
+    polls++;
+    idle_polls += !meter.is_running();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  meter.stop();
+  for (int i = 0; i < 1000 && meter.is_running(); i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_FALSE(meter.is_running());
+  meter.publish();
+  host::reset_scheduler();
+
+  // periods start at 0, 500, ..., 2000 ms; without the scaling to the sampled 150 ms a 500 ms
+  // value would need more than three periods
+  EXPECT_GE(values.values.size(), 3u);
+  EXPECT_LE(values.values.size(), 5u);
+  for (float value : values.values)
+    EXPECT_NEAR(value, 80.0, 0.1);
+  // off for 300 of every 500 ms
+  EXPECT_NEAR(double(idle_polls) / polls, 0.6, 0.15);
+  ASSERT_GE(current.values.size(), 3u);
+  EXPECT_FLOAT_EQ(current.values.back(), 0.02f * 0.6f * 1000);
+  EXPECT_GE(cpu_time_saved.state, 0.0f);
+}
+
+// --- Two-stage pipeline ---
+
+// Blocks come out in the order they went in, the pool is full with every block in flight, and
+// the indices wrap
+TEST(BlockPool, OrderFullAndWrap) {
+  BlockPool pool(3, 16, 1);
+  EXPECT_TRUE(pool.empty());
+  EXPECT_EQ(pool.peek(), nullptr);
+  uint32_t next_in = 0, next_out = 0;
+  for (int round = 0; round < 10; round++) {
+    // fill, then drain all but one
+    while (auto *block = pool.acquire()) {
+      // until it is committed, acquire() returns the same block
+      EXPECT_EQ(pool.acquire(), block);
+      block->gap = next_in++;
+      pool.commit();
+    }
+    EXPECT_EQ(next_in - next_out, 3u);
+    while (next_in - next_out > 1) {
+      auto *block = pool.peek();
+      ASSERT_NE(block, nullptr);
+      EXPECT_EQ(block->gap, next_out++);
+      pool.release();
+    }
+    EXPECT_FALSE(pool.empty());
+  }
+}
+
+// One producer and one consumer thread, like the two stages on their cores
+TEST(BlockPool, ProducerConsumerThreads) {
+  BlockPool pool(4, 64, 2);
+  const uint32_t blocks = 20000;
+  std::thread consumer([&pool]() {
+    for (uint32_t expected = 0; expected < blocks;) {
+      auto *block = pool.peek();
+      if (block == nullptr) {
+        std::this_thread::yield();
+        continue;
+      }
+      ASSERT_EQ(block->gap, expected);
+      ASSERT_EQ(block->channels[1].current()[0], float(expected));
+      expected++;
+      pool.release();
+    }
+  });
+  for (uint32_t sent = 0; sent < blocks;) {
+    auto *block = pool.acquire();
+    if (block == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    block->gap = sent;
+    block->channels[1].current()[0] = float(sent);
+    pool.commit();
+    sent++;
+  }
+  consumer.join();
+  EXPECT_TRUE(pool.empty());
+}
+
+// Stage 2 in its own thread publishes exactly the values of the single-stage meter, with the mic
+// eq shared by both chains run in stage 1
+TEST(Pipeline, MatchesSingleStage) {
+  std::vector<double> x = test_signal(8.0);
+  std::vector<std::vector<float>> results[2];
+  for (bool pipeline : {false, true}) {
+    HostSoundLevelMeter meter;
+    if (pipeline)
+      meter.set_pipeline(0, 3);
+    auto *mic_eq = meter.add_filter(load_sos("f_ics43434"));
+    auto *a = meter.add_filter(load_sos("f_a"));
+    auto *c = meter.add_filter(load_sos("f_c"));
+    std::vector<std::unique_ptr<Recorder>> recorders;
+    for (auto *weighting : {a, c}) {
+      recorders.push_back(
+          std::make_unique<Recorder>(meter.add_level_sensor<SoundLevelMeterSensorEq>(1000, {mic_eq, weighting})));
+      recorders.push_back(std::make_unique<Recorder>(
+          meter.add_level_sensor<SoundLevelMeterSensorMax>(1000, {mic_eq, weighting}, 125)));
+      recorders.push_back(
+          std::make_unique<Recorder>(meter.add_level_sensor<SoundLevelMeterSensorPeak>(1000, {mic_eq, weighting})));
+    }
+    meter.begin();
+    // a warmup second through the filters only, as the audio task does
+    meter.play(white_noise(60.0, 1.0, 5), false);
+    meter.play(x);
+    if (pipeline) {
+      EXPECT_EQ(meter.stage2_frames(), x.size());
+    }
+    for (auto &recorder : recorders)
+      results[pipeline].push_back(recorder->values);
+  }
+  ASSERT_EQ(results[0].size(), results[1].size());
+  for (size_t s = 0; s < results[0].size(); s++) {
+    ASSERT_EQ(results[0][s].size(), 8u) << s;
+    EXPECT_EQ(results[1][s], results[0][s]) << s;
+  }
+}
+
+// Frames lost before a block travel with it to stage 2
+TEST(Pipeline, GapKeepsCadence) {
+  HostSoundLevelMeter meter;
+  meter.set_pipeline(0, 2);
+  auto *leq = meter.add_level_sensor<SoundLevelMeterSensorEq>(1000, {});
+  Recorder values(leq);
+  meter.begin();
+  meter.play(sine(1000.0, 80.0, 0.5));
+  meter.source().inject(to_pcm(sine(1000.0, 80.0, 0.5), 32));
+  meter.play(sine(1000.0, 80.0, 0.6));
+  ASSERT_EQ(values.values.size(), 1u);
+  EXPECT_NEAR(values.values[0], 80.0, 0.01);
+}
+
+// Writes a recording as the microphone delivers it and replays it from the WAV file
+TEST(Replay, CalibratorTone) {
+  auto path = std::filesystem::temp_directory_path() / "samba_calibrator_94db.wav";
+  Wav wav;
+  wav.data = to_pcm(sine(1000.0, 94.0, 3.0), 32);
+  ASSERT_TRUE(write_wav(path.string(), wav));
+
+  Wav replay;
+  ASSERT_TRUE(read_wav(path.string(), replay));
+  std::filesystem::remove(path);
+  HostSoundLevelMeter meter(audio::AudioStreamInfo(replay.bits_per_sample, replay.channels, replay.sample_rate));
+  meter.set_ingest_bits_per_sample(16);
+  meter.set_ingest_shift(1);
+  auto *a = meter.add_filter(load_sos("f_a"));
+  auto *laeq = meter.add_level_sensor<SoundLevelMeterSensorEq>(1000, {a});
+  Recorder values(laeq);
+  meter.begin();
+  meter.play(replay.data);
+  ASSERT_EQ(values.values.size(), 3u);
+  EXPECT_NEAR(values.values[2], 94.0, 0.05);
+}
+
+// Recordings listed in SLM_WAV (separated by ':') are replayed through the deployed chain and
+// their levels compared with the double precision reference
+TEST(Replay, WavFiles) {
+  const char *env = std::getenv("SLM_WAV");
+  if (env == nullptr || *env == '\0')
+    GTEST_SKIP() << "set SLM_WAV to replay recordings";
+  std::stringstream paths(env);
+  std::string path;
+  while (std::getline(paths, path, ':')) {
+    Wav wav;
+    ASSERT_TRUE(read_wav(path, wav)) << path;
+    if (wav.sample_rate != SAMPLE_RATE) {
+      ADD_FAILURE() << path << ": the filters in config/spl.yaml are for 48 kHz";
+      continue;
+    }
+    HostSoundLevelMeter meter(audio::AudioStreamInfo(wav.bits_per_sample, wav.channels, wav.sample_rate));
+    meter.set_ingest_bits_per_sample(16);
+    meter.set_ingest_shift(1);
+    auto *mic_eq = meter.add_filter(load_sos("f_ics43434"));
+    auto *a = meter.add_filter(load_sos("f_a"));
+    auto *laeq = meter.add_level_sensor<SoundLevelMeterSensorEq>(1000, {mic_eq, a});
+    auto *lamax = meter.add_level_sensor<SoundLevelMeterSensorMax>(1000, {mic_eq, a}, 125);
+    Recorder eq_values(laeq), max_values(lamax);
+    meter.begin();
+    meter.play(wav.data);
+
+    std::vector<double> y = from_pcm(wav.data, wav.bits_per_sample, wav.channels);
+    ReferenceFilter(load_sos("f_ics43434")).process(y);
+    ReferenceFilter(load_sos("f_a")).process(y);
+    auto levels = reference_levels(y, SAMPLE_RATE / 8, SAMPLE_RATE);
+    ASSERT_EQ(eq_values.values.size(), levels.size()) << path;
+    for (size_t i = 0; i < levels.size(); i++) {
+      printf("%s %3zu s: LAeq %6.2f (ref %6.2f)  LAFmax %6.2f (ref %6.2f)\n", path.c_str(), i, eq_values.values[i],
+             levels[i].eq, max_values.values[i], levels[i].max);
+      EXPECT_NEAR(eq_values.values[i], levels[i].eq, 0.1) << path << " #" << i;
+      EXPECT_NEAR(max_values.values[i], levels[i].max, 0.1) << path << " #" << i;
+    }
+  }
+}
+
+// Block process times: percentiles within a quarter of the exact value, never above the max
+TEST(Histogram, PercentilesWithinSubBucket) {
+  Histogram histogram;
+  EXPECT_EQ(histogram.percentile(0.5f), 0u);
+  std::mt19937 rng(3);
+  // mostly 1-3 ms blocks with a tail up to 40 ms, as with Wi-Fi/TLS work on the same core
+  std::lognormal_distribution<double> block_us(std::log(1500.0), 0.6);
+  std::vector<uint32_t> values(5000);
+  for (auto &value : values) {
+    value = std::min(block_us(rng), 40000.0);
+    histogram.add(value);
+  }
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(histogram.count(), values.size());
+  EXPECT_EQ(histogram.max(), values.back());
+  for (float q : {0.1f, 0.5f, 0.9f, 0.99f}) {
+    uint32_t exact = values[std::ceil(q * values.size()) - 1];
+    EXPECT_NEAR(histogram.percentile(q), exact, exact / 4.0) << q;
+  }
+  EXPECT_EQ(histogram.percentile(1.0f), values.back());
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.max(), 0u);
+  EXPECT_EQ(histogram.percentile(0.99f), 0u);
+}
+
+TEST(Histogram, SmallAndOverflowValues) {
+  Histogram histogram;
+  for (uint32_t value : {0u, 1u, 2u, 3u})
+    histogram.add(value);
+  EXPECT_EQ(histogram.percentile(0.25f), 0u);
+  EXPECT_EQ(histogram.percentile(0.75f), 2u);
+  // past the last bucket (~115 ms) everything lands in it; the max still caps the percentiles
+  histogram.reset();
+  for (uint32_t value : {200000u, 300000u, 5000000u})
+    histogram.add(value);
+  EXPECT_LE(histogram.percentile(0.5f), 5000000u);
+  EXPECT_GE(histogram.percentile(0.5f), 114688u);
+  EXPECT_EQ(histogram.percentile(1.0f), 5000000u);
+}
+
+}  // namespace
+}  // namespace esphome::sound_level_meter::testing
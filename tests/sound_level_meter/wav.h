@@ -0,0 +1,81 @@
+#pragma once
+
+// Minimal PCM WAV reader/writer for replaying recordings through the sound level meter.
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace esphome::sound_level_meter::testing {
+
+struct Wav {
+  uint32_t sample_rate{48000};
+  uint8_t channels{1};
+  uint8_t bits_per_sample{32};
+  std::vector<uint8_t> data;  // interleaved little endian samples
+};
+
+inline uint32_t wav_u32(const uint8_t *p) { return p[0] | p[1] << 8 | p[2] << 16 | uint32_t(p[3]) << 24; }
+inline uint16_t wav_u16(const uint8_t *p) { return p[0] | p[1] << 8; }
+
+// PCM (format 1) or WAVE_FORMAT_EXTENSIBLE with integer samples, 8 to 32 bits
+inline bool read_wav(const std::string &path, Wav &wav) {
+  std::ifstream file(path, std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) != 0 || memcmp(&bytes[8], "WAVE", 4) != 0)
+    return false;
+  bool has_format = false;
+  for (size_t pos = 12; pos + 8 <= bytes.size();) {
+    uint32_t size = wav_u32(&bytes[pos + 4]);
+    const uint8_t *chunk = &bytes[pos + 8];
+    if (pos + 8 + size > bytes.size())
+      size = bytes.size() - pos - 8;
+    if (memcmp(&bytes[pos], "fmt ", 4) == 0 && size >= 16) {
+      uint16_t format = wav_u16(chunk);
+      if (format != 1 && format != 0xFFFE)
+        return false;
+      wav.channels = wav_u16(chunk + 2);
+      wav.sample_rate = wav_u32(chunk + 4);
+      wav.bits_per_sample = wav_u16(chunk + 14);
+      has_format = wav.bits_per_sample % 8 == 0 && wav.bits_per_sample >= 8 && wav.bits_per_sample <= 32;
+    } else if (memcmp(&bytes[pos], "data", 4) == 0 && has_format) {
+      wav.data.assign(chunk, chunk + size);
+      return true;
+    }
+    pos += 8 + size + (size & 1);
+  }
+  return false;
+}
+
+inline bool write_wav(const std::string &path, const Wav &wav) {
+  auto u32 = [](std::vector<uint8_t> &out, uint32_t v) {
+    for (int i = 0; i < 4; i++)
+      out.push_back(v >> (8 * i));
+  };
+  auto u16 = [](std::vector<uint8_t> &out, uint16_t v) {
+    out.push_back(v);
+    out.push_back(v >> 8);
+  };
+  uint16_t block_align = wav.channels * wav.bits_per_sample / 8;
+  std::vector<uint8_t> header;
+  header.insert(header.end(), {'R', 'I', 'F', 'F'});
+  u32(header, 36 + wav.data.size());
+  header.insert(header.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  u32(header, 16);
+  u16(header, 1);
+  u16(header, wav.channels);
+  u32(header, wav.sample_rate);
+  u32(header, wav.sample_rate * block_align);
+  u16(header, block_align);
+  u16(header, wav.bits_per_sample);
+  header.insert(header.end(), {'d', 'a', 't', 'a'});
+  u32(header, wav.data.size());
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(header.data()), header.size());
+  file.write(reinterpret_cast<const char *>(wav.data.data()), wav.data.size());
+  return file.good();
+}
+
+}  // namespace esphome::sound_level_meter::testing
@@ -0,0 +1,75 @@
+// Cost per value of the streaming median against the stock median filter, which copies and sorts
+// its window every time it sends: the mean, and the mean of the new_value() calls that send, which is
+// what a send costs the loop.
+//
+//   bench_streaming_quantile [values per case, default 200000]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "esphome/components/sensor/filter.h"
+#include "esphome/components/streaming_quantile/streaming_quantile.h"
+
+using namespace esphome;
+
+static volatile float sink;
+
+struct Timing {
+  double mean_ns;
+  double send_ns;
+};
+
+static Timing run(sensor::Filter &filter, const std::vector<float> &values) {
+  Timing timing{0, 0};
+  size_t sends = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (float v : values) {
+    auto call = std::chrono::steady_clock::now();
+    auto result = filter.new_value(v);
+    if (result.has_value()) {
+      sink = *result;
+      timing.send_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - call).count();
+      sends++;
+    }
+  }
+  timing.send_ns /= sends;
+  timing.mean_ns =
+      std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / values.size();
+  return timing;
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+  std::mt19937 rng(1);
+  std::normal_distribution<float> normal(50.0f, 10.0f);
+  std::vector<float> values(n);
+  for (auto &v : values)
+    v = normal(rng);
+
+  struct Case {
+    const char *name;
+    size_t window_size, send_every, send_first_at;
+  };
+  const Case cases[] = {
+      {"window 5, every 1", 5, 1, 1},
+      {"window 150, every 1", 150, 1, 1},
+      {"window 150, every 60 (airspeed.yaml)", 150, 60, 60},
+      {"window 600, every 1", 600, 1, 1},
+      {"window 600, every 60 (spl.yaml)", 600, 60, 30},
+      {"window 2000, every 1", 2000, 1, 1},
+  };
+  printf("%zu values per case, ns per value\n%-38s %10s %10s %10s %10s\n", n, "median", "stock mean",
+         "stream mean", "stock send", "stream send");
+  for (const auto &c : cases) {
+    sensor::MedianFilter stock(c.window_size, c.send_every, c.send_first_at);
+    streaming_quantile::StreamingMedianFilter streaming(c.window_size, c.send_every, c.send_first_at);
+    Timing stock_ns = run(stock, values);
+    Timing streaming_ns = run(streaming, values);
+    printf("%-38s %10.1f %10.1f %10.0f %10.0f\n", c.name, stock_ns.mean_ns, streaming_ns.mean_ns, stock_ns.send_ns,
+           streaming_ns.send_ns);
+  }
+  return 0;
+}
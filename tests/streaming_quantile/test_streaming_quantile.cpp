@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "esphome/components/sensor/filter.h"
+#include "esphome/components/streaming_quantile/order_statistics.h"
+#include "esphome/components/streaming_quantile/streaming_quantile.h"
+
+namespace esphome::streaming_quantile::testing {
+namespace {
+
+// Values from a small set, so the window holds many duplicates, with nan_fraction NaN and
+// occasional runs of NaN longer than small windows
+std::vector<float> test_values(size_t n, double nan_fraction, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> level(0, 40);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<float> values(n);
+  for (size_t i = 0; i < n; i++)
+    values[i] = uniform(rng) < nan_fraction ? NAN : level(rng) * 0.25f - 3.0f;
+  for (size_t start = n / 3; start < n && start < n / 3 + 20; start++)
+    values[start] = NAN;
+  return values;
+}
+
+// The window as the stock filters see it: the last capacity values without NaN, sorted
+std::vector<float> sorted_window(const std::vector<float> &values, size_t end, size_t capacity) {
+  std::vector<float> window;
+  for (size_t i = end > capacity ? end - capacity : 0; i < end; i++) {
+    if (!std::isnan(values[i]))
+      window.push_back(values[i]);
+  }
+  std::sort(window.begin(), window.end());
+  return window;
+}
+
+class WindowTest : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(WindowTest, RanksMatchSortedCopy) {
+  const size_t capacity = GetParam();
+  std::vector<float> values = test_values(20000, 0.05, capacity);
+  OrderStatisticWindow window(capacity);
+  for (size_t i = 0; i < values.size(); i++) {
+    window.push(values[i]);
+    std::vector<float> expected = sorted_window(values, i + 1, capacity);
+    ASSERT_EQ(window.size(), expected.size()) << "after " << i + 1;
+    ASSERT_EQ(window.count(), std::min(i + 1, capacity));
+    // every rank now and then, the extremes and the middle otherwise
+    if (i % 97 == 0) {
+      for (size_t rank = 0; rank < expected.size(); rank++)
+        ASSERT_EQ(window.at(rank), expected[rank]) << "rank " << rank << " after " << i + 1;
+    } else if (!expected.empty()) {
+      for (size_t rank : {size_t(0), expected.size() / 2, expected.size() - 1})
+        ASSERT_EQ(window.at(rank), expected[rank]) << "rank " << rank << " after " << i + 1;
+    }
+  }
+}
+
+// Pushing the values in FIFO order into an empty window rebuilds it, as a checkpoint restore does
+TEST_P(WindowTest, RebuildsFromFifoOrder) {
+  const size_t capacity = GetParam();
+  std::vector<float> values = test_values(3 * capacity + 7, 0.1, 7);
+  OrderStatisticWindow window(capacity);
+  for (float v : values)
+    window.push(v);
+  OrderStatisticWindow rebuilt(capacity);
+  for (size_t i = 0; i < window.count(); i++) {
+    float v = window.value(i);
+    float expected = values[values.size() - window.count() + i];
+    ASSERT_TRUE(v == expected || (std::isnan(v) && std::isnan(expected))) << i;
+    rebuilt.push(v);
+  }
+  ASSERT_EQ(rebuilt.size(), window.size());
+  for (size_t rank = 0; rank < window.size(); rank++)
+    ASSERT_EQ(rebuilt.at(rank), window.at(rank)) << rank;
+}
+
+INSTANTIATE_TEST_SUITE_P(Capacities, WindowTest, ::testing::Values(1, 2, 3, 5, 64, 150, 600, 2000));
+
+TEST(Window, MaxCapacity) {
+  const size_t capacity = OrderStatisticWindow::MAX_CAPACITY;
+  OrderStatisticWindow window(capacity);
+  for (size_t i = 0; i < 2 * capacity; i++)
+    window.push(static_cast<float>((i * 7919) % 100000));
+  std::vector<float> expected;
+  for (size_t i = capacity; i < 2 * capacity; i++)
+    expected.push_back(static_cast<float>((i * 7919) % 100000));
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(window.size(), capacity);
+  for (size_t rank = 0; rank < capacity; rank += 997)
+    ASSERT_EQ(window.at(rank), expected[rank]) << rank;
+  EXPECT_EQ(window.at(capacity - 1), expected.back());
+}
+
+struct FilterCase {
+  const char *name;
+  size_t window_size, send_every, send_first_at;
+  float quantile;  // NAN for the median
+};
+
+class FilterTest : public ::testing::TestWithParam<FilterCase> {};
+
+// The streaming filters send the same values at the same inputs as the stock filters
+TEST_P(FilterTest, MatchesStockFilter) {
+  const FilterCase &c = GetParam();
+  std::unique_ptr<sensor::Filter> stock, streaming;
+  if (std::isnan(c.quantile)) {
+    stock = std::make_unique<sensor::MedianFilter>(c.window_size, c.send_every, c.send_first_at);
+    streaming = std::make_unique<StreamingMedianFilter>(c.window_size, c.send_every, c.send_first_at);
+  } else {
+    stock = std::make_unique<sensor::QuantileFilter>(c.window_size, c.send_every, c.send_first_at, c.quantile);
+    streaming = std::make_unique<StreamingQuantileFilter>(c.window_size, c.send_every, c.send_first_at, c.quantile);
+  }
+  size_t sent = 0;
+  for (float value : test_values(10 * c.window_size + 500, 0.05, 3)) {
+    optional<float> expected = stock->new_value(value), actual = streaming->new_value(value);
+    ASSERT_EQ(actual.has_value(), expected.has_value()) << "value " << sent;
+    if (expected.has_value()) {
+      ASSERT_TRUE(*actual == *expected || (std::isnan(*actual) && std::isnan(*expected)))
+          << *actual << " != " << *expected << " at send " << sent;
+      sent++;
+    }
+  }
+  EXPECT_GT(sent, 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Configs, FilterTest,
+    ::testing::Values(FilterCase{"median_defaults", 5, 5, 1, NAN}, FilterCase{"airspeed_yaml", 150, 60, 60, NAN},
+                      FilterCase{"spl_yaml", 600, 60, 30, NAN}, FilterCase{"median_even_every", 4, 1, 1, NAN},
+                      FilterCase{"quantile_defaults", 5, 5, 1, 0.9f}, FilterCase{"quantile_0", 50, 1, 1, 0.0f},
+                      FilterCase{"quantile_10", 50, 3, 2, 0.1f}, FilterCase{"quantile_1", 50, 1, 1, 1.0f}),
+    [](const ::testing::TestParamInfo<FilterCase> &info) { return std::string(info.param.name); });
+
+}  // namespace
+}  // namespace esphome::streaming_quantile::testing
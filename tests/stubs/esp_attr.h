@@ -0,0 +1,10 @@
+#pragma once
+
+// Host stand-in for ESP-IDF's esp_attr.h: placement attributes are plain statics, so RTC memory
+// keeps its content for the life of the process, across the components a test creates.
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
@@ -0,0 +1,7 @@
+#pragma once
+
+// Host stand-in for ESP-IDF's esp_crt_bundle.h; the host client does no TLS.
+
+#include "esp_err.h"
+
+inline esp_err_t esp_crt_bundle_attach(void *conf) { return ESP_OK; }
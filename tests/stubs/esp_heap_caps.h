@@ -0,0 +1,47 @@
+#pragma once
+
+// Host stand-in for ESP-IDF's esp_heap_caps.h: the heap figures of internal RAM and PSRAM are
+// numbers a test sets and moves with host::heap_take()/heap_give(); nothing is allocated. PSRAM
+// starts absent (total 0).
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+namespace esphome::host {
+
+struct Heap {
+  size_t total;
+  size_t free;
+  size_t minimum_free;
+  size_t largest_block;
+};
+
+inline Heap &heap(uint32_t caps) {
+  static Heap internal{320 * 1024, 200 * 1024, 180 * 1024, 110 * 1024};
+  static Heap spiram{0, 0, 0, 0};
+  return (caps & MALLOC_CAP_SPIRAM) != 0 ? spiram : internal;
+}
+
+inline void heap_take(size_t bytes, uint32_t caps = MALLOC_CAP_INTERNAL) {
+  Heap &h = heap(caps);
+  h.free -= std::min(bytes, h.free);
+  h.minimum_free = std::min(h.minimum_free, h.free);
+  h.largest_block = std::min(h.largest_block, h.free);
+}
+
+inline void heap_give(size_t bytes, uint32_t caps = MALLOC_CAP_INTERNAL) {
+  Heap &h = heap(caps);
+  h.free = std::min(h.total, h.free + bytes);
+}
+
+}  // namespace esphome::host
+
+inline size_t heap_caps_get_total_size(uint32_t caps) { return esphome::host::heap(caps).total; }
+inline size_t heap_caps_get_free_size(uint32_t caps) { return esphome::host::heap(caps).free; }
+inline size_t heap_caps_get_minimum_free_size(uint32_t caps) { return esphome::host::heap(caps).minimum_free; }
+inline size_t heap_caps_get_largest_free_block(uint32_t caps) { return esphome::host::heap(caps).largest_block; }
@@ -0,0 +1,106 @@
+#include "esp_http_client.h"
+
+#include <strings.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "esphome/core/hal.h"
+
+struct esp_http_client {
+  esphome::host::HttpRequest request;
+  int timeout_ms{5000};
+  int write_len{0};
+  bool open{false};
+  int status{-1};
+  std::string response;
+  size_t read_pos{0};
+};
+
+namespace esphome::host {
+
+static HttpServer *server = nullptr;
+
+void set_http_server(HttpServer *http_server) { server = http_server; }
+
+std::string HttpRequest::header(const std::string &name) const {
+  for (auto it = this->headers.rbegin(); it != this->headers.rend(); ++it) {
+    if (strcasecmp(it->first.c_str(), name.c_str()) == 0)
+      return it->second;
+  }
+  return "";
+}
+
+}  // namespace esphome::host
+
+using esphome::host::server;
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config) {
+  if (config == nullptr || config->url == nullptr)
+    return nullptr;
+  auto *client = new esp_http_client;
+  client->request.url = config->url;
+  client->request.method = config->method;
+  if (config->timeout_ms > 0)
+    client->timeout_ms = config->timeout_ms;
+  return client;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value) {
+  client->request.headers.emplace_back(key, value);
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len) {
+  if (server == nullptr)
+    return ESP_ERR_HTTP_CONNECT;
+  esp_err_t err = server->connect(client->request.url);
+  if (err != ESP_OK)
+    return err;
+  client->open = true;
+  client->write_len = write_len;
+  client->request.body.clear();
+  return ESP_OK;
+}
+
+int esp_http_client_write(esp_http_client_handle_t client, const char *buffer, int len) {
+  if (!client->open)
+    return -1;
+  client->request.body.append(buffer, len);
+  return len;
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client) {
+  if (!client->open || static_cast<int>(client->request.body.size()) != client->write_len)
+    return ESP_FAIL;
+  esphome::host::HttpResponse response = server->handle(client->request);
+  uint64_t timeout_us = uint64_t(client->timeout_ms) * 1000;
+  if (response.latency_us > timeout_us) {
+    esphome::delayMicroseconds(timeout_us);
+    return -ESP_ERR_HTTP_FETCH_HEADER;
+  }
+  esphome::delayMicroseconds(response.latency_us);
+  client->status = response.status;
+  client->response = std::move(response.body);
+  client->read_pos = 0;
+  return client->response.size();
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client) { return client->status; }
+
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len) {
+  size_t n = std::min<size_t>(len, client->response.size() - client->read_pos);
+  std::memcpy(buffer, client->response.data() + client->read_pos, n);
+  client->read_pos += n;
+  return n;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client) {
+  client->open = false;
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client) {
+  delete client;
+  return ESP_OK;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// Host stand-in for ESP-IDF's esp_http_client.h. Requests go to the host::HttpServer a test
+// installs rather than over a socket: the client collects the headers and body, the server answers
+// once the body is written, and its response latency is spent on the host clock (so with the fake
+// clock a slow server costs no real time). A response slower than the client's timeout_ms fails
+// like a timed-out read, after the server has taken the request.
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esp_err.h"
+
+#define ESP_ERR_HTTP_BASE 0x7000
+#define ESP_ERR_HTTP_CONNECT (ESP_ERR_HTTP_BASE + 3)
+#define ESP_ERR_HTTP_FETCH_HEADER (ESP_ERR_HTTP_BASE + 5)
+
+typedef enum {
+  HTTP_METHOD_GET = 0,
+  HTTP_METHOD_POST,
+  HTTP_METHOD_PUT,
+  HTTP_METHOD_PATCH,
+  HTTP_METHOD_DELETE,
+} esp_http_client_method_t;
+
+typedef struct {
+  const char *url;
+  esp_http_client_method_t method;
+  int timeout_ms;
+  bool keep_alive_enable;
+  esp_err_t (*crt_bundle_attach)(void *conf);
+} esp_http_client_config_t;
+
+typedef struct esp_http_client *esp_http_client_handle_t;
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config);
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value);
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len);
+int esp_http_client_write(esp_http_client_handle_t client, const char *buffer, int len);
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client);
+int esp_http_client_get_status_code(esp_http_client_handle_t client);
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len);
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+
+namespace esphome::host {
+
+struct HttpRequest {
+  std::string url;
+  esp_http_client_method_t method;
+  std::vector<std::pair<std::string, std::string>> headers;  // as set, last value wins
+  std::string body;
+
+  // Value of the header (case insensitive), empty if not set
+  std::string header(const std::string &name) const;
+};
+
+struct HttpResponse {
+  int status{204};
+  std::string body;
+  uint32_t latency_us{0};  // from the end of the request body to the response headers
+};
+
+class HttpServer {
+ public:
+  virtual ~HttpServer() = default;
+  // A connection to url, before any request data; an error fails esp_http_client_open()
+  virtual esp_err_t connect(const std::string &url) { return ESP_OK; }
+  virtual HttpResponse handle(const HttpRequest &request) = 0;
+};
+
+// Server behind every URL; without one, connections fail
+void set_http_server(HttpServer *server);
+
+}  // namespace esphome::host
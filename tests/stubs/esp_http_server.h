@@ -0,0 +1,68 @@
+#pragma once
+
+// Host stand-in for ESP-IDF's esp_http_server.h. A request collects what the handler sends, and
+// can be made to fail after a number of chunks, like a client going away.
+
+#include <cstddef>
+#include <string>
+#include <sys/types.h>
+
+#include "esp_err.h"
+
+#define HTTPD_RESP_USE_STRLEN -1
+
+enum http_method {
+  HTTP_DELETE = 0,
+  HTTP_GET = 1,
+  HTTP_HEAD = 2,
+  HTTP_POST = 3,
+  HTTP_PUT = 4,
+};
+
+struct httpd_req {
+  int method{HTTP_GET};
+  std::string uri;
+
+  // --- What the handler sent ---
+  std::string status{"200 OK"};
+  std::string content_type{"text/html"};
+  std::string body;
+  size_t chunks{0};
+  bool finished{false};
+  // chunks accepted before httpd_resp_send_chunk() fails, -1 for no limit
+  long chunk_limit{-1};
+};
+typedef struct httpd_req httpd_req_t;
+
+inline esp_err_t httpd_resp_set_type(httpd_req_t *req, const char *type) {
+  req->content_type = type;
+  return ESP_OK;
+}
+
+inline esp_err_t httpd_resp_set_status(httpd_req_t *req, const char *status) {
+  req->status = status;
+  return ESP_OK;
+}
+
+inline esp_err_t httpd_resp_send(httpd_req_t *req, const char *buf, ssize_t buf_len) {
+  if (buf == nullptr)
+    req->body.clear();
+  else
+    req->body.assign(buf, buf_len == HTTPD_RESP_USE_STRLEN ? std::char_traits<char>::length(buf) : buf_len);
+  req->finished = true;
+  return ESP_OK;
+}
+
+inline esp_err_t httpd_resp_send_chunk(httpd_req_t *req, const char *buf, ssize_t buf_len) {
+  if (req->chunk_limit >= 0 && req->chunks >= static_cast<size_t>(req->chunk_limit))
+    return ESP_FAIL;
+  if (buf == nullptr || buf_len == 0) {
+    req->finished = true;
+    return ESP_OK;
+  }
+  if (buf_len == HTTPD_RESP_USE_STRLEN)
+    buf_len = std::char_traits<char>::length(buf);
+  req->body.append(buf, buf_len);
+  req->chunks++;
+  return ESP_OK;
+}
@@ -0,0 +1,125 @@
+#include "esp_partition.h"
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <memory>
+
+namespace esphome {
+namespace host {
+
+namespace {
+
+struct Partition {
+  esp_partition_t info;
+  std::vector<uint8_t> data;
+  PartitionStats stats;
+};
+
+std::list<Partition> partitions;
+unsigned write_failures = 0;
+
+Partition *find(const esp_partition_t *partition) {
+  for (auto &p : partitions) {
+    if (&p.info == partition)
+      return &p;
+  }
+  return nullptr;
+}
+
+bool fail_write() {
+  if (write_failures == 0)
+    return false;
+  write_failures--;
+  return true;
+}
+
+}  // namespace
+
+const esp_partition_t *add_partition(const char *label, uint32_t size, esp_partition_type_t type,
+                                     esp_partition_subtype_t subtype) {
+  partitions.remove_if([label](const Partition &p) { return strcmp(p.info.label, label) == 0; });
+  uint32_t address = 0x10000;
+  for (auto &p : partitions)
+    address = std::max(address, p.info.address + p.info.size);
+  Partition &p = partitions.emplace_back();
+  p.info = esp_partition_t{type, subtype, address, size, SPI_FLASH_SEC_SIZE, {}, false};
+  strncpy(p.info.label, label, sizeof(p.info.label) - 1);
+  p.data.assign(size, 0xFF);
+  return &p.info;
+}
+
+void remove_partitions() {
+  partitions.clear();
+  write_failures = 0;
+}
+
+std::vector<uint8_t> &partition_data(const esp_partition_t *partition) { return find(partition)->data; }
+
+PartitionStats &partition_stats(const esp_partition_t *partition) { return find(partition)->stats; }
+
+void fail_partition_writes(unsigned failures) { write_failures = failures; }
+
+}  // namespace host
+}  // namespace esphome
+
+using esphome::host::Partition;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label) {
+  for (auto &p : esphome::host::partitions) {
+    if (type != ESP_PARTITION_TYPE_ANY && p.info.type != type)
+      continue;
+    if (subtype != ESP_PARTITION_SUBTYPE_ANY && p.info.subtype != subtype)
+      continue;
+    if (label != nullptr && strcmp(p.info.label, label) != 0)
+      continue;
+    return &p.info;
+  }
+  return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size) {
+  Partition *p = esphome::host::find(partition);
+  if (p == nullptr || dst == nullptr)
+    return ESP_ERR_INVALID_ARG;
+  if (src_offset > p->data.size() || size > p->data.size() - src_offset)
+    return ESP_ERR_INVALID_SIZE;
+  std::memcpy(dst, p->data.data() + src_offset, size);
+  p->stats.bytes_read += size;
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size) {
+  Partition *p = esphome::host::find(partition);
+  if (p == nullptr || src == nullptr)
+    return ESP_ERR_INVALID_ARG;
+  if (dst_offset > p->data.size() || size > p->data.size() - dst_offset)
+    return ESP_ERR_INVALID_SIZE;
+  if (esphome::host::fail_write()) {
+    // half of it made it to flash
+    size /= 2;
+    for (size_t i = 0; i < size; i++)
+      p->data[dst_offset + i] &= static_cast<const uint8_t *>(src)[i];
+    return ESP_FAIL;
+  }
+  for (size_t i = 0; i < size; i++)
+    p->data[dst_offset + i] &= static_cast<const uint8_t *>(src)[i];
+  p->stats.bytes_written += size;
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size) {
+  Partition *p = esphome::host::find(partition);
+  if (p == nullptr)
+    return ESP_ERR_INVALID_ARG;
+  if (offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0)
+    return ESP_ERR_INVALID_ARG;
+  if (offset > p->data.size() || size > p->data.size() - offset)
+    return ESP_ERR_INVALID_SIZE;
+  if (esphome::host::fail_write())
+    return ESP_FAIL;
+  std::memset(p->data.data() + offset, 0xFF, size);
+  p->stats.sectors_erased += size / SPI_FLASH_SEC_SIZE;
+  return ESP_OK;
+}
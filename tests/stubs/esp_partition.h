@@ -0,0 +1,67 @@
+#pragma once
+
+// Host stand-in for ESP-IDF's esp_partition.h. Partitions are byte arrays in RAM with NOR flash
+// semantics: erase sets whole 4 KiB sectors to 0xFF and a write can only clear bits.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "esp_err.h"
+
+#define SPI_FLASH_SEC_SIZE 4096
+
+typedef enum {
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+  ESP_PARTITION_TYPE_ANY = 0xff,
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_APP_FACTORY = 0x00,
+  ESP_PARTITION_SUBTYPE_APP_OTA_0 = 0x10,
+  ESP_PARTITION_SUBTYPE_APP_OTA_1 = 0x11,
+  ESP_PARTITION_SUBTYPE_DATA_OTA = 0x00,
+  ESP_PARTITION_SUBTYPE_DATA_NVS = 0x02,
+  ESP_PARTITION_SUBTYPE_DATA_UNDEFINED = 0x06,
+  ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  uint32_t erase_size;
+  char label[17];
+  bool encrypted;
+} esp_partition_t;
+
+// By label, or the first of the type and subtype when label is nullptr
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size);
+
+namespace esphome {
+namespace host {
+
+struct PartitionStats {
+  size_t bytes_read{0};
+  size_t bytes_written{0};
+  size_t sectors_erased{0};
+};
+
+// Adds an erased partition; the previous one with the same label is replaced
+const esp_partition_t *add_partition(const char *label, uint32_t size,
+                                     esp_partition_type_t type = ESP_PARTITION_TYPE_DATA,
+                                     esp_partition_subtype_t subtype = ESP_PARTITION_SUBTYPE_DATA_UNDEFINED);
+void remove_partitions();
+std::vector<uint8_t> &partition_data(const esp_partition_t *partition);
+PartitionStats &partition_stats(const esp_partition_t *partition);
+// Makes the next failures write or erase calls fail, e.g. to test a torn write
+void fail_partition_writes(unsigned failures);
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,19 @@
+#pragma once
+
+// Host stand-in for ESP-IDF's esp_random.h: a seeded generator per thread, so runs are reproducible
+// and threads simulating devices side by side draw independently.
+
+#include <cstdint>
+#include <random>
+
+namespace esphome::host {
+
+inline std::mt19937 &random_engine() {
+  static thread_local std::mt19937 engine(1);
+  return engine;
+}
+inline void seed_random(uint32_t seed) { random_engine().seed(seed); }
+
+}  // namespace esphome::host
+
+inline uint32_t esp_random() { return esphome::host::random_engine()(); }
@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for ESP-IDF's esp_rom_crc.h: the ROM's little endian CRC-32, which chains like
+// zlib's crc32() when started from 0.
+
+#include <cstddef>
+#include <cstdint>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+  }
+  return ~crc;
+}
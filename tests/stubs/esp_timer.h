@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+
+inline int64_t esp_timer_get_time() { return esphome::host::clock_us(); }
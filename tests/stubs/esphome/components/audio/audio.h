@@ -0,0 +1,50 @@
+#pragma once
+
+// Host stand-in for the audio stream description and sample unpacking of
+// esphome/components/audio/audio.h.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace audio {
+
+class AudioStreamInfo {
+ public:
+  AudioStreamInfo() : AudioStreamInfo(16, 1, 16000) {}
+  AudioStreamInfo(uint8_t bits_per_sample, uint8_t channels, uint32_t sample_rate)
+      : bits_per_sample_(bits_per_sample), channels_(channels), sample_rate_(sample_rate) {}
+
+  uint8_t get_bits_per_sample() const { return this->bits_per_sample_; }
+  uint8_t get_channels() const { return this->channels_; }
+  uint32_t get_sample_rate() const { return this->sample_rate_; }
+  size_t samples_to_bytes(uint32_t samples) const { return samples * (this->bits_per_sample_ / 8); }
+  size_t frames_to_bytes(uint32_t frames) const { return frames * this->channels_ * (this->bits_per_sample_ / 8); }
+  uint32_t bytes_to_frames(size_t bytes) const { return bytes / this->frames_to_bytes(1); }
+  uint32_t frames_to_milliseconds_with_remainder(uint32_t *frames) const {
+    uint32_t ms = *frames * 1000 / this->sample_rate_;
+    *frames -= ms * this->sample_rate_ / 1000;
+    return ms;
+  }
+
+ protected:
+  uint8_t bits_per_sample_;
+  uint8_t channels_;
+  uint32_t sample_rate_;
+};
+
+// Little endian sample of 1 to 4 bytes as Q31
+inline int32_t unpack_audio_sample_to_q31(const uint8_t *data, size_t bytes_per_sample) {
+  uint32_t sample = 0;
+  for (size_t b = 0; b < bytes_per_sample; b++)
+    sample |= uint32_t(data[b]) << (8 * (4 - bytes_per_sample + b));
+  return static_cast<int32_t>(sample);
+}
+
+inline void pack_q31_as_audio_sample(int32_t sample, uint8_t *data, size_t bytes_per_sample) {
+  for (size_t b = 0; b < bytes_per_sample; b++)
+    data[b] = uint32_t(sample) >> (8 * (4 - bytes_per_sample + b));
+}
+
+}  // namespace audio
+}  // namespace esphome
@@ -0,0 +1,21 @@
+#pragma once
+
+// Host stand-in for esphome/components/http_request/http_request.h: the components only use its
+// header type and the component as a dependency, and post through esp_http_client themselves.
+
+#include <string>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace http_request {
+
+struct Header {
+  std::string name;
+  std::string value;
+};
+
+class HttpRequestComponent : public Component {};
+
+}  // namespace http_request
+}  // namespace esphome
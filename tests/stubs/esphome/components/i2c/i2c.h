@@ -0,0 +1,53 @@
+#pragma once
+
+// Host stand-in for esphome/components/i2c/i2c.h: an I2CDevice talks to whatever I2CBus a test
+// gives it, typically a simulated sensor.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/core/log.h"
+
+#define LOG_I2C_DEVICE(this) ESP_LOGCONFIG(TAG, "  Address: 0x%02X", this->address_);
+
+namespace esphome {
+namespace i2c {
+
+enum ErrorCode {
+  NO_ERROR = 0,
+  ERROR_OK = 0,
+  ERROR_INVALID_ARGUMENT = 1,
+  ERROR_NOT_ACKNOWLEDGED = 2,
+  ERROR_TIMEOUT = 3,
+  ERROR_NOT_INITIALIZED = 4,
+  ERROR_TOO_LARGE = 5,
+  ERROR_UNKNOWN = 6,
+  ERROR_CRC = 7,
+};
+
+class I2CBus {
+ public:
+  virtual ~I2CBus() = default;
+  virtual ErrorCode read(uint8_t address, uint8_t *data, size_t len) = 0;
+  virtual ErrorCode write(uint8_t address, const uint8_t *data, size_t len, bool stop) = 0;
+};
+
+class I2CDevice {
+ public:
+  void set_i2c_address(uint8_t address) { this->address_ = address; }
+  void set_i2c_bus(I2CBus *bus) { this->bus_ = bus; }
+
+  ErrorCode read(uint8_t *data, size_t len) {
+    return this->bus_ == nullptr ? ERROR_NOT_INITIALIZED : this->bus_->read(this->address_, data, len);
+  }
+  ErrorCode write(const uint8_t *data, size_t len, bool stop = true) {
+    return this->bus_ == nullptr ? ERROR_NOT_INITIALIZED : this->bus_->write(this->address_, data, len, stop);
+  }
+
+ protected:
+  uint8_t address_{0x00};
+  I2CBus *bus_{nullptr};
+};
+
+}  // namespace i2c
+}  // namespace esphome
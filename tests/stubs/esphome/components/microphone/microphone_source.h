@@ -0,0 +1,40 @@
+#pragma once
+
+// Host stand-in for esphome/components/microphone/microphone_source.h. Audio is supplied by the
+// test with inject(), which calls the data callbacks like the I2S task would.
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "esphome/components/audio/audio.h"
+
+namespace esphome {
+namespace microphone {
+
+class MicrophoneSource {
+ public:
+  explicit MicrophoneSource(audio::AudioStreamInfo stream_info) : stream_info_(stream_info) {}
+
+  void add_data_callback(std::function<void(const std::vector<uint8_t> &)> &&data_callback) {
+    this->callbacks_.push_back(std::move(data_callback));
+  }
+  audio::AudioStreamInfo get_audio_stream_info() const { return this->stream_info_; }
+  void start() { this->running_ = true; }
+  void stop() { this->running_ = false; }
+  bool is_running() const { return this->running_; }
+
+  // interleaved little endian samples in the stream format
+  void inject(const std::vector<uint8_t> &data) {
+    for (auto &callback : this->callbacks_)
+      callback(data);
+  }
+
+ protected:
+  audio::AudioStreamInfo stream_info_;
+  std::vector<std::function<void(const std::vector<uint8_t> &)>> callbacks_;
+  bool running_{false};
+};
+
+}  // namespace microphone
+}  // namespace esphome
@@ -0,0 +1,88 @@
+#pragma once
+
+// Host stand-in for esphome/components/sensor/filter.h: the Filter interface and the stock median
+// and quantile filters, which copy and sort their window every time they send.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+
+#include "esphome/core/optional.h"
+
+namespace esphome {
+namespace sensor {
+
+class Filter {
+ public:
+  virtual ~Filter() = default;
+  virtual optional<float> new_value(float value) = 0;
+};
+
+class QuantileFilter : public Filter {
+ public:
+  QuantileFilter(size_t window_size, size_t send_every, size_t send_first_at, float quantile)
+      : send_every_(send_every), send_at_(send_every - send_first_at), window_size_(window_size), quantile_(quantile) {}
+
+  optional<float> new_value(float value) override {
+    while (this->queue_.size() >= this->window_size_)
+      this->queue_.pop_front();
+    this->queue_.push_back(value);
+    if (++this->send_at_ >= this->send_every_) {
+      this->send_at_ = 0;
+      float result = NAN;
+      std::deque<float> copy = this->sorted_();
+      if (!copy.empty()) {
+        size_t position = std::ceil(copy.size() * this->quantile_);
+        if (position)
+          --position;
+        result = copy[position];
+      }
+      return result;
+    }
+    return {};
+  }
+
+ protected:
+  std::deque<float> sorted_() const {
+    std::deque<float> copy = this->queue_;
+    copy.erase(std::remove_if(copy.begin(), copy.end(), [](float v) { return std::isnan(v); }), copy.end());
+    std::sort(copy.begin(), copy.end());
+    return copy;
+  }
+
+  std::deque<float> queue_;
+  size_t send_every_;
+  size_t send_at_;
+  size_t window_size_;
+  float quantile_;
+};
+
+class MedianFilter : public QuantileFilter {
+ public:
+  MedianFilter(size_t window_size, size_t send_every, size_t send_first_at)
+      : QuantileFilter(window_size, send_every, send_first_at, 0.5f) {}
+
+  optional<float> new_value(float value) override {
+    while (this->queue_.size() >= this->window_size_)
+      this->queue_.pop_front();
+    this->queue_.push_back(value);
+    if (++this->send_at_ >= this->send_every_) {
+      this->send_at_ = 0;
+      float median = NAN;
+      std::deque<float> copy = this->sorted_();
+      size_t size = copy.size();
+      if (size) {
+        if (size % 2)
+          median = copy[size / 2];
+        else
+          median = (copy[size / 2] + copy[(size / 2) - 1]) / 2.0f;
+      }
+      return median;
+    }
+    return {};
+  }
+};
+
+}  // namespace sensor
+}  // namespace esphome
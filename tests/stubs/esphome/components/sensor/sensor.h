@@ -0,0 +1,56 @@
+#pragma once
+
+// Host stand-in for esphome/components/sensor/sensor.h without filters: publish_state() sets
+// both the raw and the filtered state.
+
+#include <cmath>
+#include <functional>
+#include <string>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#define LOG_SENSOR(prefix, type, obj) \
+  if ((obj) != nullptr) { \
+    ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name().c_str()); \
+  }
+
+namespace esphome {
+namespace sensor {
+
+class Sensor : public EntityBase {
+ public:
+  void publish_state(float state) {
+    this->raw_state = state;
+    this->raw_callback_.call(state);
+    this->state = state;
+    this->has_state_ = true;
+    this->callback_.call(state);
+  }
+  float get_state() const { return this->state; }
+  float get_raw_state() const { return this->raw_state; }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(float)> &&callback) { this->callback_.add(std::move(callback)); }
+  void add_on_raw_state_callback(std::function<void(float)> &&callback) {
+    this->raw_callback_.add(std::move(callback));
+  }
+
+  const std::string &get_unit_of_measurement() const { return this->unit_of_measurement_; }
+  void set_unit_of_measurement(const std::string &unit) { this->unit_of_measurement_ = unit; }
+  int8_t get_accuracy_decimals() const { return this->accuracy_decimals_; }
+  void set_accuracy_decimals(int8_t accuracy_decimals) { this->accuracy_decimals_ = accuracy_decimals; }
+
+  float state{NAN};
+  float raw_state{NAN};
+
+ protected:
+  CallbackManager<void(float)> callback_;
+  CallbackManager<void(float)> raw_callback_;
+  bool has_state_{false};
+  std::string unit_of_measurement_;
+  int8_t accuracy_decimals_{-1};
+};
+
+}  // namespace sensor
+}  // namespace esphome
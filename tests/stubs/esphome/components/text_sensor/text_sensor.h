@@ -0,0 +1,32 @@
+#pragma once
+
+// Host stand-in for esphome/components/text_sensor/text_sensor.h without filters.
+
+#include <functional>
+#include <string>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor : public EntityBase {
+ public:
+  void publish_state(const std::string &state) {
+    this->state = state;
+    this->has_state_ = true;
+    this->callback_.call(state);
+  }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(std::string)> &&callback) { this->callback_.add(std::move(callback)); }
+
+  std::string state;
+
+ protected:
+  CallbackManager<void(std::string)> callback_;
+  bool has_state_{false};
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
@@ -0,0 +1,31 @@
+#pragma once
+
+// Host stand-in for esphome/components/time/real_time_clock.h: the time is set by the test.
+
+#include <ctime>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+struct ESPTime {
+  time_t timestamp{0};
+  bool is_valid() const { return this->timestamp >= 1546300800; }  // 2019-01-01, as ESPHome checks
+};
+
+namespace time {
+
+class RealTimeClock : public PollingComponent {
+ public:
+  ESPTime now() { return ESPTime{this->timestamp_}; }
+  void update() override {}
+
+  // --- Host ---
+  void set_epoch(time_t timestamp) { this->timestamp_ = timestamp; }
+
+ protected:
+  time_t timestamp_{0};
+};
+
+}  // namespace time
+}  // namespace esphome
@@ -0,0 +1,112 @@
+#pragma once
+
+// Host stand-in for esphome/components/web_server_base/web_server_base.h on ESP-IDF: requests wrap
+// an httpd_req_t, and WebServerBase::handle() dispatches one to the first handler that takes it.
+
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <esp_http_server.h>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+class AsyncWebServerRequest {
+ public:
+  // url may carry a query string, e.g. "/archive?from=10&sensor=a,b"
+  explicit AsyncWebServerRequest(const std::string &url, http_method method = HTTP_GET) {
+    this->req_.method = method;
+    this->req_.uri = url;
+    size_t query = url.find('?');
+    this->url_ = url.substr(0, query);
+    if (query == std::string::npos)
+      return;
+    size_t start = query + 1;
+    while (start <= url.size()) {
+      size_t end = url.find('&', start);
+      if (end == std::string::npos)
+        end = url.size();
+      std::string param = url.substr(start, end - start);
+      size_t equals = param.find('=');
+      if (!param.empty())
+        this->params_.emplace_back(param.substr(0, equals), equals == std::string::npos ? "" : param.substr(equals + 1));
+      start = end + 1;
+    }
+  }
+
+  http_method method() const { return static_cast<http_method>(this->req_.method); }
+  std::string url() const { return this->url_; }
+  bool hasParam(const std::string &name) const {
+    for (const auto &param : this->params_) {
+      if (param.first == name)
+        return true;
+    }
+    return false;
+  }
+  std::string arg(const std::string &name) const {
+    for (const auto &param : this->params_) {
+      if (param.first == name)
+        return param.second;
+    }
+    return "";
+  }
+
+  void send(int code, const char *content_type = nullptr, const char *content = nullptr) {
+    this->code_ = code;
+    this->req_.status = std::to_string(code);
+    if (content_type != nullptr)
+      this->req_.content_type = content_type;
+    httpd_resp_send(&this->req_, content, HTTPD_RESP_USE_STRLEN);
+  }
+
+  operator httpd_req_t *() { return &this->req_; }
+
+  // --- Host ---
+  // status code given to send(), 200 for responses sent through the httpd_req_t
+  int code() const { return this->code_; }
+  httpd_req_t &req() { return this->req_; }
+
+ protected:
+  httpd_req_t req_;
+  std::string url_;
+  std::vector<std::pair<std::string, std::string>> params_;
+  int code_{200};
+};
+
+class AsyncWebHandler {
+ public:
+  virtual ~AsyncWebHandler() = default;
+  virtual bool canHandle(AsyncWebServerRequest *request) const { return false; }
+  virtual void handleRequest(AsyncWebServerRequest *request) {}
+};
+
+namespace web_server_base {
+
+class WebServerBase : public Component {
+ public:
+  void init() { this->initialized_++; }
+  void add_handler(AsyncWebHandler *handler) { this->handlers_.push_back(handler); }
+
+  // --- Host ---
+  // false, with a 404, if no handler takes the request
+  bool handle(AsyncWebServerRequest *request) {
+    for (auto *handler : this->handlers_) {
+      if (handler->canHandle(request)) {
+        handler->handleRequest(request);
+        return true;
+      }
+    }
+    request->send(404);
+    return false;
+  }
+
+ protected:
+  std::vector<AsyncWebHandler *> handlers_;
+  int initialized_{0};
+};
+
+}  // namespace web_server_base
+}  // namespace esphome
@@ -0,0 +1,7 @@
+#include "esphome/core/application.h"
+
+namespace esphome {
+
+Application App;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace esphome
@@ -0,0 +1,37 @@
+#pragma once
+
+// Host stand-in for esphome/core/application.h: the entity registry the components look sensors up
+// in. Tests register their entities, and clear() between cases.
+
+#include <string>
+#include <vector>
+
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+class Application {
+ public:
+  void register_sensor(sensor::Sensor *sensor) { this->sensors_.push_back(sensor); }
+  void register_text_sensor(text_sensor::TextSensor *text_sensor) { this->text_sensors_.push_back(text_sensor); }
+  const std::vector<sensor::Sensor *> &get_sensors() { return this->sensors_; }
+  const std::vector<text_sensor::TextSensor *> &get_text_sensors() { return this->text_sensors_; }
+  const std::string &get_name() const { return this->name_; }
+
+  // host only
+  void clear() {
+    this->sensors_.clear();
+    this->text_sensors_.clear();
+  }
+
+ protected:
+  std::vector<sensor::Sensor *> sensors_;
+  std::vector<text_sensor::TextSensor *> text_sensors_;
+  std::string name_{"samba"};
+};
+
+extern Application App;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace esphome
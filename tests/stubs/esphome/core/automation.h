@@ -0,0 +1,61 @@
+#pragma once
+
+// Host stand-in for esphome/core/automation.h: triggers call the actions added to them directly.
+
+#include <functional>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/optional.h"
+
+namespace esphome {
+
+template<typename T, typename... X> class TemplatableValue {
+ public:
+  TemplatableValue() = default;
+  TemplatableValue(T value) : value_(value), has_value_(true) {}
+  TemplatableValue(std::function<T(X...)> f) : f_(std::move(f)), has_value_(true) {}
+
+  bool has_value() const { return this->has_value_; }
+  T value(X... x) const { return this->f_ ? this->f_(x...) : this->value_; }
+
+ protected:
+  T value_{};
+  std::function<T(X...)> f_;
+  bool has_value_{false};
+};
+
+#define TEMPLATABLE_VALUE(type, name) \
+ protected: \
+  TemplatableValue<type, Ts...> name##_{}; \
+\
+ public: \
+  template<typename V> void set_##name(V name) { this->name##_ = name; }
+
+template<typename... Ts> class Action {
+ public:
+  virtual ~Action() = default;
+  virtual void play(Ts... x) = 0;
+};
+
+template<typename... Ts> class Condition {
+ public:
+  virtual ~Condition() = default;
+  virtual bool check(Ts... x) = 0;
+};
+
+template<typename... Ts> class Trigger {
+ public:
+  void trigger(Ts... x) {
+    for (auto &f : this->actions_)
+      f(x...);
+  }
+  // tests observe triggers through this instead of an automation
+  void add_action(std::function<void(Ts...)> &&f) { this->actions_.push_back(std::move(f)); }
+
+ protected:
+  std::vector<std::function<void(Ts...)>> actions_;
+};
+
+}  // namespace esphome
@@ -0,0 +1,138 @@
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace esphome {
+
+namespace {
+
+enum class ItemType { TIMEOUT, INTERVAL };
+
+struct Item {
+  const Component *component;
+  std::string name;  // empty for anonymous items, which are never cancelled
+  ItemType type;
+  uint32_t interval;
+  uint32_t next_ms;
+  std::function<void()> f;
+  bool removed{false};
+};
+
+std::recursive_mutex lock;
+std::vector<std::shared_ptr<Item>> items;
+
+bool cancel(const Component *component, const std::string &name, ItemType type) {
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  bool found = false;
+  for (auto &item : items) {
+    if (!item->removed && item->component == component && item->type == type && item->name == name) {
+      item->removed = true;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void add(const Component *component, const std::string &name, ItemType type, uint32_t delay_ms,
+         std::function<void()> &&f) {
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  if (!name.empty())
+    cancel(component, name, type);
+  if (delay_ms == SCHEDULER_DONT_RUN)
+    return;
+  uint32_t now = millis();
+  auto item = std::make_shared<Item>(Item{component, name, type, delay_ms, 0, std::move(f)});
+  item->next_ms = type == ItemType::INTERVAL ? now : now + delay_ms;
+  items.push_back(std::move(item));
+}
+
+}  // namespace
+
+Component::~Component() {
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  for (auto &item : items) {
+    if (item->component == this)
+      item->removed = true;
+  }
+}
+
+void Component::set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+  add(this, name, ItemType::INTERVAL, interval, std::move(f));
+}
+void Component::set_interval(uint32_t interval, std::function<void()> &&f) {
+  add(this, "", ItemType::INTERVAL, interval, std::move(f));
+}
+bool Component::cancel_interval(const std::string &name) { return cancel(this, name, ItemType::INTERVAL); }
+void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+  add(this, name, ItemType::TIMEOUT, timeout, std::move(f));
+}
+void Component::set_timeout(uint32_t timeout, std::function<void()> &&f) {
+  add(this, "", ItemType::TIMEOUT, timeout, std::move(f));
+}
+bool Component::cancel_timeout(const std::string &name) { return cancel(this, name, ItemType::TIMEOUT); }
+void Component::defer(const std::string &name, std::function<void()> &&f) { this->set_timeout(name, 0, std::move(f)); }
+void Component::defer(std::function<void()> &&f) { this->set_timeout("", 0, std::move(f)); }
+bool Component::cancel_defer(const std::string &name) { return this->cancel_timeout(name); }
+
+void PollingComponent::call_setup() {
+  this->setup();
+  this->start_poller();
+}
+
+void PollingComponent::start_poller() {
+  this->set_interval("update", this->get_update_interval(), [this]() { this->update(); });
+}
+
+void PollingComponent::stop_poller() { this->cancel_interval("update"); }
+
+namespace host {
+
+size_t run_scheduler() {
+  std::vector<std::shared_ptr<Item>> due;
+  {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    uint32_t now = millis();
+    items.erase(std::remove_if(items.begin(), items.end(), [](const auto &item) { return item->removed; }),
+                items.end());
+    for (auto &item : items) {
+      if (int32_t(now - item->next_ms) >= 0)
+        due.push_back(item);
+    }
+    std::stable_sort(due.begin(), due.end(),
+                     [](const auto &a, const auto &b) { return int32_t(a->next_ms - b->next_ms) < 0; });
+  }
+  size_t ran = 0;
+  for (auto &item : due) {
+    {
+      std::lock_guard<std::recursive_mutex> guard(lock);
+      if (item->removed)
+        continue;
+      if (item->type == ItemType::TIMEOUT)
+        item->removed = true;
+      else
+        item->next_ms += std::max<uint32_t>(item->interval, 1);
+    }
+    item->f();
+    ran++;
+  }
+  return ran;
+}
+
+void reset_scheduler() {
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  items.clear();
+}
+
+size_t scheduled_count(const Component *component) {
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  return std::count_if(items.begin(), items.end(), [component](const auto &item) {
+    return !item->removed && (component == nullptr || item->component == component);
+  });
+}
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,109 @@
+#pragma once
+
+// Host stand-in for esphome/core/component.h. Timeouts, intervals and defers go to a single
+// host scheduler run by host::run_scheduler() against millis(), so with the fake clock a test
+// decides when they fire. Intervals first run on the next run_scheduler() (ESPHome adds a random
+// offset instead).
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+
+namespace setup_priority {
+const float BUS = 1000.0f;
+const float IO = 900.0f;
+const float HARDWARE = 800.0f;
+const float DATA = 600.0f;
+const float PROCESSOR = 400.0f;
+const float BLUETOOTH = 350.0f;
+const float AFTER_BLUETOOTH = 300.0f;
+const float WIFI = 250.0f;
+const float ETHERNET = 250.0f;
+const float BEFORE_CONNECTION = 220.0f;
+const float AFTER_WIFI = 200.0f;
+const float AFTER_CONNECTION = 100.0f;
+const float LATE = -100.0f;
+}  // namespace setup_priority
+
+static const uint32_t SCHEDULER_DONT_RUN = 4294967295UL;
+
+class Component {
+ public:
+  virtual ~Component();
+
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+  virtual float get_loop_priority() const { return 0.0f; }
+  virtual bool can_proceed() { return true; }
+  virtual void on_shutdown() {}
+  // setup(), then for polling components the poller
+  virtual void call_setup() { this->setup(); }
+
+  bool is_failed() const { return this->failed_; }
+  void mark_failed() { this->failed_ = true; }
+  void status_set_warning(const char *message = nullptr) { this->warning_ = true; }
+  void status_clear_warning() { this->warning_ = false; }
+  bool status_has_warning() const { return this->warning_; }
+  void status_set_error(const char *message = nullptr) { this->error_ = true; }
+  void status_clear_error() { this->error_ = false; }
+  bool status_has_error() const { return this->error_; }
+
+  void enable_loop() { this->loop_enabled_ = true; }
+  void disable_loop() { this->loop_enabled_ = false; }
+  bool is_loop_enabled() const { return this->loop_enabled_; }
+
+  const char *get_component_source() const { return this->component_source_; }
+  void set_component_source(const char *source) { this->component_source_ = source; }
+
+ protected:
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);
+  void set_interval(uint32_t interval, std::function<void()> &&f);
+  bool cancel_interval(const std::string &name);
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  void set_timeout(uint32_t timeout, std::function<void()> &&f);
+  bool cancel_timeout(const std::string &name);
+  void defer(const std::string &name, std::function<void()> &&f);
+  void defer(std::function<void()> &&f);
+  bool cancel_defer(const std::string &name);
+
+  bool failed_{false};
+  bool warning_{false};
+  bool error_{false};
+  bool loop_enabled_{true};
+  const char *component_source_{"<unknown>"};
+};
+
+class PollingComponent : public Component {
+ public:
+  PollingComponent() : PollingComponent(0) {}
+  explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+
+  virtual void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+  virtual uint32_t get_update_interval() const { return this->update_interval_; }
+  virtual void update() = 0;
+
+  void call_setup() override;
+  void start_poller();
+  void stop_poller();
+
+ protected:
+  uint32_t update_interval_;
+};
+
+namespace host {
+
+// Runs the timeouts, intervals and defers that are due at millis(); returns how many ran
+size_t run_scheduler();
+// Drops everything scheduled, e.g. between tests
+void reset_scheduler();
+// Scheduled items of the component (or of all components)
+size_t scheduled_count(const Component *component = nullptr);
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cctype>
+#include <string>
+
+namespace esphome {
+
+class EntityBase {
+ public:
+  virtual ~EntityBase() = default;
+
+  const std::string &get_name() const { return this->name_; }
+  void set_name(const std::string &name) { this->name_ = name; }
+  // the name in snake case unless set
+  std::string get_object_id() const {
+    if (!this->object_id_.empty())
+      return this->object_id_;
+    std::string id;
+    for (char c : this->name_)
+      id += c == ' ' ? '_' : static_cast<char>(tolower(c));
+    return id;
+  }
+  void set_object_id(const std::string &object_id) { this->object_id_ = object_id; }
+  bool is_internal() const { return this->internal_; }
+  void set_internal(bool internal) { this->internal_ = internal; }
+  bool is_disabled_by_default() const { return this->disabled_by_default_; }
+  void set_disabled_by_default(bool disabled_by_default) { this->disabled_by_default_ = disabled_by_default; }
+
+ protected:
+  std::string name_;
+  std::string object_id_;
+  bool internal_{false};
+  bool disabled_by_default_{false};
+};
+
+}  // namespace esphome
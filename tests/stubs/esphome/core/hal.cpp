@@ -0,0 +1,110 @@
+#include "esphome/core/hal.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace esphome {
+namespace host {
+
+static const auto START = std::chrono::steady_clock::now();
+static std::atomic<bool> fake{false};
+static std::atomic<int64_t> fake_us{0};
+
+int64_t clock_us() {
+  if (fake)
+    return fake_us;
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - START).count();
+}
+
+void use_fake_clock(int64_t start_us) {
+  fake_us = start_us;
+  fake = true;
+}
+
+void use_real_clock() { fake = false; }
+
+bool is_fake_clock() { return fake; }
+
+void advance_us(int64_t us) { fake_us += us; }
+
+// --- Shared clock ---
+
+static std::mutex shared_lock;
+static std::atomic<bool> shared{false};
+static size_t shared_running{0};  // threads not waiting
+// wake-up and condition of each waiting thread, so a step of the clock wakes only those due
+static std::multimap<int64_t, std::condition_variable *> shared_wakeups;
+
+void use_shared_clock(int64_t start_us, size_t threads) {
+  std::lock_guard<std::mutex> guard(shared_lock);
+  use_fake_clock(start_us);
+  shared = threads > 0;
+  shared_running = threads;
+  shared_wakeups.clear();
+}
+
+// With every thread waiting, moves to the earliest wake-up and releases the threads due then
+static void advance_shared_locked() {
+  if (shared_running > 0 || shared_wakeups.empty())
+    return;
+  fake_us = shared_wakeups.begin()->first;
+  while (!shared_wakeups.empty() && shared_wakeups.begin()->first <= fake_us) {
+    shared_wakeups.begin()->second->notify_one();
+    shared_wakeups.erase(shared_wakeups.begin());
+    shared_running++;
+  }
+}
+
+static void wait_shared(int64_t until_us) {
+  std::unique_lock<std::mutex> lock(shared_lock);
+  if (until_us <= fake_us)
+    return;
+  std::condition_variable wake;
+  shared_running--;
+  shared_wakeups.emplace(until_us, &wake);
+  advance_shared_locked();
+  while (fake_us < until_us)
+    wake.wait_for(lock, std::chrono::milliseconds(100));
+}
+
+void leave_shared_clock() {
+  std::lock_guard<std::mutex> guard(shared_lock);
+  if (!shared)
+    return;
+  shared_running--;
+  if (shared_running == 0 && shared_wakeups.empty())
+    shared = false;
+  advance_shared_locked();
+}
+
+}  // namespace host
+
+uint32_t millis() { return host::clock_us() / 1000; }
+
+uint32_t micros() { return host::clock_us(); }
+
+void delay(uint32_t ms) {
+  if (host::shared)
+    host::wait_shared(host::fake_us + int64_t(ms) * 1000);
+  else if (host::is_fake_clock())
+    host::advance_us(int64_t(ms) * 1000);
+  else
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  if (host::shared)
+    host::wait_shared(host::fake_us + us);
+  else if (host::is_fake_clock())
+    host::advance_us(us);
+  else
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() { std::this_thread::yield(); }
+
+}  // namespace esphome
@@ -0,0 +1,39 @@
+#pragma once
+
+// Host stand-in for esphome/core/hal.h. Time comes from the host clock below, which follows the
+// steady clock unless a test switches it to a fake one it advances itself.
+
+#include <cstddef>
+#include <cstdint>
+
+#define IRAM_ATTR
+
+namespace esphome {
+
+uint32_t millis();
+uint32_t micros();
+// on the fake clock these advance the time instead of sleeping
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+namespace host {
+
+// Microseconds since the start of the process, or the fake time
+int64_t clock_us();
+// Freezes the clock at start_us; it then only moves with advance_us(), delay() and
+// delayMicroseconds()
+void use_fake_clock(int64_t start_us = 0);
+void use_real_clock();
+bool is_fake_clock();
+void advance_us(int64_t us);
+
+// Fake clock shared by threads simulating devices side by side: each of the next threads runs
+// until it delays, and once all of them are delaying the clock jumps to the earliest wake-up.
+// Every thread must call leave_shared_clock() when done; after the last one the clock is a
+// plain fake clock again.
+void use_shared_clock(int64_t start_us, size_t threads);
+void leave_shared_clock();
+
+}  // namespace host
+}  // namespace esphome
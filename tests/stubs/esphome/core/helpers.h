@@ -0,0 +1,116 @@
+#pragma once
+
+// Host stand-in for the parts of esphome/core/helpers.h the components use. Includes what the
+// real header brings in on the ESP32 (incl. FreeRTOS through semphr.h, and the C headers that put
+// the float overloads of abs() in the global namespace).
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esp_random.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/optional.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace esphome {
+
+template<typename... X> class CallbackManager;
+
+template<typename... Ts> class CallbackManager<void(Ts...)> {
+ public:
+  void add(std::function<void(Ts...)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+  void call(Ts... args) {
+    for (auto &cb : this->callbacks_)
+      cb(args...);
+  }
+  size_t size() const { return this->callbacks_.size(); }
+  void operator()(Ts... args) { this->call(args...); }
+
+ protected:
+  std::vector<std::function<void(Ts...)>> callbacks_;
+};
+
+// PSRAM and internal RAM are the same heap on the host
+template<class T> class RAMAllocator {
+ public:
+  using value_type = T;
+
+  enum Flags {
+    NONE = 0,
+    ALLOC_EXTERNAL = 1 << 0,
+    ALLOC_INTERNAL = 1 << 1,
+    ALLOW_FAILURE = 1 << 2,
+  };
+
+  RAMAllocator() = default;
+  explicit RAMAllocator(uint8_t flags) {}
+  template<class U> constexpr RAMAllocator(const RAMAllocator<U> &other) {}
+
+  T *allocate(size_t n) { return static_cast<T *>(malloc(n * sizeof(T))); }
+  T *reallocate(T *p, size_t n) { return static_cast<T *>(realloc(p, n * sizeof(T))); }
+  void deallocate(T *p, size_t n) { free(p); }
+};
+
+template<class T> using ExternalRAMAllocator = RAMAllocator<T>;
+
+class HighFrequencyLoopRequester {
+ public:
+  void start() { this->started_ = true; }
+  void stop() { this->started_ = false; }
+  static bool is_high_frequency() { return false; }
+
+ protected:
+  bool started_{false};
+};
+
+inline uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= c;
+  }
+  return hash;
+}
+
+inline std::string str_sprintf(const char *fmt, ...) {
+  std::string str;
+  va_list args;
+  va_start(args, fmt);
+  size_t length = vsnprintf(nullptr, 0, fmt, args);
+  va_end(args);
+  str.resize(length);
+  va_start(args, fmt);
+  vsnprintf(&str[0], length + 1, fmt, args);
+  va_end(args);
+  return str;
+}
+
+using std::to_string;
+
+namespace host {
+inline std::string &mac_address() {
+  static std::string mac = "a0b1c2d3e4f5";
+  return mac;
+}
+inline void set_mac_address(const std::string &mac) { mac_address() = mac; }
+}  // namespace host
+
+// Lower case hex without separators, as on the device
+inline std::string get_mac_address() { return host::mac_address(); }
+
+template<typename T> T clamp(T value, T min, T max) { return value < min ? min : (value > max ? max : value); }
+
+}  // namespace esphome
@@ -0,0 +1,42 @@
+#include "esphome/core/log.h"
+
+#include <atomic>
+#include <cstdarg>
+
+namespace esphome {
+namespace host {
+
+static std::atomic<int> level_{ESPHOME_LOG_LEVEL_WARN};
+static std::atomic<unsigned> errors_{0};
+static std::atomic<unsigned> warnings_{0};
+
+static const char *const LEVEL_NAMES[] = {"", "E", "W", "I", "C", "D", "V", "VV"};
+
+void log(int level, const char *tag, const char *format, ...) {
+  if (level == ESPHOME_LOG_LEVEL_ERROR)
+    errors_++;
+  else if (level == ESPHOME_LOG_LEVEL_WARN)
+    warnings_++;
+  if (level > level_)
+    return;
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "[%s][%s] ", LEVEL_NAMES[level], tag);
+  vfprintf(stderr, format, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+void set_log_level(int level) { level_ = level; }
+
+unsigned log_errors() { return errors_; }
+
+unsigned log_warnings() { return warnings_; }
+
+void reset_log_counts() {
+  errors_ = 0;
+  warnings_ = 0;
+}
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,70 @@
+#include "esphome/core/ring_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace esphome {
+
+std::unique_ptr<RingBuffer> RingBuffer::create(size_t len) { return std::unique_ptr<RingBuffer>(new RingBuffer(len)); }
+
+void RingBuffer::pop_(uint8_t *data, size_t len) {
+  size_t first = std::min(len, this->buffer_.size() - this->head_);
+  if (data != nullptr) {
+    memcpy(data, &this->buffer_[this->head_], first);
+    memcpy(data + first, &this->buffer_[0], len - first);
+  }
+  this->head_ = (this->head_ + len) % this->buffer_.size();
+  this->size_ -= len;
+}
+
+size_t RingBuffer::read(void *data, size_t len, TickType_t ticks_to_wait) {
+  std::unique_lock<std::mutex> guard(this->lock_);
+  if (this->size_ == 0 && ticks_to_wait > 0)
+    this->written_.wait_for(guard, std::chrono::milliseconds(ticks_to_wait), [this]() { return this->size_ > 0; });
+  size_t n = std::min(len, this->size_);
+  this->pop_(static_cast<uint8_t *>(data), n);
+  return n;
+}
+
+size_t RingBuffer::write(const void *data, size_t len) {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  if (len > this->buffer_.size()) {
+    bytes += len - this->buffer_.size();
+    len = this->buffer_.size();
+  }
+  size_t room = this->buffer_.size() - this->size_;
+  if (len > room)
+    this->pop_(nullptr, len - room);
+  size_t tail = (this->head_ + this->size_) % this->buffer_.size();
+  size_t first = std::min(len, this->buffer_.size() - tail);
+  memcpy(&this->buffer_[tail], bytes, first);
+  memcpy(&this->buffer_[0], bytes + first, len - first);
+  this->size_ += len;
+  this->written_.notify_all();
+  return len;
+}
+
+size_t RingBuffer::write_without_replacement(const void *data, size_t len, TickType_t ticks_to_wait) {
+  size_t room = this->free();
+  return this->write(data, std::min(len, room));
+}
+
+size_t RingBuffer::available() const {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  return this->size_;
+}
+
+size_t RingBuffer::free() const {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  return this->buffer_.size() - this->size_;
+}
+
+BaseType_t RingBuffer::reset() {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  this->head_ = this->size_ = 0;
+  return pdPASS;
+}
+
+}  // namespace esphome
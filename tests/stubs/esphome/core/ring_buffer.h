@@ -0,0 +1,40 @@
+#pragma once
+
+// Host stand-in for esphome/core/ring_buffer.h: a byte FIFO where write() discards the oldest
+// bytes to make room and read() waits up to ticks_to_wait milliseconds for data.
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+
+namespace esphome {
+
+class RingBuffer {
+ public:
+  static std::unique_ptr<RingBuffer> create(size_t len);
+
+  size_t read(void *data, size_t len, TickType_t ticks_to_wait = 0);
+  size_t write(const void *data, size_t len);
+  size_t write_without_replacement(const void *data, size_t len, TickType_t ticks_to_wait = 0);
+  size_t available() const;
+  size_t free() const;
+  BaseType_t reset();
+
+ protected:
+  explicit RingBuffer(size_t size) : buffer_(size) {}
+
+  std::vector<uint8_t> buffer_;
+  size_t head_{0};  // next byte read
+  size_t size_{0};  // bytes stored
+  mutable std::mutex lock_;
+  std::condition_variable written_;
+
+  void pop_(uint8_t *data, size_t len);
+};
+
+}  // namespace esphome
@@ -0,0 +1,72 @@
+#include "freertos/task.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct HostTask {
+  BaseType_t core{0};
+  std::mutex lock;
+  std::condition_variable notified;
+  uint32_t notifications{0};
+};
+
+// threads not created by xTaskCreate*() (e.g. the test itself) get a handle on first use
+static thread_local HostTask *current_task = nullptr;
+
+static HostTask *current() {
+  if (current_task == nullptr) {
+    static thread_local HostTask main_task;
+    current_task = &main_task;
+  }
+  return current_task;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_depth, void *parameter,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core_id) {
+  auto *task = new HostTask();
+  task->core = core_id;
+  if (handle != nullptr)
+    *handle = task;
+  std::thread([task, function, parameter]() {
+    current_task = task;
+    function(parameter);
+    delete task;
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_depth, void *parameter,
+                       UBaseType_t priority, TaskHandle_t *handle) {
+  return xTaskCreatePinnedToCore(function, name, stack_depth, parameter, priority, handle, 0);
+}
+
+void vTaskDelete(TaskHandle_t task) {}
+
+void vTaskDelay(TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return current(); }
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait) {
+  HostTask *task = current();
+  std::unique_lock<std::mutex> guard(task->lock);
+  task->notified.wait_for(guard, std::chrono::milliseconds(ticks_to_wait), [task]() { return task->notifications > 0; });
+  uint32_t count = task->notifications;
+  if (count > 0)
+    task->notifications = clear_count_on_exit ? 0 : count - 1;
+  return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  if (task == nullptr)
+    return pdFAIL;
+  std::lock_guard<std::mutex> guard(task->lock);
+  task->notifications++;
+  task->notified.notify_all();
+  return pdPASS;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { return 0; }
+
+BaseType_t xPortGetCoreID() { return current()->core; }
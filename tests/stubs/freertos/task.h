@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for freertos/task.h: tasks are detached std::threads, notifications a counting
+// semaphore per task. The core id is kept for xPortGetCoreID() but has no effect.
+
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+
+struct HostTask;
+using TaskHandle_t = HostTask *;
+using TaskFunction_t = void (*)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_depth, void *parameter,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core_id);
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_depth, void *parameter,
+                       UBaseType_t priority, TaskHandle_t *handle);
+// The task's thread ends when its function returns; the handle is freed then
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xPortGetCoreID();
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "esphome/components/instrumentation/trace_span.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+#include "esphome/components/trace/trace.h"
+
+namespace esphome::trace::testing {
+namespace {
+
+// Exposes the ring to the tests
+class HostTrace : public Trace {
+ public:
+  using Trace::Trace;
+  using Trace::read_event_;
+};
+
+class TraceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::use_fake_clock(1000000);
+    host::set_log_level(ESPHOME_LOG_LEVEL_WARN);
+    this->trace_.set_ring_size(8);
+    this->trace_.set_stage_sensors("stage", &this->p50_, &this->p99_);
+    this->trace_.setup();
+    this->stage_ = this->trace_.stage("stage");
+  }
+  void TearDown() override {
+    global_trace = nullptr;
+    host::use_real_clock();
+  }
+
+  // Spans of 1000 * durations us, one after the other
+  void record(std::initializer_list<uint32_t> durations) {
+    for (uint32_t duration : durations)
+      this->trace_.record(this->stage_, nullptr, host::clock_us(), duration * 1000);
+  }
+
+  // update() and the warnings it logged
+  std::string update() {
+    ::testing::internal::CaptureStderr();
+    this->trace_.update();
+    return ::testing::internal::GetCapturedStderr();
+  }
+
+  web_server_base::WebServerBase base_;
+  HostTrace trace_{&this->base_};
+  sensor::Sensor p50_, p99_;
+  Stage *stage_{nullptr};
+};
+
+TEST_F(TraceTest, StageLookedUpByName) {
+  EXPECT_EQ(this->trace_.stage("stage"), this->stage_);
+  EXPECT_NE(this->trace_.stage("other"), this->stage_);
+}
+
+TEST_F(TraceTest, SummaryOfWindow) {
+  this->record({5, 1, 4, 2, 3});
+  EXPECT_EQ(this->update(), "");
+  // p50 is the lower median, p99 the largest but one of up to 100 spans
+  EXPECT_FLOAT_EQ(this->p50_.get_state(), 3.0f);
+  EXPECT_FLOAT_EQ(this->p99_.get_state(), 4.0f);
+
+  // the next window only holds the spans since
+  this->record({7, 9});
+  this->update();
+  EXPECT_FLOAT_EQ(this->p50_.get_state(), 7.0f);
+  EXPECT_FLOAT_EQ(this->p99_.get_state(), 7.0f);
+}
+
+// A window longer than the ring is summarised over its last ring_size spans, and the overwritten
+// ones are counted
+TEST_F(TraceTest, RingWrap) {
+  this->record({100, 100, 100, 8, 1, 7, 2, 6, 3, 5, 4});
+  std::string log = this->update();
+  EXPECT_NE(log.find("3 spans overwritten"), std::string::npos) << log;
+  EXPECT_FLOAT_EQ(this->p50_.get_state(), 4.0f);
+  EXPECT_FLOAT_EQ(this->p99_.get_state(), 7.0f);
+
+  Event event;
+  for (uint32_t index = 0; index < 3; index++)
+    EXPECT_FALSE(this->trace_.read_event_(index, event)) << index;
+  ASSERT_TRUE(this->trace_.read_event_(3, event));
+  EXPECT_EQ(event.stage, this->stage_);
+  EXPECT_EQ(event.duration_us, 8000u);
+  ASSERT_TRUE(this->trace_.read_event_(10, event));
+  EXPECT_EQ(event.duration_us, 4000u);
+  // not recorded yet
+  EXPECT_FALSE(this->trace_.read_event_(11, event));
+
+  // a window that fits the ring again is not reported
+  this->record({9});
+  EXPECT_EQ(this->update(), "");
+  EXPECT_FLOAT_EQ(this->p50_.get_state(), 9.0f);
+}
+
+// GET /trace.json returns the spans still in the ring as Chrome trace events
+TEST_F(TraceTest, ChromeTraceJson) {
+  this->record({100, 100, 100, 8, 1, 7, 2, 6, 3, 5, 4});
+  AsyncWebServerRequest request("/trace.json");
+  ASSERT_TRUE(this->base_.handle(&request));
+  const std::string &body = request.req().body;
+  EXPECT_EQ(body.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u) << body;
+  EXPECT_EQ(body.find("\"dur\":100000"), std::string::npos);
+  EXPECT_NE(body.find("{\"name\":\"stage\",\"cat\":\"stage\",\"ph\":\"X\",\"ts\":1000000,\"dur\":8000,"),
+            std::string::npos);
+  EXPECT_EQ(body.substr(body.size() - 2), "]}");
+}
+
+TEST_F(TraceTest, SpansCarryTheirSample) {
+  this->record({1});
+  this->trace_.begin_sample();
+  host::advance_us(2500);
+  this->record({1});
+  this->trace_.end_sample();
+
+  Event event;
+  ASSERT_TRUE(this->trace_.read_event_(0, event));
+  EXPECT_EQ(event.sample, 0u);
+  ASSERT_TRUE(this->trace_.read_event_(1, event));
+  EXPECT_EQ(event.sample, 1u);
+  ASSERT_TRUE(this->trace_.read_event_(2, event));
+  EXPECT_STREQ(event.stage->name, "sample");
+  EXPECT_EQ(event.duration_us, 2500u);
+}
+
+TEST_F(TraceTest, ScopedSpan) {
+  {
+    TRACE_SPAN_NAMED("stage", "co2");
+    host::advance_us(1200);
+  }
+  Event event;
+  ASSERT_TRUE(this->trace_.read_event_(0, event));
+  EXPECT_EQ(event.stage, this->stage_);
+  EXPECT_STREQ(event.name, "co2");
+  EXPECT_EQ(event.duration_us, 1200u);
+}
+
+}  // namespace
+}  // namespace esphome::trace::testing
@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+"""
+Delta OTA patches for SAMBA firmware
+- Builds the compressed binary patch from the previous firmware/samba_v*.bin release to the newest,
+  at release time; patches are attached to the GitHub release, not committed.
+- Applies every patch it writes with the same decoder logic as the delta_ota component and
+  checks the result against the new image, so a patch that does not round-trip is never published.
+- Reports the bytes a device downloads per update, patch against full image.
+
+Usage:
+  python3 tools/delta_ota.py make [--firmware firmware] [--out firmware/delta] [--from VERSION]
+  python3 tools/delta_ota.py diff OLD.bin NEW.bin PATCH
+  python3 tools/delta_ota.py apply OLD.bin PATCH NEW.bin
+
+Patch format (little endian), see components/delta_ota/delta_patch.h:
+  header   magic "SDP1", old size u32, new size u32, old md5[16], new md5[16]
+  body     zlib stream of entries until new size bytes are produced:
+             diff length u32, extra length u32, old seek i32
+             diff bytes    new = old + diff (mod 256), old and new advance
+             extra bytes   copied to new
+             old position moves by seek
+The entries follow bsdiff (Percival, "Naive differences of executable code", 2003): code that
+moved keeps most bytes and differs in addresses, which leaves runs of zeros that compress well.
+Exact matches are found through a hash index of the old image instead of a suffix array.
+"""
+
+import argparse
+import hashlib
+import re
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+MAGIC = b"SDP1"
+HEADER = struct.Struct("<4sII16s16s")
+CONTROL = struct.Struct("<IIi")
+
+BLOCK = 16  # bytes hashed per index entry; shorter matches are not worth a control entry
+STRIDE = 4  # index every STRIDE-th position of the old image
+# Must not exceed the 32 KiB window of the on-device inflater (TINFL_LZ_DICT_SIZE)
+ZLIB_WBITS = 15
+
+
+# --- Diff ---
+
+
+def build_index(old):
+    index = {}
+    for i in range(0, len(old) - BLOCK + 1, STRIDE):
+        index.setdefault(old[i : i + BLOCK], i)
+    return index
+
+
+def match_length(old, opos, new, npos):
+    # compare in growing chunks, then byte by byte
+    length, step = 0, BLOCK
+    limit = min(len(old) - opos, len(new) - npos)
+    while length < limit:
+        n = min(step, limit - length)
+        if old[opos + length : opos + length + n] == new[npos + length : npos + length + n]:
+            length += n
+            step *= 2
+        elif n == 1:
+            break
+        else:
+            step = max(1, n // 2)
+    return length
+
+
+def search(index, old, new, scan):
+    """Longest exact match of new[scan:] in old, as (position, length)."""
+    best_pos, best_len = 0, 0
+    for d in range(STRIDE):
+        p = index.get(new[scan + d : scan + d + BLOCK])
+        if p is None or p < d:
+            continue
+        length = match_length(old, p - d, new, scan)
+        if length > best_len:
+            best_pos, best_len = p - d, length
+    return best_pos, best_len
+
+
+def diff(old, new):
+    """Yields (diff bytes, extra bytes, seek) entries that turn old into new."""
+    index = build_index(old)
+    old_size, new_size = len(old), len(new)
+    scan = length = pos = 0
+    last_scan = last_pos = last_offset = 0
+
+    while scan < new_size:
+        old_score = 0
+        scan += length
+        scsc = scan
+        while scan < new_size:
+            pos, length = search(index, old, new, scan)
+            while scsc < scan + length:
+                if 0 <= scsc + last_offset < old_size and old[scsc + last_offset] == new[scsc]:
+                    old_score += 1
+                scsc += 1
+            if (length == old_score and length != 0) or length > old_score + 8:
+                break
+            if 0 <= scan + last_offset < old_size and old[scan + last_offset] == new[scan]:
+                old_score -= 1
+            scan += 1
+
+        if length == old_score and scan != new_size:
+            continue
+
+        # extend the previous match forward and this one backward, allowing mismatches
+        s = best = length_f = 0
+        i = 0
+        while last_scan + i < scan and last_pos + i < old_size:
+            if old[last_pos + i] == new[last_scan + i]:
+                s += 1
+            i += 1
+            if s * 2 - i > best * 2 - length_f:
+                best, length_f = s, i
+
+        length_b = 0
+        if scan < new_size:
+            s = best = 0
+            i = 1
+            while scan >= last_scan + i and pos >= i:
+                if old[pos - i] == new[scan - i]:
+                    s += 1
+                if s * 2 - i > best * 2 - length_b:
+                    best, length_b = s, i
+                i += 1
+
+        if last_scan + length_f > scan - length_b:
+            overlap = (last_scan + length_f) - (scan - length_b)
+            s = best = length_s = 0
+            for i in range(overlap):
+                if new[last_scan + length_f - overlap + i] == old[last_pos + length_f - overlap + i]:
+                    s += 1
+                if new[scan - length_b + i] == old[pos - length_b + i]:
+                    s -= 1
+                if s > best:
+                    best, length_s = s, i + 1
+            length_f += length_s - overlap
+            length_b -= length_s
+
+        diff_bytes = bytes(
+            (n - o) & 0xFF
+            for n, o in zip(new[last_scan : last_scan + length_f], old[last_pos : last_pos + length_f])
+        )
+        extra_bytes = new[last_scan + length_f : scan - length_b]
+        seek = (pos - length_b) - (last_pos + length_f)
+        yield diff_bytes, extra_bytes, seek
+
+        last_scan = scan - length_b
+        last_pos = pos - length_b
+        last_offset = pos - scan
+
+
+def make_patch(old, new):
+    compressor = zlib.compressobj(9, zlib.DEFLATED, ZLIB_WBITS)
+    body = []
+    for diff_bytes, extra_bytes, seek in diff(old, new):
+        body.append(compressor.compress(CONTROL.pack(len(diff_bytes), len(extra_bytes), seek)))
+        body.append(compressor.compress(diff_bytes))
+        body.append(compressor.compress(extra_bytes))
+    body.append(compressor.flush())
+    header = HEADER.pack(MAGIC, len(old), len(new), hashlib.md5(old).digest(), hashlib.md5(new).digest())
+    return header + b"".join(body)
+
+
+# --- Apply ---
+
+
+def apply_patch(old, patch):
+    """Reference decoder, mirrors PatchDecoder in the delta_ota component."""
+    if len(patch) < HEADER.size:
+        raise ValueError("patch too short")
+    magic, old_size, new_size, old_md5, new_md5 = HEADER.unpack_from(patch)
+    if magic != MAGIC:
+        raise ValueError("not a SAMBA delta patch")
+    if old_size != len(old) or hashlib.md5(old).digest() != old_md5:
+        raise ValueError("patch is for another base image")
+
+    body = zlib.decompress(patch[HEADER.size :], ZLIB_WBITS)
+    new = bytearray()
+    offset = old_pos = 0
+    while len(new) < new_size:
+        diff_length, extra_length, seek = CONTROL.unpack_from(body, offset)
+        offset += CONTROL.size
+        if len(new) + diff_length + extra_length > new_size or old_pos + diff_length > old_size:
+            raise ValueError("corrupt control entry")
+        new += bytes((d + o) & 0xFF for d, o in zip(body[offset : offset + diff_length], old[old_pos:]))
+        offset += diff_length
+        old_pos += diff_length
+        new += body[offset : offset + extra_length]
+        offset += extra_length
+        old_pos += seek
+        if not 0 <= old_pos <= old_size:
+            raise ValueError("corrupt seek")
+    if offset != len(body) or hashlib.md5(new).digest() != new_md5:
+        raise ValueError("patched image does not match")
+    return bytes(new)
+
+
+# --- Commands ---
+
+
+def version_key(path):
+    return tuple(int(x) for x in re.findall(r"\d+", path.stem))
+
+
+def write_patch(old_path, new_path, patch_path):
+    old, new = old_path.read_bytes(), new_path.read_bytes()
+    patch = make_patch(old, new)
+    if apply_patch(old, patch) != new:
+        raise SystemExit(f"{patch_path.name}: round trip failed")
+    patch_path.write_bytes(patch)
+    return len(new), len(patch)
+
+
+def cmd_make(args):
+    images = sorted(Path(args.firmware).glob("samba_v*.bin"), key=version_key)
+    if len(images) < 2:
+        raise SystemExit(f"need at least two samba_v*.bin in {args.firmware}")
+    out = Path(args.out)
+    out.mkdir(parents=True, exist_ok=True)
+
+    new_path = images[-1]
+    if args.base is None:
+        old_paths = [images[-2]]
+    else:
+        old_paths = [path for path in images[:-1] if path.stem == f"samba_{args.base}"]
+        if not old_paths:
+            raise SystemExit(f"no samba_{args.base}.bin in {args.firmware}")
+
+    print(f"{'update':<28} {'full':>10} {'patch':>10} {'sent':>7}")
+    for old_path in old_paths:
+        name = f"{old_path.stem}-{new_path.stem.removeprefix('samba_')}.patch"
+        full, patch = write_patch(old_path, new_path, out / name)
+        print(f"{name.removesuffix('.patch'):<28} {full:>10} {patch:>10} {patch / full:>7.1%}")
+
+
+def cmd_diff(args):
+    full, patch = write_patch(Path(args.old), Path(args.new), Path(args.patch))
+    print(f"{args.patch}: {patch} bytes for a {full} byte image ({patch / full:.1%})")
+
+
+def cmd_apply(args):
+    new = apply_patch(Path(args.old).read_bytes(), Path(args.patch).read_bytes())
+    Path(args.new).write_bytes(new)
+    print(f"{args.new}: {len(new)} bytes, md5 {hashlib.md5(new).hexdigest()}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    make = sub.add_parser("make", help="patch from the previous release to the newest")
+    make.add_argument("--firmware", default="firmware")
+    make.add_argument("--out", default="firmware/delta")
+    make.add_argument("--from", dest="base", metavar="VERSION", help="base release, e.g. v2.01.00")
+    make.set_defaults(func=cmd_make)
+
+    diff_ = sub.add_parser("diff", help="patch between two images")
+    diff_.add_argument("old")
+    diff_.add_argument("new")
+    diff_.add_argument("patch")
+    diff_.set_defaults(func=cmd_diff)
+
+    apply_ = sub.add_parser("apply", help="apply a patch on the host")
+    apply_.add_argument("old")
+    apply_.add_argument("patch")
+    apply_.add_argument("new")
+    apply_.set_defaults(func=cmd_apply)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())